@@ -30,6 +30,12 @@
 // This is the platform independent interface between an OGL driver
 // and the shading language compiler.
 //
+// Threading: ShInitialize() and ShFinalize() are not thread-safe and must
+// bracket all other calls. In between, compilers may be constructed,
+// used and destructed on any thread, and distinct compilers may compile
+// concurrently. A single compiler handle must not be used from two threads
+// at the same time.
+//
 
 #ifdef __cplusplus
 extern "C" {
@@ -37,7 +43,7 @@ extern "C" {
 
 // Version number for shader translation API.
 // It is incremented everytime the API changes.
-#define ANGLE_SH_VERSION 112
+#define ANGLE_SH_VERSION 122
 
 //
 // The names of the following enums have been derived by replacing GL prefix
@@ -128,7 +134,16 @@ typedef enum {
   SH_NAME_MAX_LENGTH             =  0x6001,
   SH_HASHED_NAME_MAX_LENGTH      =  0x6002,
   SH_HASHED_NAMES_COUNT          =  0x6003,
-  SH_ACTIVE_UNIFORMS_ARRAY       =  0x6004
+  SH_ACTIVE_UNIFORMS_ARRAY       =  0x6004,
+  SH_TRANSLATION_CACHE_HITS      =  0x6005,
+  SH_TRANSLATION_CACHE_MISSES    =  0x6006,
+  SH_TRANSLATION_CACHE_EVICTIONS =  0x6007,
+  SH_TRANSLATION_CACHE_SIZE      =  0x6008,
+  SH_TRANSLATION_CACHE_HIT_LATENCY  = 0x6009,
+  SH_TRANSLATION_CACHE_MISS_LATENCY = 0x600A,
+  SH_TRANSLATION_CACHE_PERSISTENT_HITS = 0x600B,
+  SH_MEMORY_STATISTICS           =  0x600C,
+  SH_PASS_TIMINGS                =  0x600D
 } ShShaderInfo;
 
 // Compile options.
@@ -178,7 +193,10 @@ typedef enum {
   // compiler, selects the strategy for the clamping implementation.
   SH_CLAMP_INDIRECT_ARRAY_BOUNDS = 0x1000,
 
-  // This flag limits the complexity of an expression.
+  // This flag limits the complexity of an expression: the depth of the
+  // tree, up to MaxExpressionComplexity. A shader over the limit gets the
+  // node counts of its deepest expression and of each function in its
+  // info log.
   SH_LIMIT_EXPRESSION_COMPLEXITY = 0x2000,
 
   // This flag limits the depth of the call stack.
@@ -209,12 +227,13 @@ typedef enum {
 
 //
 // Driver must call this first, once, before doing any other
-// compiler operations.
+// compiler operations, and before starting any thread that uses them.
 // If the function succeeds, the return value is nonzero, else zero.
 //
 COMPILER_EXPORT int ShInitialize();
 //
-// Driver should call this at shutdown.
+// Driver should call this at shutdown, once no other thread uses
+// the compiler.
 // If the function succeeds, the return value is nonzero, else zero.
 //
 COMPILER_EXPORT int ShFinalize();
@@ -331,6 +350,172 @@ COMPILER_EXPORT int ShCompile(
     int compileOptions
     );
 
+//
+// Sets the memory budget of the translation cache, in bytes.
+// Compilers look up the results of each ShCompile() call in a cache shared
+// by the whole process, keyed on the shader strings, compile options, spec,
+// output and built-in resources. A byte-identical shader is thus only
+// translated once. When the cache is over budget, the least recently used
+// translations are evicted.
+// The cache is disabled by default. A maxSize of 0 disables it and frees the
+// memory it holds.
+//
+COMPILER_EXPORT void ShSetTranslationCacheSize(size_t maxSize);
+
+//
+// Persists the translation cache to a file, so that translations outlive
+// the process. Compiles that miss the in-memory cache are looked up in the
+// file, and their translations are added to it. The file is created if
+// needed, along with an index next to it. Files written by another
+// ANGLE_SH_VERSION are started over, and damaged ones only cause misses.
+// The file must not be used by two processes at once.
+// Translations that depend on the process, because they map long variable
+// names or hash names, are not persisted.
+// The index is brought up to date when the file is closed, by another call
+// to this function or ShFinalize(). A NULL path closes the file.
+// Returns 1 on success, 0 if the file cannot be opened.
+//
+COMPILER_EXPORT int ShSetTranslationCacheFile(const char* path);
+
+//
+// The phases of a compile, in the order they run.
+//
+typedef enum {
+  SH_PHASE_PARSE,                 // Preprocessing and parsing.
+  SH_PHASE_VALIDATE_LIMITATIONS,  // SH_VALIDATE_LOOP_INDEXING.
+  SH_PHASE_DEPENDENCY_GRAPH,      // SH_TIMING_RESTRICTIONS.
+  SH_PHASE_TRANSLATE,             // SH_OBJECT_CODE.
+  SH_PHASE_OTHER,                 // Everything else.
+  SH_PHASE_COUNT
+} ShCompilePhase;
+
+//
+// The memory a compile took from the pool allocator of its compiler, which
+// holds the syntax tree and everything else that only lives for the
+// compile. Memory is taken from the system in pages, which are kept by the
+// compiler for its next compiles.
+// peakBytes: The most memory the compile held at once, in bytes.
+// numPages: The most pages the compile held at once.
+// numAllocations: The number of allocations made by the compile.
+// allocatedBytes: The total size of the allocations made by the compile.
+// phaseBytes: allocatedBytes, broken down by ShCompilePhase.
+//
+typedef struct
+{
+    size_t peakBytes;
+    size_t numPages;
+    size_t numAllocations;
+    size_t allocatedBytes;
+    size_t phaseBytes[SH_PHASE_COUNT];
+} ShMemoryStatistics;
+
+//
+// The passes of a compile over the syntax tree, in the order they run.
+//
+typedef enum {
+  SH_PASS_PARSE,                          // Preprocessing and parsing.
+  SH_PASS_POST_PROCESS,
+  SH_PASS_DETECT_CALL_DEPTH,
+  SH_PASS_VALIDATE_LIMITATIONS,           // SH_VALIDATE_LOOP_INDEXING.
+  SH_PASS_TIMING_RESTRICTIONS,            // SH_TIMING_RESTRICTIONS.
+  SH_PASS_REWRITE_CSS_SHADER,             // SH_CSS_SHADERS_SPEC.
+  SH_PASS_UNROLL_FOR_LOOPS,               // SH_UNROLL_FOR_LOOP_WITH_INTEGER_INDEX.
+  SH_PASS_EMULATE_BUILT_IN_FUNCTIONS,     // SH_EMULATE_BUILT_IN_FUNCTIONS.
+  SH_PASS_CLAMP_INDIRECT_ARRAY_BOUNDS,    // SH_CLAMP_INDIRECT_ARRAY_BOUNDS.
+  SH_PASS_LIMIT_EXPRESSION_COMPLEXITY,    // SH_LIMIT_EXPRESSION_COMPLEXITY.
+  SH_PASS_MAP_LONG_VARIABLE_NAMES,        // SH_MAP_LONG_VARIABLE_NAMES.
+  SH_PASS_INIT_GL_POSITION,               // SH_INIT_GL_POSITION.
+  SH_PASS_UNFOLD_SHORT_CIRCUIT,           // SH_UNFOLD_SHORT_CIRCUIT.
+  SH_PASS_COLLECT_VARIABLES,              // SH_VARIABLES.
+  SH_PASS_INTERMEDIATE_TREE,              // SH_INTERMEDIATE_TREE.
+  SH_PASS_TRANSLATE,                      // SH_OBJECT_CODE.
+  SH_PASS_COUNT
+} ShCompilePass;
+
+//
+// The time taken by a compile, in nanoseconds.
+// Some passes share their traversals of the tree, visiting each node in
+// turn. The time of a shared traversal is not broken down by pass.
+// totalNanoseconds: The time taken by the whole compile.
+// passNanoseconds: The time taken by each ShCompilePass that ran on its
+//                  own. The passes that did not run, or only ran in shared
+//                  traversals, take none.
+// sharedNanoseconds: The time taken by the shared traversals.
+// sharedPasses: The passes that ran in shared traversals, as a mask with
+//               bit (1 << pass) set for each ShCompilePass.
+//
+typedef struct
+{
+    size_t totalNanoseconds;
+    size_t passNanoseconds[SH_PASS_COUNT];
+    size_t sharedNanoseconds;
+    unsigned int sharedPasses;
+} ShPassTimings;
+
+//
+// The event tracer of the embedder, with the arguments of the functions
+// that libGLESv2 takes through SetTraceFunctionPointers(), so that the same
+// tracer can be given to both.
+//
+typedef const unsigned char* (*ShGetCategoryEnabledFlagFunc)(const char* name);
+typedef void (*ShAddTraceEventFunc)(char phase, const unsigned char* categoryGroupEnabled,
+                                    const char* name, unsigned long long id, int numArgs,
+                                    const char** argNames, const unsigned char* argTypes,
+                                    const unsigned long long* argValues, unsigned char flags);
+
+//
+// Sets the event tracer the compilers trace their passes with. Each timed
+// ShCompilePass, and each traversal of the tree shared by several passes,
+// is traced as a pair of begin ('B') and end ('E') events in the "gpu"
+// category, while the embedder has the category enabled.
+// The tracer is shared by the whole process, and must not be changed while
+// shaders compile. NULL functions turn tracing off, which is the default.
+//
+COMPILER_EXPORT void ShSetTraceFunctionPointers(ShGetCategoryEnabledFlagFunc getCategoryEnabledFlag,
+                                                ShAddTraceEventFunc addTraceEvent);
+
+//
+// A shader to compile with ShCompileBatch().
+// The inputs are those of ShConstructCompiler() and ShCompile().
+// The outputs are filled in by ShCompileBatch():
+// compiler: The handle of the compiler the shader was compiled with, or 0 if
+//           it could not be constructed. The object code, info log and
+//           variables are queried from it as after ShCompile(). The caller
+//           must free it with ShDestruct().
+// compiled: The return value of ShCompile().
+//
+typedef struct
+{
+    ShShaderType type;
+    ShShaderSpec spec;
+    ShShaderOutput output;
+    const ShBuiltInResources* resources;
+    const char* const* shaderStrings;
+    size_t numStrings;
+    int compileOptions;
+
+    ShHandle compiler;
+    int compiled;
+} ShCompileJob;
+
+//
+// Compiles a batch of shaders, each with a compiler of its own, on a pool of
+// threads. Compiling many shaders at once, as when warming up a cache of
+// programs, thus scales with the number of cores.
+// If every shader compiles, the return value is nonzero, else zero.
+// Parameters:
+// jobs: Specifies an array of shaders to compile, which also receives the
+//       results.
+// numJobs: Specifies the number of elements in jobs array.
+// numThreads: Specifies the number of threads to compile with, including
+//             the calling thread, or 0 for one thread per processor.
+//
+COMPILER_EXPORT int ShCompileBatch(
+    ShCompileJob* jobs,
+    size_t numJobs,
+    int numThreads
+    );
+
 // Returns a parameter from a compiled shader.
 // Parameters:
 // handle: Specifies the compiler
@@ -358,6 +543,24 @@ COMPILER_EXPORT int ShCompile(
 // SH_HASHED_NAME_MAX_LENGTH: the max length of a hashed name including the
 //                            null termination character.
 // SH_HASHED_NAMES_COUNT: the number of hashed names from the latest compile.
+// SH_TRANSLATION_CACHE_HITS: the number of compiles served from the
+//                            translation cache, by all compilers.
+// SH_TRANSLATION_CACHE_MISSES: the number of compiles that missed the
+//                              translation cache, by all compilers.
+// SH_TRANSLATION_CACHE_EVICTIONS: the number of translations evicted from the
+//                                 translation cache.
+// SH_TRANSLATION_CACHE_SIZE: the memory held by the translation cache, in
+//                            bytes.
+// SH_TRANSLATION_CACHE_HIT_LATENCY: the mean time taken by the compiles
+//                                   served from the translation cache, in
+//                                   nanoseconds.
+// SH_TRANSLATION_CACHE_MISS_LATENCY: the mean time taken by the compiles that
+//                                    missed the translation cache, in
+//                                    nanoseconds.
+// SH_TRANSLATION_CACHE_PERSISTENT_HITS: the number of compiles served from
+//                                       the file set with
+//                                       ShSetTranslationCacheFile(), counted
+//                                       in SH_TRANSLATION_CACHE_HITS too.
 //
 // params: Requested parameter
 COMPILER_EXPORT void ShGetInfo(const ShHandle handle,
@@ -384,6 +587,68 @@ COMPILER_EXPORT void ShGetInfoLog(const ShHandle handle, char* infoLog);
 //          ShGetInfo with SH_OBJECT_CODE_LENGTH.
 COMPILER_EXPORT void ShGetObjectCode(const ShHandle handle, char* objCode);
 
+// Receives object code as it is generated. code is not null-terminated, and
+// is only valid during the call.
+typedef void (*ShObjectCodeCallback)(const char* code, size_t length, void* userData);
+
+// Makes the compiler hand the object code of successful compiles to a
+// callback, in chunks of a few kilobytes, instead of keeping it for
+// ShGetObjectCode(). The whole object code is thus never held at once, nor
+// copied again by the caller. The concatenated chunks are what
+// ShGetObjectCode() would have returned; the callback is not called at all
+// if the compile fails, and SH_OBJECT_CODE_LENGTH is 1 after a compile that
+// streamed its object code. Streamed compiles bypass the translation cache.
+// The callback is called on the thread that runs ShCompile(), or a worker
+// thread of ShCompileBatch(). A NULL callback restores the default.
+// Parameters:
+// handle: Specifies the compiler
+// callback: Specifies the function receiving the object code, or NULL.
+// userData: Specifies a pointer passed back to callback.
+COMPILER_EXPORT void ShSetObjectCodeCallback(const ShHandle handle,
+                                             ShObjectCodeCallback callback,
+                                             void* userData);
+
+// Returns the source included by #include "name" or #include <name>, and
+// sets length to its length, or returns NULL if there is no such source.
+// The source need not be null-terminated, and need only stay valid until
+// the callback is called again or the compile ends.
+typedef const char* (*ShIncludeCallback)(const char* name, size_t* length, void* userData);
+
+// Enables the #include directive, which is not part of GLSL ES, and makes
+// the compiler get the included sources from a callback. The compiler keeps
+// the tokens of the sources it is given, and looks them up by content, so
+// that a source included by many shaders is tokenized once. Directives and
+// macros in the source still apply each time it is included.
+// Included sources are numbered after the shader strings, in the order in
+// which they are included, and the info log reports locations in them with
+// these numbers. Compiles with an include callback bypass the translation
+// cache, as the included sources may change. A NULL callback disables
+// #include again.
+// Parameters:
+// handle: Specifies the compiler
+// callback: Specifies the function providing the included sources, or NULL.
+// userData: Specifies a pointer passed back to callback.
+COMPILER_EXPORT void ShSetIncludeCallback(const ShHandle handle,
+                                          ShIncludeCallback callback,
+                                          void* userData);
+
+// Compiles a prelude of declarations once, so that the following ShCompile()
+// calls start from it, as if its strings came before the shader strings.
+// The symbols, macros, pragmas and extension behavior of the prelude are
+// kept, and its declarations are translated with each shader. The strings
+// of the shaders keep their own numbers in the info log.
+// If the function succeeds, the return value is nonzero, else zero, and the
+// errors are written to the info log. A prelude that fails to compile is not
+// kept. A numStrings of 0 removes the prelude.
+// Parameters:
+// handle: Specifies the compiler
+// shaderStrings: Specifies an array of pointers to null-terminated strings
+//                containing the source code of the prelude.
+// numStrings: Specifies the number of elements in shaderStrings array.
+COMPILER_EXPORT int ShCompilePrelude(const ShHandle handle,
+                                     const char* const shaderStrings[],
+                                     size_t numStrings);
+
 // Returns information about a shader variable.
 // Parameters:
 // handle: Specifies the compiler
@@ -447,6 +712,12 @@ COMPILER_EXPORT void ShGetNameHashingEntry(const ShHandle handle,
 // The following parameters are defined:
 // SH_ACTIVE_UNIFORMS_ARRAY: an STL vector of active uniforms. Valid only for
 //                           HLSL output.
+// SH_MEMORY_STATISTICS: a const ShMemoryStatistics* describing the memory
+//                       taken by the latest compile. It is zeroed for
+//                       compiles served from the translation cache.
+// SH_PASS_TIMINGS: a const ShPassTimings* describing the time taken by the
+//                  latest compile. Only totalNanoseconds is set for compiles
+//                  served from the translation cache.
 // params: Requested parameter
 COMPILER_EXPORT void ShGetInfoPointer(const ShHandle handle,
                                       ShShaderInfo pname,
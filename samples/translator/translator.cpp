@@ -11,8 +11,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <vector>
 
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
 //
 // Return codes from main.
 //
@@ -28,6 +39,11 @@ static ShShaderType FindShaderType(const char* fileName);
 static bool CompileFile(char* fileName, ShHandle compiler, int compileOptions);
 static void LogMsg(const char* msg, const char* name, const int num, const char* logName);
 static void PrintActiveVariables(ShHandle compiler, ShShaderInfo varType, bool mapLongVariableNames);
+static void PrintMemoryStatistics(ShHandle compiler);
+static void PrintPassTimings(ShHandle compiler);
+static void BenchmarkConstruction(int numCompilers, ShShaderSpec spec, ShShaderOutput output, const ShBuiltInResources& resources);
+static void BenchmarkBatch(int numCopies, const std::vector<char*>& fileNames, ShShaderSpec spec, ShShaderOutput output, const ShBuiltInResources& resources, int compileOptions);
+static void BenchmarkColdStart(const char* cacheFile, const std::vector<char*>& fileNames, ShShaderSpec spec, ShShaderOutput output, const ShBuiltInResources& resources, int compileOptions);
 
 // If NUM_SOURCE_STRINGS is set to a value > 1, the input file data is
 // broken into that many chunks.
@@ -62,6 +78,12 @@ int main(int argc, char* argv[])
 
     int compileOptions = 0;
     int numCompiles = 0;
+    int numConstructions = 0;
+    int numBatchCopies = 0;
+    bool printMemoryStatistics = false;
+    bool printPassTimings = false;
+    const char* cacheFile = NULL;
+    std::vector<char*> fileNames;
     ShHandle vertexCompiler = 0;
     ShHandle fragmentCompiler = 0;
     char* buffer = 0;
@@ -88,6 +110,31 @@ int main(int argc, char* argv[])
             case 'e': compileOptions |= SH_EMULATE_BUILT_IN_FUNCTIONS; break;
             case 'd': compileOptions |= SH_DEPENDENCY_GRAPH; break;
             case 't': compileOptions |= SH_TIMING_RESTRICTIONS; break;
+            case 'a': printMemoryStatistics = true; break;
+            case 'p': printPassTimings = true; break;
+            case 'c':
+                if (argv[0][2] == '=' && atoi(&argv[0][3]) > 0)
+                    numConstructions = atoi(&argv[0][3]);
+                else
+                    failCode = EFailUsage;
+                break;
+            case 'j':
+                if (argv[0][2] == '=' && atoi(&argv[0][3]) > 0)
+                    numBatchCopies = atoi(&argv[0][3]);
+                else
+                    failCode = EFailUsage;
+                break;
+            case 'f':
+                if (argv[0][2] == '=' && argv[0][3] != '\0') {
+                    cacheFile = &argv[0][3];
+                    if (!ShSetTranslationCacheFile(cacheFile)) {
+                        printf("Error: unable to open translation cache file: %s\n", cacheFile);
+                        failCode = EFailUsage;
+                    }
+                } else {
+                    failCode = EFailUsage;
+                }
+                break;
             case 's':
                 if (argv[0][2] == '=') {
                     switch (argv[0][3]) {
@@ -136,6 +183,7 @@ int main(int argc, char* argv[])
             default: failCode = EFailUsage;
             }
         } else {
+            fileNames.push_back(argv[0]);
             ShHandle compiler = 0;
             switch (FindShaderType(argv[0])) {
             case SH_VERTEX_SHADER:
@@ -183,6 +231,18 @@ int main(int argc, char* argv[])
                   LogMsg("END", "COMPILER", numCompiles, "ACTIVE UNIFORMS");
                   printf("\n\n");
               }
+              if (printMemoryStatistics) {
+                  LogMsg("BEGIN", "COMPILER", numCompiles, "MEMORY");
+                  PrintMemoryStatistics(compiler);
+                  LogMsg("END", "COMPILER", numCompiles, "MEMORY");
+                  printf("\n\n");
+              }
+              if (printPassTimings) {
+                  LogMsg("BEGIN", "COMPILER", numCompiles, "PASS TIMINGS");
+                  PrintPassTimings(compiler);
+                  LogMsg("END", "COMPILER", numCompiles, "PASS TIMINGS");
+                  printf("\n\n");
+              }
               if (!compiled)
                   failCode = EFailCompile;
               ++numCompiles;
@@ -192,7 +252,14 @@ int main(int argc, char* argv[])
         }
     }
 
-    if ((vertexCompiler == 0) && (fragmentCompiler == 0))
+    if ((failCode == ESuccess) && (numConstructions > 0))
+        BenchmarkConstruction(numConstructions, spec, output, resources);
+    if ((failCode == ESuccess) && (numBatchCopies > 0))
+        BenchmarkBatch(numBatchCopies, fileNames, spec, output, resources, compileOptions);
+    if ((failCode == ESuccess) && cacheFile)
+        BenchmarkColdStart(cacheFile, fileNames, spec, output, resources, compileOptions);
+
+    if ((vertexCompiler == 0) && (fragmentCompiler == 0) && (numConstructions == 0))
         failCode = EFailUsage;
     if (failCode == EFailUsage)
         usage();
@@ -213,7 +280,7 @@ int main(int argc, char* argv[])
 //
 void usage()
 {
-    printf("Usage: translate [-i -m -o -u -l -e -b=e -b=g -b=h -x=i -x=d] file1 file2 ...\n"
+    printf("Usage: translate [-i -m -o -u -l -e -a -p -b=e -b=g -b=h -x=i -x=d -c=n -j=n -f=file] file1 file2 ...\n"
         "Where: filename : filename ending in .frag or .vert\n"
         "       -i       : print intermediate tree\n"
         "       -m       : map long variable names\n"
@@ -223,6 +290,8 @@ void usage()
         "       -e       : emulate certain built-in functions (workaround for driver bugs)\n"
         "       -t       : enforce experimental timing restrictions\n"
         "       -d       : print dependency graph used to enforce timing restrictions\n"
+        "       -a       : print the memory taken by each compile, by phase\n"
+        "       -p       : print the time taken by each compile, by pass\n"
         "       -s=e     : use GLES2 spec (this is by default)\n"
         "       -s=w     : use WebGL spec\n"
         "       -s=c     : use CSS Shaders spec\n"
@@ -232,7 +301,12 @@ void usage()
         "       -b=h11   : output HLSL11 code\n"
         "       -x=i     : enable GL_OES_EGL_image_external\n"
         "       -x=d     : enable GL_OES_EGL_standard_derivatives\n"
-        "       -x=r     : enable ARB_texture_rectangle\n");
+        "       -x=r     : enable ARB_texture_rectangle\n"
+        "       -c=n     : benchmark construction of n vertex and n fragment compilers\n"
+        "       -j=n     : benchmark ShCompileBatch on n copies of the files, with 1 up to\n"
+        "                  one thread per processor\n"
+        "       -f=file  : persist translations in file, and benchmark compiling the files\n"
+        "                  with fresh compilers with and without them\n");
 }
 
 //
@@ -350,6 +424,74 @@ void PrintActiveVariables(ShHandle compiler, ShShaderInfo varType, bool mapLongV
         delete [] mappedName;
 }
 
+void PrintMemoryStatistics(ShHandle compiler)
+{
+    const char* phaseNames[SH_PHASE_COUNT] = {
+        "parse", "validate limitations", "dependency graph", "translate", "other"
+    };
+
+    void* pointer = NULL;
+    ShGetInfoPointer(compiler, SH_MEMORY_STATISTICS, &pointer);
+    const ShMemoryStatistics* statistics = static_cast<const ShMemoryStatistics*>(pointer);
+    if (!statistics)
+        return;
+
+    printf("peak: %u bytes in %u pages\n",
+           static_cast<unsigned int>(statistics->peakBytes),
+           static_cast<unsigned int>(statistics->numPages));
+    printf("allocated: %u bytes in %u allocations\n",
+           static_cast<unsigned int>(statistics->allocatedBytes),
+           static_cast<unsigned int>(statistics->numAllocations));
+    for (int phase = 0; phase < SH_PHASE_COUNT; ++phase) {
+        printf("    %s: %u bytes\n", phaseNames[phase],
+               static_cast<unsigned int>(statistics->phaseBytes[phase]));
+    }
+}
+
+void PrintPassTimings(ShHandle compiler)
+{
+    const char* passNames[SH_PASS_COUNT] = {
+        "parse", "post process", "detect call depth", "validate limitations",
+        "timing restrictions", "rewrite CSS shader", "unroll for loops",
+        "emulate built-in functions", "clamp indirect array bounds",
+        "limit expression complexity", "map long variable names",
+        "init gl_Position", "unfold short circuit", "collect variables",
+        "intermediate tree", "translate"
+    };
+
+    void* pointer = NULL;
+    ShGetInfoPointer(compiler, SH_PASS_TIMINGS, &pointer);
+    const ShPassTimings* timings = static_cast<const ShPassTimings*>(pointer);
+    if (!timings)
+        return;
+
+    printf("total: %.3f ms\n", timings->totalNanoseconds / 1e6);
+    for (int pass = 0; pass < SH_PASS_COUNT; ++pass) {
+        // Skip the passes that did not run.
+        if (timings->passNanoseconds[pass] == 0)
+            continue;
+        printf("    %s: %.3f ms (%.1f%%)\n", passNames[pass],
+               timings->passNanoseconds[pass] / 1e6,
+               timings->totalNanoseconds > 0 ?
+                   100.0 * timings->passNanoseconds[pass] / timings->totalNanoseconds : 0.0);
+    }
+    if (timings->sharedPasses == 0)
+        return;
+
+    // The traversals shared by passes are not broken down by pass.
+    printf("    shared traversals (");
+    const char* separator = "";
+    for (int pass = 0; pass < SH_PASS_COUNT; ++pass) {
+        if (timings->sharedPasses & (1u << pass)) {
+            printf("%s%s", separator, passNames[pass]);
+            separator = ", ";
+        }
+    }
+    printf("): %.3f ms (%.1f%%)\n", timings->sharedNanoseconds / 1e6,
+           timings->totalNanoseconds > 0 ?
+               100.0 * timings->sharedNanoseconds / timings->totalNanoseconds : 0.0);
+}
+
 static bool ReadShaderSource(const char* fileName, ShaderSource& source) {
     FILE* in = fopen(fileName, "rb");
     if (!in) {
@@ -387,3 +529,220 @@ static void FreeShaderSource(ShaderSource& source) {
     source.clear();
 }
 
+
+//
+//   Return the peak memory used by the process so far, in kilobytes.
+//
+static size_t GetPeakMemoryKB()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.PeakWorkingSetSize / 1024;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#if defined(__APPLE__)
+    return usage.ru_maxrss / 1024;  // Reported in bytes.
+#else
+    return usage.ru_maxrss;  // Reported in kilobytes.
+#endif
+#endif
+}
+
+//
+//   Construct numCompilers compilers for each shader type, keeping them all
+//   alive, and report the time spent in ShConstructCompiler and the memory
+//   they use. The first construction of each type is reported separately
+//   since it is the only one that has to build the built-in symbol table.
+//
+void BenchmarkConstruction(int numCompilers, ShShaderSpec spec, ShShaderOutput output, const ShBuiltInResources& resources)
+{
+    const ShShaderType types[] = { SH_VERTEX_SHADER, SH_FRAGMENT_SHADER };
+    const char* typeNames[] = { "vertex", "fragment" };
+
+    for (int t = 0; t < 2; ++t) {
+        std::vector<ShHandle> compilers(numCompilers);
+        size_t memoryBefore = GetPeakMemoryKB();
+
+        clock_t start = clock();
+        compilers[0] = ShConstructCompiler(types[t], spec, output, &resources);
+        clock_t firstEnd = clock();
+        for (int i = 1; i < numCompilers; ++i)
+            compilers[i] = ShConstructCompiler(types[t], spec, output, &resources);
+        clock_t end = clock();
+
+        size_t memoryAfter = GetPeakMemoryKB();
+
+        double firstUs = 1e6 * (firstEnd - start) / CLOCKS_PER_SEC;
+        printf("%s: first ShConstructCompiler %.1f us", typeNames[t], firstUs);
+        if (numCompilers > 1) {
+            double restUs = 1e6 * (end - firstEnd) / CLOCKS_PER_SEC;
+            printf(", then %.1f us per compiler", restUs / (numCompilers - 1));
+        }
+        printf(", %.1f KB per compiler\n",
+               static_cast<double>(memoryAfter - memoryBefore) / numCompilers);
+
+        for (int i = 0; i < numCompilers; ++i) {
+            if (compilers[i])
+                ShDestruct(compilers[i]);
+        }
+    }
+}
+
+//
+//   Return a wall-clock time in seconds, for timing work spread over threads.
+//
+static double GetWallTimeSeconds()
+{
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return static_cast<double>(counter.QuadPart) / frequency.QuadPart;
+#else
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return time.tv_sec + time.tv_usec * 1e-6;
+#endif
+}
+
+static int GetProcessorCount()
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<int>(info.dwNumberOfProcessors);
+#else
+    return static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+}
+
+//
+//   Compile numCopies copies of the given files as one batch, with 1, 2, 4...
+//   threads up to one per processor, and report the throughput of each run
+//   and its speedup over the single-threaded one.
+//
+void BenchmarkBatch(int numCopies, const std::vector<char*>& fileNames, ShShaderSpec spec, ShShaderOutput output, const ShBuiltInResources& resources, int compileOptions)
+{
+    std::vector<ShaderSource> sources(fileNames.size());
+    for (size_t i = 0; i < fileNames.size(); ++i) {
+        if (!ReadShaderSource(fileNames[i], sources[i]))
+            return;
+    }
+
+    std::vector<ShCompileJob> jobs;
+    for (int copy = 0; copy < numCopies; ++copy) {
+        for (size_t i = 0; i < fileNames.size(); ++i) {
+            ShCompileJob job;
+            memset(&job, 0, sizeof(job));
+            job.type = FindShaderType(fileNames[i]);
+            job.spec = spec;
+            job.output = output;
+            job.resources = &resources;
+            job.shaderStrings = &sources[i][0];
+            job.numStrings = sources[i].size();
+            job.compileOptions = compileOptions;
+            jobs.push_back(job);
+        }
+    }
+    if (jobs.empty())
+        return;
+
+    int maxThreads = GetProcessorCount();
+    if (maxThreads < 1)
+        maxThreads = 1;
+
+    std::vector<int> threadCounts;
+    for (int numThreads = 1; numThreads < maxThreads; numThreads *= 2)
+        threadCounts.push_back(numThreads);
+    threadCounts.push_back(maxThreads);
+
+    double singleThreadedSeconds = 0.0;
+    for (size_t run = 0; run < threadCounts.size(); ++run) {
+        int numThreads = threadCounts[run];
+        double start = GetWallTimeSeconds();
+        int compiled = ShCompileBatch(&jobs[0], jobs.size(), numThreads);
+        double seconds = GetWallTimeSeconds() - start;
+
+        if (numThreads == 1)
+            singleThreadedSeconds = seconds;
+        printf("%d thread(s): %u shaders in %.1f ms, %.0f shaders/s, %.2fx%s\n",
+               numThreads, static_cast<unsigned int>(jobs.size()), seconds * 1e3,
+               jobs.size() / seconds, singleThreadedSeconds / seconds,
+               compiled ? "" : " (some shaders failed to compile)");
+
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            if (jobs[i].compiler)
+                ShDestruct(jobs[i].compiler);
+            jobs[i].compiler = 0;
+        }
+    }
+
+    for (size_t i = 0; i < sources.size(); ++i)
+        FreeShaderSource(sources[i]);
+}
+
+//
+//   Compile the given files with fresh compilers, as a process starting up
+//   would, first without the translation cache, then with the translations
+//   persisted in cacheFile, and report the time each run takes. The files
+//   compiled before the benchmark are in cacheFile, unless they map long
+//   variable names.
+//
+void BenchmarkColdStart(const char* cacheFile, const std::vector<char*>& fileNames, ShShaderSpec spec, ShShaderOutput output, const ShBuiltInResources& resources, int compileOptions)
+{
+    std::vector<ShaderSource> sources(fileNames.size());
+    for (size_t i = 0; i < fileNames.size(); ++i) {
+        if (!ReadShaderSource(fileNames[i], sources[i]))
+            return;
+    }
+
+    std::vector<ShCompileJob> jobs;
+    for (size_t i = 0; i < fileNames.size(); ++i) {
+        ShCompileJob job;
+        memset(&job, 0, sizeof(job));
+        job.type = FindShaderType(fileNames[i]);
+        job.spec = spec;
+        job.output = output;
+        job.resources = &resources;
+        job.shaderStrings = &sources[i][0];
+        job.numStrings = sources[i].size();
+        job.compileOptions = compileOptions;
+        jobs.push_back(job);
+    }
+    if (jobs.empty())
+        return;
+
+    // Closing the file brings its index up to date, as at the end of the
+    // process that wrote it.
+    ShSetTranslationCacheFile(NULL);
+
+    double seconds[2] = { 0.0, 0.0 };
+    size_t hits[2] = { 0, 0 };
+    for (int run = 0; run < 2; ++run) {
+        double start = GetWallTimeSeconds();
+        if (run == 1)
+            ShSetTranslationCacheFile(cacheFile);
+        ShCompileBatch(&jobs[0], jobs.size(), 1);
+        seconds[run] = GetWallTimeSeconds() - start;
+
+        if (jobs[0].compiler)
+            ShGetInfo(jobs[0].compiler, SH_TRANSLATION_CACHE_PERSISTENT_HITS, &hits[run]);
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            if (jobs[i].compiler)
+                ShDestruct(jobs[i].compiler);
+            jobs[i].compiler = 0;
+        }
+    }
+
+    printf("cold start: %u shaders in %.2f ms without the translation cache, "
+           "%.2f ms with %s (%u hits), %.2fx\n",
+           static_cast<unsigned int>(jobs.size()), seconds[0] * 1e3, seconds[1] * 1e3,
+           cacheFile, static_cast<unsigned int>(hits[1] - hits[0]), seconds[0] / seconds[1]);
+
+    for (size_t i = 0; i < sources.size(); ++i)
+        FreeShaderSource(sources[i]);
+}
@@ -6,6 +6,7 @@
 
 #include "compiler/BuiltInFunctionEmulator.h"
 
+#include "compiler/PassManager.h"
 #include "compiler/SymbolTable.h"
 
 namespace {
@@ -391,6 +392,14 @@ void BuiltInFunctionEmulator::MarkBuiltInFunctionsForEmulation(
     root->traverse(&marker);
 }
 
+void BuiltInFunctionEmulator::MarkBuiltInFunctionsForEmulation(
+    TPassManager* passes)
+{
+    // The marker is freed with the pool of the compile.
+    passes->addPass(SH_PASS_EMULATE_BUILT_IN_FUNCTIONS,
+                    new BuiltInFunctionEmulationMarker(*this));
+}
+
 void BuiltInFunctionEmulator::Cleanup()
 {
     mFunctions.clear();
@@ -12,6 +12,8 @@
 #include "compiler/InfoSink.h"
 #include "compiler/intermediate.h"
 
+class TPassManager;
+
 //
 // This class decides which built-in functions need to be replaced with the
 // emulated ones.
@@ -34,6 +36,9 @@ public:
     void OutputEmulatedFunctionDefinition(TInfoSinkBase& out, bool withPrecision) const;
 
     void MarkBuiltInFunctionsForEmulation(TIntermNode* root);
+    // Marks the functions in a pass of passes instead, to share its
+    // traversal.
+    void MarkBuiltInFunctionsForEmulation(TPassManager* passes);
 
     void Cleanup();
 
@@ -0,0 +1,169 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#include "compiler/BuiltInSymbolTable.h"
+
+#include <vector>
+
+#include "compiler/Initialize.h"
+#include "compiler/osinclude.h"
+
+namespace {
+
+typedef std::vector<TBuiltInSymbolTable*> TBuiltInSymbolTableList;
+TBuiltInSymbolTableList gCachedTables;
+// Guards gCachedTables and the reference counts of the tables.
+OS_Mutex gCacheLock;
+
+}  // anonymous namespace
+
+TBuiltInSymbolTable::TBuiltInSymbolTable(ShShaderType type,
+                                         ShShaderSpec spec,
+                                         const ShBuiltInResources& res)
+    : shaderType(type),
+      shaderSpec(spec),
+      resources(res),
+      refCount(0)
+{
+    TPoolAllocator* previousAllocator = GetGlobalPoolAllocator();
+    allocator.push();
+    SetGlobalPoolAllocator(&allocator);
+
+    symbolTable.push();
+
+    TPublicType integer;
+    integer.type = EbtInt;
+    integer.size = 1;
+    integer.matrix = false;
+    integer.array = false;
+
+    TPublicType floatingPoint;
+    floatingPoint.type = EbtFloat;
+    floatingPoint.size = 1;
+    floatingPoint.matrix = false;
+    floatingPoint.array = false;
+
+    TPublicType sampler;
+    sampler.size = 1;
+    sampler.matrix = false;
+    sampler.array = false;
+
+    switch(shaderType)
+    {
+      case SH_FRAGMENT_SHADER:
+        symbolTable.setDefaultPrecision(integer, EbpMedium);
+        break;
+      case SH_VERTEX_SHADER:
+        symbolTable.setDefaultPrecision(integer, EbpHigh);
+        symbolTable.setDefaultPrecision(floatingPoint, EbpHigh);
+        break;
+      default: assert(false && "Language not supported");
+    }
+    // We set defaults for all the sampler types, even those that are
+    // only available if an extension exists.
+    for (int samplerType = EbtGuardSamplerBegin + 1;
+         samplerType < EbtGuardSamplerEnd; ++samplerType) {
+        sampler.type = static_cast<TBasicType>(samplerType);
+        symbolTable.setDefaultPrecision(sampler, EbpLow);
+    }
+
+    InsertBuiltInFunctions(shaderType, shaderSpec, resources, symbolTable);
+
+    IdentifyBuiltIns(shaderType, shaderSpec, resources, symbolTable);
+
+    SetGlobalPoolAllocator(previousAllocator);
+}
+
+TBuiltInSymbolTable::~TBuiltInSymbolTable()
+{
+    ASSERT(refCount == 0);
+}
+
+// static
+bool TBuiltInSymbolTable::InitializeLock()
+{
+    return OS_InitMutex(&gCacheLock);
+}
+
+// static
+void TBuiltInSymbolTable::FreeLock()
+{
+    OS_FreeMutex(&gCacheLock);
+}
+
+// static
+TBuiltInSymbolTable* TBuiltInSymbolTable::GetInstance(ShShaderType type,
+                                                      ShShaderSpec spec,
+                                                      const ShBuiltInResources& resources)
+{
+    TScopedLock lock(&gCacheLock);
+
+    TBuiltInSymbolTable* instance = NULL;
+    for (size_t i = 0; i < gCachedTables.size(); ++i) {
+        if (gCachedTables[i]->matches(type, spec, resources)) {
+            instance = gCachedTables[i];
+            break;
+        }
+    }
+
+    if (instance == NULL) {
+        instance = new TBuiltInSymbolTable(type, spec, resources);
+        // The cache holds a reference of its own.
+        instance->refCount++;
+        gCachedTables.push_back(instance);
+    }
+
+    instance->refCount++;
+    return instance;
+}
+
+void TBuiltInSymbolTable::Release()
+{
+    TScopedLock lock(&gCacheLock);
+
+    ASSERT(refCount > 0);
+    refCount--;
+    if (refCount == 0)
+        delete this;
+}
+
+// static
+void TBuiltInSymbolTable::ClearCache()
+{
+    TBuiltInSymbolTableList tables;
+    {
+        TScopedLock lock(&gCacheLock);
+        tables.swap(gCachedTables);
+    }
+    for (size_t i = 0; i < tables.size(); ++i)
+        tables[i]->Release();
+}
+
+//
+// Only the resources that affect the contents of the built-in level are
+// compared; the others are applied by each compiler.
+//
+bool TBuiltInSymbolTable::matches(ShShaderType type,
+                                  ShShaderSpec spec,
+                                  const ShBuiltInResources& res) const
+{
+    return shaderType == type &&
+           shaderSpec == spec &&
+           resources.MaxVertexAttribs == res.MaxVertexAttribs &&
+           resources.MaxVertexUniformVectors == res.MaxVertexUniformVectors &&
+           resources.MaxVaryingVectors == res.MaxVaryingVectors &&
+           resources.MaxVertexTextureImageUnits == res.MaxVertexTextureImageUnits &&
+           resources.MaxCombinedTextureImageUnits == res.MaxCombinedTextureImageUnits &&
+           resources.MaxTextureImageUnits == res.MaxTextureImageUnits &&
+           resources.MaxFragmentUniformVectors == res.MaxFragmentUniformVectors &&
+           resources.MaxDrawBuffers == res.MaxDrawBuffers &&
+           resources.OES_standard_derivatives == res.OES_standard_derivatives &&
+           resources.OES_EGL_image_external == res.OES_EGL_image_external &&
+           resources.ARB_texture_rectangle == res.ARB_texture_rectangle &&
+           resources.EXT_draw_buffers == res.EXT_draw_buffers &&
+           resources.EXT_frag_depth == res.EXT_frag_depth &&
+           resources.FragmentPrecisionHigh == res.FragmentPrecisionHigh;
+}
@@ -0,0 +1,65 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#ifndef COMPILER_BUILT_IN_SYMBOL_TABLE_H_
+#define COMPILER_BUILT_IN_SYMBOL_TABLE_H_
+
+#include "GLSLANG/ShaderLang.h"
+
+#include "compiler/SymbolTable.h"
+
+//
+// A symbol table holding only the built-in level for a shader type, spec
+// and set of resources. It is built once, in a pool of its own, and then
+// shared read-only by every compiler initialized with the same parameters,
+// which layer their user-defined levels on top of it.
+//
+// Tables are ref-counted. GetInstance() returns a pointer to a table, and
+// after use, call Release(). GetInstance() and Release() should be paired.
+// Tables stay cached between uses until ClearCache() is called.
+//
+// GetInstance() and Release() may be called from several threads at once;
+// the cache is guarded by a lock created by InitializeLock(). Once built, a
+// table is only ever read.
+//
+class TBuiltInSymbolTable {
+public:
+    static bool InitializeLock();
+    static void FreeLock();
+
+    static TBuiltInSymbolTable* GetInstance(ShShaderType type,
+                                            ShShaderSpec spec,
+                                            const ShBuiltInResources& resources);
+    void Release();
+
+    // Drops the cached tables. Tables still in use are deleted once they
+    // are released.
+    static void ClearCache();
+
+    const TSymbolTable& getSymbolTable() const { return symbolTable; }
+
+private:
+    TBuiltInSymbolTable(ShShaderType type,
+                        ShShaderSpec spec,
+                        const ShBuiltInResources& resources);
+    ~TBuiltInSymbolTable();
+
+    bool matches(ShShaderType type,
+                 ShShaderSpec spec,
+                 const ShBuiltInResources& resources) const;
+
+    ShShaderType shaderType;
+    ShShaderSpec shaderSpec;
+    ShBuiltInResources resources;
+
+    size_t refCount;
+
+    // Holds the memory of the built-in symbols for the lifetime of the table.
+    TPoolAllocator allocator;
+    TSymbolTable symbolTable;
+};
+
+#endif  // COMPILER_BUILT_IN_SYMBOL_TABLE_H_
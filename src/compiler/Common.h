@@ -46,6 +46,12 @@ inline TString* NewPoolTString(const char* s)
 	return new(memory) TString(s);
 }
 
+inline TString* NewPoolTString(const char* s, size_t length)
+{
+	void* memory = GetGlobalPoolAllocator()->allocate(sizeof(TString));
+	return new(memory) TString(s, length);
+}
+
 //
 // Persistent string memory.  Should only be used for strings that survive
 // across compiles.
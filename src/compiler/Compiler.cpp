@@ -5,18 +5,24 @@
 //
 
 #include "compiler/BuiltInFunctionEmulator.h"
+#include "compiler/BuiltInSymbolTable.h"
 #include "compiler/DetectCallDepth.h"
+#include "compiler/EventTracer.h"
+#include "compiler/ExpressionComplexity.h"
 #include "compiler/ForLoopUnroll.h"
 #include "compiler/Initialize.h"
 #include "compiler/InitializeGLPosition.h"
-#include "compiler/InitializeParseContext.h"
 #include "compiler/MapLongVariableNames.h"
 #include "compiler/ParseContext.h"
+#include "compiler/PassManager.h"
+#include "compiler/Prelude.h"
 #include "compiler/RenameFunction.h"
 #include "compiler/ShHandle.h"
+#include "compiler/TranslationCache.h"
 #include "compiler/UnfoldShortCircuitAST.h"
 #include "compiler/ValidateLimitations.h"
 #include "compiler/VariablePacker.h"
+#include "compiler/osinclude.h"
 #include "compiler/depgraph/DependencyGraph.h"
 #include "compiler/depgraph/DependencyGraphOutput.h"
 #include "compiler/timing/RestrictFragmentShaderTiming.h"
@@ -29,26 +35,41 @@ bool isWebGLBasedSpec(ShShaderSpec spec)
 }
 
 namespace {
+// Makes the given allocator the current pool of the calling thread, and
+// restores the previous one on exit. If pushPop is true, the memory
+// allocated in the scope is freed on exit as well.
 class TScopedPoolAllocator {
 public:
-    TScopedPoolAllocator(TPoolAllocator* allocator) : mAllocator(allocator) {
-        mAllocator->push();
+    TScopedPoolAllocator(TPoolAllocator* allocator, bool pushPop)
+        : mAllocator(allocator),
+          mPushPop(pushPop),
+          mPreviousAllocator(GetGlobalPoolAllocator()) {
+        if (mPushPop)
+            mAllocator->push();
         SetGlobalPoolAllocator(mAllocator);
     }
     ~TScopedPoolAllocator() {
-        SetGlobalPoolAllocator(NULL);
-        mAllocator->pop();
+        SetGlobalPoolAllocator(mPreviousAllocator);
+        if (mPushPop)
+            mAllocator->pop();
     }
 
 private:
     TPoolAllocator* mAllocator;
+    bool mPushPop;
+    TPoolAllocator* mPreviousAllocator;
 };
 
 class TScopedSymbolTableLevel {
 public:
-    TScopedSymbolTableLevel(TSymbolTable* table) : mTable(table) {
+    // Pushes the global level, starting with the symbols of globals if given.
+    TScopedSymbolTableLevel(TSymbolTable* table, const TSymbolTable* globals = NULL)
+        : mTable(table) {
         ASSERT(mTable->atBuiltInLevel());
-        mTable->push();
+        if (globals)
+            mTable->pushGlobalLevel(*globals);
+        else
+            mTable->push();
     }
     ~TScopedSymbolTableLevel() {
         while (!mTable->atBuiltInLevel())
@@ -62,31 +83,40 @@ private:
 
 TShHandleBase::TShHandleBase() {
     allocator.push();
-    SetGlobalPoolAllocator(&allocator);
 }
 
 TShHandleBase::~TShHandleBase() {
-    SetGlobalPoolAllocator(NULL);
     allocator.popAll();
 }
 
-TCompiler::TCompiler(ShShaderType type, ShShaderSpec spec)
+TCompiler::TCompiler(ShShaderType type, ShShaderSpec spec, ShShaderOutput output)
     : shaderType(type),
       shaderSpec(spec),
+      outputType(output),
       maxUniformVectors(0),
       maxExpressionComplexity(0),
       maxCallStackDepth(0),
       fragmentPrecisionHigh(false),
+      includeCallback(NULL),
+      includeCallbackData(NULL),
+      prelude(NULL),
       clampingStrategy(SH_CLAMP_WITH_CLAMP_INTRINSIC),
+      builtInSymbolTable(NULL),
       builtInFunctionEmulator(type)
 {
     longNameMap = LongNameMap::GetInstance();
+    memset(&memoryStatistics, 0, sizeof(memoryStatistics));
+    memset(&passTimings, 0, sizeof(passTimings));
 }
 
 TCompiler::~TCompiler()
 {
     ASSERT(longNameMap);
     longNameMap->Release();
+    // The prelude is layered on the built-in level.
+    delete prelude;
+    if (builtInSymbolTable)
+        builtInSymbolTable->Release();
 }
 
 bool TCompiler::Init(const ShBuiltInResources& resources)
@@ -97,7 +127,7 @@ bool TCompiler::Init(const ShBuiltInResources& resources)
     maxExpressionComplexity = resources.MaxExpressionComplexity;
     maxCallStackDepth = resources.MaxCallStackDepth;
 
-    SetGlobalPoolAllocator(&allocator);
+    TScopedPoolAllocator scopedAlloc(&allocator, false);
 
     // Generate built-in symbol table.
     if (!InitBuiltInSymbolTable(resources))
@@ -105,6 +135,13 @@ bool TCompiler::Init(const ShBuiltInResources& resources)
     InitExtensionBehavior(resources, extensionBehavior);
     fragmentPrecisionHigh = resources.FragmentPrecisionHigh == 1;
 
+    // Define extension macros.
+    for (TExtensionBehavior::const_iterator iter = extensionBehavior.begin();
+         iter != extensionBehavior.end(); ++iter)
+        predefinedMacros.define(iter->first.c_str(), 1);
+    if (fragmentPrecisionHigh)
+        predefinedMacros.define("GL_FRAGMENT_PRECISION_HIGH", 1);
+
     arrayBoundsClamper.SetClampingStrategy(resources.ArrayIndexClampingStrategy);
     clampingStrategy = resources.ArrayIndexClampingStrategy;
 
@@ -117,12 +154,94 @@ bool TCompiler::compile(const char* const shaderStrings[],
                         size_t numStrings,
                         int compileOptions)
 {
-    TScopedPoolAllocator scopedAlloc(&allocator);
+    // Streamed object code is not kept, so it cannot be cached either.
+    bool streamed = infoSink.obj.hasCallback() && (compileOptions & SH_OBJECT_CODE);
+    // Neither can the translations of shaders that include other sources,
+    // which are not part of the key.
+    if (numStrings == 0 || streamed || includeCallback ||
+        !TTranslationCache::IsEnabled())
+        return compileShader(shaderStrings, numStrings, compileOptions);
+
+    double start = OS_GetTimeSeconds();
+    TPersistString key = getTranslationCacheKey(shaderStrings, numStrings, compileOptions);
+    // Mapped long names and hash functions belong to the process.
+    bool persistent = (compileOptions & SH_MAP_LONG_VARIABLE_NAMES) == 0 &&
+                      compileResources.HashFunction == NULL;
+    TTranslationResult result;
+    bool hit = TTranslationCache::Find(key, persistent, &result);
+    if (hit) {
+        restoreResults(result);
+    } else {
+        result.success = compileShader(shaderStrings, numStrings, compileOptions);
+        saveResults(&result);
+        TTranslationCache::Insert(key, persistent, result);
+    }
+    double seconds = OS_GetTimeSeconds() - start;
+    TTranslationCache::AddCompileTime(hit, seconds);
+    if (hit)
+        passTimings.totalNanoseconds = static_cast<size_t>(seconds * 1e9);
+    return result.success;
+}
+
+namespace {
+//
+// Charges the memory allocated from a pool during the lifetime of the
+// object to a phase of the compile.
+//
+class TScopedPhaseMemory {
+public:
+    TScopedPhaseMemory(const TPoolAllocator& allocator, ShMemoryStatistics* statistics,
+                       ShCompilePhase phase)
+        : mAllocator(allocator),
+          mPhaseBytes(&statistics->phaseBytes[phase]),
+          mStartBytes(allocator.getAllocatedBytes()) { }
+    ~TScopedPhaseMemory() {
+        *mPhaseBytes += mAllocator.getAllocatedBytes() - mStartBytes;
+    }
+
+private:
+    const TPoolAllocator& mAllocator;
+    size_t* mPhaseBytes;
+    size_t mStartBytes;
+};
+
+//
+// Adds the time spent during the lifetime of the object to a pass of the
+// compile, and traces it as an event named after the pass.
+//
+class TScopedPassTimer {
+public:
+    TScopedPassTimer(ShPassTimings* timings, ShCompilePass pass)
+        : mEvent(GetPassEventName(pass)),
+          mNanoseconds(&timings->passNanoseconds[pass]),
+          mStart(OS_GetTimeSeconds()) { }
+    ~TScopedPassTimer() {
+        *mNanoseconds += static_cast<size_t>((OS_GetTimeSeconds() - mStart) * 1e9);
+    }
+
+private:
+    TScopedTraceEvent mEvent;
+    size_t* mNanoseconds;
+    double mStart;
+};
+}  // namespace
+
+bool TCompiler::compileShader(const char* const shaderStrings[],
+                              size_t numStrings,
+                              int compileOptions)
+{
+    TScopedPoolAllocator scopedAlloc(&allocator, true);
     clearResults();
 
     if (numStrings == 0)
         return true;
 
+    double startSeconds = OS_GetTimeSeconds();
+    size_t startPages = allocator.getNumPages();
+    size_t startAllocations = allocator.getNumAllocations();
+    size_t startBytes = allocator.getAllocatedBytes();
+    allocator.resetPeakPages();
+
     // If compiling for WebGL, validate loop and indexing as well.
     if (isWebGLBasedSpec(shaderSpec))
         compileOptions |= SH_VALIDATE_LOOP_INDEXING;
@@ -136,92 +255,169 @@ bool TCompiler::compile(const char* const shaderStrings[],
         ++firstSource;
     }
 
+    // The directives of a compile only change its own extension behavior.
+    compileExtensionBehavior = extensionBehavior;
     TIntermediate intermediate(infoSink);
-    TParseContext parseContext(symbolTable, extensionBehavior, intermediate,
+    TParseContext parseContext(symbolTable, compileExtensionBehavior,
+                               &predefinedMacros, intermediate,
                                shaderType, shaderSpec, compileOptions, true,
                                sourcePath, infoSink);
     parseContext.fragmentPrecisionHigh = fragmentPrecisionHigh;
-    SetGlobalParseContext(&parseContext);
+    if (includeCallback) {
+        parseContext.directiveHandler.setIncludeCallback(includeCallback, includeCallbackData);
+        parseContext.preprocessor.setIncludeCache(&includeCache);
+    }
+    if (prelude)
+        prelude->restore(parseContext, &compileExtensionBehavior);
 
     // We preserve symbols at the built-in level from compile-to-compile.
     // Start pushing the user-defined symbols at global level.
-    TScopedSymbolTableLevel scopedSymbolLevel(&symbolTable);
+    TScopedSymbolTableLevel scopedSymbolLevel(&symbolTable,
+                                              prelude ? &prelude->getSymbolTable() : NULL);
 
     // Parse shader.
-    bool success =
-        (PaParseStrings(numStrings - firstSource, &shaderStrings[firstSource], NULL, &parseContext) == 0) &&
-        (parseContext.treeRoot != NULL);
+    bool success = false;
+    {
+        TScopedPhaseMemory phaseMemory(allocator, &memoryStatistics, SH_PHASE_PARSE);
+        TScopedPassTimer timer(&passTimings, SH_PASS_PARSE);
+        success = PaParseStrings(numStrings - firstSource, &shaderStrings[firstSource], NULL, &parseContext) == 0;
+        // The declarations of the shader follow those of the prelude.
+        if (success && prelude)
+            parseContext.treeRoot = prelude->prependTo(parseContext.treeRoot);
+        success = success && (parseContext.treeRoot != NULL);
+    }
     if (success) {
         TIntermNode* root = parseContext.treeRoot;
-        success = intermediate.postProcess(root);
+        {
+            TScopedPassTimer timer(&passTimings, SH_PASS_POST_PROCESS);
+            success = intermediate.postProcess(root);
+        }
 
         if (success)
-            success = detectCallDepth(root, infoSink, (compileOptions & SH_LIMIT_CALL_STACK_DEPTH) != 0);
-
-        if (success && (compileOptions & SH_VALIDATE_LOOP_INDEXING))
-            success = validateLimitations(root);
+            success = checkTree(root, compileOptions);
 
-        if (success && (compileOptions & SH_TIMING_RESTRICTIONS))
-            success = enforceTimingRestrictions(root, (compileOptions & SH_DEPENDENCY_GRAPH) != 0);
-
-        if (success && shaderSpec == SH_CSS_SHADERS_SPEC)
+        if (success && shaderSpec == SH_CSS_SHADERS_SPEC) {
+            TScopedPassTimer timer(&passTimings, SH_PASS_REWRITE_CSS_SHADER);
             rewriteCSSShader(root);
+        }
+
+        // The passes that mark and rewrite the tree share as few traversals
+        // as their order allows.
+        TPassManager passes(&passTimings);
 
         // Unroll for-loop markup needs to happen after validateLimitations pass.
         if (success && (compileOptions & SH_UNROLL_FOR_LOOP_WITH_INTEGER_INDEX))
-            ForLoopUnroll::MarkForLoopsWithIntegerIndicesForUnrolling(root);
+            ForLoopUnroll::MarkForLoopsWithIntegerIndicesForUnrolling(&passes);
 
         // Built-in function emulation needs to happen after validateLimitations pass.
         if (success && (compileOptions & SH_EMULATE_BUILT_IN_FUNCTIONS))
-            builtInFunctionEmulator.MarkBuiltInFunctionsForEmulation(root);
+            builtInFunctionEmulator.MarkBuiltInFunctionsForEmulation(&passes);
 
         // Clamping uniform array bounds needs to happen after validateLimitations pass.
         if (success && (compileOptions & SH_CLAMP_INDIRECT_ARRAY_BOUNDS))
-            arrayBoundsClamper.MarkIndirectArrayBoundsForClamping(root);
-
-        // Disallow expressions deemed too complex.
-        if (success && (compileOptions & SH_LIMIT_EXPRESSION_COMPLEXITY))
-            success = limitExpressionComplexity(root);
+            arrayBoundsClamper.MarkIndirectArrayBoundsForClamping(&passes);
 
         // Call mapLongVariableNames() before collectAttribsUniforms() so in
         // collectAttribsUniforms() we already have the mapped symbol names and
         // we could composite mapped and original variable names.
         // Also, if we hash all the names, then no need to do this for long names.
         if (success && (compileOptions & SH_MAP_LONG_VARIABLE_NAMES) && hashFunction == NULL)
-            mapLongVariableNames(root);
+            mapLongVariableNames(&passes);
 
-        if (success && shaderType == SH_VERTEX_SHADER && (compileOptions & SH_INIT_GL_POSITION)) {
-            InitializeGLPosition initGLPosition;
-            root->traverse(&initGLPosition);
-        }
+        InitializeGLPosition initGLPosition;
+        if (success && shaderType == SH_VERTEX_SHADER && (compileOptions & SH_INIT_GL_POSITION))
+            passes.addPass(SH_PASS_INIT_GL_POSITION, &initGLPosition);
+
+        // The short circuits are unfolded once the traversal is over.
+        UnfoldShortCircuitAST unfoldShortCircuit;
+        if (success && (compileOptions & SH_UNFOLD_SHORT_CIRCUIT))
+            passes.addPass(SH_PASS_UNFOLD_SHORT_CIRCUIT, &unfoldShortCircuit, 0, true);
+
+        if (success && (compileOptions & SH_VARIABLES))
+            collectVariables(&passes);
 
-	if (success && (compileOptions & SH_UNFOLD_SHORT_CIRCUIT)) {
-            UnfoldShortCircuitAST unfoldShortCircuit;
-            root->traverse(&unfoldShortCircuit);
+        if (success) {
+            passes.run(root);
             unfoldShortCircuit.updateTree();
-	}
-
-        if (success && (compileOptions & SH_VARIABLES)) {
-            collectVariables(root);
-            if (compileOptions & SH_ENFORCE_PACKING_RESTRICTIONS) {
-                success = enforcePackingRestrictions();
-                if (!success) {
-                    infoSink.info.prefix(EPrefixError);
-                    infoSink.info << "too many uniforms";
-                }
+        }
+
+        if (success && (compileOptions & SH_VARIABLES) &&
+            (compileOptions & SH_ENFORCE_PACKING_RESTRICTIONS)) {
+            success = enforcePackingRestrictions();
+            if (!success) {
+                infoSink.info.prefix(EPrefixError);
+                infoSink.info << "too many uniforms";
             }
         }
 
-        if (success && (compileOptions & SH_INTERMEDIATE_TREE))
+        if (success && (compileOptions & SH_INTERMEDIATE_TREE)) {
+            TScopedPassTimer timer(&passTimings, SH_PASS_INTERMEDIATE_TREE);
             intermediate.outputTree(root);
+        }
 
-        if (success && (compileOptions & SH_OBJECT_CODE))
-            translate(root);
+        if (success && (compileOptions & SH_OBJECT_CODE)) {
+            TScopedPhaseMemory phaseMemory(allocator, &memoryStatistics, SH_PHASE_TRANSLATE);
+            TScopedPassTimer timer(&passTimings, SH_PASS_TRANSLATE);
+            translate(root, parseContext);
+            infoSink.obj.flush();
+        }
     }
 
-    // Cleanup memory.
-    intermediate.remove(parseContext.treeRoot);
+    // The tree is freed with the rest of the pool. Its nodes are not
+    // destroyed: subtrees can be shared, and destroying one twice would
+    // give its containers' memory back to the pool while still in use.
+
+    memoryStatistics.numPages = allocator.getPeakPages() - startPages;
+    memoryStatistics.peakBytes = memoryStatistics.numPages * allocator.getPageSize();
+    memoryStatistics.numAllocations = allocator.getNumAllocations() - startAllocations;
+    memoryStatistics.allocatedBytes = allocator.getAllocatedBytes() - startBytes;
+    memoryStatistics.phaseBytes[SH_PHASE_OTHER] = memoryStatistics.allocatedBytes;
+    for (int phase = 0; phase < SH_PHASE_OTHER; ++phase)
+        memoryStatistics.phaseBytes[SH_PHASE_OTHER] -= memoryStatistics.phaseBytes[phase];
+    passTimings.totalNanoseconds = static_cast<size_t>((OS_GetTimeSeconds() - startSeconds) * 1e9);
+
+    return success;
+}
+
+bool TCompiler::compilePrelude(const char* const shaderStrings[], size_t numStrings)
+{
+    clearResults();
+    delete prelude;
+    prelude = NULL;
+
+    if (numStrings == 0)
+        return true;
+
+    ASSERT(builtInSymbolTable);
+    TPrelude* parsed = new TPrelude(builtInSymbolTable->getSymbolTable(), shaderStrings, numStrings);
+    bool success = false;
+    {
+        TScopedPoolAllocator scopedAlloc(&parsed->getAllocator(), false);
+
+        // The directives of the prelude change the extension behavior of
+        // the compiles that start from it, but not of this compiler.
+        TExtensionBehavior preludeExtensionBehavior = extensionBehavior;
+        TIntermediate intermediate(infoSink);
+        TParseContext parseContext(parsed->getSymbolTable(), preludeExtensionBehavior,
+                                   &predefinedMacros, intermediate,
+                                   shaderType, shaderSpec, 0, true,
+                                   NULL, infoSink);
+        parseContext.fragmentPrecisionHigh = fragmentPrecisionHigh;
+        if (includeCallback) {
+            parseContext.directiveHandler.setIncludeCallback(includeCallback, includeCallbackData);
+            parseContext.preprocessor.setIncludeCache(&includeCache);
+        }
 
+        // Unlike a shader, a prelude may only define macros.
+        success = PaParseStrings(numStrings, shaderStrings, NULL, &parseContext, true) == 0;
+        if (success)
+            parsed->save(parseContext, extensionBehavior);
+    }
+
+    if (success)
+        prelude = parsed;
+    else
+        delete parsed;
     return success;
 }
 
@@ -229,50 +425,97 @@ bool TCompiler::InitBuiltInSymbolTable(const ShBuiltInResources &resources)
 {
     compileResources = resources;
 
+    // The built-in level is shared with the other compilers created with
+    // the same type, spec and resources.
+    assert(builtInSymbolTable == NULL);
+    builtInSymbolTable = TBuiltInSymbolTable::GetInstance(shaderType, shaderSpec, resources);
+
     assert(symbolTable.isEmpty());
-    symbolTable.push();
-
-    TPublicType integer;
-    integer.type = EbtInt;
-    integer.size = 1;
-    integer.matrix = false;
-    integer.array = false;
-
-    TPublicType floatingPoint;
-    floatingPoint.type = EbtFloat;
-    floatingPoint.size = 1;
-    floatingPoint.matrix = false;
-    floatingPoint.array = false;
-
-    TPublicType sampler;
-    sampler.size = 1;
-    sampler.matrix = false;
-    sampler.array = false;
-
-    switch(shaderType)
-    {
-      case SH_FRAGMENT_SHADER:
-        symbolTable.setDefaultPrecision(integer, EbpMedium);
-        break;
-      case SH_VERTEX_SHADER:
-        symbolTable.setDefaultPrecision(integer, EbpHigh);
-        symbolTable.setDefaultPrecision(floatingPoint, EbpHigh);
-        break;
-      default: assert(false && "Language not supported");
-    }
-    // We set defaults for all the sampler types, even those that are
-    // only available if an extension exists.
-    for (int samplerType = EbtGuardSamplerBegin + 1;
-         samplerType < EbtGuardSamplerEnd; ++samplerType) {
-        sampler.type = static_cast<TBasicType>(samplerType);
-        symbolTable.setDefaultPrecision(sampler, EbpLow);
+    symbolTable.pushSharedBuiltInLevel(builtInSymbolTable->getSymbolTable());
+
+    return true;
+}
+
+namespace {
+template <typename T>
+void AppendToKey(TPersistString* key, const T& value)
+{
+    key->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+}  // namespace
+
+TPersistString TCompiler::getTranslationCacheKey(const char* const shaderStrings[],
+                                                 size_t numStrings,
+                                                 int compileOptions) const
+{
+    TPersistString key;
+    AppendToKey(&key, shaderType);
+    AppendToKey(&key, shaderSpec);
+    AppendToKey(&key, outputType);
+    AppendToKey(&key, compileOptions);
+
+    // Long names are mapped through a process-wide map, whose numbering
+    // restarts when it is recreated.
+    if (compileOptions & SH_MAP_LONG_VARIABLE_NAMES)
+        AppendToKey(&key, longNameMap->getSerial());
+
+    AppendToKey(&key, compileResources.MaxVertexAttribs);
+    AppendToKey(&key, compileResources.MaxVertexUniformVectors);
+    AppendToKey(&key, compileResources.MaxVaryingVectors);
+    AppendToKey(&key, compileResources.MaxVertexTextureImageUnits);
+    AppendToKey(&key, compileResources.MaxCombinedTextureImageUnits);
+    AppendToKey(&key, compileResources.MaxTextureImageUnits);
+    AppendToKey(&key, compileResources.MaxFragmentUniformVectors);
+    AppendToKey(&key, compileResources.MaxDrawBuffers);
+    AppendToKey(&key, compileResources.OES_standard_derivatives);
+    AppendToKey(&key, compileResources.OES_EGL_image_external);
+    AppendToKey(&key, compileResources.ARB_texture_rectangle);
+    AppendToKey(&key, compileResources.EXT_draw_buffers);
+    AppendToKey(&key, compileResources.EXT_frag_depth);
+    AppendToKey(&key, compileResources.FragmentPrecisionHigh);
+    AppendToKey(&key, compileResources.HashFunction);
+    AppendToKey(&key, compileResources.ArrayIndexClampingStrategy);
+    AppendToKey(&key, compileResources.MaxExpressionComplexity);
+    AppendToKey(&key, compileResources.MaxCallStackDepth);
+
+    // The prelude comes first, with its length, so that it cannot be taken
+    // for the shader strings.
+    AppendToKey(&key, prelude != NULL);
+    if (prelude) {
+        AppendToKey(&key, prelude->getSource().size());
+        key.append(prelude->getSource());
     }
 
-    InsertBuiltInFunctions(shaderType, shaderSpec, resources, symbolTable);
+    // Error messages refer to the index of the string they are in, so the
+    // boundaries between strings are part of the key.
+    AppendToKey(&key, numStrings);
+    for (size_t i = 0; i < numStrings; ++i) {
+        size_t length = strlen(shaderStrings[i]);
+        AppendToKey(&key, length);
+        key.append(shaderStrings[i], length);
+    }
+    return key;
+}
 
-    IdentifyBuiltIns(shaderType, shaderSpec, resources, symbolTable);
+void TCompiler::saveResults(TTranslationResult* result) const
+{
+    result->infoLog = infoSink.info.str();
+    result->objectCode = infoSink.obj.str();
+    result->attribs = attribs;
+    result->uniforms = uniforms;
+    result->varyings = varyings;
+    result->nameMap = nameMap;
+}
 
-    return true;
+void TCompiler::restoreResults(const TTranslationResult& result)
+{
+    clearResults();
+    infoSink.info << result.infoLog;
+    infoSink.obj << result.objectCode;
+    attribs = result.attribs;
+    uniforms = result.uniforms;
+    varyings = result.varyings;
+    nameMap = result.nameMap;
 }
 
 void TCompiler::clearResults()
@@ -289,12 +532,75 @@ void TCompiler::clearResults()
     builtInFunctionEmulator.Cleanup();
 
     nameMap.clear();
+
+    memset(&memoryStatistics, 0, sizeof(memoryStatistics));
+    memset(&passTimings, 0, sizeof(passTimings));
+}
+
+bool TCompiler::checkTree(TIntermNode* root, int compileOptions)
+{
+    TPassManager checks(&passTimings);
+    DetectCallDepth detect(infoSink, (compileOptions & SH_LIMIT_CALL_STACK_DEPTH) != 0,
+                           maxCallStackDepth);
+    checks.addPass(SH_PASS_DETECT_CALL_DEPTH, &detect);
+
+    // The checks that report errors while traversing write them to logs of
+    // their own, which go to the info log in the order of the checks up to
+    // the first one failed.
+    bool validateLoopIndexing = (compileOptions & SH_VALIDATE_LOOP_INDEXING) != 0;
+    TInfoSinkBase validateLog;
+    ValidateLimitations validate(shaderType, symbolTable, validateLog);
+    if (validateLoopIndexing)
+        checks.addPass(SH_PASS_VALIDATE_LIMITATIONS, &validate);
+
+    bool restrictTiming = (compileOptions & SH_TIMING_RESTRICTIONS) != 0;
+    bool restrictVertexTiming = restrictTiming && shaderSpec == SH_WEBGL_SPEC &&
+                                shaderType == SH_VERTEX_SHADER;
+    TInfoSinkBase vertexTimingLog;
+    RestrictVertexShaderTiming restrictVertex(vertexTimingLog);
+    if (restrictVertexTiming)
+        checks.addPass(SH_PASS_TIMING_RESTRICTIONS, &restrictVertex);
+
+    bool limitComplexity = (compileOptions & SH_LIMIT_EXPRESSION_COMPLEXITY) != 0;
+    ExpressionComplexity complexity;
+    if (limitComplexity)
+        checks.addPass(SH_PASS_LIMIT_EXPRESSION_COMPLEXITY, &complexity, 0, true);
+
+    {
+        // SH_PHASE_OTHER is what the other phases leave.
+        TScopedPhaseMemory phaseMemory(allocator, &memoryStatistics,
+            validateLoopIndexing ? SH_PHASE_VALIDATE_LIMITATIONS : SH_PHASE_OTHER);
+        checks.run(root);
+    }
+
+    if (!detectCallDepth(detect))
+        return false;
+
+    if (validateLoopIndexing) {
+        infoSink.info << validateLog.str();
+        if (validate.numErrors() > 0)
+            return false;
+    }
+
+    if (restrictVertexTiming) {
+        infoSink.info << vertexTimingLog.str();
+        if (restrictVertex.numErrors() > 0)
+            return false;
+    } else if (restrictTiming) {
+        TScopedPhaseMemory phaseMemory(allocator, &memoryStatistics, SH_PHASE_DEPENDENCY_GRAPH);
+        TScopedPassTimer timer(&passTimings, SH_PASS_TIMING_RESTRICTIONS);
+        if (!enforceTimingRestrictions(root, (compileOptions & SH_DEPENDENCY_GRAPH) != 0))
+            return false;
+    }
+
+    // Disallow expressions deemed too complex.
+    if (limitComplexity)
+        return complexity.checkDepth(maxExpressionComplexity, infoSink.info);
+    return true;
 }
 
-bool TCompiler::detectCallDepth(TIntermNode* root, TInfoSink& infoSink, bool limitCallStackDepth)
+bool TCompiler::detectCallDepth(DetectCallDepth& detect)
 {
-    DetectCallDepth detect(infoSink, limitCallStackDepth, maxCallStackDepth);
-    root->traverse(&detect);
     switch (detect.detectCallDepth()) {
         case DetectCallDepth::kErrorNone:
             return true;
@@ -322,12 +628,6 @@ void TCompiler::rewriteCSSShader(TIntermNode* root)
     root->traverse(&renamer);
 }
 
-bool TCompiler::validateLimitations(TIntermNode* root) {
-    ValidateLimitations validate(shaderType, infoSink.info);
-    root->traverse(&validate);
-    return validate.numErrors() == 0;
-}
-
 bool TCompiler::enforceTimingRestrictions(TIntermNode* root, bool outputGraph)
 {
     if (shaderSpec != SH_WEBGL_SPEC) {
@@ -335,45 +635,19 @@ bool TCompiler::enforceTimingRestrictions(TIntermNode* root, bool outputGraph)
         return false;
     }
 
-    if (shaderType == SH_FRAGMENT_SHADER) {
-        TDependencyGraph graph(root);
-
-        // Output any errors first.
-        bool success = enforceFragmentShaderTimingRestrictions(graph);
-        
-        // Then, output the dependency graph.
-        if (outputGraph) {
-            TDependencyGraphOutput output(infoSink.info);
-            output.outputAllSpanningTrees(graph);
-        }
-        
-        return success;
-    }
-    else {
-        return enforceVertexShaderTimingRestrictions(root);
-    }
-}
-
-bool TCompiler::limitExpressionComplexity(TIntermNode* root)
-{
-    TIntermTraverser traverser;
-    root->traverse(&traverser);
+    ASSERT(shaderType == SH_FRAGMENT_SHADER);
     TDependencyGraph graph(root);
 
-    for (TFunctionCallVector::const_iterator iter = graph.beginUserDefinedFunctionCalls();
-         iter != graph.endUserDefinedFunctionCalls();
-         ++iter)
-    {
-        TGraphFunctionCall* samplerSymbol = *iter;
-        TDependencyGraphTraverser graphTraverser;
-        samplerSymbol->traverse(&graphTraverser);
-    }
+    // Output any errors first.
+    bool success = enforceFragmentShaderTimingRestrictions(graph);
 
-    if (traverser.getMaxDepth() > maxExpressionComplexity) {
-        infoSink.info << "Expression too complex.";
-        return false;
+    // Then, output the dependency graph.
+    if (outputGraph) {
+        TDependencyGraphOutput output(infoSink.info);
+        output.outputAllSpanningTrees(graph);
     }
-    return true;
+
+    return success;
 }
 
 bool TCompiler::enforceFragmentShaderTimingRestrictions(const TDependencyGraph& graph)
@@ -383,17 +657,13 @@ bool TCompiler::enforceFragmentShaderTimingRestrictions(const TDependencyGraph&
     return restrictor.numErrors() == 0;
 }
 
-bool TCompiler::enforceVertexShaderTimingRestrictions(TIntermNode* root)
-{
-    RestrictVertexShaderTiming restrictor(infoSink.info);
-    restrictor.enforceRestrictions(root);
-    return restrictor.numErrors() == 0;
-}
-
-void TCompiler::collectVariables(TIntermNode* root)
+void TCompiler::collectVariables(TPassManager* passes)
 {
-    CollectVariables collect(attribs, uniforms, varyings, hashFunction);
-    root->traverse(&collect);
+    // The variables are collected under their mapped names. The traverser
+    // is freed with the pool of the compile.
+    passes->addPass(SH_PASS_COLLECT_VARIABLES,
+                    new CollectVariables(attribs, uniforms, varyings, hashFunction),
+                    PassBit(SH_PASS_MAP_LONG_VARIABLE_NAMES));
 }
 
 bool TCompiler::enforcePackingRestrictions()
@@ -402,11 +672,10 @@ bool TCompiler::enforcePackingRestrictions()
     return packer.CheckVariablesWithinPackingLimits(maxUniformVectors, uniforms);
 }
 
-void TCompiler::mapLongVariableNames(TIntermNode* root)
+void TCompiler::mapLongVariableNames(TPassManager* passes)
 {
     ASSERT(longNameMap);
-    MapLongVariableNames map(longNameMap);
-    root->traverse(&map);
+    passes->addPass(SH_PASS_MAP_LONG_VARIABLE_NAMES, new MapLongVariableNames(longNameMap));
 }
 
 int TCompiler::getMappedNameMaxLength() const
@@ -416,7 +685,7 @@ int TCompiler::getMappedNameMaxLength() const
 
 const TExtensionBehavior& TCompiler::getExtensionBehavior() const
 {
-    return extensionBehavior;
+    return compileExtensionBehavior;
 }
 
 const ShBuiltInResources& TCompiler::getResources() const
@@ -0,0 +1,197 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#include "compiler/CopyTree.h"
+
+#include "compiler/StaticIntermTraverser.h"
+
+namespace {
+
+//
+// Copies the nodes after their children, which are on top of the stack of
+// copies by then, in reverse order.
+//
+class CopyTreeTraverser : public TStaticIntermTraverser<CopyTreeTraverser> {
+public:
+    CopyTreeTraverser() : TStaticIntermTraverser<CopyTreeTraverser>(true, false, true) { }
+
+    TIntermNode* getCopy() const {
+        ASSERT(copies.size() == 1);
+        return copies.back();
+    }
+
+    void visitSymbol(TIntermSymbol* node);
+    void visitConstantUnion(TIntermConstantUnion* node);
+    bool visitBinary(Visit visit, TIntermBinary* node);
+    bool visitUnary(Visit visit, TIntermUnary* node);
+    bool visitSelection(Visit visit, TIntermSelection* node);
+    bool visitAggregate(Visit visit, TIntermAggregate* node);
+    bool visitLoop(Visit visit, TIntermLoop* node);
+    bool visitBranch(Visit visit, TIntermBranch* node);
+
+    // The copies are made without the path.
+    void incrementDepth(TIntermNode*) { }
+    void decrementDepth() { }
+
+private:
+    // Pushes the copy of a node that was copied already, and returns false
+    // so that its subtree is not visited again.
+    bool visitShared(TIntermNode* node);
+    void push(TIntermNode* original, TIntermNode* copy);
+    TIntermNode* pop();
+    TIntermTyped* popTyped() { return static_cast<TIntermTyped*>(pop()); }
+    TIntermNode* popIf(TIntermNode* original) { return original ? pop() : NULL; }
+    TIntermTyped* popTypedIf(TIntermNode* original) { return original ? popTyped() : NULL; }
+
+    TVector<TIntermNode*> copies;
+    TMap<TIntermNode*, TIntermNode*> copied;
+};
+
+bool CopyTreeTraverser::visitShared(TIntermNode* node)
+{
+    TMap<TIntermNode*, TIntermNode*>::const_iterator iter = copied.find(node);
+    if (iter == copied.end())
+        return true;
+
+    copies.push_back(iter->second);
+    return false;
+}
+
+void CopyTreeTraverser::push(TIntermNode* original, TIntermNode* copy)
+{
+    copy->setLine(original->getLine());
+    copied[original] = copy;
+    copies.push_back(copy);
+}
+
+TIntermNode* CopyTreeTraverser::pop()
+{
+    ASSERT(!copies.empty());
+    TIntermNode* copy = copies.back();
+    copies.pop_back();
+    return copy;
+}
+
+void CopyTreeTraverser::visitSymbol(TIntermSymbol* node)
+{
+    if (!visitShared(node))
+        return;
+
+    TIntermSymbol* copy = new TIntermSymbol(node->getId(), node->getOriginalSymbol(),
+                                            node->getType());
+    copy->setSymbol(node->getSymbol());
+    push(node, copy);
+}
+
+void CopyTreeTraverser::visitConstantUnion(TIntermConstantUnion* node)
+{
+    if (!visitShared(node))
+        return;
+
+    push(node, new TIntermConstantUnion(node->getUnionArrayPointer(), node->getType()));
+}
+
+bool CopyTreeTraverser::visitBinary(Visit visit, TIntermBinary* node)
+{
+    if (visit == PreVisit)
+        return visitShared(node);
+
+    TIntermBinary* copy = new TIntermBinary(node->getOp());
+    copy->setType(node->getType());
+    copy->setRight(popTypedIf(node->getRight()));
+    copy->setLeft(popTypedIf(node->getLeft()));
+    if (node->getAddIndexClamp())
+        copy->setAddIndexClamp();
+    push(node, copy);
+    return true;
+}
+
+bool CopyTreeTraverser::visitUnary(Visit visit, TIntermUnary* node)
+{
+    if (visit == PreVisit)
+        return visitShared(node);
+
+    TIntermUnary* copy = new TIntermUnary(node->getOp());
+    copy->setType(node->getType());
+    copy->setOperand(popTyped());
+    if (node->getUseEmulatedFunction())
+        copy->setUseEmulatedFunction();
+    push(node, copy);
+    return true;
+}
+
+bool CopyTreeTraverser::visitSelection(Visit visit, TIntermSelection* node)
+{
+    if (visit == PreVisit)
+        return visitShared(node);
+
+    TIntermNode* falseBlock = popIf(node->getFalseBlock());
+    TIntermNode* trueBlock = popIf(node->getTrueBlock());
+    TIntermTyped* condition = popTyped();
+    push(node, new TIntermSelection(condition, trueBlock, falseBlock, node->getType()));
+    return true;
+}
+
+bool CopyTreeTraverser::visitAggregate(Visit visit, TIntermAggregate* node)
+{
+    if (visit == PreVisit)
+        return visitShared(node);
+
+    TIntermAggregate* copy = new TIntermAggregate;
+    copy->setOp(node->getOp());
+    copy->setType(node->getType());
+    copy->setName(node->getName());
+    if (node->isUserDefined())
+        copy->setUserDefined();
+    copy->setOptimize(node->getOptimize());
+    copy->setDebug(node->getDebug());
+    if (node->getUseEmulatedFunction())
+        copy->setUseEmulatedFunction();
+
+    TIntermSequence& sequence = copy->getSequence();
+    sequence.resize(node->getSequence().size());
+    for (TIntermSequence::reverse_iterator iter = sequence.rbegin(); iter != sequence.rend(); ++iter)
+        *iter = pop();
+    push(node, copy);
+    return true;
+}
+
+bool CopyTreeTraverser::visitLoop(Visit visit, TIntermLoop* node)
+{
+    if (visit == PreVisit)
+        return visitShared(node);
+
+    TIntermTyped* expression = popTypedIf(node->getExpression());
+    TIntermNode* body = popIf(node->getBody());
+    TIntermTyped* condition = popTypedIf(node->getCondition());
+    TIntermNode* init = popIf(node->getInit());
+    TIntermLoop* copy = new TIntermLoop(node->getType(), init, condition, expression, body);
+    copy->setUnrollFlag(node->getUnrollFlag());
+    push(node, copy);
+    return true;
+}
+
+bool CopyTreeTraverser::visitBranch(Visit visit, TIntermBranch* node)
+{
+    if (visit == PreVisit)
+        return visitShared(node);
+
+    TIntermTyped* expression = popTypedIf(node->getExpression());
+    push(node, new TIntermBranch(node->getFlowOp(), expression));
+    return true;
+}
+
+}  // namespace
+
+TIntermNode* CopyTree(TIntermNode* root)
+{
+    if (root == NULL)
+        return NULL;
+
+    CopyTreeTraverser copier;
+    copier.traverse(root);
+    return copier.getCopy();
+}
@@ -0,0 +1,18 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#ifndef COMPILER_COPY_TREE_H_
+#define COMPILER_COPY_TREE_H_
+
+class TIntermNode;
+
+// Returns a copy of the tree, allocated from the current pool, which can be
+// modified without modifying the original. Subtrees shared in the original
+// are shared in the copy as well. Types and constant values are copied by
+// reference to the structures and values of the original.
+TIntermNode* CopyTree(TIntermNode* root);
+
+#endif  // COMPILER_COPY_TREE_H_
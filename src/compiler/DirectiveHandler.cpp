@@ -28,7 +28,9 @@ static TBehavior getBehavior(const std::string& str)
 TDirectiveHandler::TDirectiveHandler(TExtensionBehavior& extBehavior,
                                      TDiagnostics& diagnostics)
     : mExtensionBehavior(extBehavior),
-      mDiagnostics(diagnostics)
+      mDiagnostics(diagnostics),
+      mIncludeCallback(NULL),
+      mIncludeCallbackData(NULL)
 {
 }
 
@@ -159,3 +161,16 @@ void TDirectiveHandler::handleVersion(const pp::SourceLocation& loc,
                                "version number", str, "not supported");
     }
 }
+
+bool TDirectiveHandler::handleInclude(const pp::SourceLocation& loc,
+                                      const std::string& name,
+                                      const char** source,
+                                      size_t* length)
+{
+    if (!mIncludeCallback)
+        return false;
+
+    *length = 0;
+    *source = mIncludeCallback(name.c_str(), length, mIncludeCallbackData);
+    return *source != NULL;
+}
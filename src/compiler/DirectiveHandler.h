@@ -7,6 +7,8 @@
 #ifndef COMPILER_DIRECTIVE_HANDLER_H_
 #define COMPILER_DIRECTIVE_HANDLER_H_
 
+#include "GLSLANG/ShaderLang.h"
+
 #include "compiler/ExtensionBehavior.h"
 #include "compiler/Pragma.h"
 #include "compiler/preprocessor/DirectiveHandlerBase.h"
@@ -20,7 +22,15 @@ class TDirectiveHandler : public pp::DirectiveHandler
                       TDiagnostics& diagnostics);
     virtual ~TDirectiveHandler();
 
+    void setIncludeCallback(ShIncludeCallback callback, void* userData)
+    {
+        mIncludeCallback = callback;
+        mIncludeCallbackData = userData;
+    }
+
     const TPragma& pragma() const { return mPragma; }
+    // Starts from the pragmas of an earlier source, such as a prelude.
+    void setPragma(const TPragma& pragma) { mPragma = pragma; }
     const TExtensionBehavior& extensionBehavior() const { return mExtensionBehavior; }
 
     virtual void handleError(const pp::SourceLocation& loc,
@@ -37,10 +47,17 @@ class TDirectiveHandler : public pp::DirectiveHandler
     virtual void handleVersion(const pp::SourceLocation& loc,
                                int version);
 
+    virtual bool handleInclude(const pp::SourceLocation& loc,
+                               const std::string& name,
+                               const char** source,
+                               size_t* length);
+
   private:
     TPragma mPragma;
     TExtensionBehavior& mExtensionBehavior;
     TDiagnostics& mDiagnostics;
+    ShIncludeCallback mIncludeCallback;
+    void* mIncludeCallbackData;
 };
 
 #endif  // COMPILER_DIRECTIVE_HANDLER_H_
@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#include "compiler/EventTracer.h"
+
+namespace {
+
+// The values of the phase and flags arguments of the event tracer, as in
+// third_party/trace_event.
+const char kPhaseBegin = 'B';
+const char kPhaseEnd = 'E';
+const unsigned char kFlagNone = 0;
+
+const char* const kPassEventNames[SH_PASS_COUNT] = {
+    "Parse",
+    "PostProcess",
+    "DetectCallDepth",
+    "ValidateLimitations",
+    "TimingRestrictions",
+    "RewriteCSSShader",
+    "UnrollForLoops",
+    "EmulateBuiltInFunctions",
+    "ClampIndirectArrayBounds",
+    "LimitExpressionComplexity",
+    "MapLongVariableNames",
+    "InitGLPosition",
+    "UnfoldShortCircuit",
+    "CollectVariables",
+    "IntermediateTree",
+    "Translate",
+};
+
+ShAddTraceEventFunc gAddTraceEvent = NULL;
+// The flag of the "gpu" category, which the embedder keeps up to date.
+const unsigned char* gCategoryEnabled = NULL;
+
+void AddTraceEvent(char phase, const char* name)
+{
+    gAddTraceEvent(phase, gCategoryEnabled, name, 0, 0, NULL, NULL, NULL, kFlagNone);
+}
+
+}  // namespace
+
+void SetTraceFunctions(ShGetCategoryEnabledFlagFunc getCategoryEnabledFlag,
+                       ShAddTraceEventFunc addTraceEvent)
+{
+    if (getCategoryEnabledFlag && addTraceEvent) {
+        gCategoryEnabled = getCategoryEnabledFlag("gpu");
+        gAddTraceEvent = addTraceEvent;
+    } else {
+        gCategoryEnabled = NULL;
+        gAddTraceEvent = NULL;
+    }
+}
+
+const char* GetPassEventName(ShCompilePass pass)
+{
+    return kPassEventNames[pass];
+}
+
+TScopedTraceEvent::TScopedTraceEvent(const char* name)
+    : mName(NULL)
+{
+    if (gAddTraceEvent && gCategoryEnabled && *gCategoryEnabled) {
+        mName = name;
+        AddTraceEvent(kPhaseBegin, mName);
+    }
+}
+
+TScopedTraceEvent::~TScopedTraceEvent()
+{
+    // The end event follows the begin event even if the category was
+    // disabled since.
+    if (mName)
+        AddTraceEvent(kPhaseEnd, mName);
+}
@@ -0,0 +1,34 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#ifndef COMPILER_EVENT_TRACER_H_
+#define COMPILER_EVENT_TRACER_H_
+
+#include "GLSLANG/ShaderLang.h"
+
+// Sets the event tracer of the embedder, which ShSetTraceFunctionPointers()
+// takes. NULL functions turn tracing off.
+void SetTraceFunctions(ShGetCategoryEnabledFlagFunc getCategoryEnabledFlag,
+                       ShAddTraceEventFunc addTraceEvent);
+
+// Returns the name of the events of pass.
+const char* GetPassEventName(ShCompilePass pass);
+
+//
+// Traces the lifetime of the object as a pair of begin and end events in
+// the "gpu" category, if the embedder has the category enabled when the
+// object is constructed.
+//
+class TScopedTraceEvent {
+public:
+    explicit TScopedTraceEvent(const char* name);
+    ~TScopedTraceEvent();
+
+private:
+    const char* mName;  // NULL if the events are not traced.
+};
+
+#endif  // COMPILER_EVENT_TRACER_H_
@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#include "compiler/ExpressionComplexity.h"
+
+#include <algorithm>
+
+#include "compiler/InfoSink.h"
+
+ExpressionComplexity::ExpressionComplexity()
+    : TIntermTraverser(true, false, true),
+      mFunction(0),
+      mExpression(NULL),
+      mExpressionNodes(0),
+      mDeepestDepth(0),
+      mDeepestFunction(0),
+      mDeepestExpression(NULL),
+      mDeepestExpressionNodes(0)
+{
+    mDeepestLine.first_file = mDeepestLine.last_file = 0;
+    mDeepestLine.first_line = mDeepestLine.last_line = 0;
+
+    Function global = { TString(), 0, 0, 0 };
+    mFunctions.push_back(global);
+}
+
+bool ExpressionComplexity::checkDepth(int maxDepth, TInfoSinkBase& sink) const
+{
+    if (getMaxDepth() <= maxDepth)
+        return true;
+
+    sink.prefix(EPrefixError);
+    sink.location(mDeepestLine);
+    sink << "Expression too complex";
+    const TString& name = mFunctions[mDeepestFunction].name;
+    if (!name.empty())
+        sink << " in '" << name << "'";
+    sink << ": " << mDeepestDepth << " levels deep, the limit is " << maxDepth;
+    if (mDeepestExpression)
+        sink << "; the expression has " << mDeepestExpressionNodes << " nodes";
+    sink << "\n";
+
+    for (size_t i = 0; i < mFunctions.size(); ++i) {
+        const Function& function = mFunctions[i];
+        if (function.name.empty() && function.maxExpressionNodes == 0)
+            continue;
+        sink.prefix(EPrefixNote);
+        if (function.name.empty())
+            sink << "global scope";
+        else
+            sink << "'" << function.name << "'";
+        sink << ": " << function.numNodes << " nodes, " << function.maxDepth
+             << " levels deep, largest expression of " << function.maxExpressionNodes
+             << " nodes\n";
+    }
+    return false;
+}
+
+void ExpressionComplexity::visitSymbol(TIntermSymbol* node)
+{
+    visitNode(PreVisit, node, false, false);
+}
+
+void ExpressionComplexity::visitConstantUnion(TIntermConstantUnion* node)
+{
+    visitNode(PreVisit, node, false, false);
+}
+
+bool ExpressionComplexity::visitBinary(Visit visit, TIntermBinary* node)
+{
+    visitNode(visit, node, false, true);
+    return true;
+}
+
+bool ExpressionComplexity::visitUnary(Visit visit, TIntermUnary* node)
+{
+    visitNode(visit, node, false, true);
+    return true;
+}
+
+bool ExpressionComplexity::visitSelection(Visit visit, TIntermSelection* node)
+{
+    // If statements are statements, and ternary operators expressions.
+    visitNode(visit, node, !node->usesTernaryOperator(), true);
+    return true;
+}
+
+bool ExpressionComplexity::visitAggregate(Visit visit, TIntermAggregate* node)
+{
+    bool isStatement = false;
+    switch (node->getOp()) {
+      case EOpFunction:
+        if (visit == PreVisit) {
+            const TString& name = node->getName();
+            Function function = { name.substr(0, name.find('(')), 0, 0, 0 };
+            mFunctions.push_back(function);
+            mFunction = mFunctions.size() - 1;
+        }
+        isStatement = true;
+        break;
+      case EOpNull:
+      case EOpSequence:
+      case EOpParameters:
+      case EOpDeclaration:
+      case EOpPrototype:
+        isStatement = true;
+        break;
+      default:
+        break;
+    }
+
+    visitNode(visit, node, isStatement, true);
+    if (visit == PostVisit && node->getOp() == EOpFunction)
+        mFunction = 0;
+    return true;
+}
+
+bool ExpressionComplexity::visitLoop(Visit visit, TIntermLoop* node)
+{
+    visitNode(visit, node, true, true);
+    return true;
+}
+
+bool ExpressionComplexity::visitBranch(Visit visit, TIntermBranch* node)
+{
+    // A branch has children only if it returns a value.
+    visitNode(visit, node, true, node->getExpression() != NULL);
+    return true;
+}
+
+void ExpressionComplexity::visitNode(Visit visit, TIntermNode* node,
+                                     bool isStatement, bool hasChildren)
+{
+    Function& function = mFunctions[mFunction];
+    if (visit == PreVisit) {
+        ++function.numNodes;
+        if (mExpression == NULL && !isStatement) {
+            mExpression = node;
+            mExpressionNodes = 0;
+        }
+        if (mExpression)
+            ++mExpressionNodes;
+
+        if (hasChildren) {
+            // The depth the node takes the tree to, as incrementDepth()
+            // counts it.
+            int nodeDepth = depth + 1;
+            function.maxDepth = std::max(function.maxDepth, nodeDepth);
+            if (nodeDepth > mDeepestDepth) {
+                mDeepestDepth = nodeDepth;
+                mDeepestFunction = mFunction;
+                mDeepestLine = mExpression ? mExpression->getLine() : node->getLine();
+                mDeepestExpression = mExpression;
+            }
+        }
+    }
+
+    // A leaf ends on its only visit.
+    if ((visit == PostVisit || !hasChildren) && node == mExpression) {
+        function.maxExpressionNodes = std::max(function.maxExpressionNodes, mExpressionNodes);
+        if (mDeepestExpression == mExpression)
+            mDeepestExpressionNodes = mExpressionNodes;
+        mExpression = NULL;
+    }
+}
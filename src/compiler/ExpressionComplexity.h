@@ -0,0 +1,66 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#ifndef COMPILER_EXPRESSION_COMPLEXITY_H_
+#define COMPILER_EXPRESSION_COMPLEXITY_H_
+
+#include "compiler/intermediate.h"
+
+class TInfoSinkBase;
+
+//
+// Measures the complexity of a tree in a single traversal: its depth, which
+// SH_LIMIT_EXPRESSION_COMPLEXITY limits, and the nodes of each expression
+// and function. The traverser keeps its path, and so needs its path kept
+// when it shares a traversal.
+//
+class ExpressionComplexity : public TIntermTraverser {
+public:
+    ExpressionComplexity();
+
+    // Returns false if the tree is deeper than maxDepth, after writing an
+    // error about its deepest expression and the complexity of each
+    // function to sink.
+    bool checkDepth(int maxDepth, TInfoSinkBase& sink) const;
+
+    virtual void visitSymbol(TIntermSymbol* node);
+    virtual void visitConstantUnion(TIntermConstantUnion* node);
+    virtual bool visitBinary(Visit visit, TIntermBinary* node);
+    virtual bool visitUnary(Visit visit, TIntermUnary* node);
+    virtual bool visitSelection(Visit visit, TIntermSelection* node);
+    virtual bool visitAggregate(Visit visit, TIntermAggregate* node);
+    virtual bool visitLoop(Visit visit, TIntermLoop* node);
+    virtual bool visitBranch(Visit visit, TIntermBranch* node);
+
+private:
+    struct Function {
+        // The unmangled name, or empty for the global scope.
+        TString name;
+        int numNodes;
+        int maxDepth;
+        int maxExpressionNodes;
+    };
+
+    // Counts a node with children, or a leaf if hasChildren is false.
+    // Statements are not part of expressions.
+    void visitNode(Visit visit, TIntermNode* node, bool isStatement, bool hasChildren);
+
+    TVector<Function> mFunctions;
+    size_t mFunction;
+
+    // The expression being visited, if any.
+    TIntermNode* mExpression;
+    int mExpressionNodes;
+
+    // Where the tree is deepest.
+    int mDeepestDepth;
+    size_t mDeepestFunction;
+    TSourceLoc mDeepestLine;
+    TIntermNode* mDeepestExpression;
+    int mDeepestExpressionNodes;
+};
+
+#endif  // COMPILER_EXPRESSION_COMPLEXITY_H_
@@ -5,6 +5,7 @@
 //
 
 #include "compiler/ForLoopUnroll.h"
+#include "compiler/PassManager.h"
 
 namespace {
 
@@ -152,6 +153,13 @@ void ForLoopUnroll::MarkForLoopsWithIntegerIndicesForUnrolling(
     root->traverse(&marker);
 }
 
+void ForLoopUnroll::MarkForLoopsWithIntegerIndicesForUnrolling(
+    TPassManager* passes)
+{
+    // The marker is freed with the pool of the compile.
+    passes->addPass(SH_PASS_UNROLL_FOR_LOOPS, new IntegerForLoopUnrollMarker);
+}
+
 int ForLoopUnroll::getLoopIncrement(TIntermLoop* node)
 {
     TIntermNode* expr = node->getExpression();
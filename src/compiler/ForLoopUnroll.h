@@ -6,6 +6,8 @@
 
 #include "compiler/intermediate.h"
 
+class TPassManager;
+
 struct TLoopIndexInfo {
     int id;
     int initValue;
@@ -37,6 +39,8 @@ public:
     void Pop();
 
     static void MarkForLoopsWithIntegerIndicesForUnrolling(TIntermNode* root);
+    // Marks the loops in a pass of passes instead, to share its traversal.
+    static void MarkForLoopsWithIntegerIndicesForUnrolling(TPassManager* passes);
 
 private:
     int getLoopIncrement(TIntermLoop* node);
@@ -6,40 +6,77 @@
 
 #include "compiler/InfoSink.h"
 
+#include <stdio.h>
+
+#include "common/angleutils.h"
+
+TInfoSinkBase& TInfoSinkBase::operator<<(float f) {
+    // Make sure that at least one decimal point is written. If a number
+    // does not have a fractional part, the default precision format does
+    // not write the decimal portion which gets interpreted as integer by
+    // the compiler.
+    char buffer[64];
+    if (fractionalPart(f) == 0.0f)
+        snprintf(buffer, sizeof(buffer), "%.1f", f);
+    else
+        snprintf(buffer, sizeof(buffer), "%.8g", f);
+    buffer[sizeof(buffer) - 1] = '\0';
+
+    // Unlike streams, printf follows the decimal separator of the C locale,
+    // which the embedder may have changed.
+    size_t length = 0;
+    for (; buffer[length]; ++length) {
+        if (buffer[length] == ',')
+            buffer[length] = '.';
+    }
+    append(buffer, length);
+    return *this;
+}
+
+void TInfoSinkBase::appendInteger(unsigned long magnitude, bool negative) {
+    char buffer[24];
+    char* end = buffer + sizeof(buffer);
+    char* begin = end;
+    do {
+        *--begin = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    if (negative)
+        *--begin = '-';
+    append(begin, end - begin);
+}
+
 void TInfoSinkBase::prefix(TPrefixType p) {
     switch(p) {
         case EPrefixNone:
             break;
         case EPrefixWarning:
-            sink.append("WARNING: ");
+            *this << "WARNING: ";
             break;
         case EPrefixError:
-            sink.append("ERROR: ");
+            *this << "ERROR: ";
             break;
         case EPrefixInternalError:
-            sink.append("INTERNAL ERROR: ");
+            *this << "INTERNAL ERROR: ";
             break;
         case EPrefixUnimplemented:
-            sink.append("UNIMPLEMENTED: ");
+            *this << "UNIMPLEMENTED: ";
             break;
         case EPrefixNote:
-            sink.append("NOTE: ");
+            *this << "NOTE: ";
             break;
         default:
-            sink.append("UNKOWN ERROR: ");
+            *this << "UNKOWN ERROR: ";
             break;
     }
 }
 
 void TInfoSinkBase::location(int file, int line) {
-    TPersistStringStream stream;
     if (line)
-        stream << file << ":" << line;
+        *this << file << ":" << line;
     else
-        stream << file << ":? ";
-    stream << ": ";
-
-    sink.append(stream.str());
+        *this << file << ":? ";
+    *this << ": ";
 }
 
 void TInfoSinkBase::location(const TSourceLoc& loc) {
@@ -49,6 +86,18 @@ void TInfoSinkBase::location(const TSourceLoc& loc) {
 void TInfoSinkBase::message(TPrefixType p, const TSourceLoc& loc, const char* m) {
     prefix(p);
     location(loc);
-    sink.append(m);
-    sink.append("\n");
+    *this << m << "\n";
+}
+
+void TInfoSinkBase::setCallback(ShObjectCodeCallback newCallback, void* userData) {
+    flush();
+    callback = newCallback;
+    callbackData = userData;
+}
+
+void TInfoSinkBase::flush() {
+    if (callback && !sink.empty()) {
+        callback(sink.data(), sink.size(), callbackData);
+        sink.clear();
+    }
 }
@@ -8,6 +8,8 @@
 #define _INFOSINK_INCLUDED_
 
 #include <math.h>
+#include <string.h>
+#include "GLSLANG/ShaderLang.h"
 #include "compiler/Common.h"
 
 // Returns the fractional part of the given floating-point number.
@@ -37,57 +39,50 @@ enum TPrefixType {
 //
 class TInfoSinkBase {
 public:
-    TInfoSinkBase() {}
+    TInfoSinkBase() : callback(NULL), callbackData(NULL) {}
 
     template <typename T>
     TInfoSinkBase& operator<<(const T& t) {
         TPersistStringStream stream;
         stream << t;
-        sink.append(stream.str());
+        TPersistString str = stream.str();
+        append(str.data(), str.size());
         return *this;
     }
     // Override << operator for specific types. It is faster to append strings
     // and characters directly to the sink.
     TInfoSinkBase& operator<<(char c) {
-        sink.append(1, c);
+        append(&c, 1);
         return *this;
     }
     TInfoSinkBase& operator<<(const char* str) {
-        sink.append(str);
+        append(str, strlen(str));
         return *this;
     }
     TInfoSinkBase& operator<<(const TPersistString& str) {
-        sink.append(str);
+        append(str.data(), str.size());
         return *this;
     }
     TInfoSinkBase& operator<<(const TString& str) {
-        sink.append(str.c_str());
+        append(str.data(), str.size());
         return *this;
     }
-    // Make sure floats are written with correct precision.
-    TInfoSinkBase& operator<<(float f) {
-        // Make sure that at least one decimal point is written. If a number
-        // does not have a fractional part, the default precision format does
-        // not write the decimal portion which gets interpreted as integer by
-        // the compiler.
-        TPersistStringStream stream;
-        if (fractionalPart(f) == 0.0f) {
-            stream.precision(1);
-            stream << std::showpoint << std::fixed << f;
-        } else {
-            stream.unsetf(std::ios::fixed);
-            stream.unsetf(std::ios::scientific);
-            stream.precision(8);
-            stream << f;
-        }
-        sink.append(stream.str());
+    // Integers are formatted without a stream, which is costly to create.
+    TInfoSinkBase& operator<<(int i) { return *this << static_cast<long>(i); }
+    TInfoSinkBase& operator<<(unsigned int i) { return *this << static_cast<unsigned long>(i); }
+    TInfoSinkBase& operator<<(long i) {
+        appendInteger(i < 0 ? 0ul - static_cast<unsigned long>(i) : i, i < 0);
         return *this;
     }
+    TInfoSinkBase& operator<<(unsigned long i) {
+        appendInteger(i, false);
+        return *this;
+    }
+    // Make sure floats are written with correct precision.
+    TInfoSinkBase& operator<<(float f);
     // Write boolean values as their names instead of integral value.
     TInfoSinkBase& operator<<(bool b) {
-        const char* str = b ? "true" : "false";
-        sink.append(str);
-        return *this;
+        return *this << (b ? "true" : "false");
     }
 
     void erase() { sink.clear(); }
@@ -101,8 +96,32 @@ public:
     void location(const TSourceLoc& loc);
     void message(TPrefixType p, const TSourceLoc& loc, const char* m);
 
+    // Makes the sink hand its contents to callback, whenever they reach a
+    // few kilobytes and on flush(), instead of keeping them. A NULL
+    // callback makes the sink keep its contents again.
+    void setCallback(ShObjectCodeCallback callback, void* userData);
+    bool hasCallback() const { return callback != NULL; }
+    void flush();
+
 private:
+    void append(const char* str, size_t length) {
+        if (callback && length >= kCallbackChunkSize) {
+            // Hand large strings over without copying them.
+            flush();
+            callback(str, length, callbackData);
+            return;
+        }
+        sink.append(str, length);
+        if (callback && sink.size() >= kCallbackChunkSize)
+            flush();
+    }
+    void appendInteger(unsigned long magnitude, bool negative);
+
+    static const size_t kCallbackChunkSize = 16 * 1024;
+
     TPersistString sink;
+    ShObjectCodeCallback callback;
+    void* callbackData;
 };
 
 class TInfoSink {
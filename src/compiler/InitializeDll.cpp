@@ -6,8 +6,11 @@
 
 #include "compiler/InitializeDll.h"
 
+#include "compiler/BuiltInSymbolTable.h"
 #include "compiler/InitializeGlobals.h"
-#include "compiler/InitializeParseContext.h"
+#include "compiler/Keywords.h"
+#include "compiler/MapLongVariableNames.h"
+#include "compiler/TranslationCache.h"
 #include "compiler/osinclude.h"
 
 bool InitProcess()
@@ -17,8 +20,23 @@ bool InitProcess()
         return false;
     }
 
-    if (!InitializeParseContextIndex()) {
-        assert(0 && "InitProcess(): Failed to initalize parse context");
+    if (!InitializeKeywordTable()) {
+        assert(0 && "InitProcess(): Failed to initalize keyword table");
+        return false;
+    }
+
+    if (!TBuiltInSymbolTable::InitializeLock()) {
+        assert(0 && "InitProcess(): Failed to initalize built-in symbol table lock");
+        return false;
+    }
+
+    if (!LongNameMap::InitializeLock()) {
+        assert(0 && "InitProcess(): Failed to initalize long name map lock");
+        return false;
+    }
+
+    if (!TTranslationCache::InitializeLock()) {
+        assert(0 && "InitProcess(): Failed to initalize translation cache lock");
         return false;
     }
 
@@ -27,6 +45,9 @@ bool InitProcess()
 
 void DetachProcess()
 {
-    FreeParseContextIndex();
+    TTranslationCache::FreeLock();
+    TBuiltInSymbolTable::ClearCache();
+    LongNameMap::FreeLock();
+    TBuiltInSymbolTable::FreeLock();
     FreePoolIndex();
 }
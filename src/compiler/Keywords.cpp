@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#include "compiler/Keywords.h"
+
+#include <assert.h>
+#include <string.h>
+
+#include "compiler/ParseContext.h"
+#include "glslang_tab.h"
+
+const TKeyword kKeywords[] = {
+    { "asm",                 kReservedWord },
+    { "attribute",           ATTRIBUTE },
+    { "bool",                BOOL_TYPE },
+    { "break",               BREAK },
+    { "bvec2",               BVEC2 },
+    { "bvec3",               BVEC3 },
+    { "bvec4",               BVEC4 },
+    { "cast",                kReservedWord },
+    { "class",               kReservedWord },
+    { "const",               CONST_QUAL },
+    { "continue",            CONTINUE },
+    { "default",             kReservedWord },
+    { "discard",             DISCARD },
+    { "do",                  DO },
+    { "double",              kReservedWord },
+    { "dvec2",               kReservedWord },
+    { "dvec3",               kReservedWord },
+    { "dvec4",               kReservedWord },
+    { "else",                ELSE },
+    { "enum",                kReservedWord },
+    { "extern",              kReservedWord },
+    { "external",            kReservedWord },
+    { "false",               BOOLCONSTANT },
+    { "fixed",               kReservedWord },
+    { "flat",                kReservedWord },
+    { "float",               FLOAT_TYPE },
+    { "for",                 FOR },
+    { "fvec2",               kReservedWord },
+    { "fvec3",               kReservedWord },
+    { "fvec4",               kReservedWord },
+    { "goto",                kReservedWord },
+    { "half",                kReservedWord },
+    { "highp",               HIGH_PRECISION },
+    { "hvec2",               kReservedWord },
+    { "hvec3",               kReservedWord },
+    { "hvec4",               kReservedWord },
+    { "if",                  IF },
+    { "in",                  IN_QUAL },
+    { "inline",              kReservedWord },
+    { "inout",               INOUT_QUAL },
+    { "input",               kReservedWord },
+    { "int",                 INT_TYPE },
+    { "interface",           kReservedWord },
+    { "invariant",           INVARIANT },
+    { "ivec2",               IVEC2 },
+    { "ivec3",               IVEC3 },
+    { "ivec4",               IVEC4 },
+    { "long",                kReservedWord },
+    { "lowp",                LOW_PRECISION },
+    { "mat2",                MATRIX2 },
+    { "mat3",                MATRIX3 },
+    { "mat4",                MATRIX4 },
+    { "mediump",             MEDIUM_PRECISION },
+    { "namespace",           kReservedWord },
+    { "noinline",            kReservedWord },
+    { "out",                 OUT_QUAL },
+    { "output",              kReservedWord },
+    { "packed",              kReservedWord },
+    { "precision",           PRECISION },
+    { "public",              kReservedWord },
+    { "return",              RETURN },
+    { "sampler1D",           kReservedWord },
+    { "sampler1DShadow",     kReservedWord },
+    { "sampler2D",           SAMPLER2D },
+    { "sampler2DRect",       SAMPLER2DRECT },
+    { "sampler2DRectShadow", kReservedWord },
+    { "sampler2DShadow",     kReservedWord },
+    { "sampler3D",           kReservedWord },
+    { "sampler3DRect",       kReservedWord },
+    { "samplerCube",         SAMPLERCUBE },
+    { "samplerExternalOES",  SAMPLER_EXTERNAL_OES },
+    { "short",               kReservedWord },
+    { "sizeof",              kReservedWord },
+    { "static",              kReservedWord },
+    { "struct",              STRUCT },
+    { "superp",              kReservedWord },
+    { "switch",              kReservedWord },
+    { "template",            kReservedWord },
+    { "this",                kReservedWord },
+    { "true",                BOOLCONSTANT },
+    { "typedef",             kReservedWord },
+    { "uniform",             UNIFORM },
+    { "union",               kReservedWord },
+    { "unsigned",            kReservedWord },
+    { "using",               kReservedWord },
+    { "varying",             VARYING },
+    { "vec2",                VEC2 },
+    { "vec3",                VEC3 },
+    { "vec4",                VEC4 },
+    { "void",                VOID_TYPE },
+    { "volatile",            kReservedWord },
+    { "while",               WHILE },
+};
+const size_t kNumKeywords = sizeof(kKeywords) / sizeof(kKeywords[0]);
+
+namespace {
+
+// Length of the longest keyword - "sampler2DRectShadow".
+const size_t kMaxKeywordLength = 19;
+
+// The keywords are hashed into kSlotCount slots by multiplying in their
+// characters one at a time, and taking the top bits of the product. The
+// multiplier was searched for to give each keyword a slot of its own.
+const unsigned int kKeywordHashMultiplier = 0x9ec928b5u;
+const unsigned int kSlotBits = 9;
+const size_t kSlotCount = 1 << kSlotBits;
+
+// One more than the index in kKeywords of the keyword in each slot, or 0 if
+// no keyword hashes to the slot.
+unsigned char gSlots[kSlotCount];
+
+size_t Hash(const char* name, size_t length)
+{
+    unsigned int hash = static_cast<unsigned int>(length);
+    for (size_t i = 0; i < length; ++i)
+        hash = (hash ^ static_cast<unsigned char>(name[i])) * kKeywordHashMultiplier;
+    return hash >> (32 - kSlotBits);
+}
+
+}  // namespace
+
+bool InitializeKeywordTable()
+{
+    unsigned char slots[kSlotCount] = { 0 };
+    for (size_t i = 0; i < kNumKeywords; ++i) {
+        const char* name = kKeywords[i].name;
+        size_t length = strlen(name);
+        assert(length <= kMaxKeywordLength);
+
+        size_t slot = Hash(name, length);
+        if (slots[slot] != 0)
+            return false;
+        slots[slot] = static_cast<unsigned char>(i + 1);
+    }
+    memcpy(gSlots, slots, sizeof(gSlots));
+    return true;
+}
+
+const TKeyword* FindKeyword(const char* name, size_t length)
+{
+    if (length > kMaxKeywordLength)
+        return NULL;
+
+    unsigned char slot = gSlots[Hash(name, length)];
+    if (slot == 0)
+        return NULL;
+
+    // The name is a keyword only if it is the one hashed to the slot.
+    const TKeyword* keyword = &kKeywords[slot - 1];
+    if (strncmp(keyword->name, name, length) != 0 || keyword->name[length] != '\0')
+        return NULL;
+    return keyword;
+}
@@ -0,0 +1,34 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#ifndef COMPILER_KEYWORDS_H_
+#define COMPILER_KEYWORDS_H_
+
+#include <stddef.h>
+
+// The parser token of the words reserved for future use.
+const int kReservedWord = -1;
+
+struct TKeyword {
+    const char* name;
+    // The parser token of the keyword, or kReservedWord.
+    int token;
+};
+
+// The keywords and reserved words of GLSL ES 1.00, sorted by name.
+extern const TKeyword kKeywords[];
+extern const size_t kNumKeywords;
+
+// Builds the perfect hash table of the keywords. Called once per process,
+// before any shader is lexed. Returns false if two keywords hash to the
+// same slot, which calls for a new kKeywordHashMultiplier.
+bool InitializeKeywordTable();
+
+// Returns the keyword or reserved word named by the length characters at
+// name, or NULL if the name is an identifier.
+const TKeyword* FindKeyword(const char* name, size_t length);
+
+#endif  // COMPILER_KEYWORDS_H_
@@ -6,6 +6,8 @@
 
 #include "compiler/MapLongVariableNames.h"
 
+#include "compiler/osinclude.h"
+
 namespace {
 
 TString mapLongName(size_t id, const TString& name, bool isGlobal)
@@ -23,11 +25,15 @@ TString mapLongName(size_t id, const TString& name, bool isGlobal)
 }
 
 LongNameMap* gLongNameMapInstance = NULL;
+unsigned int gLongNameMapSerial = 0;
+// Guards gLongNameMapInstance, its contents and gLongNameMapSerial.
+OS_Mutex gLongNameMapLock;
 
 }  // anonymous namespace
 
 LongNameMap::LongNameMap()
-    : refCount(0)
+    : refCount(0),
+      serial(++gLongNameMapSerial)
 {
 }
 
@@ -35,9 +41,22 @@ LongNameMap::~LongNameMap()
 {
 }
 
+// static
+bool LongNameMap::InitializeLock()
+{
+    return OS_InitMutex(&gLongNameMapLock);
+}
+
+// static
+void LongNameMap::FreeLock()
+{
+    OS_FreeMutex(&gLongNameMapLock);
+}
+
 // static
 LongNameMap* LongNameMap::GetInstance()
 {
+    TScopedLock lock(&gLongNameMapLock);
     if (gLongNameMapInstance == NULL)
         gLongNameMapInstance = new LongNameMap;
     gLongNameMapInstance->refCount++;
@@ -46,6 +65,7 @@ LongNameMap* LongNameMap::GetInstance()
 
 void LongNameMap::Release()
 {
+    TScopedLock lock(&gLongNameMapLock);
     ASSERT(gLongNameMapInstance == this);
     ASSERT(refCount > 0);
     refCount--;
@@ -55,24 +75,18 @@ void LongNameMap::Release()
     }
 }
 
-const char* LongNameMap::Find(const char* originalName) const
+TString LongNameMap::Map(const TString& originalName)
 {
-    std::map<std::string, std::string>::const_iterator it = mLongNameMap.find(
-        originalName);
+    TScopedLock lock(&gLongNameMapLock);
+    std::string name(originalName.c_str());
+    std::map<std::string, std::string>::const_iterator it = mLongNameMap.find(name);
     if (it != mLongNameMap.end())
-        return (*it).second.c_str();
-    return NULL;
-}
+        return it->second.c_str();
 
-void LongNameMap::Insert(const char* originalName, const char* mappedName)
-{
+    TString mappedName = mapLongName(mLongNameMap.size(), originalName, true);
     mLongNameMap.insert(std::map<std::string, std::string>::value_type(
-        originalName, mappedName));
-}
-
-size_t LongNameMap::Size() const
-{
-    return mLongNameMap.size();
+        name, mappedName.c_str()));
+    return mappedName;
 }
 
 MapLongVariableNames::MapLongVariableNames(LongNameMap* globalMap)
@@ -91,8 +105,7 @@ void MapLongVariableNames::visitSymbol(TIntermSymbol* symbol)
           case EvqInvariantVaryingIn:
           case EvqInvariantVaryingOut:
           case EvqUniform:
-            symbol->setSymbol(
-                mapGlobalLongName(symbol->getSymbol()));
+            symbol->setSymbol(mGlobalMap->Map(symbol->getSymbol()));
             break;
           default:
             symbol->setSymbol(
@@ -101,15 +114,3 @@ void MapLongVariableNames::visitSymbol(TIntermSymbol* symbol)
         };
     }
 }
-
-TString MapLongVariableNames::mapGlobalLongName(const TString& name)
-{
-    ASSERT(mGlobalMap);
-    const char* mappedName = mGlobalMap->Find(name.c_str());
-    if (mappedName != NULL)
-        return mappedName;
-    size_t id = mGlobalMap->Size();
-    TString rt = mapLongName(id, name, true);
-    mGlobalMap->Insert(name.c_str(), rt.c_str());
-    return rt;
-}
@@ -18,26 +18,33 @@
 // This is a ref-counted singleton. GetInstance() returns a pointer to the
 // singleton, and after use, call Release(). GetInstance() and Release() should
 // be paired.
+//
+// The map is shared by all compilers, possibly on different threads, and is
+// guarded by a lock created by InitializeLock(). Global names are numbered in
+// the order the process first sees them, so the same name maps to the same
+// short name in every shader.
 class LongNameMap {
 public:
+    static bool InitializeLock();
+    static void FreeLock();
+
     static LongNameMap* GetInstance();
     void Release();
 
-    // Return the mapped name if <originalName, mappedName> is in the map;
-    // otherwise, return NULL.
-    const char* Find(const char* originalName) const;
+    // Return the mapped name of a global long name, mapping it first if it
+    // is not in the map yet.
+    TString Map(const TString& originalName);
 
-    // Insert a pair into the map.
-    void Insert(const char* originalName, const char* mappedName);
-
-    // Return the number of entries in the map.
-    size_t Size() const;
+    // Return a number that differs between successive instances. Names are
+    // only mapped consistently by the same instance.
+    unsigned int getSerial() const { return serial; }
 
 private:
     LongNameMap();
     ~LongNameMap();
 
     size_t refCount;
+    unsigned int serial;
     std::map<std::string, std::string> mLongNameMap;
 };
 
@@ -50,8 +57,6 @@ public:
     virtual void visitSymbol(TIntermSymbol*);
 
 private:
-    TString mapGlobalLongName(const TString& name);
-
     LongNameMap* mGlobalMap;
 };
 
@@ -116,8 +116,8 @@ void OutputHLSL::output()
     mContext.treeRoot->traverse(this);   // Output the body first to determine what has to go in the header
     header();
 
-    mContext.infoSink().obj << mHeader.c_str();
-    mContext.infoSink().obj << mBody.c_str();
+    mContext.infoSink().obj << mHeader.str();
+    mContext.infoSink().obj << mBody.str();
 }
 
 TInfoSinkBase &OutputHLSL::getBodyStream()
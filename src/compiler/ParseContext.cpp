@@ -173,7 +173,7 @@ void TParseContext::recover()
 }
 
 //
-// Used by flex/bison to output all syntax and parsing errors.
+// Used by the lexer and bison to output all syntax and parsing errors.
 //
 void TParseContext::error(const TSourceLoc& loc,
                           const char* reason, const char* token, 
@@ -197,11 +197,6 @@ void TParseContext::warning(const TSourceLoc& loc,
                           srcLoc, reason, token, extraInfo);
 }
 
-void TParseContext::trace(const char* str)
-{
-    diagnostics.writeDebug(str);
-}
-
 //
 // Same error message for all places assignments don't work.
 //
@@ -923,7 +918,7 @@ const TFunction* TParseContext::findFunction(const TSourceLoc& line, TFunction*
     // If a function is found, check for one with a matching argument list.
     const TSymbol* symbol = symbolTable.find(call->getName(), builtIn);
     if (symbol == 0 || symbol->isFunction()) {
-        symbol = symbolTable.find(call->getMangledName(), builtIn);
+        symbol = symbolTable.findFunction(*call, builtIn);
     }
 
     if (symbol == 0) {
@@ -1582,7 +1577,7 @@ TIntermTyped* TParseContext::addIndexExpression(TIntermTyped *baseExpression, co
 // Returns 0 for success.
 //
 int PaParseStrings(size_t count, const char* const string[], const int length[],
-                   TParseContext* context) {
+                   TParseContext* context, bool allowsEmpty) {
     if ((count == 0) || (string == NULL))
         return 1;
 
@@ -1590,7 +1585,7 @@ int PaParseStrings(size_t count, const char* const string[], const int length[],
         return 1;
 
     int error = glslang_scan(count, string, length, context);
-    if (!error)
+    if (!error && !(allowsEmpty && glslang_is_empty(context)))
         error = glslang_parse(context);
 
     glslang_finalize(context);
@@ -25,7 +25,7 @@ struct TMatrixFields {
 // they can be passed to the parser without needing a global.
 //
 struct TParseContext {
-    TParseContext(TSymbolTable& symt, TExtensionBehavior& ext, TIntermediate& interm, ShShaderType type, ShShaderSpec spec, int options, bool checksPrecErrors, const char* sourcePath, TInfoSink& is) :
+    TParseContext(TSymbolTable& symt, TExtensionBehavior& ext, const pp::PredefinedMacroSet* predefinedMacros, TIntermediate& interm, ShShaderType type, ShShaderSpec spec, int options, bool checksPrecErrors, const char* sourcePath, TInfoSink& is) :
             intermediate(interm),
             symbolTable(symt),
             shaderType(type),
@@ -40,7 +40,7 @@ struct TParseContext {
             checksPrecisionErrors(checksPrecErrors),
             diagnostics(is),
             directiveHandler(ext, diagnostics),
-            preprocessor(&diagnostics, &directiveHandler),
+            preprocessor(&diagnostics, &directiveHandler, predefinedMacros),
             scanner(NULL) {  }
     TIntermediate& intermediate; // to hold and build a parse tree
     TSymbolTable& symbolTable;   // symbol table that goes with the language currently being parsed
@@ -67,7 +67,6 @@ struct TParseContext {
                const char* extraInfo="");
     void warning(const TSourceLoc& loc, const char* reason, const char* token,
                  const char* extraInfo="");
-    void trace(const char* str);
     void recover();
 
     bool parseVectorFields(const TString&, int vecSize, TVectorFields&, const TSourceLoc& line);
@@ -128,7 +127,9 @@ struct TParseContext {
     bool structNestingErrorCheck(const TSourceLoc& line, const TField& field);
 };
 
+// If allowsEmpty is true, strings that hold nothing but directives are
+// parsed without errors, leaving the tree root NULL.
 int PaParseStrings(size_t count, const char* const string[], const int length[],
-                   TParseContext* context);
+                   TParseContext* context, bool allowsEmpty = false);
 
 #endif // _PARSER_HELPER_INCLUDED_
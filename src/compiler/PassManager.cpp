@@ -0,0 +1,199 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#include "compiler/PassManager.h"
+
+#include <algorithm>
+
+#include "compiler/EventTracer.h"
+#include "compiler/StaticIntermTraverser.h"
+#include "compiler/osinclude.h"
+
+namespace {
+
+//
+// Visits each node with the traversers of several passes, in the order they
+// were added. A traverser that returns false from a pre-visit is left out
+// until the post-visit of the node, which it does not get, as on its own.
+//
+class TFusedTraverser : public TStaticIntermTraverser<TFusedTraverser> {
+public:
+    TFusedTraverser() : TStaticIntermTraverser<TFusedTraverser>(true, false, true) { }
+
+    void add(TIntermTraverser* traverser, bool usesPath)
+    {
+        ASSERT(!traverser->inVisit && !traverser->rightToLeft);
+        Member member = { traverser, usesPath, NULL };
+        mMembers.push_back(member);
+    }
+
+    void visitSymbol(TIntermSymbol* node)
+    {
+        for (MemberList::iterator member = mMembers.begin(); member != mMembers.end(); ++member) {
+            if (member->skipped == NULL)
+                member->traverser->visitSymbol(node);
+        }
+    }
+    void visitConstantUnion(TIntermConstantUnion* node)
+    {
+        for (MemberList::iterator member = mMembers.begin(); member != mMembers.end(); ++member) {
+            if (member->skipped == NULL)
+                member->traverser->visitConstantUnion(node);
+        }
+    }
+    bool visitBinary(Visit visit, TIntermBinary* node)
+    {
+        return visitNode(visit, node, &TIntermTraverser::visitBinary);
+    }
+    bool visitUnary(Visit visit, TIntermUnary* node)
+    {
+        return visitNode(visit, node, &TIntermTraverser::visitUnary);
+    }
+    bool visitSelection(Visit visit, TIntermSelection* node)
+    {
+        return visitNode(visit, node, &TIntermTraverser::visitSelection);
+    }
+    bool visitAggregate(Visit visit, TIntermAggregate* node)
+    {
+        return visitNode(visit, node, &TIntermTraverser::visitAggregate);
+    }
+    bool visitLoop(Visit visit, TIntermLoop* node)
+    {
+        return visitNode(visit, node, &TIntermTraverser::visitLoop);
+    }
+    bool visitBranch(Visit visit, TIntermBranch* node)
+    {
+        // A branch without an expression has no children to keep a path to.
+        return visitNode(visit, node, &TIntermTraverser::visitBranch,
+                         node->getExpression() != NULL);
+    }
+
+    // The members keep their own paths.
+    void incrementDepth(TIntermNode*) { }
+    void decrementDepth() { }
+
+private:
+    struct Member {
+        TIntermTraverser* traverser;
+        bool usesPath;
+        // The node whose subtree the traverser skips, if any.
+        TIntermNode* skipped;
+    };
+    typedef TVector<Member> MemberList;
+
+    // Returns false if none of the traversers visits the children of node.
+    template <typename T>
+    bool visitNode(Visit visit, T* node, bool (TIntermTraverser::*visitFunction)(Visit, T*),
+                   bool hasChildren = true)
+    {
+        if (visit == PreVisit) {
+            bool visitChildren = false;
+            for (MemberList::iterator member = mMembers.begin(); member != mMembers.end(); ++member) {
+                if (member->skipped != NULL)
+                    continue;
+                TIntermTraverser* traverser = member->traverser;
+                if (traverser->preVisit && !(traverser->*visitFunction)(PreVisit, node)) {
+                    member->skipped = node;
+                    continue;
+                }
+                if (member->usesPath && hasChildren)
+                    traverser->incrementDepth(node);
+                visitChildren = true;
+            }
+            if (!visitChildren) {
+                // The node gets no post-visit to resume the traversers.
+                for (MemberList::iterator member = mMembers.begin(); member != mMembers.end(); ++member) {
+                    if (member->skipped == node)
+                        member->skipped = NULL;
+                }
+            }
+            return visitChildren;
+        }
+
+        ASSERT(visit == PostVisit);
+        for (MemberList::iterator member = mMembers.begin(); member != mMembers.end(); ++member) {
+            if (member->skipped == node) {
+                member->skipped = NULL;
+                continue;
+            }
+            if (member->skipped != NULL)
+                continue;
+            TIntermTraverser* traverser = member->traverser;
+            if (member->usesPath && hasChildren)
+                traverser->decrementDepth();
+            if (traverser->postVisit)
+                (traverser->*visitFunction)(PostVisit, node);
+        }
+        return true;
+    }
+
+    MemberList mMembers;
+};
+
+}  // namespace
+
+TPassManager::TPassManager(ShPassTimings* timings)
+    : mTimings(timings)
+{
+}
+
+void TPassManager::addPass(ShCompilePass pass, TIntermTraverser* traverser,
+                           unsigned int runsAfter, bool usesPath)
+{
+    Pass added = { pass, traverser, usesPath, 0 };
+    if (!mPasses.empty()) {
+        const Pass& last = mPasses.back();
+        added.traversal = last.traversal;
+        bool fusable = !traverser->inVisit && !traverser->rightToLeft;
+        bool lastFusable = !last.traverser->inVisit && !last.traverser->rightToLeft;
+        if (!fusable || !lastFusable)
+            ++added.traversal;
+    }
+    for (PassList::const_iterator iter = mPasses.begin(); iter != mPasses.end(); ++iter) {
+        if (runsAfter & PassBit(iter->pass))
+            added.traversal = std::max(added.traversal, iter->traversal + 1);
+    }
+    mPasses.push_back(added);
+}
+
+int TPassManager::run(TIntermNode* root)
+{
+    int numTraversals = 0;
+    PassList::const_iterator begin = mPasses.begin();
+    while (begin != mPasses.end()) {
+        PassList::const_iterator end = begin + 1;
+        while (end != mPasses.end() && end->traversal == begin->traversal)
+            ++end;
+
+        TScopedTraceEvent event(end - begin == 1 ? GetPassEventName(begin->pass) : "SharedTraversal");
+        double start = OS_GetTimeSeconds();
+        if (end - begin == 1) {
+            root->traverse(begin->traverser);
+        } else {
+            TFusedTraverser fused;
+            for (PassList::const_iterator iter = begin; iter != end; ++iter)
+                fused.add(iter->traverser, iter->usesPath);
+            fused.traverse(root);
+        }
+        if (mTimings) {
+            size_t nanoseconds = static_cast<size_t>((OS_GetTimeSeconds() - start) * 1e9);
+            if (end - begin == 1) {
+                mTimings->passNanoseconds[begin->pass] += nanoseconds;
+            } else {
+                // Timing each visit would cost more than the traversals
+                // save by being shared.
+                mTimings->sharedNanoseconds += nanoseconds;
+                for (PassList::const_iterator iter = begin; iter != end; ++iter)
+                    mTimings->sharedPasses |= PassBit(iter->pass);
+            }
+        }
+
+        ++numTraversals;
+        begin = end;
+    }
+    mPasses.clear();
+    return numTraversals;
+}
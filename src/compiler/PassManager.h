@@ -0,0 +1,58 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#ifndef COMPILER_PASS_MANAGER_H_
+#define COMPILER_PASS_MANAGER_H_
+
+#include "GLSLANG/ShaderLang.h"
+
+#include "compiler/intermediate.h"
+
+// Returns the bit of pass in the runsAfter masks of TPassManager::addPass().
+inline unsigned int PassBit(ShCompilePass pass) { return 1u << pass; }
+
+//
+// Runs the passes that visit the tree with a traverser in as few traversals
+// of the tree as their ordering allows. The passes sharing a traversal visit
+// each node in the order they were added, each as it would on its own: a
+// pass that returns false from a pre-visit skips the subtree of the node
+// while the others go on.
+//
+// A pass runs in a later traversal than the passes it runs after, and than
+// those added before it. Traversers with in-visits or right-to-left
+// traversals get a traversal of their own.
+//
+class TPassManager {
+public:
+    // Charges the traversals to timings if given: a traversal of a single
+    // pass to the pass, and a shared traversal to the shared time.
+    explicit TPassManager(ShPassTimings* timings = NULL);
+
+    // Adds a pass that traverses the tree with traverser. runsAfter is the
+    // mask of PassBit()s of the added passes that must have traversed the
+    // whole tree before this one starts. If usesPath is true, the traverser
+    // keeps its path, and so its getParentNode(), as it would on its own.
+    void addPass(ShCompilePass pass, TIntermTraverser* traverser,
+                 unsigned int runsAfter = 0, bool usesPath = false);
+
+    // Runs the added passes over the tree at root, and removes them.
+    // Returns the number of traversals it took.
+    int run(TIntermNode* root);
+
+private:
+    struct Pass {
+        ShCompilePass pass;
+        TIntermTraverser* traverser;
+        bool usesPath;
+        int traversal;
+    };
+    typedef TVector<Pass> PassList;
+
+    ShPassTimings* mTimings;
+    PassList mPasses;
+};
+
+#endif  // COMPILER_PASS_MANAGER_H_
@@ -17,6 +17,11 @@
 
 OS_TLSIndex PoolIndex = OS_INVALID_TLS_INDEX;
 
+// Popped multi-page allocations are kept for re-use until they add up to
+// this many bytes. Shaders big enough to need them tend to be compiled
+// again, with the same large blocks.
+static const size_t maxLargeFreeBytes = 512 * 1024;
+
 bool InitializePoolIndex()
 {
     assert(PoolIndex == OS_INVALID_TLS_INDEX);
@@ -53,9 +58,13 @@ TPoolAllocator::TPoolAllocator(int growthIncrement, int allocationAlignment) :
     pageSize(growthIncrement),
     alignment(allocationAlignment),
     freeList(0),
+    largeFreeList(0),
+    largeFreeBytes(0),
     inUseList(0),
-    numCalls(0),
-    totalBytes(0)
+    numAllocations(0),
+    allocatedBytes(0),
+    numPages(0),
+    peakPages(0)
 {
     //
     // Don't allow page sizes we know are smaller than all common
@@ -111,6 +120,11 @@ TPoolAllocator::~TPoolAllocator()
         delete [] reinterpret_cast<char*>(freeList);
         freeList = next;
     }
+    while (largeFreeList) {
+        tHeader* next = largeFreeList->nextPage;
+        delete [] reinterpret_cast<char*>(largeFreeList);
+        largeFreeList = next;
+    }
 }
 
 // Support MSVC++ 6.0
@@ -166,7 +180,8 @@ void TPoolAllocator::push()
 // that have occurred since the last push(), or since the
 // last pop(), or since the object's creation.
 //
-// The deallocated pages are saved for future allocations.
+// The deallocated pages are saved for future allocations, and so are
+// multi-page allocations while they fit in maxLargeFreeBytes.
 //
 void TPoolAllocator::pop()
 {
@@ -179,11 +194,19 @@ void TPoolAllocator::pop()
     while (inUseList != page) {
         // invoke destructor to free allocation list
         inUseList->~tHeader();
-        
+        numPages -= inUseList->pageCount;
+
         tHeader* nextInUse = inUseList->nextPage;
-        if (inUseList->pageCount > 1)
-            delete [] reinterpret_cast<char*>(inUseList);
-        else {
+        if (inUseList->pageCount > 1) {
+            size_t blockBytes = inUseList->pageCount * pageSize;
+            if (largeFreeBytes + blockBytes <= maxLargeFreeBytes) {
+                inUseList->nextPage = largeFreeList;
+                largeFreeList = inUseList;
+                largeFreeBytes += blockBytes;
+            } else {
+                delete [] reinterpret_cast<char*>(inUseList);
+            }
+        } else {
             inUseList->nextPage = freeList;
             freeList = inUseList;
         }
@@ -205,11 +228,8 @@ void TPoolAllocator::popAll()
 
 void* TPoolAllocator::allocate(size_t numBytes)
 {
-    //
-    // Just keep some interesting statistics.
-    //
-    ++numCalls;
-    totalBytes += numBytes;
+    ++numAllocations;
+    allocatedBytes += numBytes;
 
     // If we are using guard blocks, all allocations are bracketed by
     // them: [guardblock][allocation][guardblock].  numBytes is how
@@ -245,14 +265,38 @@ void* TPoolAllocator::allocate(size_t numBytes)
         // Detect integer overflow.
         if (numBytesToAlloc < allocationSize)
             return 0;
-
-        tHeader* memory = reinterpret_cast<tHeader*>(::new char[numBytesToAlloc]);
-        if (memory == 0)
+        size_t pageCount = (numBytesToAlloc + pageSize - 1) / pageSize;
+        if (pageCount > static_cast<size_t>(-1) / pageSize)
             return 0;
 
+        //
+        // Re-use the smallest popped multi-page allocation that is large
+        // enough, if any.  Otherwise, round the new one up to whole pages,
+        // so that it can be re-used for any request of as many pages.
+        //
+        tHeader** bestFit = 0;
+        for (tHeader** block = &largeFreeList; *block; block = &(*block)->nextPage) {
+            if ((*block)->pageCount >= pageCount &&
+                (!bestFit || (*block)->pageCount < (*bestFit)->pageCount))
+                bestFit = block;
+        }
+
+        tHeader* memory;
+        if (bestFit) {
+            memory = *bestFit;
+            *bestFit = memory->nextPage;
+            pageCount = memory->pageCount;
+            largeFreeBytes -= pageCount * pageSize;
+        } else {
+            memory = reinterpret_cast<tHeader*>(::new char[pageCount * pageSize]);
+            if (memory == 0)
+                return 0;
+        }
+
         // Use placement-new to initialize header
-        new(memory) tHeader(inUseList, (numBytesToAlloc + pageSize - 1) / pageSize);
+        new(memory) tHeader(inUseList, pageCount);
         inUseList = memory;
+        addPages(memory->pageCount);
 
         currentPageOffset = pageSize;  // make next allocation come from a new page
 
@@ -276,13 +320,39 @@ void* TPoolAllocator::allocate(size_t numBytes)
     // Use placement-new to initialize header
     new(memory) tHeader(inUseList, 1);
     inUseList = memory;
-    
+    addPages(1);
+
     unsigned char* ret = reinterpret_cast<unsigned char *>(inUseList) + headerSkip;
     currentPageOffset = (headerSkip + allocationSize + alignmentMask) & ~alignmentMask;
 
     return initializeAllocation(inUseList, ret, numBytes);
 }
 
+void TPoolAllocator::deallocate(void* memory, size_t numBytes)
+{
+#ifndef GUARD_BLOCKS
+    //
+    // Only the last allocation of the current page can be given back, and
+    // not if the page belongs to the allocations made before the last
+    // push(), whose offset pop() restores.
+    //
+    if (inUseList == 0 || inUseList->pageCount != 1)
+        return;
+    if (!stack.empty() && stack.back().page == inUseList)
+        return;
+
+    unsigned char* page = reinterpret_cast<unsigned char*>(inUseList);
+    unsigned char* end = page + currentPageOffset;
+    unsigned char* start = static_cast<unsigned char*>(memory);
+    if (start < page + headerSkip || start >= end)
+        return;
+
+    size_t offset = start - page;
+    if (((offset + numBytes + alignmentMask) & ~alignmentMask) == currentPageOffset)
+        currentPageOffset = offset;
+#endif
+}
+
 
 //
 // Check all allocations in a list for damage by calling check on each.
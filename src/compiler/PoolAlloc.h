@@ -105,9 +105,9 @@ private:
 // repositories of free pages or used pages.
 //
 // Page stacks are linked together with a simple header at the beginning
-// of each allocation obtained from the underlying OS.  Multi-page allocations
-// are returned to the OS.  Individual page allocations are kept for future
-// re-use.
+// of each allocation obtained from the underlying OS.  Individual page
+// allocations are kept for future re-use.  Multi-page allocations are kept
+// too, up to maxLargeFreeBytes, and are otherwise returned to the OS.
 //
 // The "page size" used is not, nor must it match, the underlying OS
 // page size.  But, having it be about that size or equal to a set of 
@@ -146,11 +146,34 @@ public:
     void* allocate(size_t numBytes);
 
     //
-    // There is no deallocate.  The point of this class is that
-    // deallocation can be skipped by the user of it, as the model
-    // of use is to simultaneously deallocate everything at once
-    // by calling pop(), and to not have to solve memory leak problems.
+    // Statistics, for instrumenting the users of the pool. Pages are counted
+    // while they are in use, from the moment they are taken from the OS or
+    // the free list until the pop() that frees them. Multi-page allocations
+    // count for as many pages as they span.
     //
+    size_t getPageSize() const { return pageSize; }
+    size_t getNumAllocations() const { return numAllocations; }
+    size_t getAllocatedBytes() const { return allocatedBytes; }
+    size_t getNumPages() const { return numPages; }
+    // The most pages in use at once since the pool was created, or since
+    // the last call to resetPeakPages().
+    size_t getPeakPages() const { return peakPages; }
+    void resetPeakPages() { peakPages = numPages; }
+
+    //
+    // Call deallocate() to give back the memory of the most recent
+    // allocation still in the current page, so that the next allocation
+    // reuses it.  Any other memory is only freed by pop(), which makes it
+    // safe, if useless, to deallocate anything.  Containers free their old
+    // buffers and temporaries die in the reverse order of their creation,
+    // so this reclaims much of the garbage a compile leaves in the pool.
+    //
+    // The point of this class is still that deallocation can be skipped by
+    // the user of it, as the model of use is to simultaneously deallocate
+    // everything at once by calling pop(), and to not have to solve memory
+    // leak problems.
+    //
+    void deallocate(void* memory, size_t numBytes);
 
 protected:
     friend struct tHeader;
@@ -184,6 +207,13 @@ protected:
     };
     typedef std::vector<tAllocState> tAllocStack;
 
+    // Counts pages put in use, and the most in use at once.
+    void addPages(size_t count) {
+        numPages += count;
+        if (numPages > peakPages)
+            peakPages = numPages;
+    }
+
     // Track allocations if and only if we're using guard blocks
     void* initializeAllocation(tHeader* block, unsigned char* memory, size_t numBytes) {
 #ifdef GUARD_BLOCKS
@@ -203,11 +233,15 @@ protected:
                             //      up to make it aligned
     size_t currentPageOffset;  // next offset in top of inUseList to allocate from
     tHeader* freeList;      // list of popped memory
+    tHeader* largeFreeList; // list of popped multi-page memory
+    size_t largeFreeBytes;  // size of largeFreeList
     tHeader* inUseList;     // list of all memory currently being used
     tAllocStack stack;      // stack of where to allocate from, to partition pool
 
-    int numCalls;           // just an interesting statistic
-    size_t totalBytes;      // just an interesting statistic
+    size_t numAllocations;  // calls to allocate()
+    size_t allocatedBytes;  // bytes requested from allocate()
+    size_t numPages;        // pages in inUseList
+    size_t peakPages;       // high-water mark of numPages
 private:
     TPoolAllocator& operator=(const TPoolAllocator&);  // dont allow assignment operator
     TPoolAllocator(const TPoolAllocator&);  // dont allow default copy constructor
@@ -226,8 +260,9 @@ extern void SetGlobalPoolAllocator(TPoolAllocator* poolAllocator);
 // This STL compatible allocator is intended to be used as the allocator
 // parameter to templatized STL containers, like vector and map.
 //
-// It will use the pools for allocation, and not
-// do any deallocation, but will still do destruction.
+// It will use the pools for allocation, and hand deallocations to
+// TPoolAllocator::deallocate(), which mostly ignores them. It will still
+// do destruction.
 //
 template<class T>
 class pool_allocator {
@@ -260,6 +295,15 @@ public:
     template<class Other>
     pool_allocator(const pool_allocator<Other>& p) : allocator(&p.getAllocator()) { }
 
+    // Containers that are copy-constructed allocate from the current global
+    // pool rather than from the pool of the container they were copied from.
+    // Long-lived pools, like the one holding the shared built-in symbols,
+    // therefore do not grow when their contents are copied during a compile.
+    pool_allocator<T> select_on_container_copy_construction() const {
+        TPoolAllocator* current = GetGlobalPoolAllocator();
+        return current ? pool_allocator<T>(*current) : *this;
+    }
+
 #if defined(__SUNPRO_CC) && !defined(_RWSTD_ALLOCATOR)
     // libCStd on some platforms have a different allocate/deallocate interface.
     // Caller pre-bakes sizeof(T) into 'n' which is the number of bytes to be
@@ -270,7 +314,9 @@ public:
     void* allocate(size_type n, const void*) {
         return getAllocator().allocate(n);
     }
-    void deallocate(void*, size_type) {}
+    void deallocate(void* p, size_type n) {
+        getAllocator().deallocate(p, n);
+    }
 #else
     pointer allocate(size_type n) { 
         return reinterpret_cast<pointer>(getAllocator().allocate(n * sizeof(T)));
@@ -278,7 +324,9 @@ public:
     pointer allocate(size_type n, const void*) { 
         return reinterpret_cast<pointer>(getAllocator().allocate(n * sizeof(T)));
     }
-    void deallocate(pointer, size_type) {}
+    void deallocate(pointer p, size_type n) {
+        getAllocator().deallocate(p, n * sizeof(T));
+    }
 #endif  // _RWSTD_ALLOCATOR
 
     void construct(pointer p, const T& val) { new ((void *)p) T(val); }
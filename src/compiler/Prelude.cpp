@@ -0,0 +1,91 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#include "compiler/Prelude.h"
+
+#include <string.h>
+
+#include "compiler/CopyTree.h"
+#include "compiler/ParseContext.h"
+
+TPrelude::TPrelude(const TSymbolTable& builtIns, const char* const strings[], size_t numStrings)
+    : treeRoot(NULL)
+{
+    for (size_t i = 0; i < numStrings; ++i) {
+        size_t length = strlen(strings[i]);
+        source.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        source.append(strings[i], length);
+    }
+
+    TPoolAllocator* previousAllocator = GetGlobalPoolAllocator();
+    allocator.push();
+    SetGlobalPoolAllocator(&allocator);
+
+    symbolTable.pushSharedBuiltInLevel(builtIns);
+    symbolTable.push();
+
+    SetGlobalPoolAllocator(previousAllocator);
+}
+
+TPrelude::~TPrelude()
+{
+}
+
+void TPrelude::save(const TParseContext& parseContext, const TExtensionBehavior& initialBehavior)
+{
+    treeRoot = parseContext.treeRoot;
+    parseContext.preprocessor.saveMacros(&macros);
+    pragma = parseContext.pragma();
+
+    const TExtensionBehavior& behavior = parseContext.extensionBehavior();
+    for (TExtensionBehavior::const_iterator iter = behavior.begin();
+         iter != behavior.end(); ++iter) {
+        TExtensionBehavior::const_iterator initial = initialBehavior.find(iter->first);
+        if (initial == initialBehavior.end() || initial->second != iter->second)
+            extensionBehavior[iter->first] = iter->second;
+    }
+}
+
+void TPrelude::restore(TParseContext& parseContext, TExtensionBehavior* behavior) const
+{
+    for (TExtensionBehavior::const_iterator iter = extensionBehavior.begin();
+         iter != extensionBehavior.end(); ++iter)
+        (*behavior)[iter->first] = iter->second;
+
+    parseContext.preprocessor.defineMacros(macros);
+    parseContext.directiveHandler.setPragma(pragma);
+}
+
+TIntermNode* TPrelude::prependTo(TIntermNode* root) const
+{
+    TIntermNode* declarations = CopyTree(treeRoot);
+    if (declarations == NULL)
+        return root;
+    if (root == NULL)
+        return declarations;
+
+    // Join the declarations the way the parser grows the translation unit.
+    TIntermAggregate* aggregate = declarations->getAsAggregate();
+    if (!aggregate || aggregate->getOp() != EOpNull) {
+        aggregate = new TIntermAggregate;
+        aggregate->getSequence().push_back(declarations);
+    }
+
+    TIntermSequence& sequence = aggregate->getSequence();
+    TIntermAggregate* rootAggregate = root->getAsAggregate();
+    if (rootAggregate && rootAggregate->getOp() == EOpNull) {
+        TIntermSequence& rootSequence = rootAggregate->getSequence();
+        sequence.insert(sequence.end(), rootSequence.begin(), rootSequence.end());
+    } else {
+        sequence.push_back(root);
+    }
+
+    TSourceLoc line = declarations->getLine();
+    line.last_file = root->getLine().last_file;
+    line.last_line = root->getLine().last_line;
+    aggregate->setLine(line);
+    return aggregate;
+}
@@ -0,0 +1,71 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#ifndef COMPILER_PRELUDE_H_
+#define COMPILER_PRELUDE_H_
+
+#include "compiler/ExtensionBehavior.h"
+#include "compiler/Pragma.h"
+#include "compiler/SymbolTable.h"
+#include "compiler/preprocessor/Preprocessor.h"
+
+class TIntermNode;
+struct TParseContext;
+
+//
+// The global scope left by compiling a prelude: its symbols and tree, and
+// the macros, pragmas and extension behavior set by its directives. It is
+// parsed once, into a pool of its own, and then each compile of a compiler
+// starts from it as if the prelude came before the shader strings.
+//
+// The prelude is never modified by the compiles. They borrow its symbols,
+// copying the functions they may define, and copy its tree, since the
+// passes after parsing modify the tree.
+//
+class TPrelude {
+public:
+    // The symbol table of the prelude is layered on builtIns, which must
+    // outlive the prelude.
+    TPrelude(const TSymbolTable& builtIns, const char* const strings[], size_t numStrings);
+    ~TPrelude();
+
+    // Holds the memory of the prelude. It must be the current pool while
+    // the prelude is parsed.
+    TPoolAllocator& getAllocator() { return allocator; }
+    // The symbol table to parse the prelude into, with its global level
+    // pushed.
+    TSymbolTable& getSymbolTable() { return symbolTable; }
+    // The strings of the prelude, with their lengths, for the keys of the
+    // cached translations.
+    const TPersistString& getSource() const { return source; }
+
+    // Keeps what parseContext left after parsing the prelude. The extension
+    // behavior is kept as far as it differs from initialBehavior.
+    void save(const TParseContext& parseContext, const TExtensionBehavior& initialBehavior);
+    // Makes parseContext, which must not have parsed anything yet, start
+    // where the prelude left off. Its symbol table must have the global
+    // level of the prelude pushed.
+    void restore(TParseContext& parseContext, TExtensionBehavior* extensionBehavior) const;
+    // Returns the tree of a shader parsed after restore(), root, with a copy
+    // of the declarations of the prelude before its own.
+    TIntermNode* prependTo(TIntermNode* root) const;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(TPrelude);
+
+    // Declared first, so that the symbol table is destroyed before the
+    // memory it is in.
+    TPoolAllocator allocator;
+    TSymbolTable symbolTable;
+    TPersistString source;
+
+    TIntermNode* treeRoot;
+    pp::MacroSnapshot macros;
+    TPragma pragma;
+    TExtensionBehavior extensionBehavior;
+};
+
+#endif  // COMPILER_PRELUDE_H_
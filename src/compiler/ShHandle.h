@@ -22,12 +22,20 @@
 #include "compiler/InfoSink.h"
 #include "compiler/SymbolTable.h"
 #include "compiler/VariableInfo.h"
+#include "compiler/preprocessor/IncludeCache.h"
+#include "compiler/preprocessor/Preprocessor.h"
 #include "third_party/compiler/ArrayBoundsClamper.h"
 
+class DetectCallDepth;
 class LongNameMap;
+class TBuiltInSymbolTable;
 class TCompiler;
 class TDependencyGraph;
+class TPassManager;
+class TPrelude;
 class TranslatorHLSL;
+struct TParseContext;
+struct TTranslationResult;
 
 //
 // Helper function to identify specs that are based on the WebGL spec,
@@ -57,7 +65,7 @@ protected:
 //
 class TCompiler : public TShHandleBase {
 public:
-    TCompiler(ShShaderType type, ShShaderSpec spec);
+    TCompiler(ShShaderType type, ShShaderSpec spec, ShShaderOutput output);
     virtual ~TCompiler();
     virtual TCompiler* getAsCompiler() { return this; }
 
@@ -65,6 +73,9 @@ public:
     bool compile(const char* const shaderStrings[],
                  size_t numStrings,
                  int compileOptions);
+    // Parses the strings of a prelude, which the following compiles start
+    // from. Replaces the previous prelude, or removes it if numStrings is 0.
+    bool compilePrelude(const char* const shaderStrings[], size_t numStrings);
 
     // Get results of the last compilation.
     TInfoSink& getInfoSink() { return infoSink; }
@@ -72,6 +83,18 @@ public:
     const TVariableInfoList& getUniforms() const { return uniforms; }
     const TVariableInfoList& getVaryings() const { return varyings; }
     int getMappedNameMaxLength() const;
+    const ShMemoryStatistics& getMemoryStatistics() const { return memoryStatistics; }
+    const ShPassTimings& getPassTimings() const { return passTimings; }
+    // Hands the object code to callback as it is generated, instead of
+    // keeping it in the info sink.
+    void setObjectCodeCallback(ShObjectCodeCallback callback, void* userData) {
+        infoSink.obj.setCallback(callback, userData);
+    }
+    // Enables #include, resolved through callback.
+    void setIncludeCallback(ShIncludeCallback callback, void* userData) {
+        includeCallback = callback;
+        includeCallbackData = userData;
+    }
 
     ShHashFunction64 getHashFunction() const { return hashFunction; }
     NameMap& getNameMap() { return nameMap; }
@@ -80,36 +103,40 @@ public:
 protected:
     ShShaderType getShaderType() const { return shaderType; }
     ShShaderSpec getShaderSpec() const { return shaderSpec; }
+    // Copy the results of the last compilation to or from a cached
+    // translation.
+    virtual void saveResults(TTranslationResult* result) const;
+    virtual void restoreResults(const TTranslationResult& result);
     // Initialize symbol-table with built-in symbols.
     bool InitBuiltInSymbolTable(const ShBuiltInResources& resources);
     // Clears the results from the previous compilation.
     void clearResults();
-    // Return true if function recursion is detected or call depth exceeded.
-    bool detectCallDepth(TIntermNode* root, TInfoSink& infoSink, bool limitCallStackDepth);
+    // Returns true if the shader passes the checks the compile options ask
+    // for: the call depth, the minimum functionality mandated in GLSL 1.0
+    // spec Appendix A, the timing restrictions and the expression complexity.
+    // The checks share a traversal of the tree.
+    bool checkTree(TIntermNode* root, int compileOptions);
+    // Return false if function recursion is detected or call depth exceeded
+    // in the tree traversed by detect.
+    bool detectCallDepth(DetectCallDepth& detect);
     // Rewrites a shader's intermediate tree according to the CSS Shaders spec.
     void rewriteCSSShader(TIntermNode* root);
-    // Returns true if the given shader does not exceed the minimum
-    // functionality mandated in GLSL 1.0 spec Appendix A.
-    bool validateLimitations(TIntermNode* root);
-    // Collect info for all attribs, uniforms, varyings.
-    void collectVariables(TIntermNode* root);
-    // Map long variable names into shorter ones.
-    void mapLongVariableNames(TIntermNode* root);
+    // Collect info for all attribs, uniforms, varyings, in a pass of passes.
+    void collectVariables(TPassManager* passes);
+    // Map long variable names into shorter ones, in a pass of passes.
+    void mapLongVariableNames(TPassManager* passes);
     // Translate to object code.
-    virtual void translate(TIntermNode* root) = 0;
+    virtual void translate(TIntermNode* root, TParseContext& parseContext) = 0;
     // Returns true if, after applying the packing rules in the GLSL 1.017 spec
     // Appendix A, section 7, the shader does not use too many uniforms.
     bool enforcePackingRestrictions();
-    // Returns true if the shader passes the restrictions that aim to prevent timing attacks.
+    // Returns true if the fragment shader passes the restrictions that aim to
+    // prevent timing attacks.
     bool enforceTimingRestrictions(TIntermNode* root, bool outputGraph);
-    // Returns true if the shader does not use samplers.
-    bool enforceVertexShaderTimingRestrictions(TIntermNode* root);
     // Returns true if the shader does not use sampler dependent values to affect control 
     // flow or in operations whose time can depend on the input values.
     bool enforceFragmentShaderTimingRestrictions(const TDependencyGraph& graph);
-    // Return true if the maximum expression complexity below the limit.
-    bool limitExpressionComplexity(TIntermNode* root);
-    // Get built-in extensions with default behavior.
+    // Get built-in extensions with their behavior in the latest compile.
     const TExtensionBehavior& getExtensionBehavior() const;
     // Get the resources set by InitBuiltInSymbolTable
     const ShBuiltInResources& getResources() const;
@@ -119,8 +146,19 @@ protected:
     const BuiltInFunctionEmulator& getBuiltInFunctionEmulator() const;
 
 private:
+    // Compile without looking up the translation cache.
+    bool compileShader(const char* const shaderStrings[],
+                       size_t numStrings,
+                       int compileOptions);
+    // Return a key capturing everything the results of the compilation
+    // depend on.
+    TPersistString getTranslationCacheKey(const char* const shaderStrings[],
+                                          size_t numStrings,
+                                          int compileOptions) const;
+
     ShShaderType shaderType;
     ShShaderSpec shaderSpec;
+    ShShaderOutput outputType;
 
     int maxUniformVectors;
     int maxExpressionComplexity;
@@ -128,15 +166,30 @@ private:
 
     ShBuiltInResources compileResources;
 
-    // Built-in symbol table for the given language, spec, and resources.
-    // It is preserved from compile-to-compile.
+    // Symbol table whose built-in level is shared with the other compilers
+    // for the given language, spec, and resources. The built-in level is
+    // preserved from compile-to-compile.
     TSymbolTable symbolTable;
     // Built-in extensions with default behavior.
     TExtensionBehavior extensionBehavior;
+    // Built-in extensions with their behavior in the latest compile, which
+    // starts from the default behavior and the prelude's directives.
+    TExtensionBehavior compileExtensionBehavior;
     bool fragmentPrecisionHigh;
+    // Standard and extension macros, shared by the compiles.
+    pp::PredefinedMacroSet predefinedMacros;
+    // Provides the sources of #include, if set.
+    ShIncludeCallback includeCallback;
+    void* includeCallbackData;
+    // Tokens of the included sources, shared by the compiles.
+    pp::IncludeCache includeCache;
+    // Declarations the compiles start from, if any.
+    TPrelude* prelude;
 
     ArrayBoundsClamper arrayBoundsClamper;
     ShArrayIndexClampingStrategy clampingStrategy;
+    // Cached reference to the ref-counted table holding the built-in level.
+    TBuiltInSymbolTable* builtInSymbolTable;
     BuiltInFunctionEmulator builtInFunctionEmulator;
 
     // Results of compilation.
@@ -144,6 +197,8 @@ private:
     TVariableInfoList attribs;  // Active attributes in the compiled shader.
     TVariableInfoList uniforms;  // Active uniforms in the compiled shader.
     TVariableInfoList varyings;  // Varyings in the compiled shader.
+    ShMemoryStatistics memoryStatistics;  // Pool memory taken by the compile.
+    ShPassTimings passTimings;  // Time taken by the compile.
 
     // Cached copy of the ref-counted singleton.
     LongNameMap* longNameMap;
@@ -11,11 +11,14 @@
 
 #include "GLSLANG/ShaderLang.h"
 
+#include "compiler/EventTracer.h"
 #include "compiler/InitializeDll.h"
 #include "compiler/preprocessor/length_limits.h"
 #include "compiler/ShHandle.h"
+#include "compiler/TranslationCache.h"
 #include "compiler/TranslatorHLSL.h"
 #include "compiler/VariablePacker.h"
+#include "compiler/WorkStealingPool.h"
 
 //
 // This is the platform independent interface between an OGL driver
@@ -163,6 +166,53 @@ int ShCompile(
     return success ? 1 : 0;
 }
 
+void ShSetTranslationCacheSize(size_t maxSize)
+{
+    TTranslationCache::SetMaxSize(maxSize);
+}
+
+int ShSetTranslationCacheFile(const char* path)
+{
+    return TTranslationCache::SetPersistentStore(path) ? 1 : 0;
+}
+
+void ShSetTraceFunctionPointers(ShGetCategoryEnabledFlagFunc getCategoryEnabledFlag,
+                                ShAddTraceEventFunc addTraceEvent)
+{
+    SetTraceFunctions(getCategoryEnabledFlag, addTraceEvent);
+}
+
+static void CompileJob(size_t index, void* context)
+{
+    ShCompileJob& job = static_cast<ShCompileJob*>(context)[index];
+    job.compiler = ShConstructCompiler(job.type, job.spec, job.output, job.resources);
+    job.compiled = job.compiler ?
+        ShCompile(job.compiler, job.shaderStrings, job.numStrings, job.compileOptions) : 0;
+}
+
+//
+// Compile the given jobs on a work-stealing pool of threads. Each job gets
+// a compiler of its own, so that the jobs are independent; construction is
+// cheap next to compilation since compilers share their built-in symbols.
+//
+int ShCompileBatch(
+    ShCompileJob* jobs,
+    size_t numJobs,
+    int numThreads)
+{
+    if (jobs == 0 && numJobs > 0)
+        return 0;
+
+    TWorkStealingPool pool(numThreads);
+    pool.run(numJobs, CompileJob, jobs);
+
+    for (size_t i = 0; i < numJobs; ++i) {
+        if (!jobs[i].compiled)
+            return 0;
+    }
+    return 1;
+}
+
 void ShGetInfo(const ShHandle handle, ShShaderInfo pname, size_t* params)
 {
     if (!handle || !params)
@@ -219,6 +269,35 @@ void ShGetInfo(const ShHandle handle, ShShaderInfo pname, size_t* params)
     case SH_HASHED_NAMES_COUNT:
         *params = compiler->getNameMap().size();
         break;
+    case SH_TRANSLATION_CACHE_HITS:
+        *params = TTranslationCache::GetStatistics().hits;
+        break;
+    case SH_TRANSLATION_CACHE_PERSISTENT_HITS:
+        *params = TTranslationCache::GetStatistics().persistentHits;
+        break;
+    case SH_TRANSLATION_CACHE_MISSES:
+        *params = TTranslationCache::GetStatistics().misses;
+        break;
+    case SH_TRANSLATION_CACHE_EVICTIONS:
+        *params = TTranslationCache::GetStatistics().evictions;
+        break;
+    case SH_TRANSLATION_CACHE_SIZE:
+        *params = TTranslationCache::GetStatistics().size;
+        break;
+    case SH_TRANSLATION_CACHE_HIT_LATENCY:
+        {
+            TTranslationCacheStatistics statistics = TTranslationCache::GetStatistics();
+            *params = statistics.hits == 0 ? 0 :
+                static_cast<size_t>(1e9 * statistics.hitSeconds / statistics.hits);
+        }
+        break;
+    case SH_TRANSLATION_CACHE_MISS_LATENCY:
+        {
+            TTranslationCacheStatistics statistics = TTranslationCache::GetStatistics();
+            *params = statistics.misses == 0 ? 0 :
+                static_cast<size_t>(1e9 * statistics.missSeconds / statistics.misses);
+        }
+        break;
     default: UNREACHABLE();
     }
 }
@@ -255,6 +334,48 @@ void ShGetObjectCode(const ShHandle handle, char* objCode)
     strcpy(objCode, infoSink.obj.c_str());
 }
 
+void ShSetObjectCodeCallback(const ShHandle handle,
+                             ShObjectCodeCallback callback,
+                             void* userData)
+{
+    if (!handle)
+        return;
+
+    TShHandleBase* base = static_cast<TShHandleBase*>(handle);
+    TCompiler* compiler = base->getAsCompiler();
+    if (!compiler) return;
+
+    compiler->setObjectCodeCallback(callback, userData);
+}
+
+void ShSetIncludeCallback(const ShHandle handle,
+                          ShIncludeCallback callback,
+                          void* userData)
+{
+    if (!handle)
+        return;
+
+    TShHandleBase* base = static_cast<TShHandleBase*>(handle);
+    TCompiler* compiler = base->getAsCompiler();
+    if (!compiler) return;
+
+    compiler->setIncludeCallback(callback, userData);
+}
+
+int ShCompilePrelude(const ShHandle handle,
+                     const char* const shaderStrings[],
+                     size_t numStrings)
+{
+    if (!handle)
+        return 0;
+
+    TShHandleBase* base = static_cast<TShHandleBase*>(handle);
+    TCompiler* compiler = base->getAsCompiler();
+    if (!compiler) return 0;
+
+    return compiler->compilePrelude(shaderStrings, numStrings) ? 1 : 0;
+}
+
 void ShGetVariableInfo(const ShHandle handle,
                        ShShaderInfo varType,
                        int index,
@@ -371,13 +492,23 @@ void ShGetInfoPointer(const ShHandle handle, ShShaderInfo pname, void** params)
         return;
 
     TShHandleBase* base = static_cast<TShHandleBase*>(handle);
-    TranslatorHLSL* translator = base->getAsTranslatorHLSL();
-    if (!translator) return;
+    TCompiler* compiler = base->getAsCompiler();
+    if (!compiler) return;
 
     switch(pname)
     {
     case SH_ACTIVE_UNIFORMS_ARRAY:
-        *params = (void*)&translator->getUniforms();
+        {
+            TranslatorHLSL* translator = base->getAsTranslatorHLSL();
+            if (!translator) return;
+            *params = (void*)&translator->getUniforms();
+        }
+        break;
+    case SH_MEMORY_STATISTICS:
+        *params = (void*)&compiler->getMemoryStatistics();
+        break;
+    case SH_PASS_TIMINGS:
+        *params = (void*)&compiler->getPassTimings();
         break;
     default: UNREACHABLE();
     }
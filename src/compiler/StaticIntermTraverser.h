@@ -0,0 +1,240 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#ifndef COMPILER_STATIC_INTERM_TRAVERSER_H_
+#define COMPILER_STATIC_INTERM_TRAVERSER_H_
+
+#include "compiler/intermediate.h"
+
+//
+// Traverses the tree like TIntermTraverser, left to right, but calls the
+// visit methods of Derived directly: it dispatches on the kind of each node
+// rather than through TIntermNode::traverse(), so the visits of a pass can
+// be inlined into the traversal.
+//
+// Derived hides the visit methods it needs, as it would override them in a
+// TIntermTraverser. It may also hide incrementDepth() and decrementDepth(),
+// for example with empty ones if it does not use the path.
+//
+template <typename Derived>
+class TStaticIntermTraverser {
+public:
+    POOL_ALLOCATOR_NEW_DELETE();
+    TStaticIntermTraverser(bool preVisit = true, bool inVisit = false, bool postVisit = false) :
+            preVisit(preVisit),
+            inVisit(inVisit),
+            postVisit(postVisit),
+            depth(0),
+            maxDepth(0) {}
+
+    void traverse(TIntermNode* node);
+
+    void visitSymbol(TIntermSymbol*) {}
+    void visitConstantUnion(TIntermConstantUnion*) {}
+    bool visitBinary(Visit, TIntermBinary*) { return true; }
+    bool visitUnary(Visit, TIntermUnary*) { return true; }
+    bool visitSelection(Visit, TIntermSelection*) { return true; }
+    bool visitAggregate(Visit, TIntermAggregate*) { return true; }
+    bool visitLoop(Visit, TIntermLoop*) { return true; }
+    bool visitBranch(Visit, TIntermBranch*) { return true; }
+
+    int getMaxDepth() const { return maxDepth; }
+
+    void incrementDepth(TIntermNode* current)
+    {
+        depth++;
+        maxDepth = std::max(maxDepth, depth);
+        path.push_back(current);
+    }
+
+    void decrementDepth()
+    {
+        depth--;
+        path.pop_back();
+    }
+
+    TIntermNode* getParentNode()
+    {
+        return path.size() == 0 ? NULL : path.back();
+    }
+
+    const bool preVisit;
+    const bool inVisit;
+    const bool postVisit;
+
+protected:
+    int depth;
+    int maxDepth;
+
+    // All the nodes from root to the current node's parent during traversing.
+    TVector<TIntermNode*> path;
+
+private:
+    Derived* derived() { return static_cast<Derived*>(this); }
+
+    void traverseBinary(TIntermBinary* node);
+    void traverseUnary(TIntermUnary* node);
+    void traverseAggregate(TIntermAggregate* node);
+    void traverseSelection(TIntermSelection* node);
+    void traverseLoop(TIntermLoop* node);
+    void traverseBranch(TIntermBranch* node);
+};
+
+template <typename Derived>
+void TStaticIntermTraverser<Derived>::traverse(TIntermNode* node)
+{
+    switch (node->getKind()) {
+      case EIntermSymbol:
+        derived()->visitSymbol(static_cast<TIntermSymbol*>(node));
+        break;
+      case EIntermConstantUnion:
+        derived()->visitConstantUnion(static_cast<TIntermConstantUnion*>(node));
+        break;
+      case EIntermBinary:
+        traverseBinary(static_cast<TIntermBinary*>(node));
+        break;
+      case EIntermUnary:
+        traverseUnary(static_cast<TIntermUnary*>(node));
+        break;
+      case EIntermAggregate:
+        traverseAggregate(static_cast<TIntermAggregate*>(node));
+        break;
+      case EIntermSelection:
+        traverseSelection(static_cast<TIntermSelection*>(node));
+        break;
+      case EIntermLoop:
+        traverseLoop(static_cast<TIntermLoop*>(node));
+        break;
+      case EIntermBranch:
+        traverseBranch(static_cast<TIntermBranch*>(node));
+        break;
+    }
+}
+
+template <typename Derived>
+void TStaticIntermTraverser<Derived>::traverseBinary(TIntermBinary* node)
+{
+    bool visit = true;
+    if (preVisit)
+        visit = derived()->visitBinary(PreVisit, node);
+
+    if (visit) {
+        derived()->incrementDepth(node);
+        if (node->getLeft())
+            traverse(node->getLeft());
+        if (inVisit)
+            visit = derived()->visitBinary(InVisit, node);
+        if (visit && node->getRight())
+            traverse(node->getRight());
+        derived()->decrementDepth();
+    }
+
+    if (visit && postVisit)
+        derived()->visitBinary(PostVisit, node);
+}
+
+template <typename Derived>
+void TStaticIntermTraverser<Derived>::traverseUnary(TIntermUnary* node)
+{
+    bool visit = true;
+    if (preVisit)
+        visit = derived()->visitUnary(PreVisit, node);
+
+    if (visit) {
+        derived()->incrementDepth(node);
+        traverse(node->getOperand());
+        derived()->decrementDepth();
+    }
+
+    if (visit && postVisit)
+        derived()->visitUnary(PostVisit, node);
+}
+
+template <typename Derived>
+void TStaticIntermTraverser<Derived>::traverseAggregate(TIntermAggregate* node)
+{
+    bool visit = true;
+    if (preVisit)
+        visit = derived()->visitAggregate(PreVisit, node);
+
+    if (visit) {
+        derived()->incrementDepth(node);
+        TIntermSequence& sequence = node->getSequence();
+        for (TIntermSequence::iterator sit = sequence.begin(); sit != sequence.end(); sit++) {
+            traverse(*sit);
+            if (visit && inVisit && *sit != sequence.back())
+                visit = derived()->visitAggregate(InVisit, node);
+        }
+        derived()->decrementDepth();
+    }
+
+    if (visit && postVisit)
+        derived()->visitAggregate(PostVisit, node);
+}
+
+template <typename Derived>
+void TStaticIntermTraverser<Derived>::traverseSelection(TIntermSelection* node)
+{
+    bool visit = true;
+    if (preVisit)
+        visit = derived()->visitSelection(PreVisit, node);
+
+    if (visit) {
+        derived()->incrementDepth(node);
+        traverse(node->getCondition());
+        if (node->getTrueBlock())
+            traverse(node->getTrueBlock());
+        if (node->getFalseBlock())
+            traverse(node->getFalseBlock());
+        derived()->decrementDepth();
+    }
+
+    if (visit && postVisit)
+        derived()->visitSelection(PostVisit, node);
+}
+
+template <typename Derived>
+void TStaticIntermTraverser<Derived>::traverseLoop(TIntermLoop* node)
+{
+    bool visit = true;
+    if (preVisit)
+        visit = derived()->visitLoop(PreVisit, node);
+
+    if (visit) {
+        derived()->incrementDepth(node);
+        if (node->getInit())
+            traverse(node->getInit());
+        if (node->getCondition())
+            traverse(node->getCondition());
+        if (node->getBody())
+            traverse(node->getBody());
+        if (node->getExpression())
+            traverse(node->getExpression());
+        derived()->decrementDepth();
+    }
+
+    if (visit && postVisit)
+        derived()->visitLoop(PostVisit, node);
+}
+
+template <typename Derived>
+void TStaticIntermTraverser<Derived>::traverseBranch(TIntermBranch* node)
+{
+    bool visit = true;
+    if (preVisit)
+        visit = derived()->visitBranch(PreVisit, node);
+
+    if (visit && node->getExpression()) {
+        derived()->incrementDepth(node);
+        traverse(node->getExpression());
+        derived()->decrementDepth();
+    }
+
+    if (visit && postVisit)
+        derived()->visitBranch(PostVisit, node);
+}
+
+#endif  // COMPILER_STATIC_INTERM_TRAVERSER_H_
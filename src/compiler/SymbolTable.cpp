@@ -19,8 +19,38 @@
 #include <algorithm>
 #include <climits>
 
+namespace {
+
+//
+// Inserts an entry that is not yet in an open-addressing hash table of
+// entries with a hash, keeping its load factor at or below one half.
+//
+template <typename T>
+void InsertEntry(std::vector<const T*>* slots, size_t* count, const T* entry)
+{
+    if (2 * (*count + 1) > slots->size()) {
+        std::vector<const T*> oldSlots(std::max<size_t>(64, 2 * slots->size()), 0);
+        oldSlots.swap(*slots);
+        *count = 0;
+        for (size_t j = 0; j < oldSlots.size(); ++j) {
+            if (oldSlots[j])
+                InsertEntry(slots, count, oldSlots[j]);
+        }
+    }
+
+    size_t mask = slots->size() - 1;
+    size_t i = entry->hash & mask;
+    while ((*slots)[i])
+        i = (i + 1) & mask;
+    (*slots)[i] = entry;
+    ++*count;
+}
+
+}  // namespace
+
 TType::TType(const TPublicType &p) :
-            type(p.type), precision(p.precision), qualifier(p.qualifier), size(p.size), matrix(p.matrix), array(p.array), arraySize(p.arraySize), structure(0)
+            type(static_cast<unsigned char>(p.type)), precision(static_cast<unsigned char>(p.precision)),
+            qualifier(static_cast<unsigned char>(p.qualifier)), size(p.size), matrix(p.matrix), array(p.array), arraySize(p.arraySize), structure(0)
 {
     if (p.userDef)
         structure = p.userDef->getStruct();
@@ -29,33 +59,32 @@ TType::TType(const TPublicType &p) :
 //
 // Recursively generate mangled names.
 //
-TString TType::buildMangledName() const
+void TType::appendMangledName(TString& name) const
 {
-    TString mangledName;
     if (isMatrix())
-        mangledName += 'm';
+        name += 'm';
     else if (isVector())
-        mangledName += 'v';
-
-    switch (type) {
-    case EbtFloat:       mangledName += 'f';      break;
-    case EbtInt:         mangledName += 'i';      break;
-    case EbtBool:        mangledName += 'b';      break;
-    case EbtSampler2D:   mangledName += "s2";     break;
-    case EbtSamplerCube: mangledName += "sC";     break;
-    case EbtStruct:      mangledName += structure->mangledName(); break;
+        name += 'v';
+
+    switch (getBasicType()) {
+    case EbtFloat:       name += 'f';      break;
+    case EbtInt:         name += 'i';      break;
+    case EbtBool:        name += 'b';      break;
+    case EbtSampler2D:   name += "s2";     break;
+    case EbtSamplerCube: name += "sC";     break;
+    case EbtStruct:      name += structure->mangledName(); break;
     default:             break;
     }
 
-    mangledName += static_cast<char>('0' + getNominalSize());
+    name += static_cast<char>('0' + getNominalSize());
     if (isArray()) {
         char buf[20];
         snprintf(buf, sizeof(buf), "%d", arraySize);
-        mangledName += '[';
-        mangledName += buf;
-        mangledName += ']';
+        name += '[';
+        name += buf;
+        name += ']';
     }
-    return mangledName;
+    name += ';';
 }
 
 size_t TType::getObjectSize() const
@@ -80,47 +109,34 @@ size_t TType::getObjectSize() const
     return totalSize;
 }
 
-bool TStructure::containsArrays() const
+TStructure::TStructure(TString* name, TFieldList* fields)
+    : mName(name),
+      mFields(fields),
+      mMangledName("struct-"),
+      mObjectSize(0),
+      mRegisterCount(0),
+      mDeepestNesting(0),
+      mContainsArrays(false)
 {
+    mMangledName += *mName;
     for (size_t i = 0; i < mFields->size(); ++i) {
         const TType* fieldType = (*mFields)[i]->type();
-        if (fieldType->isArray() || fieldType->isStructureContainingArrays())
-            return true;
-    }
-    return false;
-}
 
-TString TStructure::buildMangledName() const
-{
-    TString mangledName("struct-");
-    mangledName += *mName;
-    for (size_t i = 0; i < mFields->size(); ++i) {
-        mangledName += '-';
-        mangledName += (*mFields)[i]->type()->getMangledName();
-    }
-    return mangledName;
-}
+        mMangledName += '-';
+        fieldType->appendMangledName(mMangledName);
 
-size_t TStructure::calculateObjectSize() const
-{
-    size_t size = 0;
-    for (size_t i = 0; i < mFields->size(); ++i) {
-        size_t fieldSize = (*mFields)[i]->type()->getObjectSize();
-        if (fieldSize > INT_MAX - size)
-            size = INT_MAX;
+        size_t fieldSize = fieldType->getObjectSize();
+        if (fieldSize > INT_MAX - mObjectSize)
+            mObjectSize = INT_MAX;
         else
-            size += fieldSize;
-    }
-    return size;
-}
+            mObjectSize += fieldSize;
 
-int TStructure::calculateDeepestNesting() const
-{
-    int maxNesting = 0;
-    for (size_t i = 0; i < mFields->size(); ++i) {
-        maxNesting = std::max(maxNesting, (*mFields)[i]->type()->getDeepestStructNesting());
+        mRegisterCount += fieldType->totalRegisterCount();
+        mDeepestNesting = std::max(mDeepestNesting, fieldType->getDeepestStructNesting());
+        if (fieldType->isArray() || fieldType->isStructureContainingArrays())
+            mContainsArrays = true;
     }
-    return 1 + maxNesting;
+    ++mDeepestNesting;
 }
 
 //
@@ -136,6 +152,16 @@ void TVariable::dump(TInfoSink& infoSink) const
     infoSink.debug << "\n";
 }
 
+const TString& TFunction::getMangledName() const
+{
+    if (mangledName.empty()) {
+        mangledName = mangleName(getName());
+        for (TParamList::const_iterator it = parameters.begin(); it != parameters.end(); ++it)
+            it->type->appendMangledName(mangledName);
+    }
+    return mangledName;
+}
+
 void TFunction::dump(TInfoSink &infoSink) const
 {
     infoSink.debug << getName().c_str() << ": " <<  returnType.getBasicString() << " " << getMangledName().c_str() << "\n";
@@ -143,9 +169,10 @@ void TFunction::dump(TInfoSink &infoSink) const
 
 void TSymbolTableLevel::dump(TInfoSink &infoSink) const
 {
-    tLevel::const_iterator it;
-    for (it = level.begin(); it != level.end(); ++it)
-        (*it).second->dump(infoSink);
+    for (TEntryList::const_iterator it = slots.begin(); it != slots.end(); ++it) {
+        if (it->atom && !it->signature)
+            it->symbol->dump(infoSink);
+    }
 }
 
 void TSymbolTable::dump(TInfoSink &infoSink) const
@@ -165,13 +192,319 @@ TFunction::~TFunction()
         delete (*i).type;
 }
 
+TSymbolTableLevel::TSymbolTableLevel(TAtomTable* atomTable, TTypeTable* typeTable,
+                                     const TSymbolTableLevel& symbols)
+    : atoms(atomTable),
+      types(typeTable),
+      slots(symbols.slots),
+      count(symbols.count),
+      borrowed(&symbols)
+{
+    // A function is entered under its mangled name and its signature, and
+    // the first one of its name also under its unmangled name. Copy each
+    // function once.
+    TMap<TSymbol*, TSymbol*> copies;
+    for (TEntryList::iterator it = slots.begin(); it != slots.end(); ++it) {
+        if (!it->atom || !it->symbol->isFunction())
+            continue;
+        TFunction* function = static_cast<TFunction*>(it->symbol);
+        if (function->isDefined())
+            continue;
+
+        TSymbol*& copy = copies[function];
+        if (!copy) {
+            TFunction* declaration = new TFunction(&function->getName(),
+                                                   function->getReturnType(),
+                                                   function->getBuiltInOp());
+            for (size_t i = 0; i < function->getParamCount(); ++i) {
+                TParameter param = function->getParam(i);
+                param.type = new TType(*param.type);
+                declaration->addParameter(param);
+            }
+            declaration->setUniqueId(function->getUniqueId());
+            declaration->relateToExtension(function->getExtension());
+            copy = declaration;
+        }
+        it->symbol = copy;
+    }
+}
+
 //
 // Symbol table levels are a map of pointers to symbols that have to be deleted.
 //
 TSymbolTableLevel::~TSymbolTableLevel()
 {
-    for (tLevel::iterator it = level.begin(); it != level.end(); ++it)
-        delete (*it).second;
+    // Functions are also entered under their signature and their unmangled
+    // name. Forget those entries before deleting anything, so that each
+    // symbol is deleted once. The symbols of a borrowed level are not
+    // deleted at all.
+    for (TEntryList::iterator it = slots.begin(); it != slots.end(); ++it) {
+        if (it->atom && (it->signature || it->atom->name != it->symbol->getMangledName() ||
+                         (borrowed && borrowed->find(it->atom) == it->symbol)))
+            it->symbol = 0;
+    }
+    for (TEntryList::iterator it = slots.begin(); it != slots.end(); ++it) {
+        if (it->atom)
+            delete it->symbol;
+    }
+}
+
+//
+// FNV-1a.
+//
+unsigned int TAtomTable::hash(const TString& name)
+{
+    unsigned int h = 2166136261u;
+    for (TString::const_iterator it = name.begin(); it != name.end(); ++it) {
+        h ^= static_cast<unsigned char>(*it);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+const TAtom* TAtomTable::find(const TString& name, unsigned int h) const
+{
+    if (parent) {
+        const TAtom* atom = parent->find(name, h);
+        if (atom)
+            return atom;
+    }
+
+    if (count == 0)
+        return 0;
+    size_t mask = slots.size() - 1;
+    for (size_t i = h & mask; slots[i]; i = (i + 1) & mask) {
+        if (slots[i]->hash == h && slots[i]->name == name)
+            return slots[i];
+    }
+    return 0;
+}
+
+const TAtom* TAtomTable::intern(const TString& name)
+{
+    unsigned int h = hash(name);
+    const TAtom* atom = find(name, h);
+    if (atom)
+        return atom;
+
+    // Keep the load factor at or below one half.
+    if (2 * (count + 1) > slots.size())
+        grow();
+
+    atom = new TAtom(name, h);
+    size_t mask = slots.size() - 1;
+    size_t i = h & mask;
+    while (slots[i])
+        i = (i + 1) & mask;
+    slots[i] = atom;
+    ++count;
+    return atom;
+}
+
+void TAtomTable::clear()
+{
+    std::fill(slots.begin(), slots.end(), static_cast<const TAtom*>(0));
+    count = 0;
+}
+
+void TAtomTable::grow()
+{
+    std::vector<const TAtom*> oldSlots(std::max<size_t>(64, 2 * slots.size()), 0);
+    oldSlots.swap(slots);
+
+    size_t mask = slots.size() - 1;
+    for (size_t j = 0; j < oldSlots.size(); ++j) {
+        if (!oldSlots[j])
+            continue;
+        size_t i = oldSlots[j]->hash & mask;
+        while (slots[i])
+            i = (i + 1) & mask;
+        slots[i] = oldSlots[j];
+    }
+}
+
+TCanonicalType::TCanonicalType(const TType& t, unsigned int h)
+    : type(t),
+      objectSize(t.getObjectSize()),
+      elementRegisterCount(t.elementRegisterCount()),
+      totalRegisterCount(t.totalRegisterCount()),
+      hash(h)
+{
+    type.setQualifier(EvqTemporary);
+    type.setPrecision(EbpUndefined);
+    type.appendMangledName(mangledName);
+}
+
+const TSignature TTypeTable::kEmptySignature(0, 0, 0, 2166136261u);
+
+void TTypeTable::setParent(const TTypeTable* p)
+{
+    parent = p;
+    // Signatures interned here follow those of the parents.
+    nextId = p ? p->nextId : 1;
+}
+
+//
+// Hashes what TType::operator== compares.
+//
+unsigned int TTypeTable::hash(const TType& type)
+{
+    unsigned int h = 2166136261u;
+    h = (h ^ type.getBasicType()) * 16777619u;
+    h = (h ^ type.getNominalSize()) * 16777619u;
+    h = (h ^ (type.isMatrix() ? 1 : 0)) * 16777619u;
+    h = (h ^ (type.isArray() ? type.getArraySize() + 1 : 0)) * 16777619u;
+    h = (h ^ static_cast<unsigned int>(reinterpret_cast<size_t>(type.getStruct()) >> 3)) * 16777619u;
+    return h;
+}
+
+unsigned int TTypeTable::hash(const TSignature* prefix, const TCanonicalType* last)
+{
+    return (prefix->hash ^ last->hash) * 16777619u;
+}
+
+const TCanonicalType* TTypeTable::find(const TType& type) const
+{
+    return find(type, hash(type));
+}
+
+const TCanonicalType* TTypeTable::find(const TType& type, unsigned int h) const
+{
+    if (parent) {
+        const TCanonicalType* canonical = parent->find(type, h);
+        if (canonical)
+            return canonical;
+    }
+
+    if (typeCount == 0)
+        return 0;
+    size_t mask = types.size() - 1;
+    for (size_t i = h & mask; types[i]; i = (i + 1) & mask) {
+        if (types[i]->hash == h && types[i]->type == type)
+            return types[i];
+    }
+    return 0;
+}
+
+const TCanonicalType* TTypeTable::intern(const TType& type)
+{
+    unsigned int h = hash(type);
+    const TCanonicalType* canonical = find(type, h);
+    if (canonical)
+        return canonical;
+
+    canonical = new TCanonicalType(type, h);
+    InsertEntry(&types, &typeCount, canonical);
+    return canonical;
+}
+
+const TSignature* TTypeTable::find(const TSignature* prefix, const TCanonicalType* last,
+                                   unsigned int h) const
+{
+    if (parent) {
+        const TSignature* signature = parent->find(prefix, last, h);
+        if (signature)
+            return signature;
+    }
+
+    if (signatureCount == 0)
+        return 0;
+    size_t mask = signatures.size() - 1;
+    for (size_t i = h & mask; signatures[i]; i = (i + 1) & mask) {
+        if (signatures[i]->prefix == prefix && signatures[i]->last == last)
+            return signatures[i];
+    }
+    return 0;
+}
+
+const TSignature* TTypeTable::intern(const TSignature* prefix, const TCanonicalType* last)
+{
+    unsigned int h = hash(prefix, last);
+    const TSignature* signature = find(prefix, last, h);
+    if (signature)
+        return signature;
+
+    signature = new TSignature(prefix, last, nextId++, h);
+    InsertEntry(&signatures, &signatureCount, signature);
+    return signature;
+}
+
+const TSignature* TTypeTable::find(const TFunction& function) const
+{
+    const TSignature* signature = &kEmptySignature;
+    for (size_t i = 0; signature && i < function.getParamCount(); ++i) {
+        const TCanonicalType* type = find(*function.getParam(i).type);
+        signature = type ? find(signature, type, hash(signature, type)) : 0;
+    }
+    return signature;
+}
+
+const TSignature* TTypeTable::intern(const TFunction& function)
+{
+    const TSignature* signature = &kEmptySignature;
+    for (size_t i = 0; i < function.getParamCount(); ++i)
+        signature = intern(signature, intern(*function.getParam(i).type));
+    return signature;
+}
+
+void TTypeTable::clear()
+{
+    std::fill(types.begin(), types.end(), static_cast<const TCanonicalType*>(0));
+    typeCount = 0;
+    std::fill(signatures.begin(), signatures.end(), static_cast<const TSignature*>(0));
+    signatureCount = 0;
+    nextId = parent ? parent->nextId : 1;
+}
+
+bool TSymbolTableLevel::insert(TSymbol &symbol)
+{
+    const TAtom* mangledName = atoms->intern(symbol.getMangledName());
+    if (!insert(mangledName, 0, symbol))
+        return false;
+
+    // Equal signatures make equal mangled names, so the function is not
+    // yet entered under its signature either.
+    if (symbol.isFunction()) {
+        const TFunction& function = static_cast<const TFunction&>(symbol);
+        insert(atoms->intern(function.getName()), types->intern(function), symbol);
+    }
+    return true;
+}
+
+bool TSymbolTableLevel::insert(const TAtom* atom, const TSignature* signature, TSymbol &symbol)
+{
+    if (find(atom, signature))
+        return false;
+
+    // Keep the load factor at or below one half.
+    if (2 * (count + 1) > slots.size())
+        grow();
+
+    size_t mask = slots.size() - 1;
+    size_t i = hash(atom, signature) & mask;
+    while (slots[i].atom)
+        i = (i + 1) & mask;
+    slots[i].atom = atom;
+    slots[i].signature = signature;
+    slots[i].symbol = &symbol;
+    ++count;
+    return true;
+}
+
+void TSymbolTableLevel::grow()
+{
+    TEntryList oldSlots(std::max<size_t>(8, 2 * slots.size()));
+    oldSlots.swap(slots);
+
+    size_t mask = slots.size() - 1;
+    for (TEntryList::const_iterator it = oldSlots.begin(); it != oldSlots.end(); ++it) {
+        if (!it->atom)
+            continue;
+        size_t i = hash(it->atom, it->signature) & mask;
+        while (slots[i].atom)
+            i = (i + 1) & mask;
+        slots[i] = *it;
+    }
 }
 
 //
@@ -182,10 +515,9 @@ TSymbolTableLevel::~TSymbolTableLevel()
 //
 void TSymbolTableLevel::relateToOperator(const char* name, TOperator op)
 {
-    tLevel::iterator it;
-    for (it = level.begin(); it != level.end(); ++it) {
-        if ((*it).second->isFunction()) {
-            TFunction* function = static_cast<TFunction*>((*it).second);
+    for (TEntryList::iterator it = slots.begin(); it != slots.end(); ++it) {
+        if (it->atom && it->symbol->isFunction()) {
+            TFunction* function = static_cast<TFunction*>(it->symbol);
             if (function->getName() == name)
                 function->relateToOperator(op);
         }
@@ -200,16 +532,15 @@ void TSymbolTableLevel::relateToOperator(const char* name, TOperator op)
 //
 void TSymbolTableLevel::relateToExtension(const char* name, const TString& ext)
 {
-    for (tLevel::iterator it = level.begin(); it != level.end(); ++it) {
-        TSymbol* symbol = it->second;
-        if (symbol->getName() == name)
-            symbol->relateToExtension(ext);
+    for (TEntryList::iterator it = slots.begin(); it != slots.end(); ++it) {
+        if (it->atom && it->symbol->getName() == name)
+            it->symbol->relateToExtension(ext);
     }
 }
 
 TSymbolTable::~TSymbolTable()
 {
-    for (size_t i = 0; i < table.size(); ++i)
+    for (size_t i = sharesBuiltInLevel ? 1 : 0; i < table.size(); ++i)
         delete table[i];
     for (size_t i = 0; i < precisionStack.size(); ++i)
         delete precisionStack[i];
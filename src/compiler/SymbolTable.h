@@ -31,6 +31,7 @@
 //
 
 #include <assert.h>
+#include <algorithm>
 
 #include "common/angleutils.h"
 #include "compiler/InfoSink.h"
@@ -133,10 +134,9 @@ public:
         returnType(TType(EbtVoid, EbpUndefined)),
         op(o),
         defined(false) { }
-    TFunction(const TString *name, TType& retType, TOperator tOp = EOpNull) : 
+    TFunction(const TString *name, const TType& retType, TOperator tOp = EOpNull) : 
         TSymbol(name), 
         returnType(retType),
-        mangledName(TFunction::mangleName(*name)),
         op(tOp),
         defined(false) { }
     virtual ~TFunction();
@@ -151,10 +151,12 @@ public:
     void addParameter(TParameter& p) 
     { 
         parameters.push_back(p);
-        mangledName = mangledName + p.type->getMangledName();
     }
 
-    const TString& getMangledName() const { return mangledName; }
+    // The mangled name is built when it is first asked for, which is when
+    // the function is inserted in a symbol table level. Calls are resolved
+    // by their signature, and do not need one.
+    const TString& getMangledName() const;
     const TType& getReturnType() const { return returnType; }
 
     void relateToOperator(TOperator o) { op = o; }
@@ -174,67 +176,223 @@ private:
     typedef TVector<TParameter> TParamList;
     TParamList parameters;
     TType returnType;
-    TString mangledName;
+    mutable TString mangledName;
     TOperator op;
     bool defined;
 };
 
 
-class TSymbolTableLevel {
+//
+// An interned symbol name. Each distinct name is interned once per atom
+// table, so that symbol table levels can compare names by address.
+//
+struct TAtom {
+    POOL_ALLOCATOR_NEW_DELETE();
+    TAtom(const TString& n, unsigned int h) : name(n), hash(h) { }
+
+    TString name;
+    unsigned int hash;
+};
+
+//
+// Open-addressing hash table of atoms. A table may have a parent whose
+// atoms it reuses instead of interning names again; the table of each
+// compiler uses the table of the shared built-in symbols as its parent.
+// Atoms are allocated from the global pool.
+//
+class TAtomTable {
+public:
+    TAtomTable() : parent(0), count(0) { }
+
+    void setParent(const TAtomTable* p) { parent = p; }
+
+    // Returns the atom for the name, or NULL if it was never interned, in
+    // which case no symbol table level can contain the name either.
+    const TAtom* find(const TString& name) const { return find(name, hash(name)); }
+    // Returns the atom for the name, interning the name first if needed.
+    const TAtom* intern(const TString& name);
+    // Forgets the atoms interned by this table, but not by its parent.
+    void clear();
+
+    static unsigned int hash(const TString& name);
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(TAtomTable);
+
+    const TAtom* find(const TString& name, unsigned int h) const;
+    void grow();
+
+    const TAtomTable* parent;
+    std::vector<const TAtom*> slots;
+    size_t count;
+};
+
+//
+// A type interned by a type table. Types that are equal, and so differ at
+// most in qualifier and precision, share one canonical type, which keeps
+// the properties that follow from them.
+//
+struct TCanonicalType {
+    POOL_ALLOCATOR_NEW_DELETE();
+    TCanonicalType(const TType& t, unsigned int h);
+
+    TType type;  // with a temporary qualifier and no precision
+    TString mangledName;
+    size_t objectSize;
+    int elementRegisterCount;
+    int totalRegisterCount;
+    unsigned int hash;
+};
+
+//
+// An interned list of parameter types. A signature is interned as the
+// signature of all its parameters but the last, extended by the last, so
+// that the signature of a call is found one argument at a time.
+//
+struct TSignature {
+    POOL_ALLOCATOR_NEW_DELETE();
+    TSignature(const TSignature* p, const TCanonicalType* l, unsigned int i, unsigned int h)
+        : prefix(p), last(l), id(i), hash(h) { }
+
+    const TSignature* prefix;    // NULL for the empty signature
+    const TCanonicalType* last;  // NULL for the empty signature
+    unsigned int id;             // unique among the signatures of a table and its parents
+    unsigned int hash;
+};
+
+//
+// Open-addressing hash tables of canonical types and of signatures. Like
+// an atom table, a type table may have a parent whose entries it reuses.
+// Entries are allocated from the global pool.
+//
+class TTypeTable {
 public:
-    typedef TMap<TString, TSymbol*> tLevel;
-    typedef tLevel::const_iterator const_iterator;
-    typedef const tLevel::value_type tLevelPair;
-    typedef std::pair<tLevel::iterator, bool> tInsertResult;
+    TTypeTable() : parent(0), typeCount(0), signatureCount(0), nextId(1) { }
+
+    void setParent(const TTypeTable* p);
 
-    TSymbolTableLevel() { }
+    // Returns the canonical type of the type, or NULL if it was never
+    // interned.
+    const TCanonicalType* find(const TType& type) const;
+    // Returns the canonical type of the type, interning it first if needed.
+    const TCanonicalType* intern(const TType& type);
+
+    // Returns the signature of the parameters of the function, or NULL if
+    // it was never interned, in which case no function has it.
+    const TSignature* find(const TFunction& function) const;
+    // Returns the signature of the parameters of the function, interning
+    // it and the parameter types first if needed.
+    const TSignature* intern(const TFunction& function);
+
+    // Forgets the entries interned by this table, but not by its parent.
+    void clear();
+
+    static const TSignature* emptySignature() { return &kEmptySignature; }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(TTypeTable);
+
+    const TCanonicalType* find(const TType& type, unsigned int h) const;
+    const TSignature* find(const TSignature* prefix, const TCanonicalType* last, unsigned int h) const;
+    const TSignature* intern(const TSignature* prefix, const TCanonicalType* last);
+
+    static unsigned int hash(const TType& type);
+    static unsigned int hash(const TSignature* prefix, const TCanonicalType* last);
+
+    static const TSignature kEmptySignature;
+
+    const TTypeTable* parent;
+    std::vector<const TCanonicalType*> types;
+    size_t typeCount;
+    std::vector<const TSignature*> signatures;
+    size_t signatureCount;
+    unsigned int nextId;
+};
+
+class TSymbolTableLevel {
+public:
+    TSymbolTableLevel(TAtomTable* atomTable, TTypeTable* typeTable)
+        : atoms(atomTable), types(typeTable), count(0), borrowed(0) { }
+    // Starts the level with the symbols of another level, which keeps
+    // owning them, and must outlive this level. The functions declared but
+    // not defined there are copied, so that defining them here does not
+    // modify the other level.
+    TSymbolTableLevel(TAtomTable* atomTable, TTypeTable* typeTable, const TSymbolTableLevel& symbols);
     ~TSymbolTableLevel();
 
+    //
+    // returning true means symbol was added to the table
+    //
     bool insert(const TString &name, TSymbol &symbol)
     {
-        //
-        // returning true means symbol was added to the table
-        //
-        tInsertResult result = level.insert(tLevelPair(name, &symbol));
-
-        return result.second;
+        return insert(atoms->intern(name), 0, symbol);
     }
 
-    bool insert(TSymbol &symbol)
+    // Functions are entered under their mangled name, and also under their
+    // name and signature, by which calls find them.
+    bool insert(TSymbol &symbol);
+
+    bool insert(const TAtom* atom, TSymbol &symbol)
     {
-        return insert(symbol.getMangledName(), symbol);
+        return insert(atom, 0, symbol);
     }
 
     TSymbol* find(const TString& name) const
     {
-        tLevel::const_iterator it = level.find(name);
-        if (it == level.end())
-            return 0;
-        else
-            return (*it).second;
+        const TAtom* atom = atoms->find(name);
+        return atom ? find(atom) : 0;
     }
 
-    const_iterator begin() const
+    TSymbol* find(const TAtom* atom) const
     {
-        return level.begin();
+        return find(atom, 0);
     }
 
-    const_iterator end() const
+    // Finds the function with the name and signature.
+    TSymbol* find(const TAtom* atom, const TSignature* signature) const
     {
-        return level.end();
+        if (count == 0)
+            return 0;
+        size_t mask = slots.size() - 1;
+        for (size_t i = hash(atom, signature) & mask; slots[i].atom; i = (i + 1) & mask) {
+            if (slots[i].atom == atom && slots[i].signature == signature)
+                return slots[i].symbol;
+        }
+        return 0;
     }
 
     void relateToOperator(const char* name, TOperator op);
     void relateToExtension(const char* name, const TString& ext);
     void dump(TInfoSink &infoSink) const;
 
-protected:
-    tLevel level;
+private:
+    DISALLOW_COPY_AND_ASSIGN(TSymbolTableLevel);
+
+    struct TEntry {
+        const TAtom* atom;
+        const TSignature* signature;  // NULL unless entered by signature
+        TSymbol* symbol;
+    };
+    typedef TVector<TEntry> TEntryList;
+
+    static unsigned int hash(const TAtom* atom, const TSignature* signature)
+    {
+        return signature ? atom->hash ^ ((signature->id + 1) * 2654435761u) : atom->hash;
+    }
+
+    bool insert(const TAtom* atom, const TSignature* signature, TSymbol &symbol);
+    void grow();
+
+    TAtomTable* atoms;
+    TTypeTable* types;
+    TEntryList slots;  // open-addressing table, empty slots have no atom
+    size_t count;
+    const TSymbolTableLevel* borrowed;  // level owning some of the symbols
 };
 
 class TSymbolTable {
 public:
-    TSymbolTable() : uniqueId(0)
+    TSymbolTable() : uniqueId(0), builtInAtoms(0), builtInTypes(0), sharesBuiltInLevel(false)
     {
         //
         // The symbol table cannot be used until push() is called, but
@@ -250,21 +408,68 @@ public:
     // globals are at level 1.
     //
     bool isEmpty() { return table.size() == 0; }
-    bool atBuiltInLevel() { return table.size() == 1; }
+    bool atBuiltInLevel() const { return table.size() == 1; }
     bool atGlobalLevel() { return table.size() <= 2; }
     void push()
     {
-        table.push_back(new TSymbolTableLevel);
+        table.push_back(new TSymbolTableLevel(&atoms, &types));
         precisionStack.push_back(new PrecisionStackLevel);
     }
 
+    //
+    // Instead of pushing a new level and loading the built-ins into it,
+    // use the built-in level of another symbol table that has already been
+    // loaded. The level remains owned by that table, which must outlive
+    // this one and must not be modified while it is shared.
+    //
+    void pushSharedBuiltInLevel(const TSymbolTable& builtIns)
+    {
+        assert(isEmpty() && builtIns.atBuiltInLevel());
+        table.push_back(builtIns.table[0]);
+        precisionStack.push_back(new PrecisionStackLevel(*builtIns.precisionStack[0]));
+        uniqueId = builtIns.uniqueId;
+        builtInAtoms = &builtIns.atoms;
+        atoms.setParent(builtInAtoms);
+        builtInTypes = &builtIns.types;
+        types.setParent(builtInTypes);
+        sharesBuiltInLevel = true;
+    }
+
+    //
+    // Instead of pushing an empty global level, push one that starts with
+    // the global symbols of another symbol table, layered on the same
+    // shared built-in level. That table must outlive the level, and must
+    // not be modified while the level is pushed.
+    //
+    void pushGlobalLevel(const TSymbolTable& globals)
+    {
+        assert(sharesBuiltInLevel && atBuiltInLevel());
+        assert(globals.table.size() == 2 && globals.table[0] == table[0]);
+        table.push_back(new TSymbolTableLevel(&atoms, &types, *globals.table[1]));
+        precisionStack.push_back(new PrecisionStackLevel(*globals.precisionStack[1]));
+        // Keep the ids of the new symbols distinct from those of globals.
+        uniqueId = std::max(uniqueId, globals.uniqueId);
+        atoms.setParent(&globals.atoms);
+        types.setParent(&globals.types);
+    }
+
     void pop()
     {
-        delete table.back();
+        if (!sharesBuiltInLevel || !atBuiltInLevel())
+            delete table.back();
         table.pop_back();
 
         delete precisionStack.back();
         precisionStack.pop_back();
+
+        // The atoms and types interned since the built-in level was shared
+        // belong to the pool of the compile that is ending.
+        if (sharesBuiltInLevel && atBuiltInLevel()) {
+            atoms.clear();
+            atoms.setParent(builtInAtoms);
+            types.clear();
+            types.setParent(builtInTypes);
+        }
     }
 
     bool insert(TSymbol& symbol)
@@ -304,12 +509,14 @@ public:
 
     TSymbol* find(const TString& name, bool* builtIn = 0, bool *sameScope = 0) 
     {
-        int level = currentLevel();
-        TSymbol* symbol;
-        do {
-            symbol = table[level]->find(name);
+        // Names that were never interned are not in any level.
+        const TAtom* atom = atoms.find(name);
+        int level = atom ? currentLevel() : -1;
+        TSymbol* symbol = 0;
+        while (symbol == 0 && level >= 0) {
+            symbol = table[level]->find(atom);
             --level;
-        } while (symbol == 0 && level >= 0);
+        }
         level++;
         if (builtIn)
             *builtIn = level == 0;
@@ -318,11 +525,43 @@ public:
         return symbol;
     }
 
+    //
+    // Finds the function that a call resolves to, by the name of the
+    // function and the signature of the arguments of the call.
+    //
+    TSymbol* findFunction(const TFunction& call, bool* builtIn = 0)
+    {
+        // Calls whose name or signature were never interned match no
+        // function in any level.
+        const TAtom* atom = atoms.find(call.getName());
+        const TSignature* signature = atom ? types.find(call) : 0;
+        int level = signature ? currentLevel() : -1;
+        TSymbol* symbol = 0;
+        while (symbol == 0 && level >= 0) {
+            symbol = table[level]->find(atom, signature);
+            --level;
+        }
+        level++;
+        if (builtIn)
+            *builtIn = level == 0;
+        return symbol;
+    }
+
     TSymbol* findBuiltIn(const TString &name)
     {
         return table[0]->find(name);
     }
 
+    const TSymbolTableLevel* getBuiltInLevel() const {
+        assert(!table.empty());
+        return table[0];
+    }
+
+    const TSymbolTableLevel* getGlobalLevel() const {
+        assert(table.size() >= 2);
+        return table[1];
+    }
+
     TSymbolTableLevel* getOuterLevel() {
         assert(table.size() >= 2);
         return table[currentLevel() - 1];
@@ -374,7 +613,12 @@ private:
     }
 
     int uniqueId;     // for unique identification in code generation
+    TAtomTable atoms;  // names of the symbols in all levels
+    const TAtomTable* builtInAtoms;  // parent of atoms at the built-in level
+    TTypeTable types;  // parameter types and signatures of the functions in all levels
+    const TTypeTable* builtInTypes;  // parent of types at the built-in level
     std::vector<TSymbolTableLevel*> table;
+    bool sharesBuiltInLevel;  // table[0] is owned by another symbol table
     typedef TMap<TBasicType, TPrecision> PrecisionStackLevel;
     std::vector<PrecisionStackLevel*> precisionStack;
 };
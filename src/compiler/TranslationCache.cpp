@@ -0,0 +1,223 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#include "compiler/TranslationCache.h"
+
+#include <list>
+#include <map>
+
+#include "compiler/TranslationStore.h"
+#include "compiler/osinclude.h"
+#include "third_party/murmurhash/MurmurHash3.h"
+
+namespace {
+
+struct TEntry {
+    uint32_t hash;
+    TPersistString key;
+    TTranslationResult result;
+    size_t size;
+};
+
+// Most recently used first.
+typedef std::list<TEntry> TEntryList;
+typedef std::multimap<uint32_t, TEntryList::iterator> TEntryIndex;
+
+TEntryList gEntries;
+TEntryIndex gIndex;
+size_t gMaxSize = 0;
+TTranslationStore* gStore = NULL;
+TTranslationCacheStatistics gStatistics;
+// Guards all of the above.
+OS_Mutex gCacheLock;
+
+uint32_t HashKey(const TPersistString& key)
+{
+    static const uint32_t seed = 0xDEADBEEF;
+
+    uint32_t hash = 0;
+    MurmurHash3_x86_32(key.data(), static_cast<int>(key.size()), seed, &hash);
+    return hash;
+}
+
+TEntryIndex::iterator FindEntry(uint32_t hash, const TPersistString& key)
+{
+    std::pair<TEntryIndex::iterator, TEntryIndex::iterator> range =
+        gIndex.equal_range(hash);
+    for (TEntryIndex::iterator it = range.first; it != range.second; ++it) {
+        if (it->second->key == key)
+            return it;
+    }
+    return gIndex.end();
+}
+
+void EraseEntry(TEntryIndex::iterator indexEntry)
+{
+    gStatistics.size -= indexEntry->second->size;
+    gEntries.erase(indexEntry->second);
+    gIndex.erase(indexEntry);
+}
+
+// Evicts least recently used entries until the cache holds at most maxSize
+// bytes.
+void EvictTo(size_t maxSize)
+{
+    while (gStatistics.size > maxSize && !gEntries.empty()) {
+        const TEntry& oldest = gEntries.back();
+        EraseEntry(FindEntry(oldest.hash, oldest.key));
+        gStatistics.evictions++;
+    }
+}
+
+// Adds the entry staged alone in a list, unless it is over budget or
+// already cached.
+void AddEntry(TEntryList* staged)
+{
+    TEntry& entry = staged->front();
+    if (entry.size > gMaxSize || FindEntry(entry.hash, entry.key) != gIndex.end())
+        return;
+
+    EvictTo(gMaxSize - entry.size);
+    gStatistics.size += entry.size;
+    gIndex.insert(TEntryIndex::value_type(entry.hash, staged->begin()));
+    gEntries.splice(gEntries.begin(), *staged);
+}
+
+void StageEntry(uint32_t hash, const TPersistString& key, const TTranslationResult& result,
+                TEntryList* staged)
+{
+    staged->resize(1);
+    TEntry& entry = staged->front();
+    entry.hash = hash;
+    entry.key = key;
+    entry.result = result;
+    entry.size = sizeof(TEntry) + key.size() + result.memorySize();
+}
+
+size_t VariablesSize(const TVariableInfoList& variables)
+{
+    size_t size = variables.size() * sizeof(TVariableInfo);
+    for (size_t i = 0; i < variables.size(); ++i)
+        size += variables[i].name.size() + variables[i].mappedName.size();
+    return size;
+}
+
+}  // anonymous namespace
+
+size_t TTranslationResult::memorySize() const
+{
+    size_t size = sizeof(*this) + infoLog.size() + objectCode.size();
+    size += VariablesSize(attribs) + VariablesSize(uniforms) + VariablesSize(varyings);
+    for (NameMap::const_iterator it = nameMap.begin(); it != nameMap.end(); ++it)
+        size += sizeof(*it) + it->first.size() + it->second.size();
+    size += activeUniforms.size() * sizeof(sh::Uniform);
+    for (size_t i = 0; i < activeUniforms.size(); ++i)
+        size += activeUniforms[i].name.size();
+    return size;
+}
+
+// static
+bool TTranslationCache::InitializeLock()
+{
+    gStatistics = TTranslationCacheStatistics();
+    return OS_InitMutex(&gCacheLock);
+}
+
+// static
+void TTranslationCache::FreeLock()
+{
+    SetMaxSize(0);
+    SetPersistentStore(NULL);
+    OS_FreeMutex(&gCacheLock);
+}
+
+// static
+void TTranslationCache::SetMaxSize(size_t maxSize)
+{
+    TScopedLock lock(&gCacheLock);
+    gMaxSize = maxSize;
+    EvictTo(maxSize);
+}
+
+// static
+bool TTranslationCache::SetPersistentStore(const char* path)
+{
+    TScopedLock lock(&gCacheLock);
+    delete gStore;
+    gStore = path ? TTranslationStore::Open(path) : NULL;
+    return gStore != NULL || path == NULL;
+}
+
+// static
+bool TTranslationCache::IsEnabled()
+{
+    TScopedLock lock(&gCacheLock);
+    return gMaxSize > 0 || gStore != NULL;
+}
+
+// static
+bool TTranslationCache::Find(const TPersistString& key, bool persistent,
+                             TTranslationResult* result)
+{
+    uint32_t hash = HashKey(key);
+
+    TScopedLock lock(&gCacheLock);
+    TEntryIndex::iterator it = FindEntry(hash, key);
+    if (it != gIndex.end()) {
+        gStatistics.hits++;
+        gEntries.splice(gEntries.begin(), gEntries, it->second);
+        *result = it->second->result;
+        return true;
+    }
+
+    if (persistent && gStore && gStore->find(hash, key, result)) {
+        gStatistics.hits++;
+        gStatistics.persistentHits++;
+        if (gMaxSize > 0) {
+            TEntryList staged;
+            StageEntry(hash, key, *result, &staged);
+            AddEntry(&staged);
+        }
+        return true;
+    }
+
+    gStatistics.misses++;
+    return false;
+}
+
+// static
+void TTranslationCache::Insert(const TPersistString& key, bool persistent,
+                               const TTranslationResult& result)
+{
+    // Build the entry before taking the lock, to keep the copy out of it.
+    uint32_t hash = HashKey(key);
+    TEntryList staged;
+    StageEntry(hash, key, result, &staged);
+
+    TScopedLock lock(&gCacheLock);
+    // Another thread may have compiled the same shader in the meantime, in
+    // which case the store ends up with a duplicate that is never found.
+    AddEntry(&staged);
+    if (persistent && gStore)
+        gStore->insert(hash, key, result);
+}
+
+// static
+void TTranslationCache::AddCompileTime(bool hit, double seconds)
+{
+    TScopedLock lock(&gCacheLock);
+    if (hit)
+        gStatistics.hitSeconds += seconds;
+    else
+        gStatistics.missSeconds += seconds;
+}
+
+// static
+TTranslationCacheStatistics TTranslationCache::GetStatistics()
+{
+    TScopedLock lock(&gCacheLock);
+    return gStatistics;
+}
@@ -0,0 +1,86 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#ifndef COMPILER_TRANSLATION_CACHE_H_
+#define COMPILER_TRANSLATION_CACHE_H_
+
+#include "compiler/HashNames.h"
+#include "compiler/Uniform.h"
+#include "compiler/VariableInfo.h"
+
+//
+// Everything a compile leaves for the driver to query.
+//
+struct TTranslationResult {
+    TTranslationResult() : success(false) { }
+
+    // Returns an estimate of the memory held by the result, in bytes.
+    size_t memorySize() const;
+
+    bool success;
+    TPersistString infoLog;
+    TPersistString objectCode;
+    TVariableInfoList attribs;
+    TVariableInfoList uniforms;
+    TVariableInfoList varyings;
+    NameMap nameMap;
+    // Only filled in by the HLSL translator.
+    sh::ActiveUniforms activeUniforms;
+};
+
+struct TTranslationCacheStatistics {
+    size_t hits;
+    size_t persistentHits;  // Hits served from the persistent store.
+    size_t misses;
+    size_t evictions;
+    size_t size;  // In bytes.
+    double hitSeconds;  // Time spent in compiles served from the cache.
+    double missSeconds;  // Time spent in compiles that missed.
+};
+
+//
+// A process-wide cache of translations, shared by all compilers. Keys are
+// opaque byte strings that capture everything the result of a compile
+// depends on (see TCompiler::getTranslationCacheKey()); they are hashed
+// with MurmurHash3 for lookup and compared in full on a hit.
+//
+// The cache is disabled until SetMaxSize() gives it a budget. Past that
+// budget, the least recently used entries are evicted.
+//
+// SetPersistentStore() backs the cache with a TTranslationStore, for the
+// translations that do not depend on the state of the process. The store
+// is looked up on misses in memory, and written on every insertion.
+//
+// All functions may be called from several threads at once; the cache is
+// guarded by a lock created by InitializeLock().
+//
+class TTranslationCache {
+public:
+    static bool InitializeLock();
+    // Also empties the cache.
+    static void FreeLock();
+
+    // Sets the memory budget of the cache, in bytes, evicting entries as
+    // needed. A size of 0 disables the cache and empties it.
+    static void SetMaxSize(size_t maxSize);
+    // Opens the persistent store at path, closing the previous one. A NULL
+    // path only closes it. Returns false if the store cannot be opened.
+    static bool SetPersistentStore(const char* path);
+    static bool IsEnabled();
+
+    // Copies the result cached for key, and returns true on a hit. Only
+    // persistent keys are looked up in, and written to, the persistent
+    // store.
+    static bool Find(const TPersistString& key, bool persistent, TTranslationResult* result);
+    static void Insert(const TPersistString& key, bool persistent,
+                       const TTranslationResult& result);
+
+    // Accounts the time spent in a compile, from its start to its result.
+    static void AddCompileTime(bool hit, double seconds);
+    static TTranslationCacheStatistics GetStatistics();
+};
+
+#endif  // COMPILER_TRANSLATION_CACHE_H_
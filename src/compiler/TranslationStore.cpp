@@ -0,0 +1,478 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#include "compiler/TranslationStore.h"
+
+#include <string.h>
+
+namespace {
+
+const uint32_t kDataMagic = 0x54414441;  // "ADAT"
+const uint32_t kIndexMagic = 0x58444941;  // "AIDX"
+const uint32_t kFormatVersion = 2;  // 2: keys start with the prelude.
+const uint32_t kShVersion = ANGLE_SH_VERSION;
+// Offsets are kept in 32 bits, and must fit in a long for fseek().
+const uint32_t kMaxDataSize = 1 << 30;
+const uint32_t kMinIndexSlots = 64;
+
+struct TDataHeader {
+    uint32_t magic;
+    uint32_t formatVersion;
+    uint32_t shVersion;
+    uint32_t reserved;
+};
+
+// Followed by keySize bytes of key and resultSize bytes of translation.
+struct TRecordHeader {
+    uint32_t hash;
+    uint32_t keySize;
+    uint32_t resultSize;
+    // Of the key and translation, seeded with the hash.
+    uint32_t checksum;
+};
+
+// Followed by numSlots slots.
+struct TIndexHeader {
+    uint32_t magic;
+    uint32_t formatVersion;
+    uint32_t shVersion;
+    uint32_t numSlots;
+    // Size of the data file when the index was written.
+    uint32_t dataSize;
+    uint32_t reserved;
+};
+
+uint32_t Checksum(uint32_t hash, const char* data, size_t size)
+{
+    uint32_t checksum = 0;
+    MurmurHash3_x86_32(data, static_cast<int>(size), hash, &checksum);
+    return checksum;
+}
+
+void WriteUint(TPersistString* out, uint32_t value)
+{
+    out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void WriteString(TPersistString* out, const std::string& value)
+{
+    WriteUint(out, static_cast<uint32_t>(value.size()));
+    out->append(value);
+}
+
+void WriteVariables(TPersistString* out, const TVariableInfoList& variables)
+{
+    WriteUint(out, static_cast<uint32_t>(variables.size()));
+    for (size_t i = 0; i < variables.size(); ++i) {
+        const TVariableInfo& variable = variables[i];
+        WriteString(out, variable.name);
+        WriteString(out, variable.mappedName);
+        WriteUint(out, variable.type);
+        WriteUint(out, variable.size);
+        WriteUint(out, variable.precision);
+        WriteUint(out, variable.staticUse);
+    }
+}
+
+void WriteTranslation(TPersistString* out, const TTranslationResult& result)
+{
+    WriteUint(out, result.success);
+    WriteString(out, result.infoLog);
+    WriteString(out, result.objectCode);
+    WriteVariables(out, result.attribs);
+    WriteVariables(out, result.uniforms);
+    WriteVariables(out, result.varyings);
+
+    WriteUint(out, static_cast<uint32_t>(result.nameMap.size()));
+    for (NameMap::const_iterator it = result.nameMap.begin(); it != result.nameMap.end(); ++it) {
+        WriteString(out, it->first);
+        WriteString(out, it->second);
+    }
+
+    WriteUint(out, static_cast<uint32_t>(result.activeUniforms.size()));
+    for (size_t i = 0; i < result.activeUniforms.size(); ++i) {
+        const sh::Uniform& uniform = result.activeUniforms[i];
+        WriteUint(out, uniform.type);
+        WriteUint(out, uniform.precision);
+        WriteString(out, uniform.name);
+        WriteUint(out, uniform.arraySize);
+        WriteUint(out, uniform.registerIndex);
+    }
+}
+
+//
+// Reads back what the functions above write. Reading past the end of the
+// record makes the reader invalid, and returns zeros and empty strings.
+//
+class TRecordReader {
+public:
+    TRecordReader(const char* data, size_t size)
+        : mData(data), mEnd(data + size), mValid(true) { }
+
+    // True if every read succeeded and the whole record was read.
+    bool isValidAndDone() const { return mValid && mData == mEnd; }
+
+    uint32_t readUint()
+    {
+        uint32_t value = 0;
+        if (!mValid || static_cast<size_t>(mEnd - mData) < sizeof(value)) {
+            mValid = false;
+            return 0;
+        }
+        memcpy(&value, mData, sizeof(value));
+        mData += sizeof(value);
+        return value;
+    }
+
+    std::string readString()
+    {
+        uint32_t size = readUint();
+        if (!mValid || static_cast<size_t>(mEnd - mData) < size) {
+            mValid = false;
+            return std::string();
+        }
+        std::string value(mData, size);
+        mData += size;
+        return value;
+    }
+
+    // Every element takes at least a byte, which bounds the allocations made
+    // for a corrupted count.
+    uint32_t readCount()
+    {
+        uint32_t count = readUint();
+        if (static_cast<size_t>(mEnd - mData) < count) {
+            mValid = false;
+            return 0;
+        }
+        return count;
+    }
+
+private:
+    const char* mData;
+    const char* mEnd;
+    bool mValid;
+};
+
+void ReadVariables(TRecordReader* reader, TVariableInfoList* variables)
+{
+    variables->resize(reader->readCount());
+    for (size_t i = 0; i < variables->size(); ++i) {
+        TVariableInfo& variable = (*variables)[i];
+        variable.name = reader->readString();
+        variable.mappedName = reader->readString();
+        variable.type = static_cast<ShDataType>(reader->readUint());
+        variable.size = static_cast<int>(reader->readUint());
+        variable.precision = static_cast<TPrecision>(reader->readUint());
+        variable.staticUse = reader->readUint() != 0;
+    }
+}
+
+bool ReadTranslation(const char* data, size_t size, TTranslationResult* result)
+{
+    TRecordReader reader(data, size);
+    result->success = reader.readUint() != 0;
+    result->infoLog = reader.readString();
+    result->objectCode = reader.readString();
+    ReadVariables(&reader, &result->attribs);
+    ReadVariables(&reader, &result->uniforms);
+    ReadVariables(&reader, &result->varyings);
+
+    result->nameMap.clear();
+    uint32_t numNames = reader.readCount();
+    for (uint32_t i = 0; i < numNames; ++i) {
+        TPersistString name = reader.readString();
+        result->nameMap[name] = reader.readString();
+    }
+
+    result->activeUniforms.clear();
+    uint32_t numUniforms = reader.readCount();
+    for (uint32_t i = 0; i < numUniforms; ++i) {
+        GLenum type = reader.readUint();
+        GLenum precision = reader.readUint();
+        std::string name = reader.readString();
+        int arraySize = static_cast<int>(reader.readUint());
+        int registerIndex = static_cast<int>(reader.readUint());
+        result->activeUniforms.push_back(
+            sh::Uniform(type, precision, name.c_str(), arraySize, registerIndex));
+    }
+
+    return reader.isValidAndDone();
+}
+
+}  // anonymous namespace
+
+struct TTranslationStore::TIndexSlot {
+    uint32_t hash;
+    // 0 for an empty slot.
+    uint32_t offset;
+};
+
+// static
+TTranslationStore* TTranslationStore::Open(const char* path)
+{
+    TTranslationStore* store = new TTranslationStore(path);
+    if (!store->openData()) {
+        delete store;
+        return NULL;
+    }
+    return store;
+}
+
+TTranslationStore::TTranslationStore(const char* path)
+    : dataPath(path),
+      indexPath(dataPath + ".index"),
+      dataFile(NULL),
+      dataFileSize(0),
+      dataEnd(0),
+      indexSlots(NULL),
+      numIndexSlots(0),
+      indexedEnd(0)
+{
+}
+
+TTranslationStore::~TTranslationStore()
+{
+    if (dataFile) {
+        writeIndex();
+        fclose(dataFile);
+    }
+    OS_UnmapFile(&indexFile);
+}
+
+bool TTranslationStore::openData()
+{
+    dataFile = fopen(dataPath.c_str(), "r+b");
+    if (dataFile) {
+        TDataHeader header;
+        long size = 0;
+        if (fread(&header, sizeof(header), 1, dataFile) == 1 &&
+            header.magic == kDataMagic &&
+            header.formatVersion == kFormatVersion &&
+            header.shVersion == kShVersion &&
+            fseek(dataFile, 0, SEEK_END) == 0 &&
+            (size = ftell(dataFile)) >= 0) {
+            // Anything past kMaxDataSize cannot be addressed, and is
+            // overwritten as if it were garbage.
+            dataFileSize = static_cast<unsigned long>(size) < kMaxDataSize ?
+                static_cast<uint32_t>(size) : kMaxDataSize;
+            dataEnd = sizeof(header);
+            openIndex();
+            recoverRecords(dataEnd);
+            return true;
+        }
+        fclose(dataFile);
+    }
+
+    // The store is new, or was written by another version of the translator.
+    dataFile = fopen(dataPath.c_str(), "w+b");
+    if (!dataFile)
+        return false;
+
+    TDataHeader header = { kDataMagic, kFormatVersion, kShVersion, 0 };
+    if (fwrite(&header, sizeof(header), 1, dataFile) != 1 || fflush(dataFile) != 0) {
+        fclose(dataFile);
+        dataFile = NULL;
+        return false;
+    }
+    dataFileSize = dataEnd = sizeof(header);
+    return true;
+}
+
+void TTranslationStore::openIndex()
+{
+    if (!OS_MapFile(indexPath.c_str(), &indexFile))
+        return;
+
+    const TIndexHeader* header = static_cast<const TIndexHeader*>(indexFile.data);
+    if (indexFile.size < sizeof(TIndexHeader) ||
+        header->magic != kIndexMagic ||
+        header->formatVersion != kFormatVersion ||
+        header->shVersion != kShVersion ||
+        header->numSlots == 0 ||
+        (header->numSlots & (header->numSlots - 1)) != 0 ||
+        header->numSlots > (indexFile.size - sizeof(TIndexHeader)) / sizeof(TIndexSlot) ||
+        indexFile.size != sizeof(TIndexHeader) + header->numSlots * sizeof(TIndexSlot) ||
+        header->dataSize < sizeof(TDataHeader) ||
+        header->dataSize > dataFileSize) {
+        // Rebuild the index from the data file.
+        OS_UnmapFile(&indexFile);
+        return;
+    }
+
+    indexSlots = reinterpret_cast<const TIndexSlot*>(header + 1);
+    numIndexSlots = header->numSlots;
+    indexedEnd = header->dataSize;
+    dataEnd = indexedEnd;
+}
+
+//
+// Indexes the records from offset on, up to the first one that is not
+// valid. That is where the process that last wrote the store stopped, if it
+// did not close it; the next record will be written there.
+//
+void TTranslationStore::recoverRecords(uint32_t offset)
+{
+    uint32_t hash = 0;
+    uint32_t keySize = 0;
+    std::vector<char> payload;
+    while (readRecord(offset, &hash, &keySize, &payload)) {
+        pendingIndex.insert(TPendingIndex::value_type(hash, offset));
+        offset += static_cast<uint32_t>(sizeof(TRecordHeader) + payload.size());
+    }
+    dataEnd = offset;
+}
+
+bool TTranslationStore::readRecord(uint32_t offset, uint32_t* hash, uint32_t* keySize,
+                                   std::vector<char>* payload)
+{
+    if (offset < sizeof(TDataHeader) ||
+        offset > dataFileSize ||
+        dataFileSize - offset < sizeof(TRecordHeader))
+        return false;
+
+    TRecordHeader header;
+    if (fseek(dataFile, offset, SEEK_SET) != 0 ||
+        fread(&header, sizeof(header), 1, dataFile) != 1)
+        return false;
+
+    uint32_t available = dataFileSize - offset - static_cast<uint32_t>(sizeof(TRecordHeader));
+    if (header.keySize == 0 ||
+        header.keySize > available ||
+        header.resultSize > available - header.keySize)
+        return false;
+
+    payload->resize(header.keySize + header.resultSize);
+    if (fread(&(*payload)[0], payload->size(), 1, dataFile) != 1 ||
+        Checksum(header.hash, &(*payload)[0], payload->size()) != header.checksum)
+        return false;
+
+    *hash = header.hash;
+    *keySize = header.keySize;
+    return true;
+}
+
+bool TTranslationStore::readTranslation(uint32_t offset, uint32_t hash,
+                                        const TPersistString& key,
+                                        TTranslationResult* result)
+{
+    uint32_t recordHash = 0;
+    uint32_t keySize = 0;
+    std::vector<char> payload;
+    if (!readRecord(offset, &recordHash, &keySize, &payload) ||
+        recordHash != hash ||
+        keySize != key.size() ||
+        memcmp(&payload[0], key.data(), keySize) != 0)
+        return false;
+
+    return ReadTranslation(&payload[keySize], payload.size() - keySize, result);
+}
+
+bool TTranslationStore::find(uint32_t hash, const TPersistString& key,
+                             TTranslationResult* result)
+{
+    if (indexSlots) {
+        uint32_t mask = numIndexSlots - 1;
+        for (uint32_t i = 0; i < numIndexSlots; ++i) {
+            const TIndexSlot& slot = indexSlots[(hash + i) & mask];
+            if (slot.offset == 0)
+                break;
+            if (slot.hash == hash && readTranslation(slot.offset, hash, key, result))
+                return true;
+        }
+    }
+
+    std::pair<TPendingIndex::iterator, TPendingIndex::iterator> range =
+        pendingIndex.equal_range(hash);
+    for (TPendingIndex::iterator it = range.first; it != range.second; ++it) {
+        if (readTranslation(it->second, hash, key, result))
+            return true;
+    }
+    return false;
+}
+
+void TTranslationStore::insert(uint32_t hash, const TPersistString& key,
+                               const TTranslationResult& result)
+{
+    TPersistString record(sizeof(TRecordHeader), '\0');
+    record.append(key);
+    WriteTranslation(&record, result);
+    // The store is full.
+    if (record.size() > kMaxDataSize - dataEnd)
+        return;
+
+    TRecordHeader header;
+    header.hash = hash;
+    header.keySize = static_cast<uint32_t>(key.size());
+    header.resultSize = static_cast<uint32_t>(record.size() - sizeof(header) - key.size());
+    header.checksum = Checksum(hash, record.data() + sizeof(header), record.size() - sizeof(header));
+    memcpy(&record[0], &header, sizeof(header));
+
+    // Flush each record, so that it is kept if the process exits without
+    // closing the store. A record that is only partly written is overwritten
+    // by the next one.
+    if (fseek(dataFile, dataEnd, SEEK_SET) != 0 ||
+        fwrite(record.data(), record.size(), 1, dataFile) != 1 ||
+        fflush(dataFile) != 0)
+        return;
+
+    pendingIndex.insert(TPendingIndex::value_type(hash, dataEnd));
+    dataEnd += static_cast<uint32_t>(record.size());
+    if (dataFileSize < dataEnd)
+        dataFileSize = dataEnd;
+}
+
+void TTranslationStore::writeIndex()
+{
+    if (indexSlots && pendingIndex.empty())
+        return;
+
+    std::vector<TIndexSlot> entries;
+    for (uint32_t i = 0; i < numIndexSlots; ++i) {
+        if (indexSlots[i].offset != 0)
+            entries.push_back(indexSlots[i]);
+    }
+    for (TPendingIndex::const_iterator it = pendingIndex.begin(); it != pendingIndex.end(); ++it) {
+        TIndexSlot entry = { it->first, it->second };
+        entries.push_back(entry);
+    }
+
+    // Keep the table at most half full, so that probe sequences stay short.
+    uint32_t numSlots = kMinIndexSlots;
+    while (numSlots < 2 * entries.size())
+        numSlots *= 2;
+    TIndexSlot emptySlot = { 0, 0 };
+    std::vector<TIndexSlot> slots(numSlots, emptySlot);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        uint32_t slot = entries[i].hash & (numSlots - 1);
+        while (slots[slot].offset != 0)
+            slot = (slot + 1) & (numSlots - 1);
+        slots[slot] = entries[i];
+    }
+
+    // A mapped file cannot be replaced on Windows.
+    OS_UnmapFile(&indexFile);
+    indexSlots = NULL;
+    numIndexSlots = 0;
+
+    // Write the index aside, so that a failure leaves the old one in place.
+    TPersistString tempPath = indexPath + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file)
+        return;
+    TIndexHeader header = { kIndexMagic, kFormatVersion, kShVersion, numSlots, dataEnd, 0 };
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fwrite(&slots[0], sizeof(TIndexSlot), numSlots, file) == numSlots;
+    written = fclose(file) == 0 && written;
+
+    if (written) {
+        // rename() does not replace an existing file on Windows.
+        remove(indexPath.c_str());
+        written = rename(tempPath.c_str(), indexPath.c_str()) == 0;
+    }
+    if (!written)
+        remove(tempPath.c_str());
+}
@@ -0,0 +1,87 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#ifndef COMPILER_TRANSLATION_STORE_H_
+#define COMPILER_TRANSLATION_STORE_H_
+
+#include <stdio.h>
+#include <map>
+
+#include "compiler/TranslationCache.h"
+#include "compiler/osinclude.h"
+#include "third_party/murmurhash/MurmurHash3.h"
+
+//
+// Keeps translations on disk, so that they outlive the process.
+//
+// The store is made of two files. <path> holds the translations, as records
+// appended one after the other. <path>.index is an open-addressed hash
+// table from key hashes to record offsets, which is mapped in memory when
+// the store is opened, so that opening it costs the same however many
+// translations it holds. Records added since the index was last written
+// are indexed in memory, and the index is rewritten when the store is
+// closed. If the process exits without closing the store, the records past
+// the end of the index are found again by scanning the data file on the
+// next open.
+//
+// Both files start with ANGLE_SH_VERSION; a store written by another
+// version of the translator is discarded. Every record carries a checksum,
+// and every offset read from the files is checked, so that truncated or
+// corrupted files only cause misses.
+//
+// The store is not thread-safe, and must not be opened by two processes at
+// once; TTranslationCache guards it with its own lock.
+//
+class TTranslationStore {
+public:
+    // Opens the store at path, creating it if needed. Returns NULL if the
+    // data file can neither be opened nor created.
+    static TTranslationStore* Open(const char* path);
+    // Writes the index and closes the files.
+    ~TTranslationStore();
+
+    // Copies the translation stored for key, and returns true if there is
+    // one. hash is the hash of key.
+    bool find(uint32_t hash, const TPersistString& key, TTranslationResult* result);
+    void insert(uint32_t hash, const TPersistString& key, const TTranslationResult& result);
+
+private:
+    struct TIndexSlot;
+    typedef std::multimap<uint32_t, uint32_t> TPendingIndex;
+
+    explicit TTranslationStore(const char* path);
+
+    bool openData();
+    void openIndex();
+    void recoverRecords(uint32_t offset);
+    void writeIndex();
+
+    // Reads the record at offset, checking its checksum, and returns false
+    // if it is not a valid record.
+    bool readRecord(uint32_t offset, uint32_t* hash, uint32_t* keySize,
+                    std::vector<char>* payload);
+    bool readTranslation(uint32_t offset, uint32_t hash, const TPersistString& key,
+                         TTranslationResult* result);
+
+    TPersistString dataPath;
+    TPersistString indexPath;
+
+    FILE* dataFile;
+    uint32_t dataFileSize;
+    // End of the last valid record, where the next one is written.
+    uint32_t dataEnd;
+
+    OS_MappedFile indexFile;
+    const TIndexSlot* indexSlots;
+    uint32_t numIndexSlots;
+    // End of the records covered by the mapped index.
+    uint32_t indexedEnd;
+
+    // Records past indexedEnd, by hash.
+    TPendingIndex pendingIndex;
+};
+
+#endif  // COMPILER_TRANSLATION_STORE_H_
@@ -9,10 +9,10 @@
 #include "compiler/OutputESSL.h"
 
 TranslatorESSL::TranslatorESSL(ShShaderType type, ShShaderSpec spec)
-    : TCompiler(type, spec) {
+    : TCompiler(type, spec, SH_ESSL_OUTPUT) {
 }
 
-void TranslatorESSL::translate(TIntermNode* root) {
+void TranslatorESSL::translate(TIntermNode* root, TParseContext& parseContext) {
     TInfoSinkBase& sink = getInfoSink().obj;
 
     // Write built-in extension behaviors.
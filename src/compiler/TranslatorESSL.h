@@ -14,7 +14,7 @@ public:
     TranslatorESSL(ShShaderType type, ShShaderSpec spec);
 
 protected:
-    virtual void translate(TIntermNode* root);
+    virtual void translate(TIntermNode* root, TParseContext& parseContext);
 
 private:
     void writeExtensionBehavior();
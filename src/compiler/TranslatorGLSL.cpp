@@ -22,10 +22,10 @@ static void writeVersion(ShShaderType type, TIntermNode* root,
 }
 
 TranslatorGLSL::TranslatorGLSL(ShShaderType type, ShShaderSpec spec)
-    : TCompiler(type, spec) {
+    : TCompiler(type, spec, SH_GLSL_OUTPUT) {
 }
 
-void TranslatorGLSL::translate(TIntermNode* root) {
+void TranslatorGLSL::translate(TIntermNode* root, TParseContext& parseContext) {
     TInfoSinkBase& sink = getInfoSink().obj;
 
     // Write GLSL version.
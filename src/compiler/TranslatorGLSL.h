@@ -14,7 +14,7 @@ public:
     TranslatorGLSL(ShShaderType type, ShShaderSpec spec);
 
 protected:
-    virtual void translate(TIntermNode* root);
+    virtual void translate(TIntermNode* root, TParseContext& parseContext);
 };
 
 #endif  // COMPILER_TRANSLATORGLSL_H_
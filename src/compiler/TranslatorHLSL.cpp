@@ -6,19 +6,30 @@
 
 #include "compiler/TranslatorHLSL.h"
 
-#include "compiler/InitializeParseContext.h"
 #include "compiler/OutputHLSL.h"
+#include "compiler/TranslationCache.h"
 
 TranslatorHLSL::TranslatorHLSL(ShShaderType type, ShShaderSpec spec, ShShaderOutput output)
-    : TCompiler(type, spec), mOutputType(output)
+    : TCompiler(type, spec, output), mOutputType(output)
 {
 }
 
-void TranslatorHLSL::translate(TIntermNode *root)
+void TranslatorHLSL::translate(TIntermNode *root, TParseContext& parseContext)
 {
-    TParseContext& parseContext = *GetGlobalParseContext();
     sh::OutputHLSL outputHLSL(parseContext, getResources(), mOutputType);
 
     outputHLSL.output();
     mActiveUniforms = outputHLSL.getUniforms();
 }
+
+void TranslatorHLSL::saveResults(TTranslationResult* result) const
+{
+    TCompiler::saveResults(result);
+    result->activeUniforms = mActiveUniforms;
+}
+
+void TranslatorHLSL::restoreResults(const TTranslationResult& result)
+{
+    TCompiler::restoreResults(result);
+    mActiveUniforms = result.activeUniforms;
+}
@@ -18,7 +18,9 @@ public:
     const sh::ActiveUniforms &getUniforms() { return mActiveUniforms; }
 
 protected:
-    virtual void translate(TIntermNode* root);
+    virtual void translate(TIntermNode* root, TParseContext& parseContext);
+    virtual void saveResults(TTranslationResult* result) const;
+    virtual void restoreResults(const TTranslationResult& result);
 
     sh::ActiveUniforms mActiveUniforms;
     ShShaderOutput mOutputType;
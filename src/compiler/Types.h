@@ -42,49 +42,37 @@ inline TFieldList* NewPoolTFieldList()
     return new(memory) TFieldList;
 }
 
+//
+// The type of a structure. Types of the same structure are equal, and share
+// the properties that follow from its fields, which are computed once when
+// the structure is made: the fields must be complete by then.
+//
 class TStructure
 {
 public:
     POOL_ALLOCATOR_NEW_DELETE();
-    TStructure(TString* name, TFieldList* fields)
-        : mName(name),
-          mFields(fields),
-          mObjectSize(0),
-          mDeepestNesting(0) {
-    }
+    TStructure(TString* name, TFieldList* fields);
 
     const TString& name() const { return *mName; }
     const TFieldList& fields() const { return *mFields; }
 
-    const TString& mangledName() const {
-        if (mMangledName.empty())
-            mMangledName = buildMangledName();
-        return mMangledName;
-    }
-    size_t objectSize() const {
-        if (mObjectSize == 0)
-            mObjectSize = calculateObjectSize();
-        return mObjectSize;
-    };
-    int deepestNesting() const {
-        if (mDeepestNesting == 0)
-            mDeepestNesting = calculateDeepestNesting();
-        return mDeepestNesting;
-    }
-    bool containsArrays() const;
+    const TString& mangledName() const { return mMangledName; }
+    size_t objectSize() const { return mObjectSize; }
+    int registerCount() const { return mRegisterCount; }
+    int deepestNesting() const { return mDeepestNesting; }
+    bool containsArrays() const { return mContainsArrays; }
 
 private:
     DISALLOW_COPY_AND_ASSIGN(TStructure);
-    TString buildMangledName() const;
-    size_t calculateObjectSize() const;
-    int calculateDeepestNesting() const;
 
     TString* mName;
     TFieldList* mFields;
 
-    mutable TString mMangledName;
-    mutable size_t mObjectSize;
-    mutable int mDeepestNesting;
+    TString mMangledName;
+    size_t mObjectSize;
+    int mRegisterCount;
+    int mDeepestNesting;
+    bool mContainsArrays;
 };
 
 //
@@ -96,23 +84,24 @@ public:
     POOL_ALLOCATOR_NEW_DELETE();
     TType() {}
     TType(TBasicType t, TPrecision p, TQualifier q = EvqTemporary, unsigned char s = 1, bool m = false, bool a = false) :
-            type(t), precision(p), qualifier(q), size(s), matrix(m), array(a), arraySize(0), structure(0)
+            type(static_cast<unsigned char>(t)), precision(static_cast<unsigned char>(p)), qualifier(static_cast<unsigned char>(q)),
+            size(s), matrix(m), array(a), arraySize(0), structure(0)
     {
     }
     explicit TType(const TPublicType &p);
     TType(TStructure* userDef, TPrecision p = EbpUndefined) :
-            type(EbtStruct), precision(p), qualifier(EvqTemporary), size(1), matrix(false), array(false), arraySize(0), structure(userDef)
+            type(EbtStruct), precision(static_cast<unsigned char>(p)), qualifier(EvqTemporary), size(1), matrix(false), array(false), arraySize(0), structure(userDef)
     {
     }
 
-    TBasicType getBasicType() const { return type; }
-    void setBasicType(TBasicType t) { type = t; }
+    TBasicType getBasicType() const { return static_cast<TBasicType>(type); }
+    void setBasicType(TBasicType t) { type = static_cast<unsigned char>(t); }
 
-    TPrecision getPrecision() const { return precision; }
-    void setPrecision(TPrecision p) { precision = p; }
+    TPrecision getPrecision() const { return static_cast<TPrecision>(precision); }
+    void setPrecision(TPrecision p) { precision = static_cast<unsigned char>(p); }
 
-    TQualifier getQualifier() const { return qualifier; }
-    void setQualifier(TQualifier q) { qualifier = q; }
+    TQualifier getQualifier() const { return static_cast<TQualifier>(qualifier); }
+    void setQualifier(TQualifier q) { qualifier = static_cast<unsigned char>(q); }
 
     // One-dimensional size of single instance type
     int getNominalSize() const { return size; }
@@ -124,15 +113,7 @@ public:
     {
         if (structure)
         {
-            const TFieldList &fields = getStruct()->fields();
-            int registerCount = 0;
-
-            for (size_t i = 0; i < fields.size(); i++)
-            {
-                registerCount += fields[i]->type()->totalRegisterCount();
-            }
-
-            return registerCount;
+            return structure->registerCount();
         }
         else if (isMatrix())
         {
@@ -170,13 +151,9 @@ public:
     TStructure* getStruct() const { return structure; }
     void setStruct(TStructure* s) { structure = s; }
 
-    const TString& getMangledName() const {
-        if (mangled.empty()) {
-            mangled = buildMangledName();
-            mangled += ';';
-        }
-        return mangled;
-    }
+    // Appends the mangled name of the type, by which the signatures of
+    // functions tell their parameters apart, to name.
+    void appendMangledName(TString& name) const;
 
     bool sameElementType(const TType& right) const {
         return      type == right.type   &&
@@ -206,9 +183,9 @@ public:
         return false;
     }
 
-    const char* getBasicString() const { return ::getBasicString(type); }
-    const char* getPrecisionString() const { return ::getPrecisionString(precision); }
-    const char* getQualifierString() const { return ::getQualifierString(qualifier); }
+    const char* getBasicString() const { return ::getBasicString(getBasicType()); }
+    const char* getPrecisionString() const { return ::getPrecisionString(getPrecision()); }
+    const char* getQualifierString() const { return ::getQualifierString(getQualifier()); }
     TString getCompleteString() const;
 
     // If this type is a struct, returns the deepest struct nesting of
@@ -232,19 +209,17 @@ public:
     }
 
 private:
-    TString buildMangledName() const;
-
-    TBasicType type;
-    TPrecision precision;
-    TQualifier qualifier;
+    // The enums are kept in bytes. The type is then no larger than three
+    // pointers, which makes up for the kind that tree nodes store.
+    unsigned char type;         // TBasicType
+    unsigned char precision;    // TPrecision
+    unsigned char qualifier;    // TQualifier
     unsigned char size;
     bool matrix;
     bool array;
     int arraySize;
 
     TStructure* structure;      // 0 unless this is a struct
-
-    mutable TString mangled;
 };
 
 //
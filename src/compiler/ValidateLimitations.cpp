@@ -6,8 +6,7 @@
 
 #include "compiler/ValidateLimitations.h"
 #include "compiler/InfoSink.h"
-#include "compiler/InitializeParseContext.h"
-#include "compiler/ParseContext.h"
+#include "compiler/SymbolTable.h"
 
 namespace {
 bool IsLoopIndex(const TIntermSymbol* symbol, const TLoopStack& stack) {
@@ -97,15 +96,23 @@ private:
 }  // namespace
 
 ValidateLimitations::ValidateLimitations(ShShaderType shaderType,
+                                         TSymbolTable& symbolTable,
                                          TInfoSinkBase& sink)
-    : mShaderType(shaderType),
+    : TIntermTraverser(true, false, true),
+      mShaderType(shaderType),
+      mSymbolTable(symbolTable),
       mSink(sink),
       mNumErrors(0)
 {
 }
 
-bool ValidateLimitations::visitBinary(Visit, TIntermBinary* node)
+bool ValidateLimitations::visitBinary(Visit visit, TIntermBinary* node)
 {
+    if (visit != PreVisit)
+        return true;
+    if (isLoopHeader(node))
+        return false;
+
     // Check if loop index is modified in the loop body.
     validateOperation(node, node->getLeft());
 
@@ -141,16 +148,26 @@ bool ValidateLimitations::visitBinary(Visit, TIntermBinary* node)
     return true;
 }
 
-bool ValidateLimitations::visitUnary(Visit, TIntermUnary* node)
+bool ValidateLimitations::visitUnary(Visit visit, TIntermUnary* node)
 {
+    if (visit != PreVisit)
+        return true;
+    if (isLoopHeader(node))
+        return false;
+
     // Check if loop index is modified in the loop body.
     validateOperation(node, node->getOperand());
 
     return true;
 }
 
-bool ValidateLimitations::visitAggregate(Visit, TIntermAggregate* node)
+bool ValidateLimitations::visitAggregate(Visit visit, TIntermAggregate* node)
 {
+    if (visit != PreVisit)
+        return true;
+    if (isLoopHeader(node))
+        return false;
+
     switch (node->getOp()) {
       case EOpFunctionCall:
         validateFunctionCall(node);
@@ -161,8 +178,13 @@ bool ValidateLimitations::visitAggregate(Visit, TIntermAggregate* node)
     return true;
 }
 
-bool ValidateLimitations::visitLoop(Visit, TIntermLoop* node)
+bool ValidateLimitations::visitLoop(Visit visit, TIntermLoop* node)
 {
+    if (visit == PostVisit) {
+        mLoopStack.pop_back();
+        return true;
+    }
+
     if (!validateLoopType(node))
         return false;
 
@@ -172,15 +194,10 @@ bool ValidateLimitations::visitLoop(Visit, TIntermLoop* node)
     if (!validateForLoopHeader(node, &info))
         return false;
 
-    TIntermNode* body = node->getBody();
-    if (body != NULL) {
-        mLoopStack.push_back(info);
-        body->traverse(this);
-        mLoopStack.pop_back();
-    }
-
-    // The loop is fully processed - no need to visit children.
-    return false;
+    // The header is fully processed - only the body is visited, within
+    // the loop, up to the post-visit.
+    mLoopStack.push_back(info);
+    return true;
 }
 
 void ValidateLimitations::error(TSourceLoc loc,
@@ -202,6 +219,15 @@ bool ValidateLimitations::isLoopIndex(const TIntermSymbol* symbol) const
     return IsLoopIndex(symbol, mLoopStack);
 }
 
+bool ValidateLimitations::isLoopHeader(const TIntermNode* node) const
+{
+    if (mLoopStack.empty())
+        return false;
+    TIntermLoop* loop = mLoopStack.back().loop;
+    return node == loop->getInit() || node == loop->getCondition() ||
+           node == loop->getExpression();
+}
+
 bool ValidateLimitations::validateLoopType(TIntermLoop* node) {
     TLoopType type = node->getType();
     if (type == ELoopFor)
@@ -435,8 +461,7 @@ bool ValidateLimitations::validateFunctionCall(TIntermAggregate* node)
         return true;
 
     bool valid = true;
-    TSymbolTable& symbolTable = GetGlobalParseContext()->symbolTable;
-    TSymbol* symbol = symbolTable.find(node->getName());
+    TSymbol* symbol = mSymbolTable.find(node->getName());
     ASSERT(symbol && symbol->isFunction());
     TFunction* function = static_cast<TFunction*>(symbol);
     for (ParamIndex::const_iterator i = pIndex.begin();
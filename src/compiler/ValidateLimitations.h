@@ -8,6 +8,7 @@
 #include "compiler/intermediate.h"
 
 class TInfoSinkBase;
+class TSymbolTable;
 
 struct TLoopInfo {
     struct TIndex {
@@ -19,9 +20,13 @@ typedef TVector<TLoopInfo> TLoopStack;
 
 // Traverses intermediate tree to ensure that the shader does not exceed the
 // minimum functionality mandated in GLSL 1.0 spec, Appendix A.
+// It visits the nodes before and after their children only, so that it can
+// share a traversal with other passes.
 class ValidateLimitations : public TIntermTraverser {
 public:
-    ValidateLimitations(ShShaderType shaderType, TInfoSinkBase& sink);
+    ValidateLimitations(ShShaderType shaderType,
+                        TSymbolTable& symbolTable,
+                        TInfoSinkBase& sink);
 
     int numErrors() const { return mNumErrors; }
 
@@ -35,6 +40,9 @@ private:
 
     bool withinLoopBody() const;
     bool isLoopIndex(const TIntermSymbol* symbol) const;
+    // Returns true if node is the init, condition or expression of the
+    // innermost loop, which validateForLoopHeader() checks.
+    bool isLoopHeader(const TIntermNode* node) const;
     bool validateLoopType(TIntermLoop* node);
     bool validateForLoopHeader(TIntermLoop* node, TLoopInfo* info);
     bool validateForLoopInit(TIntermLoop* node, TLoopInfo* info);
@@ -52,6 +60,7 @@ private:
     bool validateIndexing(TIntermBinary* node);
 
     ShShaderType mShaderType;
+    TSymbolTable& mSymbolTable;
     TInfoSinkBase& mSink;
     int mNumErrors;
     TLoopStack mLoopStack;
@@ -0,0 +1,114 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#include "compiler/WorkStealingPool.h"
+
+TWorkStealingPool::TWorkStealingPool(int threads)
+    : numThreads(threads > 0 ? threads : OS_GetProcessorCount()),
+      currentTask(NULL),
+      currentContext(NULL)
+{
+}
+
+void TWorkStealingPool::run(size_t count, Task task, void* context)
+{
+    if (count == 0)
+        return;
+
+    size_t numWorkers = static_cast<size_t>(numThreads);
+    if (numWorkers > count)
+        numWorkers = count;
+
+    currentTask = task;
+    currentContext = context;
+
+    // Deal the tasks out in contiguous shares, so that neighbouring tasks,
+    // which tend to be alike, run on the same thread.
+    workers.resize(numWorkers);
+    for (size_t i = 0; i < numWorkers; ++i) {
+        Worker& worker = workers[i];
+        worker.pool = this;
+        worker.id = i;
+        worker.begin = count * i / numWorkers;
+        worker.end = count * (i + 1) / numWorkers;
+        OS_InitMutex(&worker.lock);
+    }
+
+    std::vector<OS_Thread> threads;
+    threads.reserve(numWorkers - 1);
+    for (size_t i = 1; i < numWorkers; ++i) {
+        OS_Thread thread;
+        if (OS_CreateThread(&thread, WorkerMain, &workers[i]))
+            threads.push_back(thread);
+        // If a thread cannot be started, its share is stolen by the others.
+    }
+
+    work(0);
+
+    for (size_t i = 0; i < threads.size(); ++i)
+        OS_JoinThread(threads[i]);
+
+    for (size_t i = 0; i < numWorkers; ++i)
+        OS_FreeMutex(&workers[i].lock);
+    workers.clear();
+    currentTask = NULL;
+    currentContext = NULL;
+}
+
+// static
+void TWorkStealingPool::WorkerMain(void* param)
+{
+    Worker* worker = static_cast<Worker*>(param);
+    worker->pool->work(worker->id);
+}
+
+void TWorkStealingPool::work(size_t id)
+{
+    size_t index = 0;
+    while (takeTask(id, &index) || stealTask(id, &index))
+        currentTask(index, currentContext);
+}
+
+bool TWorkStealingPool::takeTask(size_t id, size_t* index)
+{
+    Worker& worker = workers[id];
+    TScopedLock lock(&worker.lock);
+    if (worker.begin == worker.end)
+        return false;
+    *index = worker.begin++;
+    return true;
+}
+
+//
+// Takes the second half of the tasks left to another worker, keeping the
+// first of them to run now. No task is ever added to the batch, so a worker
+// that finds every other worker out of tasks is done.
+//
+bool TWorkStealingPool::stealTask(size_t id, size_t* index)
+{
+    size_t numWorkers = workers.size();
+    for (size_t i = 1; i < numWorkers; ++i) {
+        Worker& victim = workers[(id + i) % numWorkers];
+        size_t begin = 0;
+        size_t end = 0;
+        {
+            TScopedLock lock(&victim.lock);
+            if (victim.begin == victim.end)
+                continue;
+            begin = victim.begin + (victim.end - victim.begin) / 2;
+            end = victim.end;
+            victim.end = begin;
+        }
+
+        *index = begin;
+        Worker& thief = workers[id];
+        TScopedLock lock(&thief.lock);
+        thief.begin = begin + 1;
+        thief.end = end;
+        return true;
+    }
+    return false;
+}
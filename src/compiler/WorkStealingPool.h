@@ -0,0 +1,58 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#ifndef COMPILER_WORK_STEALING_POOL_H_
+#define COMPILER_WORK_STEALING_POOL_H_
+
+#include <stddef.h>
+#include <vector>
+
+#include "compiler/osinclude.h"
+
+//
+// Runs a batch of independent tasks, numbered 0 to count - 1, on a pool of
+// threads. Each worker starts with a contiguous share of the tasks, which it
+// runs in order. A worker that runs out steals the second half of the tasks
+// left to another worker, so that long tasks do not leave threads idle.
+//
+// The calling thread is one of the workers; the others are started by run()
+// and joined before it returns.
+//
+class TWorkStealingPool {
+public:
+    typedef void (*Task)(size_t index, void* context);
+
+    // A numThreads of 0 or less uses one thread per processor.
+    explicit TWorkStealingPool(int numThreads);
+
+    int getNumThreads() const { return numThreads; }
+
+    // Runs task(i, context) for each i in [0, count), and returns once all
+    // of them are done.
+    void run(size_t count, Task task, void* context);
+
+private:
+    struct Worker {
+        TWorkStealingPool* pool;
+        size_t id;
+        // Tasks left to the worker: [begin, end).
+        OS_Mutex lock;
+        size_t begin;
+        size_t end;
+    };
+
+    static void WorkerMain(void* param);
+    void work(size_t id);
+    bool takeTask(size_t id, size_t* index);
+    bool stealTask(size_t id, size_t* index);
+
+    int numThreads;
+    Task currentTask;
+    void* currentContext;
+    std::vector<Worker> workers;
+};
+
+#endif  // COMPILER_WORK_STEALING_POOL_H_
@@ -11,26 +11,17 @@
 #include <stdarg.h>
 #include <stdio.h>
 
-#include "compiler/InitializeParseContext.h"
-#include "compiler/ParseContext.h"
-
-static const int kTraceBufferLen = 1024;
-
 #ifdef TRACE_ENABLED
 extern "C" {
+// Traces go to stderr rather than to the info log of the shader being
+// compiled, which is not known here: compilers may run on several threads.
 void Trace(const char *format, ...) {
     if (!format) return;
 
-    TParseContext* parseContext = GetGlobalParseContext();
-    if (parseContext) {
-        char buf[kTraceBufferLen];
-        va_list args;
-        va_start(args, format);
-        vsnprintf(buf, kTraceBufferLen, format, args);
-        va_end(args);
-
-        parseContext->trace(buf);
-    }
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
 }
 }  // extern "C"
 #endif  // TRACE_ENABLED
@@ -12,29 +12,66 @@
 TDependencyGraph::TDependencyGraph(TIntermNode* intermNode)
 {
     TDependencyGraphBuilder::build(intermNode, this);
+    buildDependentNodes();
 }
 
-TDependencyGraph::~TDependencyGraph()
+void TDependencyGraph::addNode(TGraphNode* node)
 {
-    for (TGraphNodeVector::const_iterator iter = mAllNodes.begin(); iter != mAllNodes.end(); ++iter)
-    {
-        TGraphNode* node = *iter;
-        delete node;
+    node->setIndex(size());
+    mAllNodes.push_back(node);
+}
+
+void TDependencyGraph::addDependentNode(TGraphParentNode* node, TGraphNode* dependent)
+{
+    if (node != dependent)
+        mEdges.push_back(TEdge(node->getIndex(), dependent->getIndex()));
+}
+
+void TDependencyGraph::buildDependentNodes()
+{
+    // Count the edges of each node, and place the rows one after the other.
+    mDependentNodeOffsets.assign(mAllNodes.size() + 1, 0);
+    for (TVector<TEdge>::const_iterator edge = mEdges.begin(); edge != mEdges.end(); ++edge)
+        ++mDependentNodeOffsets[edge->first + 1];
+    for (size_t i = 1; i < mDependentNodeOffsets.size(); ++i)
+        mDependentNodeOffsets[i] += mDependentNodeOffsets[i - 1];
+
+    mDependentNodes.resize(mEdges.size());
+    TVector<int> rowEnds;
+    rowEnds.assign(mDependentNodeOffsets.begin(), mDependentNodeOffsets.end() - 1);
+    for (TVector<TEdge>::const_iterator edge = mEdges.begin(); edge != mEdges.end(); ++edge)
+        mDependentNodes[rowEnds[edge->first]++] = edge->second;
+    mEdges.clear();
+
+    // Sort each row and drop its repeated edges, moving the rows down over the dropped ones.
+    int numDependentNodes = 0;
+    for (size_t i = 0; i + 1 < mDependentNodeOffsets.size(); ++i) {
+        TVector<int>::iterator rowBegin = mDependentNodes.begin() + mDependentNodeOffsets[i];
+        TVector<int>::iterator rowEnd = mDependentNodes.begin() + mDependentNodeOffsets[i + 1];
+        std::sort(rowBegin, rowEnd);
+        mDependentNodeOffsets[i] = numDependentNodes;
+        for (TVector<int>::const_iterator iter = rowBegin; iter != rowEnd; ++iter) {
+            if (numDependentNodes == mDependentNodeOffsets[i] ||
+                mDependentNodes[numDependentNodes - 1] != *iter)
+                mDependentNodes[numDependentNodes++] = *iter;
+        }
     }
+    mDependentNodeOffsets.back() = numDependentNodes;
+    mDependentNodes.resize(numDependentNodes);
 }
 
 TGraphArgument* TDependencyGraph::createArgument(TIntermAggregate* intermFunctionCall,
                                                  int argumentNumber)
 {
     TGraphArgument* argument = new TGraphArgument(intermFunctionCall, argumentNumber);
-    mAllNodes.push_back(argument);
+    addNode(argument);
     return argument;
 }
 
 TGraphFunctionCall* TDependencyGraph::createFunctionCall(TIntermAggregate* intermFunctionCall)
 {
     TGraphFunctionCall* functionCall = new TGraphFunctionCall(intermFunctionCall);
-    mAllNodes.push_back(functionCall);
+    addNode(functionCall);
     if (functionCall->getIntermFunctionCall()->isUserDefined())
         mUserDefinedFunctionCalls.push_back(functionCall);
     return functionCall;
@@ -51,7 +88,7 @@ TGraphSymbol* TDependencyGraph::getOrCreateSymbol(TIntermSymbol* intermSymbol)
         symbol = pair.second;
     } else {
         symbol = new TGraphSymbol(intermSymbol);
-        mAllNodes.push_back(symbol);
+        addNode(symbol);
 
         TSymbolIdPair pair(intermSymbol->getId(), symbol);
         mSymbolIdMap.insert(pair);
@@ -67,21 +104,21 @@ TGraphSymbol* TDependencyGraph::getOrCreateSymbol(TIntermSymbol* intermSymbol)
 TGraphSelection* TDependencyGraph::createSelection(TIntermSelection* intermSelection)
 {
     TGraphSelection* selection = new TGraphSelection(intermSelection);
-    mAllNodes.push_back(selection);
+    addNode(selection);
     return selection;
 }
 
 TGraphLoop* TDependencyGraph::createLoop(TIntermLoop* intermLoop)
 {
     TGraphLoop* loop = new TGraphLoop(intermLoop);
-    mAllNodes.push_back(loop);
+    addNode(loop);
     return loop;
 }
 
 TGraphLogicalOp* TDependencyGraph::createLogicalOp(TIntermBinary* intermLogicalOp)
 {
     TGraphLogicalOp* logicalOp = new TGraphLogicalOp(intermLogicalOp);
-    mAllNodes.push_back(logicalOp);
+    addNode(logicalOp);
     return logicalOp;
 }
 
@@ -9,9 +9,6 @@
 
 #include "compiler/intermediate.h"
 
-#include <set>
-#include <stack>
-
 class TGraphNode;
 class TGraphParentNode;
 class TGraphArgument;
@@ -23,21 +20,29 @@ class TGraphLogicalOp;
 class TDependencyGraphTraverser;
 class TDependencyGraphOutput;
 
-typedef std::set<TGraphNode*> TGraphNodeSet;
-typedef std::vector<TGraphNode*> TGraphNodeVector;
-typedef std::vector<TGraphSymbol*> TGraphSymbolVector;
-typedef std::vector<TGraphFunctionCall*> TFunctionCallVector;
+typedef TVector<TGraphNode*> TGraphNodeVector;
+typedef TVector<TGraphSymbol*> TGraphSymbolVector;
+typedef TVector<TGraphFunctionCall*> TFunctionCallVector;
 
 //
-// Base class for all dependency graph nodes.
+// Base class for all dependency graph nodes. The nodes live in the pool of
+// the compile, like the intermediate tree they are made from.
 //
 class TGraphNode {
 public:
-    TGraphNode(TIntermNode* node) : intermNode(node) {}
+    POOL_ALLOCATOR_NEW_DELETE();
+    TGraphNode(TIntermNode* node) : intermNode(node), mIndex(-1) {}
     virtual ~TGraphNode() {}
-    virtual void traverse(TDependencyGraphTraverser* graphTraverser);
+    // Calls the visit method of graphTraverser for the node.
+    virtual void visit(TDependencyGraphTraverser* graphTraverser) {}
+
+    // The position of the node in its graph.
+    int getIndex() const { return mIndex; }
+    void setIndex(int index) { mIndex = index; }
 protected:
     TIntermNode* intermNode;
+private:
+    int mIndex;
 };
 
 //
@@ -47,10 +52,6 @@ class TGraphParentNode : public TGraphNode {
 public:
     TGraphParentNode(TIntermNode* node) : TGraphNode(node) {}
     virtual ~TGraphParentNode() {}
-    void addDependentNode(TGraphNode* node) { if (node != this) mDependentNodes.insert(node); }
-    virtual void traverse(TDependencyGraphTraverser* graphTraverser);
-private:
-    TGraphNodeSet mDependentNodes;
 };
 
 //
@@ -64,7 +65,7 @@ public:
     virtual ~TGraphArgument() {}
     const TIntermAggregate* getIntermFunctionCall() const { return intermNode->getAsAggregate(); }
     int getArgumentNumber() const { return mArgumentNumber; }
-    virtual void traverse(TDependencyGraphTraverser* graphTraverser);
+    virtual void visit(TDependencyGraphTraverser* graphTraverser);
 private:
     int mArgumentNumber;
 };
@@ -78,7 +79,7 @@ public:
         : TGraphParentNode(intermFunctionCall) {}
     virtual ~TGraphFunctionCall() {}
     const TIntermAggregate* getIntermFunctionCall() const { return intermNode->getAsAggregate(); }
-    virtual void traverse(TDependencyGraphTraverser* graphTraverser);
+    virtual void visit(TDependencyGraphTraverser* graphTraverser);
 };
 
 //
@@ -89,7 +90,7 @@ public:
     TGraphSymbol(TIntermSymbol* intermSymbol) : TGraphParentNode(intermSymbol) {}
     virtual ~TGraphSymbol() {}
     const TIntermSymbol* getIntermSymbol() const { return intermNode->getAsSymbolNode(); }
-    virtual void traverse(TDependencyGraphTraverser* graphTraverser);
+    virtual void visit(TDependencyGraphTraverser* graphTraverser);
 };
 
 //
@@ -100,7 +101,7 @@ public:
     TGraphSelection(TIntermSelection* intermSelection) : TGraphNode(intermSelection) {}
     virtual ~TGraphSelection() {}
     const TIntermSelection* getIntermSelection() const { return intermNode->getAsSelectionNode(); }
-    virtual void traverse(TDependencyGraphTraverser* graphTraverser);
+    virtual void visit(TDependencyGraphTraverser* graphTraverser);
 };
 
 //
@@ -111,7 +112,7 @@ public:
     TGraphLoop(TIntermLoop* intermLoop) : TGraphNode(intermLoop) {}
     virtual ~TGraphLoop() {}
     const TIntermLoop* getIntermLoop() const { return intermNode->getAsLoopNode(); }
-    virtual void traverse(TDependencyGraphTraverser* graphTraverser);
+    virtual void visit(TDependencyGraphTraverser* graphTraverser);
 };
 
 //
@@ -123,7 +124,7 @@ public:
     virtual ~TGraphLogicalOp() {}
     const TIntermBinary* getIntermLogicalOp() const { return intermNode->getAsBinaryNode(); }
     const char* getOpString() const;
-    virtual void traverse(TDependencyGraphTraverser* graphTraverser);
+    virtual void visit(TDependencyGraphTraverser* graphTraverser);
 };
 
 //
@@ -132,16 +133,20 @@ public:
 // This class provides an interface to the entry points of the dependency graph.
 //
 // Dependency graph nodes should be created by using one of the provided "create..." methods.
-// This class (and nobody else) manages the memory of the created nodes.
-// Nodes may not be removed after being added, so all created nodes will exist while the
-// TDependencyGraph instance exists.
+// The nodes are allocated from the pool of the compile, and indexed in the order they are
+// created. Nodes may not be removed after being added, so all created nodes will exist while
+// the pool does.
+//
+// The edges from each node to the nodes that depend on it are kept in one array, sorted by
+// node, with the edges of each node ordered by index (compressed sparse rows).
 //
 class TDependencyGraph {
 public:
     TDependencyGraph(TIntermNode* intermNode);
-    ~TDependencyGraph();
     TGraphNodeVector::const_iterator begin() const { return mAllNodes.begin(); }
     TGraphNodeVector::const_iterator end() const { return mAllNodes.end(); }
+    int size() const { return static_cast<int>(mAllNodes.size()); }
+    TGraphNode* getNode(int index) const { return mAllNodes[index]; }
 
     TGraphSymbolVector::const_iterator beginSamplerSymbols() const
     {
@@ -163,26 +168,53 @@ public:
         return mUserDefinedFunctionCalls.end();
     }
 
+    // The indices of the nodes that depend on node.
+    TVector<int>::const_iterator beginDependentNodes(const TGraphNode* node) const
+    {
+        return mDependentNodes.begin() + mDependentNodeOffsets[node->getIndex()];
+    }
+
+    TVector<int>::const_iterator endDependentNodes(const TGraphNode* node) const
+    {
+        return mDependentNodes.begin() + mDependentNodeOffsets[node->getIndex() + 1];
+    }
+
     TGraphArgument* createArgument(TIntermAggregate* intermFunctionCall, int argumentNumber);
     TGraphFunctionCall* createFunctionCall(TIntermAggregate* intermFunctionCall);
     TGraphSymbol* getOrCreateSymbol(TIntermSymbol* intermSymbol);
     TGraphSelection* createSelection(TIntermSelection* intermSelection);
     TGraphLoop* createLoop(TIntermLoop* intermLoop);
     TGraphLogicalOp* createLogicalOp(TIntermBinary* intermLogicalOp);
+
+    // Makes dependent depend on node, while the graph is built. Edges from a node to itself
+    // and repeated edges are dropped.
+    void addDependentNode(TGraphParentNode* node, TGraphNode* dependent);
 private:
     typedef TMap<int, TGraphSymbol*> TSymbolIdMap;
     typedef std::pair<int, TGraphSymbol*> TSymbolIdPair;
+    typedef std::pair<int, int> TEdge;
+
+    void addNode(TGraphNode* node);
+    // Lays out the edges added by the builder in rows.
+    void buildDependentNodes();
 
     TGraphNodeVector mAllNodes;
     TGraphSymbolVector mSamplerSymbols;
     TFunctionCallVector mUserDefinedFunctionCalls;
     TSymbolIdMap mSymbolIdMap;
+
+    // The edges added while building the graph.
+    TVector<TEdge> mEdges;
+    // The edges of node i are mDependentNodes[mDependentNodeOffsets[i]] up to
+    // mDependentNodes[mDependentNodeOffsets[i + 1]].
+    TVector<int> mDependentNodeOffsets;
+    TVector<int> mDependentNodes;
 };
 
 //
 // For traversing the dependency graph. Users should derive from this,
-// put their traversal specific data in it, and then pass it to a
-// traverse method.
+// put their traversal specific data in it, and then pass it to
+// traverse().
 //
 // When using this, just fill in the methods for nodes you want visited.
 //
@@ -197,16 +229,26 @@ public:
     virtual void visitLoop(TGraphLoop* loop) {};
     virtual void visitLogicalOp(TGraphLogicalOp* logicalOp) {};
 
+    // Visits the nodes of graph that depend on start, and start, depth first. Each node is
+    // visited once, and not at all if it is marked visited already.
+    void traverse(const TDependencyGraph& graph, TGraphNode* start);
+
     int getDepth() const { return mDepth; }
-    void incrementDepth() { ++mDepth; }
-    void decrementDepth() { --mDepth; }
 
-    void clearVisited() { mVisited.clear(); }
-    void markVisited(TGraphNode* node) { mVisited.insert(node); }
-    bool isVisited(TGraphNode* node) const { return mVisited.find(node) != mVisited.end(); }
+    void clearVisited() { std::fill(mVisited.begin(), mVisited.end(), 0u); }
+    void markVisited(const TGraphNode* node);
+    bool isVisited(const TGraphNode* node) const;
 private:
+    // A node on the path of traverse(), and the next of its edges to follow.
+    struct TPathEntry {
+        const TGraphNode* node;
+        TVector<int>::const_iterator nextDependentNode;
+    };
+
     int mDepth;
-    TGraphNodeSet mVisited;
+    // A bit per node of the graph, by index.
+    TVector<unsigned int> mVisited;
+    TVector<TPathEntry> mPath;
 };
 
 #endif
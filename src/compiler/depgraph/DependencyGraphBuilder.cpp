@@ -50,10 +50,10 @@ void TDependencyGraphBuilder::visitFunctionCall(TIntermAggregate* intermFunction
         TIntermNode* intermArgument = *iter;
         intermArgument->traverse(this);
 
-        if (TParentNodeSet* argumentNodes = mNodeSets.getTopSet()) {
+        if (!mNodeSets.isTopSetEmpty()) {
             TGraphArgument* argument = mGraph->createArgument(intermFunctionCall, argumentNumber);
-            connectMultipleNodesToSingleNode(argumentNodes, argument);
-            argument->addDependentNode(functionCall);
+            connectTopSetToSingleNode(argument);
+            mGraph->addDependentNode(argument, functionCall);
         }
     }
 
@@ -85,10 +85,8 @@ void TDependencyGraphBuilder::visitSymbol(TIntermSymbol* intermSymbol)
 
     // If this symbol is the current leftmost symbol under an assignment, replace the previous
     // leftmost symbol with this symbol.
-    if (!mLeftmostSymbols.empty() && mLeftmostSymbols.top() != &mRightSubtree) {
-        mLeftmostSymbols.pop();
-        mLeftmostSymbols.push(symbol);
-    }
+    if (!mLeftmostSymbols.empty() && mLeftmostSymbols.back() != &mRightSubtree)
+        mLeftmostSymbols.back() = symbol;
 }
 
 bool TDependencyGraphBuilder::visitBinary(Visit visit, TIntermBinary* intermBinary)
@@ -118,7 +116,7 @@ void TDependencyGraphBuilder::visitAssignment(TIntermBinary* intermAssignment)
         {
             TLeftmostSymbolMaintainer leftmostSymbolMaintainer(this, mLeftSubtree);
             intermLeft->traverse(this);
-            leftmostSymbol = mLeftmostSymbols.top();
+            leftmostSymbol = mLeftmostSymbols.back();
 
             // After traversing the left subtree of this assignment, we should have found a real
             // leftmost symbol, and the leftmost symbol should not be a placeholder.
@@ -131,8 +129,8 @@ void TDependencyGraphBuilder::visitAssignment(TIntermBinary* intermAssignment)
             intermRight->traverse(this);
         }
 
-        if (TParentNodeSet* assignmentNodes = mNodeSets.getTopSet())
-            connectMultipleNodesToSingleNode(assignmentNodes, leftmostSymbol);
+        if (!mNodeSets.isTopSetEmpty())
+            connectTopSetToSingleNode(leftmostSymbol);
     }
 
     // Push the leftmost symbol of this assignment into the current set of dependent symbols to
@@ -150,9 +148,9 @@ void TDependencyGraphBuilder::visitLogicalOp(TIntermBinary* intermLogicalOp)
         TNodeSetPropagatingMaintainer nodeSetMaintainer(this);
 
         intermLeft->traverse(this);
-        if (TParentNodeSet* leftNodes = mNodeSets.getTopSet()) {
+        if (!mNodeSets.isTopSetEmpty()) {
             TGraphLogicalOp* logicalOp = mGraph->createLogicalOp(intermLogicalOp);
-            connectMultipleNodesToSingleNode(leftNodes, logicalOp);
+            connectTopSetToSingleNode(logicalOp);
         }
     }
 
@@ -179,9 +177,9 @@ bool TDependencyGraphBuilder::visitSelection(Visit visit, TIntermSelection* inte
         TNodeSetMaintainer nodeSetMaintainer(this);
 
         intermCondition->traverse(this);
-        if (TParentNodeSet* conditionNodes = mNodeSets.getTopSet()) {
+        if (!mNodeSets.isTopSetEmpty()) {
             TGraphSelection* selection = mGraph->createSelection(intermSelection);
-            connectMultipleNodesToSingleNode(conditionNodes, selection);
+            connectTopSetToSingleNode(selection);
         }
     }
 
@@ -200,9 +198,9 @@ bool TDependencyGraphBuilder::visitLoop(Visit visit, TIntermLoop* intermLoop)
         TNodeSetMaintainer nodeSetMaintainer(this);
 
         intermCondition->traverse(this);
-        if (TParentNodeSet* conditionNodes = mNodeSets.getTopSet()) {
+        if (!mNodeSets.isTopSetEmpty()) {
             TGraphLoop* loop = mGraph->createLoop(intermLoop);
-            connectMultipleNodesToSingleNode(conditionNodes, loop);
+            connectTopSetToSingleNode(loop);
         }
     }
 
@@ -216,12 +214,13 @@ bool TDependencyGraphBuilder::visitLoop(Visit visit, TIntermLoop* intermLoop)
 }
 
 
-void TDependencyGraphBuilder::connectMultipleNodesToSingleNode(TParentNodeSet* nodes,
-                                                               TGraphNode* node) const
+void TDependencyGraphBuilder::connectTopSetToSingleNode(TGraphNode* node) const
 {
-    for (TParentNodeSet::const_iterator iter = nodes->begin(); iter != nodes->end(); ++iter)
+    for (TParentNodeVector::const_iterator iter = mNodeSets.beginTopSet();
+         iter != mNodeSets.endTopSet();
+         ++iter)
     {
         TGraphParentNode* currentNode = *iter;
-        currentNode->addDependentNode(node);
+        mGraph->addDependentNode(currentNode, node);
     }
 }
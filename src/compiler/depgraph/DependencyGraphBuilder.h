@@ -24,35 +24,43 @@ public:
     virtual bool visitLoop(Visit visit, TIntermLoop*);
 
 private:
-    typedef std::stack<TGraphSymbol*> TSymbolStack;
-    typedef std::set<TGraphParentNode*> TParentNodeSet;
+    typedef TVector<TGraphSymbol*> TSymbolStack;
+    typedef TVector<TGraphParentNode*> TParentNodeVector;
 
     //
     // For collecting the dependent nodes of assignments, conditions, etc.
     // while traversing the intermediate tree.
     //
     // This data structure is stack of sets. Each set contains dependency graph parent nodes.
+    // The sets are kept one after the other in a single vector, so a set is popped into the
+    // one below it by forgetting where it starts. A set may hold a node more than once; the
+    // graph drops the repeated edges this makes.
     //
     class TNodeSetStack {
     public:
         TNodeSetStack() {};
-        ~TNodeSetStack() { clear(); }
 
         // This should only be called after a pushSet.
-        // Returns NULL if the top set is empty.
-        TParentNodeSet* getTopSet() const
+        bool isTopSetEmpty() const
         {
-            ASSERT(!nodeSets.empty());
-            TParentNodeSet* topSet = nodeSets.top();
-            return !topSet->empty() ? topSet : NULL;
+            ASSERT(!setStarts.empty());
+            return setStarts.back() == nodes.size();
         }
 
-        void pushSet() { nodeSets.push(new TParentNodeSet()); }
+        TParentNodeVector::const_iterator beginTopSet() const
+        {
+            ASSERT(!setStarts.empty());
+            return nodes.begin() + setStarts.back();
+        }
+
+        TParentNodeVector::const_iterator endTopSet() const { return nodes.end(); }
+
+        void pushSet() { setStarts.push_back(nodes.size()); }
         void popSet()
         {
-            ASSERT(!nodeSets.empty());
-            delete nodeSets.top();
-            nodeSets.pop();
+            ASSERT(!setStarts.empty());
+            nodes.resize(setStarts.back());
+            setStarts.pop_back();
         }
 
         // Pops the top set and adds its contents to the new top set.
@@ -60,16 +68,10 @@ private:
         // If there is no set below the top set, the top set is just deleted.
         void popSetIntoNext()
         {
-            ASSERT(!nodeSets.empty());
-            TParentNodeSet* oldTopSet = nodeSets.top();
-            nodeSets.pop();
-
-            if (!nodeSets.empty()) {
-                TParentNodeSet* newTopSet = nodeSets.top();
-                newTopSet->insert(oldTopSet->begin(), oldTopSet->end());
-            }
-
-            delete oldTopSet;
+            ASSERT(!setStarts.empty());
+            setStarts.pop_back();
+            if (setStarts.empty())
+                nodes.clear();
         }
 
         // Does nothing if there is no top set.
@@ -78,22 +80,15 @@ private:
         // We don't need to track those symbols.
         void insertIntoTopSet(TGraphParentNode* node)
         {
-            if (nodeSets.empty())
+            if (setStarts.empty())
                 return;
 
-            nodeSets.top()->insert(node);
-        }
-
-        void clear()
-        {
-            while (!nodeSets.empty())
-                popSet();
+            nodes.push_back(node);
         }
 
     private:
-        typedef std::stack<TParentNodeSet*> TParentNodeSetStack;
-
-        TParentNodeSetStack nodeSets;
+        TParentNodeVector nodes;
+        TVector<size_t> setStarts;
     };
 
     //
@@ -138,15 +133,15 @@ private:
         TLeftmostSymbolMaintainer(TDependencyGraphBuilder* factory, TGraphSymbol& subtree)
             : leftmostSymbols(factory->mLeftmostSymbols)
         {
-            needsPlaceholderSymbol = leftmostSymbols.empty() || leftmostSymbols.top() != &subtree;
+            needsPlaceholderSymbol = leftmostSymbols.empty() || leftmostSymbols.back() != &subtree;
             if (needsPlaceholderSymbol)
-                leftmostSymbols.push(&subtree);
+                leftmostSymbols.push_back(&subtree);
         }
 
         ~TLeftmostSymbolMaintainer()
         {
             if (needsPlaceholderSymbol)
-                leftmostSymbols.pop();
+                leftmostSymbols.pop_back();
         }
 
     protected:
@@ -161,7 +156,8 @@ private:
         , mGraph(graph) {}
     void build(TIntermNode* intermNode) { intermNode->traverse(this); }
 
-    void connectMultipleNodesToSingleNode(TParentNodeSet* nodes, TGraphNode* node) const;
+    // Makes node depend on the nodes of the top node set.
+    void connectTopSetToSingleNode(TGraphNode* node) const;
 
     void visitAssignment(TIntermBinary*);
     void visitLogicalOp(TIntermBinary*);
@@ -50,7 +50,7 @@ void TDependencyGraphOutput::visitLogicalOp(TGraphLogicalOp* logicalOp)
     mSink << "logical " << logicalOp->getOpString() << "\n";
 }
 
-void TDependencyGraphOutput::outputAllSpanningTrees(TDependencyGraph& graph)
+void TDependencyGraphOutput::outputAllSpanningTrees(const TDependencyGraph& graph)
 {
     mSink << "\n";
 
@@ -59,7 +59,7 @@ void TDependencyGraphOutput::outputAllSpanningTrees(TDependencyGraph& graph)
         TGraphNode* symbol = *iter;
         mSink << "--- Dependency graph spanning tree ---\n";
         clearVisited();
-        symbol->traverse(this);
+        traverse(graph, symbol);
         mSink << "\n";
     }
 }
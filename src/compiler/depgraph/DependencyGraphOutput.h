@@ -20,7 +20,7 @@ public:
     virtual void visitLoop(TGraphLoop* loop);
     virtual void visitLogicalOp(TGraphLogicalOp* logicalOp);
 
-    void outputAllSpanningTrees(TDependencyGraph& graph);
+    void outputAllSpanningTrees(const TDependencyGraph& graph);
 private:
     void outputIndentation();
 
@@ -6,64 +6,92 @@
 
 #include "compiler/depgraph/DependencyGraph.h"
 
-// These methods do a breadth-first traversal through the graph and mark visited nodes.
+namespace {
 
-void TGraphNode::traverse(TDependencyGraphTraverser* graphTraverser)
+// The visited marks are a bit per node.
+const size_t kBitsPerWord = sizeof(unsigned int) * 8;
+
+}  // namespace
+
+// This method does a depth-first traversal through the graph and marks visited nodes. It keeps
+// the path in a stack of its own, so a long chain of dependencies cannot overflow the call
+// stack.
+void TDependencyGraphTraverser::traverse(const TDependencyGraph& graph, TGraphNode* start)
 {
-    graphTraverser->markVisited(this);
+    mVisited.resize((graph.size() + kBitsPerWord - 1) / kBitsPerWord, 0u);
+
+    if (isVisited(start))
+        return;
+
+    mPath.clear();
+    TPathEntry entry = { start, graph.beginDependentNodes(start) };
+    mPath.push_back(entry);
+    markVisited(start);
+    mDepth = 0;
+    start->visit(this);
+
+    while (!mPath.empty()) {
+        TPathEntry& top = mPath.back();
+        if (top.nextDependentNode == graph.endDependentNodes(top.node)) {
+            mPath.pop_back();
+            continue;
+        }
+
+        TGraphNode* node = graph.getNode(*top.nextDependentNode++);
+        if (isVisited(node))
+            continue;
+
+        // Visit the parent node's children.
+        TPathEntry child = { node, graph.beginDependentNodes(node) };
+        mPath.push_back(child);
+        markVisited(node);
+        mDepth = static_cast<int>(mPath.size()) - 1;
+        node->visit(this);
+    }
+    mDepth = 0;
 }
 
-void TGraphParentNode::traverse(TDependencyGraphTraverser* graphTraverser)
+void TDependencyGraphTraverser::markVisited(const TGraphNode* node)
 {
-    TGraphNode::traverse(graphTraverser);
-
-    graphTraverser->incrementDepth();
-
-    // Visit the parent node's children.
-    for (TGraphNodeSet::const_iterator iter = mDependentNodes.begin();
-         iter != mDependentNodes.end();
-         ++iter)
-    {
-        TGraphNode* node = *iter;
-        if (!graphTraverser->isVisited(node))
-            node->traverse(graphTraverser);
-    }
+    size_t index = node->getIndex();
+    if (index / kBitsPerWord >= mVisited.size())
+        mVisited.resize(index / kBitsPerWord + 1, 0u);
+    mVisited[index / kBitsPerWord] |= 1u << (index % kBitsPerWord);
+}
 
-    graphTraverser->decrementDepth();
+bool TDependencyGraphTraverser::isVisited(const TGraphNode* node) const
+{
+    size_t index = node->getIndex();
+    return index / kBitsPerWord < mVisited.size() &&
+           (mVisited[index / kBitsPerWord] & (1u << (index % kBitsPerWord))) != 0;
 }
 
-void TGraphArgument::traverse(TDependencyGraphTraverser* graphTraverser)
+void TGraphArgument::visit(TDependencyGraphTraverser* graphTraverser)
 {
     graphTraverser->visitArgument(this);
-    TGraphParentNode::traverse(graphTraverser);
 }
 
-void TGraphFunctionCall::traverse(TDependencyGraphTraverser* graphTraverser)
+void TGraphFunctionCall::visit(TDependencyGraphTraverser* graphTraverser)
 {
     graphTraverser->visitFunctionCall(this);
-    TGraphParentNode::traverse(graphTraverser);
 }
 
-void TGraphSymbol::traverse(TDependencyGraphTraverser* graphTraverser)
+void TGraphSymbol::visit(TDependencyGraphTraverser* graphTraverser)
 {
     graphTraverser->visitSymbol(this);
-    TGraphParentNode::traverse(graphTraverser);
 }
 
-void TGraphSelection::traverse(TDependencyGraphTraverser* graphTraverser)
+void TGraphSelection::visit(TDependencyGraphTraverser* graphTraverser)
 {
     graphTraverser->visitSelection(this);
-    TGraphNode::traverse(graphTraverser);
 }
 
-void TGraphLoop::traverse(TDependencyGraphTraverser* graphTraverser)
+void TGraphLoop::visit(TDependencyGraphTraverser* graphTraverser)
 {
     graphTraverser->visitLoop(this);
-    TGraphNode::traverse(graphTraverser);
 }
 
-void TGraphLogicalOp::traverse(TDependencyGraphTraverser* graphTraverser)
+void TGraphLogicalOp::visit(TDependencyGraphTraverser* graphTraverser)
 {
     graphTraverser->visitLogicalOp(this);
-    TGraphNode::traverse(graphTraverser);
 }
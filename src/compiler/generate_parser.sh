@@ -3,14 +3,7 @@
 # Use of this source code is governed by a BSD-style license that can be
 # found in the LICENSE file.
 
-# Generates GLSL ES parser - glslang_lex.cpp, glslang_tab.h, and glslang_tab.cpp
-
-run_flex()
-{
-input_file=$script_dir/$1.l
-output_source=$script_dir/$1_lex.cpp
-flex --noline --nounistd --outfile=$output_source $input_file
-}
+# Generates GLSL ES parser - glslang_tab.h and glslang_tab.cpp
 
 run_bison()
 {
@@ -23,6 +16,4 @@ bison --no-lines --skeleton=yacc.c --defines=$output_header --output=$output_sou
 script_dir=$(dirname $0)
 
 # Generate Parser
-run_flex glslang
 run_bison glslang
-patch --silent --forward < 64bit-lexer-safety.patch
@@ -12,5 +12,8 @@ extern int glslang_scan(size_t count,
                         const char* const string[],
                         const int length[],
                         TParseContext* context);
+// Returns true if the input holds nothing but directives. The first token
+// is lexed ahead to find out, and left for glslang_parse().
+extern bool glslang_is_empty(TParseContext* context);
 extern int glslang_parse(TParseContext* context);
 
@@ -198,34 +198,45 @@ class TIntermSelection;
 class TIntermTyped;
 class TIntermSymbol;
 class TIntermLoop;
+class TIntermBranch;
 class TInfoSink;
 
+//
+// The classes of the tree nodes, which a node knows without a virtual call.
+//
+enum TIntermNodeKind {
+    EIntermSymbol,
+    EIntermConstantUnion,
+    EIntermBinary,
+    EIntermUnary,
+    EIntermAggregate,
+    EIntermSelection,
+    EIntermLoop,
+    EIntermBranch
+};
+
 //
 // Base class for the tree nodes
 //
 class TIntermNode {
 public:
     POOL_ALLOCATOR_NEW_DELETE();
-    TIntermNode() {
-        // TODO: Move this to TSourceLoc constructor
-        // after getting rid of TPublicType.
-        line.first_file = line.last_file = 0;
-        line.first_line = line.last_line = 0;
-    }
     virtual ~TIntermNode() { }
 
+    TIntermNodeKind getKind() const { return static_cast<TIntermNodeKind>(kind); }
+
     const TSourceLoc& getLine() const { return line; }
     void setLine(const TSourceLoc& l) { line = l; }
 
     virtual void traverse(TIntermTraverser*) = 0;
-    virtual TIntermTyped* getAsTyped() { return 0; }
-    virtual TIntermConstantUnion* getAsConstantUnion() { return 0; }
-    virtual TIntermAggregate* getAsAggregate() { return 0; }
-    virtual TIntermBinary* getAsBinaryNode() { return 0; }
-    virtual TIntermUnary* getAsUnaryNode() { return 0; }
-    virtual TIntermSelection* getAsSelectionNode() { return 0; }
-    virtual TIntermSymbol* getAsSymbolNode() { return 0; }
-    virtual TIntermLoop* getAsLoopNode() { return 0; }
+    TIntermTyped* getAsTyped();
+    TIntermConstantUnion* getAsConstantUnion();
+    TIntermAggregate* getAsAggregate();
+    TIntermBinary* getAsBinaryNode();
+    TIntermUnary* getAsUnaryNode();
+    TIntermSelection* getAsSelectionNode();
+    TIntermSymbol* getAsSymbolNode();
+    TIntermLoop* getAsLoopNode();
 
     // Replace a child node. Return true if |original| is a child
     // node and it is replaced; otherwise, return false.
@@ -233,7 +244,16 @@ public:
         TIntermNode *original, TIntermNode *replacement) = 0;
 
 protected:
+    explicit TIntermNode(TIntermNodeKind k) : kind(static_cast<unsigned char>(k)) {
+        // TODO: Move this to TSourceLoc constructor
+        // after getting rid of TPublicType.
+        line.first_file = line.last_file = 0;
+        line.first_line = line.last_line = 0;
+    }
+
+private:
     TSourceLoc line;
+    unsigned char kind;
 };
 
 //
@@ -249,8 +269,6 @@ struct TIntermNodePair {
 //
 class TIntermTyped : public TIntermNode {
 public:
-    TIntermTyped(const TType& t) : type(t)  { }
-    virtual TIntermTyped* getAsTyped() { return this; }
 
     void setType(const TType& t) { type = t; }
     const TType& getType() const { return type; }
@@ -274,6 +292,8 @@ public:
     int getArraySize() const { return type.getArraySize(); }
 
 protected:
+    TIntermTyped(TIntermNodeKind k, const TType& t) : TIntermNode(k), type(t)  { }
+
     TType type;
 };
 
@@ -291,14 +311,14 @@ public:
     TIntermLoop(TLoopType aType,
                 TIntermNode *aInit, TIntermTyped* aCond, TIntermTyped* aExpr,
                 TIntermNode* aBody) :
-            type(aType),
+            TIntermNode(EIntermLoop),
             init(aInit),
             cond(aCond),
             expr(aExpr),
             body(aBody),
+            type(aType),
             unrollFlag(false) { }
 
-    virtual TIntermLoop* getAsLoopNode() { return this; }
     virtual void traverse(TIntermTraverser*);
     virtual bool replaceChildNode(
         TIntermNode *original, TIntermNode *replacement);
@@ -313,11 +333,11 @@ public:
     bool getUnrollFlag() { return unrollFlag; }
 
 protected:
-    TLoopType type;
     TIntermNode* init;  // for-loop initialization
     TIntermTyped* cond; // loop exit condition
     TIntermTyped* expr; // for-loop expression
     TIntermNode* body;  // loop body
+    TLoopType type;
 
     bool unrollFlag; // Whether the loop should be unrolled or not.
 };
@@ -328,6 +348,7 @@ protected:
 class TIntermBranch : public TIntermNode {
 public:
     TIntermBranch(TOperator op, TIntermTyped* e) :
+            TIntermNode(EIntermBranch),
             flowOp(op),
             expression(e) { }
 
@@ -352,7 +373,7 @@ public:
     // per process globalpoolallocator, then it causes increased memory usage per compile
     // it is essential to use "symbol = sym" to assign to symbol
     TIntermSymbol(int i, const TString& sym, const TType& t) : 
-            TIntermTyped(t), id(i)  { symbol = sym; originalSymbol = sym; } 
+            TIntermTyped(EIntermSymbol, t), id(i)  { symbol = sym; originalSymbol = sym; } 
 
     int getId() const { return id; }
     const TString& getSymbol() const { return symbol; }
@@ -363,7 +384,6 @@ public:
     const TString& getOriginalSymbol() const { return originalSymbol; }
 
     virtual void traverse(TIntermTraverser*);
-    virtual TIntermSymbol* getAsSymbolNode() { return this; }
     virtual bool replaceChildNode(TIntermNode *, TIntermNode *) { return false; }
 
 protected:
@@ -374,7 +394,7 @@ protected:
 
 class TIntermConstantUnion : public TIntermTyped {
 public:
-    TIntermConstantUnion(ConstantUnion *unionPointer, const TType& t) : TIntermTyped(t), unionArrayPointer(unionPointer) { }
+    TIntermConstantUnion(ConstantUnion *unionPointer, const TType& t) : TIntermTyped(EIntermConstantUnion, t), unionArrayPointer(unionPointer) { }
 
     ConstantUnion* getUnionArrayPointer() const { return unionArrayPointer; }
     
@@ -382,7 +402,6 @@ public:
     float getFConst(int index) const { return unionArrayPointer ? unionArrayPointer[index].getFConst() : 0.0f; }
     bool getBConst(int index) const { return unionArrayPointer ? unionArrayPointer[index].getBConst() : false; }
 
-    virtual TIntermConstantUnion* getAsConstantUnion()  { return this; }
     virtual void traverse(TIntermTraverser*);
     virtual bool replaceChildNode(TIntermNode *, TIntermNode *) { return false; }
 
@@ -404,8 +423,8 @@ public:
     bool isConstructor() const;
 
 protected:
-    TIntermOperator(TOperator o) : TIntermTyped(TType(EbtFloat, EbpUndefined)), op(o) {}
-    TIntermOperator(TOperator o, TType& t) : TIntermTyped(t), op(o) {}   
+    TIntermOperator(TIntermNodeKind k, TOperator o) : TIntermTyped(k, TType(EbtFloat, EbpUndefined)), op(o) {}
+    TIntermOperator(TIntermNodeKind k, TOperator o, TType& t) : TIntermTyped(k, t), op(o) {}
     TOperator op;
 };
 
@@ -414,9 +433,8 @@ protected:
 //
 class TIntermBinary : public TIntermOperator {
 public:
-    TIntermBinary(TOperator o) : TIntermOperator(o), addIndexClamp(false) {}
+    TIntermBinary(TOperator o) : TIntermOperator(EIntermBinary, o), addIndexClamp(false) {}
 
-    virtual TIntermBinary* getAsBinaryNode() { return this; }
     virtual void traverse(TIntermTraverser*);
     virtual bool replaceChildNode(
         TIntermNode *original, TIntermNode *replacement);
@@ -443,11 +461,10 @@ protected:
 //
 class TIntermUnary : public TIntermOperator {
 public:
-    TIntermUnary(TOperator o, TType& t) : TIntermOperator(o, t), operand(0), useEmulatedFunction(false) {}
-    TIntermUnary(TOperator o) : TIntermOperator(o), operand(0), useEmulatedFunction(false) {}
+    TIntermUnary(TOperator o, TType& t) : TIntermOperator(EIntermUnary, o, t), operand(0), useEmulatedFunction(false) {}
+    TIntermUnary(TOperator o) : TIntermOperator(EIntermUnary, o), operand(0), useEmulatedFunction(false) {}
 
     virtual void traverse(TIntermTraverser*);
-    virtual TIntermUnary* getAsUnaryNode() { return this; }
     virtual bool replaceChildNode(
         TIntermNode *original, TIntermNode *replacement);
 
@@ -474,11 +491,10 @@ typedef TVector<int> TQualifierList;
 //
 class TIntermAggregate : public TIntermOperator {
 public:
-    TIntermAggregate() : TIntermOperator(EOpNull), userDefined(false), useEmulatedFunction(false) { }
-    TIntermAggregate(TOperator o) : TIntermOperator(o), useEmulatedFunction(false) { }
+    TIntermAggregate() : TIntermOperator(EIntermAggregate, EOpNull), userDefined(false), optimize(false), debug(false), useEmulatedFunction(false) { }
+    TIntermAggregate(TOperator o) : TIntermOperator(EIntermAggregate, o), userDefined(false), optimize(false), debug(false), useEmulatedFunction(false) { }
     ~TIntermAggregate() { }
 
-    virtual TIntermAggregate* getAsAggregate() { return this; }
     virtual void traverse(TIntermTraverser*);
     virtual bool replaceChildNode(
         TIntermNode *original, TIntermNode *replacement);
@@ -520,9 +536,9 @@ protected:
 class TIntermSelection : public TIntermTyped {
 public:
     TIntermSelection(TIntermTyped* cond, TIntermNode* trueB, TIntermNode* falseB) :
-            TIntermTyped(TType(EbtVoid, EbpUndefined)), condition(cond), trueBlock(trueB), falseBlock(falseB) {}
+            TIntermTyped(EIntermSelection, TType(EbtVoid, EbpUndefined)), condition(cond), trueBlock(trueB), falseBlock(falseB) {}
     TIntermSelection(TIntermTyped* cond, TIntermNode* trueB, TIntermNode* falseB, const TType& type) :
-            TIntermTyped(type), condition(cond), trueBlock(trueB), falseBlock(falseB) {}
+            TIntermTyped(EIntermSelection, type), condition(cond), trueBlock(trueB), falseBlock(falseB) {}
 
     virtual void traverse(TIntermTraverser*);
     virtual bool replaceChildNode(
@@ -532,7 +548,6 @@ public:
     TIntermNode* getCondition() const { return condition; }
     TIntermNode* getTrueBlock() const { return trueBlock; }
     TIntermNode* getFalseBlock() const { return falseBlock; }
-    TIntermSelection* getAsSelectionNode() { return this; }
 
 protected:
     TIntermTyped* condition;
@@ -540,6 +555,31 @@ protected:
     TIntermNode* falseBlock;
 };
 
+inline TIntermTyped* TIntermNode::getAsTyped() {
+    return kind != EIntermLoop && kind != EIntermBranch ? static_cast<TIntermTyped*>(this) : 0;
+}
+inline TIntermConstantUnion* TIntermNode::getAsConstantUnion() {
+    return kind == EIntermConstantUnion ? static_cast<TIntermConstantUnion*>(this) : 0;
+}
+inline TIntermAggregate* TIntermNode::getAsAggregate() {
+    return kind == EIntermAggregate ? static_cast<TIntermAggregate*>(this) : 0;
+}
+inline TIntermBinary* TIntermNode::getAsBinaryNode() {
+    return kind == EIntermBinary ? static_cast<TIntermBinary*>(this) : 0;
+}
+inline TIntermUnary* TIntermNode::getAsUnaryNode() {
+    return kind == EIntermUnary ? static_cast<TIntermUnary*>(this) : 0;
+}
+inline TIntermSelection* TIntermNode::getAsSelectionNode() {
+    return kind == EIntermSelection ? static_cast<TIntermSelection*>(this) : 0;
+}
+inline TIntermSymbol* TIntermNode::getAsSymbolNode() {
+    return kind == EIntermSymbol ? static_cast<TIntermSymbol*>(this) : 0;
+}
+inline TIntermLoop* TIntermNode::getAsLoopNode() {
+    return kind == EIntermLoop ? static_cast<TIntermLoop*>(this) : 0;
+}
+
 enum Visit
 {
     PreVisit,
@@ -62,4 +62,72 @@ inline void* OS_GetTLSValue(OS_TLSIndex nIndex)
 #endif  // ANGLE_OS_WIN
 }
 
+//
+// Mutex Operations
+//
+#if defined(ANGLE_OS_WIN)
+typedef CRITICAL_SECTION OS_Mutex;
+#elif defined(ANGLE_OS_POSIX)
+typedef pthread_mutex_t OS_Mutex;
+#endif  // ANGLE_OS_WIN
+
+bool OS_InitMutex(OS_Mutex* mutex);
+void OS_FreeMutex(OS_Mutex* mutex);
+void OS_LockMutex(OS_Mutex* mutex);
+void OS_UnlockMutex(OS_Mutex* mutex);
+
+//
+// Thread Operations
+//
+#if defined(ANGLE_OS_WIN)
+typedef HANDLE OS_Thread;
+#elif defined(ANGLE_OS_POSIX)
+typedef pthread_t OS_Thread;
+#endif  // ANGLE_OS_WIN
+
+typedef void (*OS_ThreadFunction)(void* param);
+
+bool OS_CreateThread(OS_Thread* thread, OS_ThreadFunction function, void* param);
+void OS_JoinThread(OS_Thread thread);
+// Returns the number of processors available to the process, at least 1.
+int OS_GetProcessorCount();
+
+//
+// Timer Operations
+//
+// Returns a wall-clock time in seconds, for measuring intervals.
+double OS_GetTimeSeconds();
+
+//
+// File Mapping Operations
+//
+struct OS_MappedFile {
+    OS_MappedFile() : data(NULL), size(0) { }
+
+    const void* data;
+    size_t size;
+};
+
+// Maps the whole of an existing, non-empty file in memory, for reading.
+// The mapping stays valid when the file is later replaced or deleted.
+bool OS_MapFile(const char* path, OS_MappedFile* file);
+void OS_UnmapFile(OS_MappedFile* file);
+
+// Holds the given mutex for the lifetime of the object.
+class TScopedLock {
+public:
+    explicit TScopedLock(OS_Mutex* mutex) : mMutex(mutex) {
+        OS_LockMutex(mMutex);
+    }
+    ~TScopedLock() {
+        OS_UnlockMutex(mMutex);
+    }
+
+private:
+    TScopedLock(const TScopedLock&);
+    TScopedLock& operator=(const TScopedLock&);
+
+    OS_Mutex* mMutex;
+};
+
 #endif // __OSINCLUDE_H
@@ -13,6 +13,13 @@
 #error Trying to build a posix specific file in a non-posix build.
 #endif
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
 //
 // Thread Local Storage Operations
 //
@@ -62,3 +69,130 @@ bool OS_FreeTLSIndex(OS_TLSIndex nIndex)
     else
         return false;
 }
+
+
+//
+// Mutex Operations
+//
+bool OS_InitMutex(OS_Mutex* mutex)
+{
+    return pthread_mutex_init(mutex, NULL) == 0;
+}
+
+
+void OS_FreeMutex(OS_Mutex* mutex)
+{
+    pthread_mutex_destroy(mutex);
+}
+
+
+void OS_LockMutex(OS_Mutex* mutex)
+{
+    int result = pthread_mutex_lock(mutex);
+    assert(result == 0 && "OS_LockMutex(): Unable to lock mutex");
+    (void)result;
+}
+
+
+void OS_UnlockMutex(OS_Mutex* mutex)
+{
+    int result = pthread_mutex_unlock(mutex);
+    assert(result == 0 && "OS_UnlockMutex(): Unable to unlock mutex");
+    (void)result;
+}
+
+
+//
+// Thread Operations
+//
+namespace {
+
+struct ThreadStart {
+    OS_ThreadFunction function;
+    void* param;
+};
+
+void* ThreadMain(void* param)
+{
+    ThreadStart start = *static_cast<ThreadStart*>(param);
+    delete static_cast<ThreadStart*>(param);
+    start.function(start.param);
+    return NULL;
+}
+
+}  // anonymous namespace
+
+bool OS_CreateThread(OS_Thread* thread, OS_ThreadFunction function, void* param)
+{
+    ThreadStart* start = new ThreadStart;
+    start->function = function;
+    start->param = param;
+    if (pthread_create(thread, NULL, ThreadMain, start) != 0) {
+        delete start;
+        return false;
+    }
+    return true;
+}
+
+
+void OS_JoinThread(OS_Thread thread)
+{
+    pthread_join(thread, NULL);
+}
+
+
+int OS_GetProcessorCount()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? static_cast<int>(count) : 1;
+}
+
+
+//
+// Timer Operations
+//
+double OS_GetTimeSeconds()
+{
+#if defined(_POSIX_TIMERS) && _POSIX_TIMERS > 0 && defined(_POSIX_MONOTONIC_CLOCK)
+    // The monotonic clock has nanosecond resolution, and is not set back.
+    struct timespec now;
+    if (clock_gettime(CLOCK_MONOTONIC, &now) == 0)
+        return now.tv_sec + now.tv_nsec * 1e-9;
+#endif
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return time.tv_sec + time.tv_usec * 1e-6;
+}
+
+
+//
+// File Mapping Operations
+//
+bool OS_MapFile(const char* path, OS_MappedFile* file)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+        data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps the file open.
+    close(fd);
+    if (data == MAP_FAILED)
+        return false;
+
+    file->data = data;
+    file->size = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+
+void OS_UnmapFile(OS_MappedFile* file)
+{
+    if (file->data)
+        munmap(const_cast<void*>(file->data), file->size);
+    file->data = NULL;
+    file->size = 0;
+}
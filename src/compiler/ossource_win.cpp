@@ -55,3 +55,128 @@ bool OS_FreeTLSIndex(OS_TLSIndex nIndex)
 	else
 		return false;
 }
+
+//
+// Mutex Operations
+//
+bool OS_InitMutex(OS_Mutex* mutex)
+{
+	InitializeCriticalSection(mutex);
+	return true;
+}
+
+
+void OS_FreeMutex(OS_Mutex* mutex)
+{
+	DeleteCriticalSection(mutex);
+}
+
+
+void OS_LockMutex(OS_Mutex* mutex)
+{
+	EnterCriticalSection(mutex);
+}
+
+
+void OS_UnlockMutex(OS_Mutex* mutex)
+{
+	LeaveCriticalSection(mutex);
+}
+
+//
+// Thread Operations
+//
+namespace {
+
+struct ThreadStart {
+	OS_ThreadFunction function;
+	void* param;
+};
+
+DWORD WINAPI ThreadMain(LPVOID param)
+{
+	ThreadStart start = *static_cast<ThreadStart*>(param);
+	delete static_cast<ThreadStart*>(param);
+	start.function(start.param);
+	return 0;
+}
+
+}  // anonymous namespace
+
+bool OS_CreateThread(OS_Thread* thread, OS_ThreadFunction function, void* param)
+{
+	ThreadStart* start = new ThreadStart;
+	start->function = function;
+	start->param = param;
+	*thread = CreateThread(NULL, 0, ThreadMain, start, 0, NULL);
+	if (*thread == NULL) {
+		delete start;
+		return false;
+	}
+	return true;
+}
+
+
+void OS_JoinThread(OS_Thread thread)
+{
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+}
+
+
+int OS_GetProcessorCount()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors > 0 ? static_cast<int>(info.dwNumberOfProcessors) : 1;
+}
+
+//
+// Timer Operations
+//
+double OS_GetTimeSeconds()
+{
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return static_cast<double>(counter.QuadPart) / frequency.QuadPart;
+}
+
+//
+// File Mapping Operations
+//
+bool OS_MapFile(const char* path, OS_MappedFile* file)
+{
+	// Let the file be replaced or deleted while it is mapped.
+	HANDLE handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+	                            NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (handle == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	const void* data = NULL;
+	if (GetFileSizeEx(handle, &size) && size.QuadPart > 0 && size.HighPart == 0) {
+		HANDLE mapping = CreateFileMappingA(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mapping) {
+			data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			// The view keeps the mapping and the file open.
+			CloseHandle(mapping);
+		}
+	}
+	CloseHandle(handle);
+	if (!data)
+		return false;
+
+	file->data = data;
+	file->size = size.LowPart;
+	return true;
+}
+
+
+void OS_UnmapFile(OS_MappedFile* file)
+{
+	if (file->data)
+		UnmapViewOfFile(file->data);
+	file->data = NULL;
+	file->size = 0;
+}
@@ -109,6 +109,12 @@ std::string Diagnostics::message(ID id)
           return "invalid file number";
       case INVALID_LINE_DIRECTIVE:
           return "invalid line directive";
+      case INVALID_INCLUDE_DIRECTIVE:
+          return "invalid include directive";
+      case INCLUDE_NOT_FOUND:
+          return "included source not found";
+      case INCLUDE_TOO_DEEP:
+          return "includes nested too deeply";
       // Errors end.
       // Warnings begin.
       case EOF_IN_DIRECTIVE:
@@ -9,6 +9,8 @@
 
 #include <string>
 
+#include "TokenText.h"
+
 namespace pp
 {
 
@@ -61,6 +63,9 @@ class Diagnostics
         INVALID_LINE_NUMBER,
         INVALID_FILE_NUMBER,
         INVALID_LINE_DIRECTIVE,
+        INVALID_INCLUDE_DIRECTIVE,
+        INCLUDE_NOT_FOUND,
+        INCLUDE_TOO_DEEP,
         ERROR_END,
 
         WARNING_BEGIN,
@@ -73,6 +78,10 @@ class Diagnostics
     virtual ~Diagnostics();
 
     void report(ID id, const SourceLocation& loc, const std::string& text);
+    void report(ID id, const SourceLocation& loc, const TokenText& text)
+    {
+        report(id, loc, text.str());
+    }
 
   protected:
     Severity severity(ID id);
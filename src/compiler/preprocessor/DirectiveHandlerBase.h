@@ -7,6 +7,7 @@
 #ifndef COMPILER_PREPROCESSOR_DIRECTIVE_HANDLER_H_
 #define COMPILER_PREPROCESSOR_DIRECTIVE_HANDLER_H_
 
+#include <cstddef>
 #include <string>
 
 namespace pp
@@ -37,6 +38,15 @@ class DirectiveHandler
 
     virtual void handleVersion(const SourceLocation& loc,
                                int version) = 0;
+
+    // Handle #include "name" or #include <name>, only recognized if the
+    // preprocessor is given an include cache. Returns false if there is no
+    // such source. Otherwise points source to its length characters, which
+    // need not be null-terminated nor stay valid after the directive.
+    virtual bool handleInclude(const SourceLocation& loc,
+                               const std::string& name,
+                               const char** source,
+                               size_t* length) = 0;
 };
 
 }  // namespace pp
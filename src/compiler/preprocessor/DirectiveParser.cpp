@@ -6,13 +6,16 @@
 
 #include "DirectiveParser.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <cstring>
 #include <sstream>
 
 #include "DiagnosticsBase.h"
 #include "DirectiveHandlerBase.h"
 #include "ExpressionParser.h"
+#include "IncludeCache.h"
 #include "MacroExpander.h"
 #include "Token.h"
 #include "Tokenizer.h"
@@ -33,8 +36,12 @@ enum DirectiveType
     DIRECTIVE_PRAGMA,
     DIRECTIVE_EXTENSION,
     DIRECTIVE_VERSION,
-    DIRECTIVE_LINE
+    DIRECTIVE_LINE,
+    DIRECTIVE_INCLUDE
 };
+
+// Bounds the recursion of sources that include themselves.
+const size_t kMaxIncludeDepth = 32;
 }  // namespace
 
 static DirectiveType getDirective(const pp::Token* token)
@@ -52,6 +59,7 @@ static DirectiveType getDirective(const pp::Token* token)
     static const std::string kDirectiveExtension("extension");
     static const std::string kDirectiveVersion("version");
     static const std::string kDirectiveLine("line");
+    static const std::string kDirectiveInclude("include");
 
     if (token->type != pp::Token::IDENTIFIER)
         return DIRECTIVE_NONE;
@@ -82,6 +90,8 @@ static DirectiveType getDirective(const pp::Token* token)
         return DIRECTIVE_VERSION;
     else if (token->text == kDirectiveLine)
         return DIRECTIVE_LINE;
+    else if (token->text == kDirectiveInclude)
+        return DIRECTIVE_INCLUDE;
 
     return DIRECTIVE_NONE;
 }
@@ -116,24 +126,26 @@ static void skipUntilEOD(pp::Lexer* lexer, pp::Token* token)
     }
 }
 
-static bool isMacroNameReserved(const std::string& name)
+static bool isMacroNameReserved(const pp::TokenText& name)
 {
     // Names prefixed with "GL_" are reserved.
-    if (name.substr(0, 3) == "GL_")
+    if ((name.size() >= 3) && (std::strncmp(name.data(), "GL_", 3) == 0))
         return true;
 
     // Names containing two consecutive underscores are reserved.
-    if (name.find("__") != std::string::npos)
+    static const char kUnderscores[] = "__";
+    if (std::search(name.begin(), name.end(),
+                    kUnderscores, kUnderscores + 2) != name.end())
         return true;
 
     return false;
 }
 
-static bool isMacroPredefined(const std::string& name,
+static bool isMacroPredefined(const pp::TokenText& name,
                               const pp::MacroSet& macroSet)
 {
-    pp::MacroSet::const_iterator iter = macroSet.find(name);
-    return iter != macroSet.end() ? iter->second.predefined : false;
+    const pp::Macro* macro = macroSet.find(name);
+    return macro ? macro->predefined : false;
 }
 
 namespace pp
@@ -177,8 +189,7 @@ class DefinedParser : public Lexer
             skipUntilEOD(mLexer, token);
             return;
         }
-        MacroSet::const_iterator iter = mMacroSet->find(token->text);
-        std::string expression = iter != mMacroSet->end() ? "1" : "0";
+        const char* expression = mMacroSet->find(token->text) ? "1" : "0";
 
         if (paren)
         {
@@ -195,7 +206,7 @@ class DefinedParser : public Lexer
         // We have a valid defined operator.
         // Convert the current token into a CONST_INT token.
         token->type = Token::CONST_INT;
-        token->text = expression;
+        token->text.assign(expression);
     }
 
   private:
@@ -206,13 +217,17 @@ class DefinedParser : public Lexer
 
 DirectiveParser::DirectiveParser(Tokenizer* tokenizer,
                                  MacroSet* macroSet,
+                                 TokenTextTable* textTable,
                                  Diagnostics* diagnostics,
                                  DirectiveHandler* directiveHandler) :
     mPastFirstStatement(false),
     mTokenizer(tokenizer),
     mMacroSet(macroSet),
+    mTextTable(textTable),
     mDiagnostics(diagnostics),
-    mDirectiveHandler(directiveHandler)
+    mDirectiveHandler(directiveHandler),
+    mIncludeCache(0),
+    mNumIncludes(0)
 {
 }
 
@@ -220,6 +235,10 @@ void DirectiveParser::lex(Token* token)
 {
     do
     {
+        // Only the directives of excluded groups matter, so the lines that
+        // cannot hold one are not even lexed.
+        if (skipping())
+            mTokenizer->skipExcludedLines();
         mTokenizer->lex(token);
 
         if (token->type == Token::PP_HASH)
@@ -265,6 +284,10 @@ void DirectiveParser::parseDirective(Token* token)
         return;
     }
 
+    // #include is only a directive if it is enabled.
+    if ((directive == DIRECTIVE_INCLUDE) && !mIncludeCache)
+        directive = DIRECTIVE_NONE;
+
     switch(directive)
     {
       case DIRECTIVE_NONE:
@@ -311,6 +334,9 @@ void DirectiveParser::parseDirective(Token* token)
       case DIRECTIVE_LINE:
         parseLine(token);
         break;
+      case DIRECTIVE_INCLUDE:
+        parseInclude(token);
+        break;
       default:
         assert(false);
         break;
@@ -393,15 +419,16 @@ void DirectiveParser::parseDefine(Token* token)
     }
 
     // Check for macro redefinition.
-    MacroSet::const_iterator iter = mMacroSet->find(macro.name);
-    if (iter != mMacroSet->end() && !macro.equals(iter->second))
+    const Macro* previous = mMacroSet->find(macro.name);
+    if (previous && !macro.equals(*previous))
     {
         mDiagnostics->report(Diagnostics::MACRO_REDEFINED,
                              token->location,
                              macro.name);
         return;
     }
-    mMacroSet->insert(std::make_pair(macro.name, macro));
+    if (!previous)
+        mMacroSet->insert(macro);
 }
 
 void DirectiveParser::parseUndef(Token* token)
@@ -416,17 +443,17 @@ void DirectiveParser::parseUndef(Token* token)
         return;
     }
 
-    MacroSet::iterator iter = mMacroSet->find(token->text);
-    if (iter != mMacroSet->end())
+    const Macro* macro = mMacroSet->find(token->text);
+    if (macro)
     {
-        if (iter->second.predefined)
+        if (macro->predefined)
         {
             mDiagnostics->report(Diagnostics::MACRO_PREDEFINED_UNDEFINED,
                                  token->location, token->text);
         }
         else
         {
-            mMacroSet->erase(iter);
+            mMacroSet->erase(token->text);
         }
     }
 
@@ -593,14 +620,14 @@ void DirectiveParser::parsePragma(Token* token)
         switch(state++)
         {
           case PRAGMA_NAME:
-            name = token->text;
+            name = token->text.str();
             valid = valid && (token->type == Token::IDENTIFIER);
             break;
           case LEFT_PAREN:
             valid = valid && (token->type == '(');
             break;
           case PRAGMA_VALUE:
-            value = token->text;
+            value = token->text.str();
             valid = valid && (token->type == Token::IDENTIFIER);
             break;
           case RIGHT_PAREN:
@@ -654,7 +681,7 @@ void DirectiveParser::parseExtension(Token* token)
                                      token->location, token->text);
                 valid = false;
             }
-            if (valid) name = token->text;
+            if (valid) name = token->text.str();
             break;
           case COLON:
             if (valid && (token->type != ':'))
@@ -671,7 +698,7 @@ void DirectiveParser::parseExtension(Token* token)
                                      token->location, token->text);
                 valid = false;
             }
-            if (valid) behavior = token->text;
+            if (valid) behavior = token->text.str();
             break;
           default:
             if (valid)
@@ -769,7 +796,8 @@ void DirectiveParser::parseLine(Token* token)
     int line = 0, file = 0;
     int state = LINE_NUMBER;
 
-    MacroExpander macroExpander(mTokenizer, mMacroSet, mDiagnostics);
+    MacroExpander macroExpander(mTokenizer, mMacroSet, mTextTable,
+                                mDiagnostics, 0);
     macroExpander.lex(token);
     while ((token->type != '\n') && (token->type != Token::LAST))
     {
@@ -828,6 +856,85 @@ void DirectiveParser::parseLine(Token* token)
     }
 }
 
+void DirectiveParser::parseInclude(Token* token)
+{
+    assert(getDirective(token) == DIRECTIVE_INCLUDE);
+    assert(mIncludeCache);
+
+    // The name is between quotes or angle brackets. A quote is a token of
+    // its own, and the name is made up of the tokens up to the next one.
+    const SourceLocation location = token->location;
+    mTokenizer->lex(token);
+    int close = 0;
+    if (token->type == '<')
+        close = '>';
+    else if ((token->type == Token::PP_OTHER) && (token->text == "\""))
+        close = '"';
+
+    std::string name;
+    bool valid = close != 0;
+    if (valid)
+    {
+        mTokenizer->lex(token);
+        while (!isEOD(token) &&
+               !((token->text.size() == 1) && (token->text[0] == close)))
+        {
+            if (token->hasLeadingSpace() && !name.empty())
+                name += ' ';
+            name.append(token->text.data(), token->text.size());
+            mTokenizer->lex(token);
+        }
+        valid = !isEOD(token) && !name.empty();
+        if (valid)
+        {
+            mTokenizer->lex(token);
+            valid = isEOD(token);
+        }
+    }
+    if (!valid)
+    {
+        mDiagnostics->report(Diagnostics::INVALID_INCLUDE_DIRECTIVE,
+                             token->location, token->text);
+        return;
+    }
+
+    if (mTokenizer->pushedTokensDepth() >= kMaxIncludeDepth)
+    {
+        mDiagnostics->report(Diagnostics::INCLUDE_TOO_DEEP, location, name);
+        return;
+    }
+    const char* text = 0;
+    size_t length = 0;
+    if (!mDirectiveHandler->handleInclude(location, name, &text, &length))
+    {
+        mDiagnostics->report(Diagnostics::INCLUDE_NOT_FOUND, location, name);
+        return;
+    }
+
+    // Included sources are numbered after the input strings, in the order
+    // they are included.
+    const IncludeCache::Source& source =
+        mIncludeCache->get(text, length, mTokenizer->maxTokenLength());
+    int file = static_cast<int>(mTokenizer->inputCount()) + mNumIncludes++;
+    for (size_t i = 0; i < source.diagnostics.size(); ++i)
+    {
+        const IncludeCache::Source::Diagnostic& diagnostic =
+            source.diagnostics[i];
+        SourceLocation diagnosticLocation = diagnostic.location;
+        diagnosticLocation.file = file;
+        mDiagnostics->report(diagnostic.id, diagnosticLocation,
+                             diagnostic.text);
+    }
+    mTokenizer->pushTokens(&source.tokens, file);
+
+    // The included tokens come before the end of the input too.
+    if (token->type == Token::LAST)
+    {
+        token->type = '\n';
+        token->text.assign("\n");
+    }
+}
+
 bool DirectiveParser::skipping() const
 {
     if (mConditionalStack.empty()) return false;
@@ -883,7 +990,8 @@ int DirectiveParser::parseExpressionIf(Token* token)
            (getDirective(token) == DIRECTIVE_ELIF));
 
     DefinedParser definedParser(mTokenizer, mMacroSet, mDiagnostics);
-    MacroExpander macroExpander(&definedParser, mMacroSet, mDiagnostics);
+    MacroExpander macroExpander(&definedParser, mMacroSet, mTextTable,
+                                mDiagnostics, 0);
     ExpressionParser expressionParser(&macroExpander, mDiagnostics);
 
     int expression = 0;
@@ -915,8 +1023,7 @@ int DirectiveParser::parseExpressionIfdef(Token* token)
         return 0;
     }
 
-    MacroSet::const_iterator iter = mMacroSet->find(token->text);
-    int expression = iter != mMacroSet->end() ? 1 : 0;
+    int expression = mMacroSet->find(token->text) ? 1 : 0;
 
     // Warn if there are tokens after #ifdef expression.
     mTokenizer->lex(token);
@@ -11,12 +11,14 @@
 #include "Macro.h"
 #include "pp_utils.h"
 #include "SourceLocation.h"
+#include "TokenText.h"
 
 namespace pp
 {
 
 class Diagnostics;
 class DirectiveHandler;
+class IncludeCache;
 class Tokenizer;
 
 class DirectiveParser : public Lexer
@@ -24,9 +26,13 @@ class DirectiveParser : public Lexer
   public:
     DirectiveParser(Tokenizer* tokenizer,
                     MacroSet* macroSet,
+                    TokenTextTable* textTable,
                     Diagnostics* diagnostics,
                     DirectiveHandler* directiveHandler);
 
+    // Enables #include. The included sources are tokenized through cache.
+    void setIncludeCache(IncludeCache* cache) { mIncludeCache = cache; }
+
     virtual void lex(Token* token);
 
   private:
@@ -46,6 +52,7 @@ class DirectiveParser : public Lexer
     void parseExtension(Token* token);
     void parseVersion(Token* token);
     void parseLine(Token* token);
+    void parseInclude(Token* token);
 
     bool skipping() const;
     void parseConditionalIf(Token* token);
@@ -54,7 +61,7 @@ class DirectiveParser : public Lexer
 
     struct ConditionalBlock
     {
-        std::string type;
+        TokenText type;
         SourceLocation location;
         bool skipBlock;
         bool skipGroup;
@@ -73,8 +80,11 @@ class DirectiveParser : public Lexer
     std::vector<ConditionalBlock> mConditionalStack;
     Tokenizer* mTokenizer;
     MacroSet* mMacroSet;
+    TokenTextTable* mTextTable;
     Diagnostics* mDiagnostics;
     DirectiveHandler* mDirectiveHandler;
+    IncludeCache* mIncludeCache;
+    int mNumIncludes;
 };
 
 }  // namespace pp
@@ -0,0 +1,129 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#include "IncludeCache.h"
+
+#include <cstring>
+
+#include "Tokenizer.h"
+
+namespace
+{
+
+// Keeps the diagnostics reported while a source is tokenized, so that they
+// can be reported again whenever it is included.
+class DiagnosticsRecorder : public pp::Diagnostics
+{
+  public:
+    explicit DiagnosticsRecorder(pp::IncludeCache::Source* source) :
+        mSource(source)
+    {
+    }
+
+  protected:
+    virtual void print(ID id,
+                       const pp::SourceLocation& loc,
+                       const std::string& text)
+    {
+        pp::IncludeCache::Source::Diagnostic diagnostic;
+        diagnostic.id = id;
+        diagnostic.location = loc;
+        diagnostic.text = text;
+        mSource->diagnostics.push_back(diagnostic);
+    }
+
+  private:
+    pp::IncludeCache::Source* mSource;
+};
+
+}  // namespace
+
+namespace pp
+{
+
+IncludeCache::IncludeCache() :
+    mTotalSize(0),
+    mTextTable(new TokenTextTable)
+{
+}
+
+IncludeCache::~IncludeCache()
+{
+    clear();
+    delete mTextTable;
+}
+
+const IncludeCache::Source& IncludeCache::get(const char* text,
+                                              size_t length,
+                                              size_t maxTokenLength)
+{
+    size_t hash = TokenText(text, length).hash();
+    std::pair<SourceMap::iterator, SourceMap::iterator> range =
+        mSources.equal_range(hash);
+    for (SourceMap::iterator iter = range.first; iter != range.second; ++iter)
+    {
+        const Source* source = iter->second;
+        if ((source->maxTokenLength == maxTokenLength) &&
+            (source->text.size() == length) &&
+            (std::memcmp(source->text.data(), text, length) == 0))
+            return *source;
+    }
+
+    Source* source = new Source;
+    source->text.assign(text, length);
+    source->hash = hash;
+    source->maxTokenLength = maxTokenLength;
+
+    // The tokens refer to the copy of the text, which the cache keeps.
+    DiagnosticsRecorder diagnostics(source);
+    Tokenizer tokenizer(&diagnostics, mTextTable);
+    const char* string = source->text.c_str();
+    int stringLength = static_cast<int>(length);
+    tokenizer.init(1, &string, &stringLength);
+    tokenizer.setMaxTokenLength(maxTokenLength);
+
+    Token token;
+    tokenizer.lex(&token);
+    while (token.type != Token::LAST)
+    {
+        source->tokens.push_back(token);
+        tokenizer.lex(&token);
+    }
+    // The includer goes on with a new line.
+    if (!source->tokens.empty() && (source->tokens.back().type != '\n'))
+    {
+        token.type = '\n';
+        token.text.assign("\n");
+        source->tokens.push_back(token);
+    }
+
+    mSources.insert(std::make_pair(hash, source));
+    mTotalSize += length;
+    return *source;
+}
+
+void IncludeCache::trim(size_t maxSize)
+{
+    if (mTotalSize > maxSize)
+    {
+        clear();
+        delete mTextTable;
+        mTextTable = new TokenTextTable;
+    }
+}
+
+void IncludeCache::clear()
+{
+    for (SourceMap::iterator iter = mSources.begin();
+         iter != mSources.end(); ++iter)
+    {
+        delete iter->second;
+    }
+    mSources.clear();
+    mTotalSize = 0;
+}
+
+}  // namespace pp
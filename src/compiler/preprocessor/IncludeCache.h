@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#ifndef COMPILER_PREPROCESSOR_INCLUDE_CACHE_H_
+#define COMPILER_PREPROCESSOR_INCLUDE_CACHE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "DiagnosticsBase.h"
+#include "pp_utils.h"
+#include "SourceLocation.h"
+#include "Token.h"
+#include "TokenText.h"
+
+namespace pp
+{
+
+// The tokens of the sources included with #include, kept across
+// preprocessors so that a source included by many shaders is tokenized
+// once. Sources are looked up by their content, not their name. The tokens
+// are those of the tokenizer: directives are still parsed and macros still
+// expanded each time a source is included.
+class IncludeCache
+{
+  public:
+    struct Source
+    {
+        struct Diagnostic
+        {
+            Diagnostics::ID id;
+            SourceLocation location;
+            std::string text;
+        };
+
+        std::string text;
+        size_t hash;
+        size_t maxTokenLength;
+        // The tokens of text, in file 0, ending with a newline. Their text
+        // refers to text or to the cache.
+        std::vector<Token> tokens;
+        // Reported while tokenizing text.
+        std::vector<Diagnostic> diagnostics;
+    };
+
+    IncludeCache();
+    ~IncludeCache();
+
+    // Returns the tokens of the length characters at text, tokenizing them
+    // if no source with the same text is cached.
+    const Source& get(const char* text, size_t length, size_t maxTokenLength);
+
+    // Drops all the sources if they add up to more than maxSize characters.
+    // The tokens of the sources must not be in use.
+    void trim(size_t maxSize);
+
+    size_t size() const { return mSources.size(); }
+
+  private:
+    PP_DISALLOW_COPY_AND_ASSIGN(IncludeCache);
+
+    void clear();
+
+    typedef std::multimap<size_t, Source*> SourceMap;
+    SourceMap mSources;  // Keyed by hash.
+    size_t mTotalSize;
+    // Holds the text of the tokens not found as is in a source.
+    TokenTextTable* mTextTable;
+};
+
+}  // namespace pp
+#endif  // COMPILER_PREPROCESSOR_INCLUDE_CACHE_H_
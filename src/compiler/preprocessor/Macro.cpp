@@ -6,6 +6,9 @@
 
 #include "Macro.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "Token.h"
 
 namespace pp
@@ -19,5 +22,137 @@ bool Macro::equals(const Macro& other) const
            (replacements == other.replacements);
 }
 
+MacroSet::MacroSet(const MacroSet* parent) :
+    mParent(parent),
+    mCount(0),
+    mGeneration(0),
+    mLengths(parent ? parent->mLengths : 0)
+{
+    if (parent)
+        std::memcpy(mFirstChars, parent->mFirstChars, sizeof(mFirstChars));
+    else
+        std::memset(mFirstChars, 0, sizeof(mFirstChars));
+}
+
+MacroSet::~MacroSet()
+{
+    for (size_t i = 0; i < mBuckets.size(); ++i)
+    {
+        Node* node = mBuckets[i];
+        while (node)
+        {
+            Node* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+}
+
+const Macro* MacroSet::find(const TokenText& name) const
+{
+    if (!mayContain(name))
+        return 0;
+    return find(name, name.hash());
+}
+
+void MacroSet::insert(const Macro& macro)
+{
+    ++mGeneration;
+    size_t hash = macro.name.hash();
+    Node** link = findNode(macro.name, hash);
+    if (*link)
+    {
+        (*link)->macro = macro;
+        return;
+    }
+
+    Node* node = new Node;
+    node->macro = macro;
+    node->hash = hash;
+    node->next = 0;
+    *link = node;
+
+    unsigned char first = macro.name.empty() ? 0 : macro.name[0];
+    mFirstChars[first / 32] |= 1u << (first % 32);
+    mLengths |= 1u << std::min<size_t>(macro.name.size(), 31);
+    if (++mCount > mBuckets.size())
+        grow();
+}
+
+void MacroSet::erase(const TokenText& name)
+{
+    if (mCount == 0)
+        return;
+
+    Node** link = findNode(name, name.hash());
+    Node* node = *link;
+    if (node)
+    {
+        *link = node->next;
+        delete node;
+        --mCount;
+        ++mGeneration;
+    }
+}
+
+void MacroSet::getMacros(std::vector<const Macro*>* macros) const
+{
+    for (size_t i = 0; i < mBuckets.size(); ++i)
+    {
+        for (const Node* node = mBuckets[i]; node; node = node->next)
+            macros->push_back(&node->macro);
+    }
+}
+
+bool MacroSet::mayContain(const TokenText& name) const
+{
+    unsigned char first = name.empty() ? 0 : name[0];
+    return ((mFirstChars[first / 32] & (1u << (first % 32))) != 0) &&
+           ((mLengths & (1u << std::min<size_t>(name.size(), 31))) != 0);
+}
+
+const Macro* MacroSet::find(const TokenText& name, size_t hash) const
+{
+    if (mCount != 0)
+    {
+        for (const Node* node = mBuckets[hash & (mBuckets.size() - 1)];
+             node; node = node->next)
+        {
+            if ((node->hash == hash) && (node->macro.name == name))
+                return &node->macro;
+        }
+    }
+    return mParent ? mParent->find(name, hash) : 0;
+}
+
+MacroSet::Node** MacroSet::findNode(const TokenText& name, size_t hash)
+{
+    if (mBuckets.empty())
+        grow();
+
+    Node** link = &mBuckets[hash & (mBuckets.size() - 1)];
+    while (*link && !(((*link)->hash == hash) && ((*link)->macro.name == name)))
+        link = &(*link)->next;
+    return link;
+}
+
+void MacroSet::grow()
+{
+    std::vector<Node*> buckets(std::max<size_t>(mBuckets.size() * 2, 16), 0);
+    size_t mask = buckets.size() - 1;
+    for (size_t i = 0; i < mBuckets.size(); ++i)
+    {
+        Node* node = mBuckets[i];
+        while (node)
+        {
+            Node* next = node->next;
+            node->next = buckets[node->hash & mask];
+            buckets[node->hash & mask] = node;
+            node = next;
+        }
+    }
+    mBuckets.swap(buckets);
+}
+
 }  // namespace pp
 
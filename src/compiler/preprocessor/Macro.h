@@ -7,10 +7,11 @@
 #ifndef COMPILER_PREPROCESSOR_MACRO_H_
 #define COMPILER_PREPROCESSOR_MACRO_H_
 
-#include <map>
-#include <string>
 #include <vector>
 
+#include "pp_utils.h"
+#include "TokenText.h"
+
 namespace pp
 {
 
@@ -23,7 +24,7 @@ struct Macro
         kTypeObj,
         kTypeFunc
     };
-    typedef std::vector<std::string> Parameters;
+    typedef std::vector<TokenText> Parameters;
     typedef std::vector<Token> Replacements;
 
     Macro() : predefined(false), disabled(false), type(kTypeObj) { }
@@ -33,12 +34,67 @@ struct Macro
     mutable bool disabled;
 
     Type type;
-    std::string name;
+    TokenText name;
     Parameters parameters;
     Replacements replacements;
 };
 
-typedef std::map<std::string, Macro> MacroSet;
+// Hash table of macros, keyed by name. Macros stay where they are until
+// they are erased. Most identifiers are not macro names, so each set keeps
+// the first characters and lengths of its names, and rejects most other
+// names without hashing them.
+class MacroSet
+{
+  public:
+    // The macros of parent are also found through this set, unless it has
+    // macros of the same names. The parent must outlive this set, and is
+    // not changed by it.
+    explicit MacroSet(const MacroSet* parent = 0);
+    ~MacroSet();
+
+    // Returns the macro with the given name, or NULL if there is none.
+    const Macro* find(const TokenText& name) const;
+    // Adds macro, replacing the macro of this set with the same name.
+    void insert(const Macro& macro);
+    // Removes the macro with the given name from this set.
+    void erase(const TokenText& name);
+    // Appends the macros of this set, but not those of the parent.
+    void getMacros(std::vector<const Macro*>* macros) const;
+
+    // Changes whenever a macro is inserted or erased, here or in the
+    // parent, so that results depending on the macros can be revalidated.
+    unsigned int generation() const
+    {
+        return mGeneration + (mParent ? mParent->generation() : 0);
+    }
+
+  private:
+    PP_DISALLOW_COPY_AND_ASSIGN(MacroSet);
+
+    struct Node
+    {
+        Macro macro;
+        size_t hash;
+        Node* next;
+    };
+
+    bool mayContain(const TokenText& name) const;
+    const Macro* find(const TokenText& name, size_t hash) const;
+    Node** findNode(const TokenText& name, size_t hash);
+    void grow();
+
+    const MacroSet* mParent;
+    std::vector<Node*> mBuckets;  // Power-of-two size, or empty.
+    size_t mCount;
+    unsigned int mGeneration;
+
+    // Bit c is set if a name starts with character c, either in this set
+    // or in the parent. Bits are not cleared when a macro is erased.
+    unsigned int mFirstChars[256 / 32];
+    // Bit n is set if a name is n characters long, or if n is 31 and a
+    // name is longer.
+    unsigned int mLengths;
+};
 
 }  // namespace pp
 #endif  // COMPILER_PREPROCESSOR_MACRO_H_
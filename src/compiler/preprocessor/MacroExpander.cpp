@@ -12,6 +12,15 @@
 #include "DiagnosticsBase.h"
 #include "Token.h"
 
+namespace
+{
+
+// Most invocations are not repeated with the same arguments, so there is
+// a limit on the number remembered.
+const size_t kMaxCacheEntries = 4096;
+
+}  // namespace
+
 namespace pp
 {
 
@@ -46,12 +55,127 @@ class TokenLexer : public Lexer
     TokenVector::const_iterator mIter;
 };
 
+// Discards the diagnostics reported while a replacement list is rescanned
+// in isolation. They are reported when it is rescanned in context.
+class NullDiagnostics : public Diagnostics
+{
+  protected:
+    virtual void print(ID id,
+                       const SourceLocation& loc,
+                       const std::string& text)
+    {
+    }
+};
+
+static bool tokensEqual(const Token& lhs, const Token& rhs)
+{
+    // The location is that of the macro name, whatever it was.
+    return (lhs.type == rhs.type) &&
+           (lhs.flags == rhs.flags) &&
+           (lhs.text == rhs.text);
+}
+
+MacroExpansionCache::MacroExpansionCache() :
+    mGeneration(0),
+    mActiveExpansions(0),
+    mUncacheable(false)
+{
+}
+
+MacroExpansionCache::Entry* MacroExpansionCache::find(
+    const Macro& macro,
+    const Token& identifier,
+    const std::vector<std::vector<Token> >& args,
+    size_t* hash)
+{
+    const unsigned int flags = identifier.flags & kPaddingFlags;
+
+    size_t h = reinterpret_cast<size_t>(&macro) ^ flags;
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        for (size_t j = 0; j < args[i].size(); ++j)
+        {
+            const Token& token = args[i][j];
+            h = h * 31 + (token.text.hash() ^ token.type ^ (token.flags << 16));
+        }
+        h = h * 31 + 1;
+    }
+    *hash = h;
+
+    std::pair<Entries::iterator, Entries::iterator> range =
+        mEntries.equal_range(h);
+    for (Entries::iterator iter = range.first; iter != range.second; ++iter)
+    {
+        Entry& entry = iter->second;
+        if ((entry.macro != &macro) || (entry.flags != flags))
+            continue;
+
+        // The arguments are separated by LAST tokens in the entry.
+        bool match = true;
+        size_t index = 0;
+        for (size_t i = 0; match && (i < args.size()); ++i)
+        {
+            for (size_t j = 0; match && (j < args[i].size()); ++j, ++index)
+            {
+                match = (index < entry.args.size()) &&
+                        tokensEqual(entry.args[index], args[i][j]);
+            }
+            match = match && (index < entry.args.size()) &&
+                    (entry.args[index++].type == Token::LAST);
+        }
+        if (match && (index == entry.args.size()))
+            return &entry;
+    }
+    return 0;
+}
+
+MacroExpansionCache::Entry* MacroExpansionCache::insert(
+    const Macro& macro,
+    const Token& identifier,
+    const std::vector<std::vector<Token> >& args,
+    size_t hash)
+{
+    if (mEntries.size() >= kMaxCacheEntries)
+        mEntries.clear();
+
+    Entries::iterator iter = mEntries.insert(std::make_pair(hash, Entry()));
+    Entry& entry = iter->second;
+    entry.macro = &macro;
+    entry.flags = identifier.flags & kPaddingFlags;
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        entry.args.insert(entry.args.end(), args[i].begin(), args[i].end());
+        entry.args.push_back(Token());
+    }
+    entry.state = kStateSeen;
+    return &entry;
+}
+
+void MacroExpansionCache::validate(const MacroSet& macroSet)
+{
+    // The entries refer to the macros, and the expansions depend on all of
+    // them.
+    unsigned int generation = macroSet.generation();
+    if (generation != mGeneration)
+    {
+        mEntries.clear();
+        mGeneration = generation;
+    }
+}
+
 MacroExpander::MacroExpander(Lexer* lexer,
                              MacroSet* macroSet,
-                             Diagnostics* diagnostics) :
+                             TokenTextTable* textTable,
+                             Diagnostics* diagnostics,
+                             MacroExpansionCache* cache) :
     mLexer(lexer),
     mMacroSet(macroSet),
-    mDiagnostics(diagnostics)
+    mTextTable(textTable),
+    mDiagnostics(diagnostics),
+    mCache(cache),
+    mTokenRescanned(false),
+    mIsolated(false),
+    mReadPastEnd(false)
 {
 }
 
@@ -61,6 +185,10 @@ MacroExpander::~MacroExpander()
     {
         delete mContextStack[i];
     }
+    for (std::size_t i = 0; i < mFreeContexts.size(); ++i)
+    {
+        delete mFreeContexts[i];
+    }
 }
 
 void MacroExpander::lex(Token* token)
@@ -72,33 +200,37 @@ void MacroExpander::lex(Token* token)
         if (token->type != Token::IDENTIFIER)
             break;
 
+        // The tokens of a rescanned replacement list are final.
+        if (mTokenRescanned)
+            break;
+
         if (token->expansionDisabled())
             break;
 
-        MacroSet::const_iterator iter = mMacroSet->find(token->text);
-        if (iter == mMacroSet->end())
+        const Macro* macro = mMacroSet->find(token->text);
+        if (!macro)
             break;
 
-        const Macro& macro = iter->second;
-        if (macro.disabled)
+        if (macro->disabled)
         {
             // If a particular token is not expanded, it is never expanded.
             token->setExpansionDisabled(true);
             break;
         }
-        if ((macro.type == Macro::kTypeFunc) && !isNextTokenLeftParen())
+        if ((macro->type == Macro::kTypeFunc) && !isNextTokenLeftParen())
         {
             // If the token immediately after the macro name is not a '(',
             // this macro should not be expanded.
             break;
         }
 
-        pushMacro(macro, *token);
+        pushMacro(*macro, *token);
     }
 }
 
 void MacroExpander::getToken(Token* token)
 {
+    mTokenRescanned = false;
     if (mReserveToken.get())
     {
         *token = *mReserveToken;
@@ -114,7 +246,9 @@ void MacroExpander::getToken(Token* token)
 
     if (!mContextStack.empty())
     {
-        *token = mContextStack.back()->get();
+        MacroContext* context = mContextStack.back();
+        *token = context->get();
+        mTokenRescanned = context->rescanned;
     }
     else
     {
@@ -143,6 +277,10 @@ bool MacroExpander::isNextTokenLeftParen()
     getToken(&token);
 
     bool lparen = token.type == '(';
+    // Whether the macro is invoked depends on what follows the replacement
+    // list being rescanned.
+    if (mIsolated && (token.type == Token::LAST))
+        mReadPastEnd = true;
     ungetToken(token);
 
     return lparen;
@@ -155,16 +293,43 @@ bool MacroExpander::pushMacro(const Macro& macro, const Token& identifier)
     assert(identifier.type == Token::IDENTIFIER);
     assert(identifier.text == macro.name);
 
-    std::vector<Token> replacements;
-    if (!expandMacro(macro, identifier, &replacements))
+    MacroContext* context = 0;
+    if (mFreeContexts.empty())
+    {
+        context = new MacroContext;
+    }
+    else
+    {
+        context = mFreeContexts.back();
+        mFreeContexts.pop_back();
+    }
+
+    bool rescanned = false;
+    bool expanded = (mCache && !macro.predefined &&
+                     (mCache->mActiveExpansions == 0)) ?
+        expandMacroMemoized(macro, identifier, &context->replacements,
+                            &rescanned) :
+        expandMacro(macro, identifier, &context->replacements);
+    if (!expanded)
+    {
+        mFreeContexts.push_back(context);
         return false;
+    }
 
     // Macro is disabled for expansion until it is popped off the stack.
-    macro.disabled = true;
+    // Predefined macros expand to a number, so they need not be disabled,
+    // and they are left alone as they may be shared by preprocessors.
+    // Neither is a macro whose replacement list is already rescanned.
+    if (!macro.predefined && !rescanned)
+    {
+        macro.disabled = true;
+        if (mCache)
+            ++mCache->mActiveExpansions;
+    }
 
-    MacroContext* context = new MacroContext;
     context->macro = &macro;
-    context->replacements.swap(replacements);
+    context->rescanned = rescanned;
+    context->index = 0;
     mContextStack.push_back(context);
     return true;
 }
@@ -177,14 +342,112 @@ void MacroExpander::popMacro()
     mContextStack.pop_back();
 
     assert(context->empty());
-    assert(context->macro->disabled);
-    context->macro->disabled = false;
-    delete context;
+    if (!context->macro->predefined && !context->rescanned)
+    {
+        assert(context->macro->disabled);
+        context->macro->disabled = false;
+        if (mCache)
+            --mCache->mActiveExpansions;
+    }
+    mFreeContexts.push_back(context);
 }
 
 bool MacroExpander::expandMacro(const Macro& macro,
                                 const Token& identifier,
                                 std::vector<Token>* replacements)
+{
+    std::vector<MacroArg> args;
+    if (macro.type == Macro::kTypeFunc)
+    {
+        args.reserve(macro.parameters.size());
+        if (!collectMacroArgs(macro, identifier, &args))
+            return false;
+    }
+
+    substituteMacroArgs(macro, identifier, &args, replacements);
+    return true;
+}
+
+bool MacroExpander::expandMacroMemoized(const Macro& macro,
+                                        const Token& identifier,
+                                        std::vector<Token>* replacements,
+                                        bool* rescanned)
+{
+    std::vector<MacroArg> args;
+    if (macro.type == Macro::kTypeFunc)
+    {
+        args.reserve(macro.parameters.size());
+        if (!collectMacroArgs(macro, identifier, &args))
+            return false;
+    }
+
+    mCache->validate(*mMacroSet);
+    size_t hash = 0;
+    MacroExpansionCache::Entry* entry =
+        mCache->find(macro, identifier, args, &hash);
+    if (entry && (entry->state == MacroExpansionCache::kStateExpanded))
+    {
+        replacements->assign(entry->expansion.begin(), entry->expansion.end());
+        for (std::size_t i = 0; i < replacements->size(); ++i)
+            (*replacements)[i].location = identifier.location;
+        *rescanned = true;
+        return true;
+    }
+    // The expansion is only computed in isolation the second time, so
+    // that invocations seen once cost no more than an entry.
+    bool seenBefore = (entry != 0);
+    if (!entry)
+        entry = mCache->insert(macro, identifier, args, hash);
+
+    // The entry stays valid as long as no expansion uses the cache.
+    ++mCache->mActiveExpansions;
+    mCache->mUncacheable = false;
+    substituteMacroArgs(macro, identifier, &args, replacements);
+
+    if (seenBefore && (entry->state == MacroExpansionCache::kStateSeen))
+    {
+        entry->state = MacroExpansionCache::kStateUncacheable;
+        std::vector<Token> expansion;
+        if (rescanInIsolation(macro, *replacements, &expansion))
+        {
+            entry->state = MacroExpansionCache::kStateExpanded;
+            entry->expansion = expansion;
+            replacements->swap(expansion);
+            *rescanned = true;
+        }
+    }
+    --mCache->mActiveExpansions;
+    return true;
+}
+
+bool MacroExpander::rescanInIsolation(const Macro& macro,
+                                      const std::vector<Token>& replacements,
+                                      std::vector<Token>* expansion)
+{
+    std::vector<Token> tokens(replacements);
+    TokenLexer lexer(&tokens);
+    NullDiagnostics diagnostics;
+    MacroExpander expander(&lexer, mMacroSet, mTextTable, &diagnostics,
+                           mCache);
+    expander.mIsolated = true;
+
+    macro.disabled = true;
+    Token token;
+    expander.lex(&token);
+    while (token.type != Token::LAST)
+    {
+        expansion->push_back(token);
+        expander.lex(&token);
+    }
+    macro.disabled = false;
+
+    return !expander.mReadPastEnd && !mCache->mUncacheable;
+}
+
+void MacroExpander::substituteMacroArgs(const Macro& macro,
+                                        const Token& identifier,
+                                        std::vector<MacroArg>* args,
+                                        std::vector<Token>* replacements)
 {
     replacements->clear();
     if (macro.type == Macro::kTypeObj)
@@ -199,29 +462,27 @@ bool MacroExpander::expandMacro(const Macro& macro,
 
             assert(replacements->size() == 1);
             Token& repl = replacements->front();
+            if (mCache && ((macro.name == kLine) || (macro.name == kFile)))
+                mCache->mUncacheable = true;
             if (macro.name == kLine)
             {
                 std::ostringstream stream;
                 stream << identifier.location.line;
-                repl.text = stream.str();
+                repl.text = mTextTable->intern(stream.str());
             }
             else if (macro.name == kFile)
             {
                 std::ostringstream stream;
                 stream << identifier.location.file;
-                repl.text = stream.str();
+                repl.text = mTextTable->intern(stream.str());
             }
         }
     }
     else
     {
         assert(macro.type == Macro::kTypeFunc);
-        std::vector<MacroArg> args;
-        args.reserve(macro.parameters.size());
-        if (!collectMacroArgs(macro, identifier, &args))
-            return false;
-
-        replaceMacroParams(macro, args, replacements);
+        expandMacroArgs(args);
+        replaceMacroParams(macro, *args, replacements);
     }
 
     for (std::size_t i = 0; i < replacements->size(); ++i)
@@ -236,7 +497,6 @@ bool MacroExpander::expandMacro(const Macro& macro,
         }
         repl.location = identifier.location;
     }
-    return true;
 }
 
 bool MacroExpander::collectMacroArgs(const Macro& macro,
@@ -254,6 +514,8 @@ bool MacroExpander::collectMacroArgs(const Macro& macro,
 
         if (token.type == Token::LAST)
         {
+            if (mCache)
+                mCache->mUncacheable = true;
             mDiagnostics->report(Diagnostics::MACRO_UNTERMINATED_INVOCATION,
                                  identifier.location, identifier.text);
             // Do not lose EOF token.
@@ -304,18 +566,26 @@ bool MacroExpander::collectMacroArgs(const Macro& macro,
         Diagnostics::ID id = args->size() < macro.parameters.size() ?
             Diagnostics::MACRO_TOO_FEW_ARGS :
             Diagnostics::MACRO_TOO_MANY_ARGS;
+        if (mCache)
+            mCache->mUncacheable = true;
         mDiagnostics->report(id, identifier.location, identifier.text);
         return false;
     }
+    return true;
+}
 
+void MacroExpander::expandMacroArgs(std::vector<MacroArg>* args)
+{
     // Pre-expand each argument before substitution.
     // This step expands each argument individually before they are
     // inserted into the macro body.
+    Token token;
     for (std::size_t i = 0; i < args->size(); ++i)
     {
         MacroArg& arg = args->at(i);
         TokenLexer lexer(&arg);
-        MacroExpander expander(&lexer, mMacroSet, mDiagnostics);
+        MacroExpander expander(&lexer, mMacroSet, mTextTable, mDiagnostics,
+                               mCache);
 
         arg.clear();
         expander.lex(&token);
@@ -325,7 +595,6 @@ bool MacroExpander::collectMacroArgs(const Macro& macro,
             expander.lex(&token);
         }
     }
-    return true;
 }
 
 void MacroExpander::replaceMacroParams(const Macro& macro,
@@ -8,22 +8,81 @@
 #define COMPILER_PREPROCESSOR_MACRO_EXPANDER_H_
 
 #include <cassert>
+#include <map>
 #include <memory>
 #include <vector>
 
 #include "Lexer.h"
 #include "Macro.h"
 #include "pp_utils.h"
+#include "Token.h"
 
 namespace pp
 {
 
 class Diagnostics;
+class TokenTextTable;
+
+// Remembers the fully expanded replacement lists of the macros invoked
+// more than once with the same arguments, so that the arguments need not
+// be expanded, substituted and rescanned again. Expansions that depend on
+// the tokens following the invocation, on its location, or that report
+// errors are not remembered. All entries are dropped when a macro is
+// defined or undefined.
+class MacroExpansionCache
+{
+  public:
+    MacroExpansionCache();
+
+  private:
+    PP_DISALLOW_COPY_AND_ASSIGN(MacroExpansionCache);
+    friend class MacroExpander;
+
+    enum State
+    {
+        kStateSeen,         // Invoked once, expansion not computed.
+        kStateExpanded,     // Expansion computed and valid.
+        kStateUncacheable   // Expansion must be computed every time.
+    };
+    struct Entry
+    {
+        const Macro* macro;
+        unsigned int flags;         // Padding flags of the macro name.
+        std::vector<Token> args;    // Unexpanded, separated by LAST tokens.
+        State state;
+        std::vector<Token> expansion;
+    };
+    typedef std::multimap<size_t, Entry> Entries;
+
+    static const unsigned int kPaddingFlags =
+        Token::AT_START_OF_LINE | Token::HAS_LEADING_SPACE;
+
+    Entry* find(const Macro& macro, const Token& identifier,
+                const std::vector<std::vector<Token> >& args, size_t* hash);
+    Entry* insert(const Macro& macro, const Token& identifier,
+                  const std::vector<std::vector<Token> >& args, size_t hash);
+    void validate(const MacroSet& macroSet);
+
+    Entries mEntries;
+    unsigned int mGeneration;  // Of the macro set the entries are valid for.
+    // Number of macros being expanded, whose context is on a stack.
+    // Expansions depend on which macros are disabled, so the cache is only
+    // used when no macro is.
+    int mActiveExpansions;
+    // Set when an expansion reports an error, or expands __LINE__ or
+    // __FILE__.
+    bool mUncacheable;
+};
 
 class MacroExpander : public Lexer
 {
   public:
-    MacroExpander(Lexer* lexer, MacroSet* macroSet, Diagnostics* diagnostics);
+    // The cache may be NULL, in which case nothing is memoized.
+    MacroExpander(Lexer* lexer,
+                  MacroSet* macroSet,
+                  TokenTextTable* textTable,
+                  Diagnostics* diagnostics,
+                  MacroExpansionCache* cache);
     virtual ~MacroExpander();
 
     virtual void lex(Token* token);
@@ -38,14 +97,26 @@ class MacroExpander : public Lexer
     bool pushMacro(const Macro& macro, const Token& identifier);
     void popMacro();
 
+    typedef std::vector<Token> MacroArg;
     bool expandMacro(const Macro& macro,
                      const Token& identifier,
                      std::vector<Token>* replacements);
+    bool expandMacroMemoized(const Macro& macro,
+                             const Token& identifier,
+                             std::vector<Token>* replacements,
+                             bool* rescanned);
+    void substituteMacroArgs(const Macro& macro,
+                             const Token& identifier,
+                             std::vector<MacroArg>* args,
+                             std::vector<Token>* replacements);
+    bool rescanInIsolation(const Macro& macro,
+                           const std::vector<Token>& replacements,
+                           std::vector<Token>* expansion);
 
-    typedef std::vector<Token> MacroArg;
     bool collectMacroArgs(const Macro& macro,
                           const Token& identifier,
                           std::vector<MacroArg>* args);
+    void expandMacroArgs(std::vector<MacroArg>* args);
     void replaceMacroParams(const Macro& macro,
                             const std::vector<MacroArg>& args,
                             std::vector<Token>* replacements);
@@ -53,10 +124,13 @@ class MacroExpander : public Lexer
     struct MacroContext
     {
         const Macro* macro;
+        // True if the replacements are already expanded and rescanned,
+        // and the macro is not disabled.
+        bool rescanned;
         std::size_t index;
         std::vector<Token> replacements;
 
-        MacroContext() : macro(0), index(0) { }
+        MacroContext() : macro(0), rescanned(false), index(0) { }
         bool empty() const { return index == replacements.size(); }
         const Token& get() { return replacements[index++]; }
         void unget() { assert(index > 0); --index; }
@@ -64,10 +138,20 @@ class MacroExpander : public Lexer
 
     Lexer* mLexer;
     MacroSet* mMacroSet;
+    TokenTextTable* mTextTable;
     Diagnostics* mDiagnostics;
+    MacroExpansionCache* mCache;
 
     std::auto_ptr<Token> mReserveToken;
     std::vector<MacroContext*> mContextStack;
+    // Popped contexts, kept for the next macros.
+    std::vector<MacroContext*> mFreeContexts;
+    // True if the last token came from a rescanned context.
+    bool mTokenRescanned;
+    // True if this expander rescans a replacement list in isolation, and
+    // a macro invocation in it ran past its end.
+    bool mIsolated;
+    bool mReadPastEnd;
 };
 
 }  // namespace pp
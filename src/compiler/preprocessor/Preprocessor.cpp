@@ -7,40 +7,126 @@
 #include "Preprocessor.h"
 
 #include <cassert>
+#include <cstring>
+#include <memory>
 #include <sstream>
 
 #include "DiagnosticsBase.h"
 #include "DirectiveParser.h"
+#include "IncludeCache.h"
 #include "Macro.h"
 #include "MacroExpander.h"
 #include "Token.h"
 #include "Tokenizer.h"
 
+namespace
+{
+
+void addPredefinedMacro(pp::MacroSet* macroSet,
+                        pp::TokenTextTable* textTable,
+                        const char* name,
+                        int value)
+{
+    std::ostringstream stream;
+    stream << value;
+
+    pp::Token token;
+    token.type = pp::Token::CONST_INT;
+    token.text = textTable->intern(stream.str());
+
+    pp::Macro macro;
+    macro.predefined = true;
+    macro.type = pp::Macro::kTypeObj;
+    macro.name = textTable->intern(name, std::strlen(name));
+    macro.replacements.push_back(token);
+
+    macroSet->insert(macro);
+}
+
+// The size of the included sources kept, beyond which they are all
+// dropped.
+const size_t kMaxIncludeCacheSize = 4 * 1024 * 1024;
+
+}  // namespace
+
 namespace pp
 {
 
+PredefinedMacroSet::PredefinedMacroSet() :
+    mTextTable(new TokenTextTable),
+    mMacroSet(new MacroSet)
+{
+    static const int kGLSLVersion = 100;
+
+    // Add standard pre-defined macros.
+    define("__LINE__", 0);
+    define("__FILE__", 0);
+    define("__VERSION__", kGLSLVersion);
+    define("GL_ES", 1);
+}
+
+PredefinedMacroSet::~PredefinedMacroSet()
+{
+    delete mMacroSet;
+    delete mTextTable;
+}
+
+void PredefinedMacroSet::define(const char* name, int value)
+{
+    addPredefinedMacro(mMacroSet, mTextTable, name, value);
+}
+
+MacroSnapshot::MacroSnapshot() :
+    mTextTable(new TokenTextTable),
+    mMacros(new std::vector<Macro>)
+{
+}
+
+MacroSnapshot::~MacroSnapshot()
+{
+    delete mMacros;
+    delete mTextTable;
+}
+
+size_t MacroSnapshot::size() const
+{
+    return mMacros->size();
+}
+
 struct PreprocessorImpl
 {
     Diagnostics* diagnostics;
+    // Standard macros, if no predefined macros are shared.
+    std::auto_ptr<PredefinedMacroSet> standardMacros;
+    TokenTextTable textTable;
     MacroSet macroSet;
     Tokenizer tokenizer;
     DirectiveParser directiveParser;
+    MacroExpansionCache expansionCache;
     MacroExpander macroExpander;
 
     PreprocessorImpl(Diagnostics* diag,
-                     DirectiveHandler* directiveHandler) :
+                     DirectiveHandler* directiveHandler,
+                     const PredefinedMacroSet* predefinedMacros) :
         diagnostics(diag),
-        tokenizer(diag),
-        directiveParser(&tokenizer, &macroSet, diag, directiveHandler),
-        macroExpander(&directiveParser, &macroSet, diag)
+        standardMacros(predefinedMacros ? 0 : new PredefinedMacroSet),
+        macroSet(predefinedMacros ? predefinedMacros->mMacroSet :
+                                    standardMacros->mMacroSet),
+        tokenizer(diag, &textTable),
+        directiveParser(&tokenizer, &macroSet, &textTable, diag,
+                        directiveHandler),
+        macroExpander(&directiveParser, &macroSet, &textTable, diag,
+                      &expansionCache)
     {
     }
 };
 
 Preprocessor::Preprocessor(Diagnostics* diagnostics,
-                           DirectiveHandler* directiveHandler)
+                           DirectiveHandler* directiveHandler,
+                           const PredefinedMacroSet* predefinedMacros)
 {
-    mImpl = new PreprocessorImpl(diagnostics, directiveHandler);
+    mImpl = new PreprocessorImpl(diagnostics, directiveHandler,
+                                 predefinedMacros);
 }
 
 Preprocessor::~Preprocessor()
@@ -52,38 +138,62 @@ bool Preprocessor::init(size_t count,
                         const char* const string[],
                         const int length[])
 {
-    static const int kGLSLVersion = 100;
-
-    // Add standard pre-defined macros.
-    predefineMacro("__LINE__", 0);
-    predefineMacro("__FILE__", 0);
-    predefineMacro("__VERSION__", kGLSLVersion);
-    predefineMacro("GL_ES", 1);
-
     return mImpl->tokenizer.init(count, string, length);
 }
 
 void Preprocessor::predefineMacro(const char* name, int value)
 {
-    std::ostringstream stream;
-    stream << value;
+    addPredefinedMacro(&mImpl->macroSet, &mImpl->textTable, name, value);
+}
+
+void Preprocessor::setMaxTokenLength(size_t maxLength)
+{
+    mImpl->tokenizer.setMaxTokenLength(maxLength);
+}
 
-    Token token;
-    token.type = Token::CONST_INT;
-    token.text = stream.str();
+void Preprocessor::setIncludeCache(IncludeCache* cache)
+{
+    // No tokens of the cache are in use yet.
+    cache->trim(kMaxIncludeCacheSize);
+    mImpl->directiveParser.setIncludeCache(cache);
+}
 
-    Macro macro;
-    macro.predefined = true;
-    macro.type = Macro::kTypeObj;
-    macro.name = name;
-    macro.replacements.push_back(token);
+void Preprocessor::saveMacros(MacroSnapshot* snapshot) const
+{
+    std::vector<const Macro*> macros;
+    mImpl->macroSet.getMacros(&macros);
+
+    // The text of the macros is in the input or in the text table of this
+    // preprocessor, so the snapshot keeps a copy.
+    TokenTextTable* textTable = snapshot->mTextTable;
+    snapshot->mMacros->clear();
+    for (size_t i = 0; i < macros.size(); ++i)
+    {
+        if (macros[i]->predefined)
+            continue;
 
-    mImpl->macroSet[name] = macro;
+        Macro macro = *macros[i];
+        macro.disabled = false;
+        macro.name = textTable->intern(macro.name.data(), macro.name.size());
+        for (size_t j = 0; j < macro.parameters.size(); ++j)
+        {
+            TokenText& text = macro.parameters[j];
+            text = textTable->intern(text.data(), text.size());
+        }
+        for (size_t j = 0; j < macro.replacements.size(); ++j)
+        {
+            TokenText& text = macro.replacements[j].text;
+            text = textTable->intern(text.data(), text.size());
+        }
+        snapshot->mMacros->push_back(macro);
+    }
 }
 
-void Preprocessor::setMaxTokenLength(size_t maxLength)
+void Preprocessor::defineMacros(const MacroSnapshot& snapshot)
 {
-    mImpl->tokenizer.setMaxTokenLength(maxLength);
+    const std::vector<Macro>& macros = *snapshot.mMacros;
+    for (size_t i = 0; i < macros.size(); ++i)
+        mImpl->macroSet.insert(macros[i]);
 }
 
 void Preprocessor::lex(Token* token)
@@ -8,6 +8,7 @@
 #define COMPILER_PREPROCESSOR_PREPROCESSOR_H_
 
 #include <stddef.h>
+#include <vector>
 
 #include "pp_utils.h"
 
@@ -16,13 +17,60 @@ namespace pp
 
 class Diagnostics;
 class DirectiveHandler;
+class IncludeCache;
+struct Macro;
+class MacroSet;
 struct PreprocessorImpl;
 struct Token;
+class TokenTextTable;
+
+// A set of predefined macros that preprocessors can share, so that the
+// macros are not defined again for each of them. It starts with the
+// standard macros __LINE__, __FILE__, __VERSION__ and GL_ES. It must
+// outlive the preprocessors that use it, which do not change it.
+class PredefinedMacroSet
+{
+  public:
+    PredefinedMacroSet();
+    ~PredefinedMacroSet();
+
+    // Adds a pre-defined macro.
+    void define(const char* name, int value);
+
+  private:
+    PP_DISALLOW_COPY_AND_ASSIGN(PredefinedMacroSet);
+    friend struct PreprocessorImpl;
+
+    TokenTextTable* mTextTable;
+    MacroSet* mMacroSet;
+};
+
+// The macros defined by a preprocessor, saved so that other preprocessors
+// can start with them. It holds the text of the macros.
+class MacroSnapshot
+{
+  public:
+    MacroSnapshot();
+    ~MacroSnapshot();
+
+    size_t size() const;
+
+  private:
+    PP_DISALLOW_COPY_AND_ASSIGN(MacroSnapshot);
+    friend class Preprocessor;
+
+    TokenTextTable* mTextTable;
+    std::vector<Macro>* mMacros;
+};
 
 class Preprocessor
 {
   public:
-    Preprocessor(Diagnostics* diagnostics, DirectiveHandler* directiveHandler);
+    // The preprocessor uses the macros of predefinedMacros if given, and
+    // defines the standard ones itself otherwise.
+    Preprocessor(Diagnostics* diagnostics,
+                 DirectiveHandler* directiveHandler,
+                 const PredefinedMacroSet* predefinedMacros = 0);
     ~Preprocessor();
 
     // count: specifies the number of elements in the string and length arrays.
@@ -43,6 +91,17 @@ class Preprocessor
     // TOKEN_TOO_LONG diagnostic will be generated.
     // The maximum length defaults to 256.
     void setMaxTokenLength(size_t maxLength);
+    // Enables #include. The directive handler provides the included
+    // sources, which are tokenized through cache, so that the sources it
+    // already holds are not tokenized again. The cache must outlive the
+    // preprocessor, and may be used by one preprocessor at a time.
+    void setIncludeCache(IncludeCache* cache);
+    // Saves the macros defined so far, other than the predefined ones, to
+    // snapshot, replacing the macros it held.
+    void saveMacros(MacroSnapshot* snapshot) const;
+    // Defines the macros of snapshot, as if their definitions came before
+    // the input. The snapshot must outlive the preprocessor.
+    void defineMacros(const MacroSnapshot& snapshot);
 
     void lex(Token* token);
 
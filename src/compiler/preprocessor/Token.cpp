@@ -56,19 +56,19 @@ void Token::setExpansionDisabled(bool disable)
 bool Token::iValue(int* value) const
 {
     assert(type == CONST_INT);
-    return numeric_lex_int(text, value);
+    return numeric_lex_int(text.str(), value);
 }
 
 bool Token::uValue(unsigned int* value) const
 {
     assert(type == CONST_INT);
-    return numeric_lex_int(text, value);
+    return numeric_lex_int(text.str(), value);
 }
 
 bool Token::fValue(float* value) const
 {
     assert(type == CONST_FLOAT);
-    return numeric_lex_float(text, value);
+    return numeric_lex_float(text.str(), value);
 }
 
 std::ostream& operator<<(std::ostream& out, const Token& token)
@@ -8,9 +8,9 @@
 #define COMPILER_PREPROCESSOR_TOKEN_H_
 
 #include <ostream>
-#include <string>
 
 #include "SourceLocation.h"
+#include "TokenText.h"
 
 namespace pp
 {
@@ -87,7 +87,7 @@ struct Token
     int type;
     unsigned int flags;
     SourceLocation location;
-    std::string text;
+    TokenText text;
 };
 
 inline bool operator==(const Token& lhs, const Token& rhs)
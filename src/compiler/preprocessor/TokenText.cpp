@@ -0,0 +1,126 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#include "TokenText.h"
+
+#include <algorithm>
+
+namespace
+{
+
+const size_t kInitialSlots = 64;
+const size_t kBlockSize = 4096;
+
+}  // namespace
+
+namespace pp
+{
+
+int TokenText::compare(const TokenText& other) const
+{
+    int result = std::memcmp(mData, other.mData, std::min(mSize, other.mSize));
+    if (result != 0)
+        return result;
+    if (mSize == other.mSize)
+        return 0;
+    return mSize < other.mSize ? -1 : 1;
+}
+
+size_t TokenText::hash() const
+{
+    // FNV-1a.
+    size_t h = 2166136261u;
+    for (size_t i = 0; i < mSize; ++i)
+    {
+        h ^= static_cast<unsigned char>(mData[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+std::ostream& operator<<(std::ostream& out, const TokenText& text)
+{
+    out.write(text.data(), text.size());
+    return out;
+}
+
+TokenTextTable::TokenTextTable() :
+    mSlots(kInitialSlots, TokenText(0, 0)),
+    mCount(0),
+    mBlockOffset(kBlockSize)
+{
+}
+
+TokenTextTable::~TokenTextTable()
+{
+    for (size_t i = 0; i < mBlocks.size(); ++i)
+        delete [] mBlocks[i];
+}
+
+TokenText TokenTextTable::intern(const char* data, size_t size)
+{
+    TokenText text(data, size);
+    size_t mask = mSlots.size() - 1;
+    size_t index = text.hash() & mask;
+    while (mSlots[index].data() != 0)
+    {
+        if (mSlots[index] == text)
+            return mSlots[index];
+        index = (index + 1) & mask;
+    }
+
+    TokenText interned(store(data, size), size);
+    mSlots[index] = interned;
+    // Keep the table at most half full.
+    if (++mCount * 2 > mSlots.size())
+        grow();
+    return interned;
+}
+
+const char* TokenTextTable::store(const char* data, size_t size)
+{
+    char* storage = 0;
+    if (size + 1 > kBlockSize)
+    {
+        // Text too long to share a block has one of its own. It is put
+        // before the last block, which may still have room.
+        storage = new char[size + 1];
+        mBlocks.insert(mBlocks.end() - (mBlocks.empty() ? 0 : 1), storage);
+    }
+    else
+    {
+        if (mBlockOffset + size + 1 > kBlockSize)
+        {
+            mBlocks.push_back(new char[kBlockSize]);
+            mBlockOffset = 0;
+        }
+        storage = mBlocks.back() + mBlockOffset;
+        mBlockOffset += size + 1;
+    }
+    std::memcpy(storage, data, size);
+    storage[size] = '\0';
+    return storage;
+}
+
+void TokenTextTable::grow()
+{
+    std::vector<TokenText> slots(mSlots.size() * 2, TokenText(0, 0));
+    size_t mask = slots.size() - 1;
+    for (size_t i = 0; i < mSlots.size(); ++i)
+    {
+        const TokenText& text = mSlots[i];
+        if (text.data() == 0)
+            continue;
+
+        size_t index = text.hash() & mask;
+        while (slots[index].data() != 0)
+            index = (index + 1) & mask;
+        slots[index] = text;
+    }
+    mSlots.swap(slots);
+}
+
+}  // namespace pp
@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#ifndef COMPILER_PREPROCESSOR_TOKEN_TEXT_H_
+#define COMPILER_PREPROCESSOR_TOKEN_TEXT_H_
+
+#include <cassert>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "pp_utils.h"
+
+namespace pp
+{
+
+// The text of a token. It does not own its characters, which are not
+// null-terminated either. They are in one of the input strings, which
+// outlive the preprocessor, in a TokenTextTable, or in a string literal.
+// Tokens are therefore copied without copying their text.
+class TokenText
+{
+  public:
+    TokenText() : mData(""), mSize(0) { }
+    explicit TokenText(const char* str) : mData(str), mSize(std::strlen(str)) { }
+    TokenText(const char* data, size_t size) : mData(data), mSize(size) { }
+
+    const char* data() const { return mData; }
+    size_t size() const { return mSize; }
+    bool empty() const { return mSize == 0; }
+
+    const char* begin() const { return mData; }
+    const char* end() const { return mData + mSize; }
+    char operator[](size_t index) const
+    {
+        assert(index < mSize);
+        return mData[index];
+    }
+
+    void assign(const char* str) { *this = TokenText(str); }
+    void assign(const char* data, size_t size) { *this = TokenText(data, size); }
+    void clear() { *this = TokenText(); }
+    // Keeps the first size characters only.
+    void truncate(size_t size) { if (size < mSize) mSize = size; }
+
+    std::string str() const { return std::string(mData, mSize); }
+
+    int compare(const TokenText& other) const;
+    size_t hash() const;
+    bool equals(const TokenText& other) const
+    {
+        return (mSize == other.mSize) &&
+               ((mData == other.mData) ||
+                (std::memcmp(mData, other.mData, mSize) == 0));
+    }
+
+  private:
+    const char* mData;
+    size_t mSize;
+};
+
+inline bool operator==(const TokenText& lhs, const TokenText& rhs)
+{
+    return lhs.equals(rhs);
+}
+
+inline bool operator==(const TokenText& lhs, const char* rhs)
+{
+    return lhs.equals(TokenText(rhs));
+}
+
+inline bool operator==(const char* lhs, const TokenText& rhs)
+{
+    return rhs.equals(TokenText(lhs));
+}
+
+inline bool operator==(const TokenText& lhs, const std::string& rhs)
+{
+    return lhs.equals(TokenText(rhs.data(), rhs.size()));
+}
+
+inline bool operator==(const std::string& lhs, const TokenText& rhs)
+{
+    return rhs.equals(TokenText(lhs.data(), lhs.size()));
+}
+
+template <typename T>
+inline bool operator!=(const TokenText& lhs, const T& rhs)
+{
+    return !(lhs == rhs);
+}
+
+inline bool operator!=(const char* lhs, const TokenText& rhs)
+{
+    return !(rhs == lhs);
+}
+
+inline bool operator!=(const std::string& lhs, const TokenText& rhs)
+{
+    return !(rhs == lhs);
+}
+
+inline bool operator<(const TokenText& lhs, const TokenText& rhs)
+{
+    return lhs.compare(rhs) < 0;
+}
+
+extern std::ostream& operator<<(std::ostream& out, const TokenText& text);
+
+// Owns the text of the tokens that are not in the input strings, such as
+// those split across two strings or made up by the preprocessor. Equal
+// texts are stored once, and they live as long as the table.
+class TokenTextTable
+{
+  public:
+    TokenTextTable();
+    ~TokenTextTable();
+
+    TokenText intern(const char* data, size_t size);
+    TokenText intern(const std::string& str)
+    {
+        return intern(str.data(), str.size());
+    }
+
+  private:
+    PP_DISALLOW_COPY_AND_ASSIGN(TokenTextTable);
+
+    const char* store(const char* data, size_t size);
+    void grow();
+
+    std::vector<TokenText> mSlots;  // Open addressing, power-of-two size.
+    size_t mCount;
+
+    std::vector<char*> mBlocks;  // Storage of the interned characters.
+    size_t mBlockOffset;         // Next free character of mBlocks.back().
+};
+
+}  // namespace pp
+#endif  // COMPILER_PREPROCESSOR_TOKEN_TEXT_H_
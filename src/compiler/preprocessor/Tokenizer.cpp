@@ -529,7 +529,7 @@ IF YOU MODIFY THIS FILE YOU ALSO NEED TO RUN generate_parser.sh.
 #pragma GCC diagnostic ignored "-Wmissing-noreturn"
 #endif
 
-typedef std::string YYSTYPE;
+typedef pp::TokenText YYSTYPE;
 typedef pp::SourceLocation YYLTYPE;
 
 // Use the unused yycolumn variable to track file (string) number.
@@ -908,28 +908,28 @@ case 7:
 YY_RULE_SETUP
 {
     // # is only valid at start of line for preprocessor directives.
-    yylval->assign(1, yytext[0]);
+    *yylval = yyextra->text(yytext, 1);
     return yyextra->lineStart ? pp::Token::PP_HASH : pp::Token::PP_OTHER;
 }
 	YY_BREAK
 case 8:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::IDENTIFIER;
 }
 	YY_BREAK
 case 9:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::CONST_INT;
 }
 	YY_BREAK
 case 10:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::CONST_FLOAT;
 }
 	YY_BREAK
@@ -938,161 +938,161 @@ YY_RULE_SETUP
 case 11:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::PP_NUMBER;
 }
 	YY_BREAK
 case 12:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_INC;
 }
 	YY_BREAK
 case 13:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_DEC;
 }
 	YY_BREAK
 case 14:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_LEFT;
 }
 	YY_BREAK
 case 15:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_RIGHT;
 }
 	YY_BREAK
 case 16:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_LE;
 }
 	YY_BREAK
 case 17:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_GE;
 }
 	YY_BREAK
 case 18:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_EQ;
 }
 	YY_BREAK
 case 19:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_NE;
 }
 	YY_BREAK
 case 20:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_AND;
 }
 	YY_BREAK
 case 21:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_XOR;
 }
 	YY_BREAK
 case 22:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_OR;
 }
 	YY_BREAK
 case 23:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_ADD_ASSIGN;
 }
 	YY_BREAK
 case 24:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_SUB_ASSIGN;
 }
 	YY_BREAK
 case 25:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_MUL_ASSIGN;
 }
 	YY_BREAK
 case 26:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_DIV_ASSIGN;
 }
 	YY_BREAK
 case 27:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_MOD_ASSIGN;
 }
 	YY_BREAK
 case 28:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_LEFT_ASSIGN;
 }
 	YY_BREAK
 case 29:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_RIGHT_ASSIGN;
 }
 	YY_BREAK
 case 30:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_AND_ASSIGN;
 }
 	YY_BREAK
 case 31:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_XOR_ASSIGN;
 }
 	YY_BREAK
 case 32:
 YY_RULE_SETUP
 {
-    yylval->assign(yytext, yyleng);
+    *yylval = yyextra->text(yytext, yyleng);
     return pp::Token::OP_OR_ASSIGN;
 }
 	YY_BREAK
 case 33:
 YY_RULE_SETUP
 {
-    yylval->assign(1, yytext[0]);
+    *yylval = yyextra->text(yytext, 1);
     return yytext[0];
 }
 	YY_BREAK
@@ -1105,7 +1105,7 @@ case 35:
 YY_RULE_SETUP
 {
     ++yylineno;
-    yylval->assign(1, '\n');
+    yylval->assign("\n");
     return '\n';
 }
 	YY_BREAK
@@ -1117,7 +1117,7 @@ YY_RULE_SETUP
 case 37:
 YY_RULE_SETUP
 {
-    yylval->assign(1, yytext[0]);
+    *yylval = yyextra->text(yytext, 1);
     return pp::Token::PP_OTHER;
 }
 	YY_BREAK
@@ -2288,13 +2288,81 @@ void ppfree (void * ptr , yyscan_t yyscanner)
 
 #define YYTABLES_NAME "yytables"
 
+namespace {
+
+// Returns the length of the newline at p, or 0 if telling "\r" from "\r\n"
+// needs the character at end.
+size_t newlineLength(const char* p, const char* end)
+{
+    if (*p == '\n')
+        return 1;
+    if (p + 1 == end)
+        return 0;
+    return (p[1] == '\n') ? 2 : 1;
+}
+
+bool isNewline(char c)
+{
+    return (c == '\n') || (c == '\r');
+}
+
+// Tracks the location of the characters skipped by
+// Tokenizer::skipExcludedLines() as YY_USER_ACTION would.
+struct SkipLocation
+{
+    SkipLocation(const pp::Input::Location& scanLoc, const char* scanPtr,
+                 int fileno, int lineno) :
+        location(scanLoc), ptr(scanPtr), file(fileno), line(lineno)
+    {
+    }
+
+    void advance(const char* p)
+    {
+        location.cIndex += p - ptr;
+        ptr = p;
+    }
+
+    // Counts the newline at p, which starts a token.
+    void newline(const pp::Input& input, const char* p)
+    {
+        advance(p);
+        while ((location.sIndex < input.count()) &&
+               (location.cIndex >= input.length(location.sIndex)))
+        {
+            location.cIndex -= input.length(location.sIndex++);
+            ++file; line = 1;
+        }
+        ++line;
+    }
+
+    pp::Input::Location location;
+    const char* ptr;
+    int file;
+    int line;
+};
+
+}  // namespace
+
 namespace pp {
 
-Tokenizer::Tokenizer(Diagnostics* diagnostics)
+TokenText Tokenizer::Context::text(const char* matched, size_t length) const
+{
+    // YY_USER_ACTION has moved scanLoc past the token, which starts in the
+    // string at scanLoc.
+    if (scanLoc.cIndex <= input.length(scanLoc.sIndex))
+    {
+        const char* end = input.string(scanLoc.sIndex) + scanLoc.cIndex;
+        return TokenText(end - length, length);
+    }
+    return textTable->intern(matched, length);
+}
+
+Tokenizer::Tokenizer(Diagnostics* diagnostics, TokenTextTable* textTable)
     : mHandle(0),
       mMaxTokenLength(256)
 {
     mContext.diagnostics = diagnostics;
+    mContext.textTable = textTable;
 }
 
 Tokenizer::~Tokenizer()
@@ -2312,6 +2380,11 @@ bool Tokenizer::init(size_t count, const char* const string[], const int length[
 
 void Tokenizer::setFileNumber(int file)
 {
+    if (!mPushedTokens.empty())
+    {
+        mPushedTokens.back().file = file;
+        return;
+    }
     // We use column number as file number.
     // See macro yyfileno.
     ppset_column(file,mHandle);
@@ -2319,17 +2392,155 @@ void Tokenizer::setFileNumber(int file)
 
 void Tokenizer::setLineNumber(int line)
 {
+    if (!mPushedTokens.empty())
+    {
+        // The line after that of the last token lexed, which ends a line,
+        // is the given one.
+        PushedTokens& pushed = mPushedTokens.back();
+        int lastLine = (pushed.index > 0) ?
+            (*pushed.tokens)[pushed.index - 1].location.line : 0;
+        pushed.lineOffset = line - (lastLine + 1);
+        return;
+    }
     ppset_lineno(line,mHandle);
 }
 
+void Tokenizer::pushTokens(const std::vector<Token>* tokens, int file)
+{
+    PushedTokens pushed;
+    pushed.tokens = tokens;
+    pushed.index = 0;
+    pushed.file = file;
+    pushed.lineOffset = 0;
+    mPushedTokens.push_back(pushed);
+}
+
+void Tokenizer::skipExcludedLines()
+{
+    struct yyguts_t* yyg = static_cast<struct yyguts_t*>(mHandle);
+    if (!mPushedTokens.empty())
+        return;
+    if (!mContext.lineStart || !YY_CURRENT_BUFFER || (YY_START != INITIAL))
+        return;
+
+    // Scan the characters the scanner has buffered but not matched yet.
+    // A line that does not end in the buffer is left to the scanner, as
+    // matching it may need more input.
+    char* cur = yyg->yy_c_buf_p;
+    const char* end = YY_CURRENT_BUFFER_LVALUE->yy_ch_buf + yyg->yy_n_chars;
+    *cur = yyg->yy_hold_char;
+
+    SkipLocation loc(mContext.scanLoc, cur, yyfileno, yylineno);
+    SkipLocation resume = loc;  // Start of the last line scanned.
+    bool leadingSpace = false;
+    bool atLineStart = true;  // Only blanks and comments so far.
+    while (cur < end)
+    {
+        char c = *cur;
+        if (isNewline(c))
+        {
+            size_t length = newlineLength(cur, end);
+            if (length == 0)
+                break;
+            loc.newline(mContext.input, cur);
+            cur += length;
+            loc.advance(cur);
+            resume = loc;
+            leadingSpace = false;
+            atLineStart = true;
+        }
+        else if ((c == ' ') || (c == '\t') || (c == '\v') || (c == '\f'))
+        {
+            leadingSpace = true;
+            ++cur;
+        }
+        else if ((c == '\\') && (cur + 1 < end) && isNewline(cur[1]))
+        {
+            // Line continuation.
+            size_t length = newlineLength(cur + 1, end);
+            if (length == 0)
+                break;
+            loc.newline(mContext.input, cur);
+            cur += 1 + length;
+        }
+        else if ((c == '/') && (cur + 1 < end) && (cur[1] == '/'))
+        {
+            cur += 2;
+            while ((cur < end) && !isNewline(*cur))
+                ++cur;
+            leadingSpace = true;
+        }
+        else if ((c == '/') && (cur + 1 < end) && (cur[1] == '*'))
+        {
+            cur += 2;
+            while ((cur + 1 < end) && !((cur[0] == '*') && (cur[1] == '/')))
+            {
+                size_t length = isNewline(*cur) ? newlineLength(cur, end) : 1;
+                if (length == 0)
+                    break;
+                if (isNewline(*cur))
+                    loc.newline(mContext.input, cur);
+                cur += length;
+            }
+            if (cur + 1 >= end)
+                break;
+            cur += 2;
+            leadingSpace = true;
+        }
+        else if ((c == '#') && atLineStart)
+        {
+            // The line may hold a directive; the scanner lexes it.
+            loc.advance(cur);
+            resume = loc;
+            mContext.leadingSpace = leadingSpace;
+            break;
+        }
+        else if ((cur + 1 == end) && ((c == '\\') || (c == '/')))
+        {
+            // Whether this starts a continuation or comment is unknown.
+            break;
+        }
+        else
+        {
+            atLineStart = false;
+            ++cur;
+        }
+    }
+
+    // Resume scanning at the hash of a directive, or else at the start of
+    // the last line scanned.
+    char* resumePtr = const_cast<char*>(resume.ptr);
+    mContext.scanLoc = resume.location;
+    yyfileno = resume.file;
+    yylineno = resume.line;
+
+    yyg->yy_c_buf_p = resumePtr;
+    yyg->yy_hold_char = *resumePtr;
+    *resumePtr = '\0';
+}
+
 void Tokenizer::lex(Token* token)
 {
+    while (!mPushedTokens.empty())
+    {
+        PushedTokens& pushed = mPushedTokens.back();
+        if (pushed.index < pushed.tokens->size())
+        {
+            *token = (*pushed.tokens)[pushed.index++];
+            token->location.file = pushed.file;
+            token->location.line += pushed.lineOffset;
+            return;
+        }
+        // Popped only now, as #line may follow the last token.
+        mPushedTokens.pop_back();
+    }
+
     token->type = pplex(&token->text,&token->location,mHandle);
     if (token->text.size() > mMaxTokenLength)
     {
         mContext.diagnostics->report(Diagnostics::TOKEN_TOO_LONG,
                                      token->location, token->text);
-        token->text.erase(mMaxTokenLength);
+        token->text.truncate(mMaxTokenLength);
     }
 
     token->flags = 0;
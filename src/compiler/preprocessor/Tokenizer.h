@@ -7,14 +7,18 @@
 #ifndef COMPILER_PREPROCESSOR_TOKENIZER_H_
 #define COMPILER_PREPROCESSOR_TOKENIZER_H_
 
+#include <vector>
+
 #include "Input.h"
 #include "Lexer.h"
 #include "pp_utils.h"
+#include "TokenText.h"
 
 namespace pp
 {
 
 class Diagnostics;
+struct Token;
 
 class Tokenizer : public Lexer
 {
@@ -31,17 +35,42 @@ class Tokenizer : public Lexer
 
         bool leadingSpace;
         bool lineStart;
+
+        // Holds the text of tokens that are split across input strings.
+        TokenTextTable* textTable;
+        // Returns the text of the token just matched, which is the length
+        // characters at matched. It refers to the input strings unless the
+        // token is split across them.
+        TokenText text(const char* matched, size_t length) const;
     };
 
-    Tokenizer(Diagnostics* diagnostics);
+    Tokenizer(Diagnostics* diagnostics, TokenTextTable* textTable);
     ~Tokenizer();
 
     bool init(size_t count, const char* const string[], const int length[]);
 
     void setMaxTokenLength(size_t maxLength) { mMaxTokenLength = maxLength; }
+    size_t maxTokenLength() const { return mMaxTokenLength; }
     void setFileNumber(int file);
     void setLineNumber(int line);
 
+    size_t inputCount() const { return mContext.input.count(); }
+
+    // Makes lex() return tokens, as if they were in the given file, before
+    // the rest of the input. The tokens are those of another tokenizer, and
+    // must stay valid until they are all lexed. Tokens pushed while others
+    // are lexed are lexed first. The file and line numbers set meanwhile
+    // apply to the tokens being lexed.
+    void pushTokens(const std::vector<Token>* tokens, int file);
+    // Returns the number of token sequences being lexed.
+    size_t pushedTokensDepth() const { return mPushedTokens.size(); }
+
+    // Skips the lines of an excluded conditional group up to the next one
+    // that may hold a directive, without lexing them. Only has an effect
+    // at the start of a line. Lines are skipped from the buffered input
+    // only; lex() still has to be called for the rest.
+    void skipExcludedLines();
+
     virtual void lex(Token* token);
 
   private:
@@ -52,6 +81,15 @@ class Tokenizer : public Lexer
     void* mHandle;  // Scanner handle.
     Context mContext;  // Scanner extra.
     size_t mMaxTokenLength;
+
+    struct PushedTokens
+    {
+        const std::vector<Token>* tokens;
+        size_t index;  // Of the next token to lex.
+        int file;
+        int lineOffset;
+    };
+    std::vector<PushedTokens> mPushedTokens;
 };
 
 }  // namespace pp
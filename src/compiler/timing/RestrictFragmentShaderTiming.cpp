@@ -51,7 +51,7 @@ void RestrictFragmentShaderTiming::enforceRestrictions(const TDependencyGraph& g
     {
         TGraphSymbol* samplerSymbol = *iter;
         clearVisited();
-        samplerSymbol->traverse(this);
+        traverse(graph, samplerSymbol);
     }
 }
 
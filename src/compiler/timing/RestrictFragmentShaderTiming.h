@@ -12,6 +12,8 @@
 #include "compiler/intermediate.h"
 #include "compiler/depgraph/DependencyGraph.h"
 
+#include <set>
+
 class TInfoSinkBase;
 
 class RestrictFragmentShaderTiming : TDependencyGraphTraverser {
@@ -25,6 +25,8 @@
 
 #include "third_party/compiler/ArrayBoundsClamper.h"
 
+#include "compiler/PassManager.h"
+
 // The built-in 'clamp' instruction only accepts floats and returns a float.  I
 // iterated a few times with our driver team who examined the output from our
 // compiler - they said the multiple casts generates more code than a single
@@ -42,8 +44,9 @@ namespace {
 
 class ArrayBoundsClamperMarker : public TIntermTraverser {
 public:
-    ArrayBoundsClamperMarker()
-        : mNeedsClamp(false)
+    // Sets *needsClamp if any node needs clamping.
+    ArrayBoundsClamperMarker(bool* needsClamp)
+        : mNeedsClamp(needsClamp)
    {
    }
 
@@ -55,16 +58,14 @@ public:
            if (left->isArray() || left->isVector() || left->isMatrix())
            {
                node->setAddIndexClamp();
-               mNeedsClamp = true;
+               *mNeedsClamp = true;
            }
        }
        return true;
    }
 
-    bool GetNeedsClamp() { return mNeedsClamp; }
-
 private:
-    bool mNeedsClamp;
+    bool* mNeedsClamp;
 };
 
 }  // anonymous namespace
@@ -84,12 +85,15 @@ void ArrayBoundsClamper::MarkIndirectArrayBoundsForClamping(TIntermNode* root)
 {
     ASSERT(root);
 
-    ArrayBoundsClamperMarker clamper;
+    ArrayBoundsClamperMarker clamper(&mArrayBoundsClampDefinitionNeeded);
     root->traverse(&clamper);
-    if (clamper.GetNeedsClamp())
-    {
-        SetArrayBoundsClampDefinitionNeeded();
-    }
+}
+
+void ArrayBoundsClamper::MarkIndirectArrayBoundsForClamping(TPassManager* passes)
+{
+    // The marker is freed with the pool of the compile.
+    passes->addPass(SH_PASS_CLAMP_INDIRECT_ARRAY_BOUNDS,
+                    new ArrayBoundsClamperMarker(&mArrayBoundsClampDefinitionNeeded));
 }
 
 void ArrayBoundsClamper::OutputClampingFunctionDefinition(TInfoSinkBase& out) const
@@ -31,6 +31,8 @@
 #include "compiler/InfoSink.h"
 #include "compiler/intermediate.h"
 
+class TPassManager;
+
 class ArrayBoundsClamper {
 public:
     ArrayBoundsClamper();
@@ -42,6 +44,8 @@ public:
     // Marks nodes in the tree that index arrays indirectly as
     // requiring clamping.
     void MarkIndirectArrayBoundsForClamping(TIntermNode* root);
+    // Marks the nodes in a pass of passes instead, to share its traversal.
+    void MarkIndirectArrayBoundsForClamping(TPassManager* passes);
 
     // If necessary, output array clamp function source into the shader source.
     void OutputClampingFunctionDefinition(TInfoSinkBase& out) const;
@@ -53,7 +57,6 @@ public:
 
 private:
     bool GetArrayBoundsClampDefinitionNeeded() const { return mArrayBoundsClampDefinitionNeeded; }
-    void SetArrayBoundsClampDefinitionNeeded() { mArrayBoundsClampDefinitionNeeded = true; }
 
     ShArrayIndexClampingStrategy mClampingStrategy;
     bool mArrayBoundsClampDefinitionNeeded;
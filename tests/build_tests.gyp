@@ -74,6 +74,19 @@
         'compiler_tests/compiler_test_main.cpp',
       ],
     },
+    {
+      'target_name': 'translator_perftests',
+      'type': 'executable',
+      'dependencies': [
+        '../src/build_angle.gyp:translator_static',
+      ],
+      'include_dirs': [
+        '../include',
+      ],
+      'sources': [
+        'perf_tests/translator_perftests.cpp',
+      ],
+    },
   ],
 }
 
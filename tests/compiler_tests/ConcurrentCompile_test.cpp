@@ -0,0 +1,250 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#include <string.h>
+#include <string>
+#include <vector>
+#include "GLSLANG/ShaderLang.h"
+#include "gtest/gtest.h"
+
+#define SHADER(Src) #Src
+
+namespace {
+
+struct ShaderSource {
+    ShShaderType type;
+    const char* source;
+};
+
+const ShaderSource kShaders[] = {
+    { SH_VERTEX_SHADER, SHADER(
+        attribute vec4 a_position;
+        attribute vec3 a_normal;
+        uniform mat4 u_modelViewProjectionMatrix;
+        uniform mat3 u_normalMatrixWithAVeryLongNameThatGetsMapped;
+        varying vec3 v_normalInEyeSpaceWithAVeryLongNameThatGetsMapped;
+        void main() {
+            v_normalInEyeSpaceWithAVeryLongNameThatGetsMapped =
+                u_normalMatrixWithAVeryLongNameThatGetsMapped * a_normal;
+            gl_Position = u_modelViewProjectionMatrix * a_position;
+        }
+    ) },
+    { SH_FRAGMENT_SHADER, SHADER(
+        precision mediump float;
+        uniform sampler2D u_texture;
+        uniform vec3 u_lightDirectionWithAVeryLongNameThatGetsMapped;
+        varying vec3 v_normalInEyeSpaceWithAVeryLongNameThatGetsMapped;
+        float weight(int i) {
+            return 1.0 / float(i + 1);
+        }
+        void accumulate(in int i, inout vec4 color) {
+            color += texture2D(u_texture, vec2(weight(i), 0.5));
+        }
+        void main() {
+            vec4 color = vec4(0.0);
+            for (int i = 0; i < 4; ++i)
+                accumulate(i, color);
+            float diffuse = max(dot(normalize(v_normalInEyeSpaceWithAVeryLongNameThatGetsMapped),
+                                    u_lightDirectionWithAVeryLongNameThatGetsMapped), 0.0);
+            gl_FragColor = color * diffuse;
+        }
+    ) },
+    { SH_FRAGMENT_SHADER, SHADER(
+        precision mediump float;
+        struct Light {
+            vec3 position;
+            vec3 color;
+        };
+        uniform Light u_lights[2];
+        varying vec3 v_position;
+        void main() {
+            vec3 color = vec3(0.0);
+            for (int i = 0; i < 2; ++i)
+                color += u_lights[i].color / length(u_lights[i].position - v_position);
+            gl_FragColor = vec4(color, 1.0);
+        }
+    ) },
+    { SH_FRAGMENT_SHADER, SHADER(
+        precision mediump float;
+        void update(out int i) {
+            i = 0;
+        }
+        void main() {
+            for (int i = 0; i < 4; ++i)
+                update(i);
+            gl_FragColor = vec4(undeclared);
+        }
+    ) },
+};
+
+const ShShaderOutput kOutputs[] = {
+    SH_ESSL_OUTPUT,
+    SH_GLSL_OUTPUT,
+    SH_HLSL11_OUTPUT,
+};
+
+const size_t kNumShaders = sizeof(kShaders) / sizeof(kShaders[0]);
+const size_t kNumOutputs = sizeof(kOutputs) / sizeof(kOutputs[0]);
+
+const int kCompileOptions =
+    SH_OBJECT_CODE | SH_VARIABLES | SH_MAP_LONG_VARIABLE_NAMES;
+
+std::string GetInfoString(ShHandle compiler, ShShaderInfo pname)
+{
+    size_t length = 0;
+    ShGetInfo(compiler, pname, &length);
+    if (length == 0)
+        return std::string();
+    std::vector<char> buffer(length);
+    if (pname == SH_OBJECT_CODE_LENGTH)
+        ShGetObjectCode(compiler, &buffer[0]);
+    else
+        ShGetInfoLog(compiler, &buffer[0]);
+    return std::string(&buffer[0]);
+}
+
+// Compiles every shader of the corpus for the given output, with compilers
+// of its own, and returns the object code and info log of each shader.
+std::vector<std::string> CompileCorpus(ShShaderOutput output)
+{
+    ShBuiltInResources resources;
+    ShInitBuiltInResources(&resources);
+
+    ShHandle vertexCompiler = ShConstructCompiler(
+        SH_VERTEX_SHADER, SH_WEBGL_SPEC, output, &resources);
+    ShHandle fragmentCompiler = ShConstructCompiler(
+        SH_FRAGMENT_SHADER, SH_WEBGL_SPEC, output, &resources);
+
+    std::vector<std::string> results;
+    for (size_t i = 0; i < kNumShaders; ++i) {
+        ShHandle compiler = kShaders[i].type == SH_VERTEX_SHADER ?
+            vertexCompiler : fragmentCompiler;
+        ShCompile(compiler, &kShaders[i].source, 1, kCompileOptions);
+        results.push_back(GetInfoString(compiler, SH_OBJECT_CODE_LENGTH) +
+                          GetInfoString(compiler, SH_INFO_LOG_LENGTH));
+    }
+
+    ShDestruct(vertexCompiler);
+    ShDestruct(fragmentCompiler);
+    return results;
+}
+
+struct ThreadData {
+    const std::vector<std::string>* expected;  // Indexed by output.
+    int iterations;
+    int mismatches;
+};
+
+#if defined(_WIN32) || defined(_WIN64)
+DWORD WINAPI CompileThread(LPVOID param)
+#else
+void* CompileThread(void* param)
+#endif
+{
+    ThreadData* data = static_cast<ThreadData*>(param);
+    for (int i = 0; i < data->iterations; ++i) {
+        for (size_t j = 0; j < kNumOutputs; ++j) {
+            if (CompileCorpus(kOutputs[j]) != data->expected[j])
+                ++data->mismatches;
+        }
+    }
+    return 0;
+}
+
+}  // namespace
+
+// Compiles the corpus on several threads at once, each with compilers of
+// its own, and checks that every result matches the single-threaded one.
+TEST(ConcurrentCompileTest, MatchesSingleThreadedOutput)
+{
+    const int kNumThreads = 8;
+    const int kIterations = 10;
+
+    // The single-threaded pass also fills the shared long name map, so that
+    // the mapped names do not depend on which thread sees a name first.
+    std::vector<std::string> expected[kNumOutputs];
+    for (size_t i = 0; i < kNumOutputs; ++i) {
+        expected[i] = CompileCorpus(kOutputs[i]);
+        ASSERT_EQ(kNumShaders, expected[i].size());
+    }
+
+    ThreadData data[kNumThreads];
+    for (int i = 0; i < kNumThreads; ++i) {
+        data[i].expected = expected;
+        data[i].iterations = kIterations;
+        data[i].mismatches = 0;
+    }
+
+#if defined(_WIN32) || defined(_WIN64)
+    HANDLE threads[kNumThreads];
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads[i] = CreateThread(NULL, 0, CompileThread, &data[i], 0, NULL);
+        ASSERT_TRUE(threads[i] != NULL);
+    }
+    WaitForMultipleObjects(kNumThreads, threads, TRUE, INFINITE);
+    for (int i = 0; i < kNumThreads; ++i)
+        CloseHandle(threads[i]);
+#else
+    pthread_t threads[kNumThreads];
+    for (int i = 0; i < kNumThreads; ++i)
+        ASSERT_EQ(0, pthread_create(&threads[i], NULL, CompileThread, &data[i]));
+    for (int i = 0; i < kNumThreads; ++i)
+        pthread_join(threads[i], NULL);
+#endif
+
+    for (int i = 0; i < kNumThreads; ++i)
+        EXPECT_EQ(0, data[i].mismatches) << "thread " << i;
+}
+
+// Compiles the corpus for every output as a single batch, and checks that
+// every result matches the one of a compile on the calling thread.
+TEST(ConcurrentCompileTest, BatchMatchesSingleThreadedOutput)
+{
+    const int kNumCopies = 8;
+
+    std::vector<std::string> expected[kNumOutputs];
+    for (size_t i = 0; i < kNumOutputs; ++i)
+        expected[i] = CompileCorpus(kOutputs[i]);
+
+    ShBuiltInResources resources;
+    ShInitBuiltInResources(&resources);
+
+    std::vector<ShCompileJob> jobs;
+    for (int copy = 0; copy < kNumCopies; ++copy) {
+        for (size_t i = 0; i < kNumOutputs; ++i) {
+            for (size_t j = 0; j < kNumShaders; ++j) {
+                ShCompileJob job;
+                memset(&job, 0, sizeof(job));
+                job.type = kShaders[j].type;
+                job.spec = SH_WEBGL_SPEC;
+                job.output = kOutputs[i];
+                job.resources = &resources;
+                job.shaderStrings = &kShaders[j].source;
+                job.numStrings = 1;
+                job.compileOptions = kCompileOptions;
+                jobs.push_back(job);
+            }
+        }
+    }
+
+    // The last shader of the corpus does not compile.
+    EXPECT_EQ(0, ShCompileBatch(&jobs[0], jobs.size(), 4));
+
+    for (size_t k = 0; k < jobs.size(); ++k) {
+        size_t i = (k / kNumShaders) % kNumOutputs;
+        size_t j = k % kNumShaders;
+        ASSERT_TRUE(jobs[k].compiler != NULL);
+        EXPECT_EQ(j != kNumShaders - 1, jobs[k].compiled != 0) << "job " << k;
+        EXPECT_EQ(expected[i][j],
+                  GetInfoString(jobs[k].compiler, SH_OBJECT_CODE_LENGTH) +
+                  GetInfoString(jobs[k].compiler, SH_INFO_LOG_LENGTH)) << "job " << k;
+        ShDestruct(jobs[k].compiler);
+    }
+}
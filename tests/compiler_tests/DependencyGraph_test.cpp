@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+#include <stdio.h>
+#include <time.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "GLSLANG/ShaderLang.h"
+#include "gtest/gtest.h"
+
+#define SHADER(Src) #Src
+
+class DependencyGraphTest : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        ShBuiltInResources resources;
+        ShInitBuiltInResources(&resources);
+        resources.MaxTextureImageUnits = 8;
+        resources.MaxCombinedTextureImageUnits = 8;
+        mCompiler = ShConstructCompiler(
+            SH_FRAGMENT_SHADER, SH_WEBGL_SPEC, SH_GLSL_OUTPUT, &resources);
+        ASSERT_TRUE(mCompiler != NULL);
+    }
+
+    virtual void TearDown()
+    {
+        ShDestruct(mCompiler);
+    }
+
+    bool compile(const std::string& shader, int compileOptions)
+    {
+        const char* source = shader.c_str();
+        return ShCompile(mCompiler, &source, 1, compileOptions) != 0;
+    }
+
+    std::string getInfoLog()
+    {
+        size_t bufferLen = 0;
+        ShGetInfo(mCompiler, SH_INFO_LOG_LENGTH, &bufferLen);
+        std::vector<char> buffer(bufferLen);
+        ShGetInfoLog(mCompiler, &buffer[0]);
+        return std::string(&buffer[0]);
+    }
+
+    // Returns a shader that passes a sampled value down a chain of length
+    // variables, and then to the statement end.
+    std::string chainShader(int length, const char* end)
+    {
+        std::ostringstream shader;
+        shader << "precision mediump float;\n"
+                  "uniform sampler2D u_sampler;\n"
+                  "varying vec2 v_uv;\n"
+                  "void main() {\n"
+                  "    vec4 c0 = texture2D(u_sampler, v_uv);\n";
+        for (int i = 1; i < length; ++i)
+            shader << "    vec4 c" << i << " = c" << i - 1 << " * 0.5;\n";
+        shader << "    " << end << "\n"
+                  "}\n";
+        return shader.str();
+    }
+
+    ShHandle mCompiler;
+};
+
+TEST_F(DependencyGraphTest, AllowsSampledColors)
+{
+    EXPECT_TRUE(compile(chainShader(4, "gl_FragColor = c3;"), SH_TIMING_RESTRICTIONS))
+        << getInfoLog();
+}
+
+TEST_F(DependencyGraphTest, RejectsSampledConditions)
+{
+    EXPECT_FALSE(compile(chainShader(4, "if (c3.x > 0.5) gl_FragColor = c3;"),
+                         SH_TIMING_RESTRICTIONS));
+    EXPECT_NE(std::string::npos, getInfoLog().find(
+        "An expression dependent on a sampler is not permitted in a conditional statement."));
+
+    EXPECT_FALSE(compile(chainShader(4, "gl_FragColor = c3.x > 0.5 && v_uv.x > 0.5 ? c3 : c2;"),
+                         SH_TIMING_RESTRICTIONS));
+    EXPECT_NE(std::string::npos, getInfoLog().find(
+        "on the left hand side of a logical and operator."));
+}
+
+TEST_F(DependencyGraphTest, RejectsSampledCoordinates)
+{
+    EXPECT_FALSE(compile(chainShader(4, "gl_FragColor = texture2D(u_sampler, c3.xy);"),
+                         SH_TIMING_RESTRICTIONS));
+    std::string log = getInfoLog();
+    EXPECT_NE(std::string::npos, log.find(
+        "not permitted to be the coordinate argument of a sampling operation.")) << log;
+}
+
+TEST_F(DependencyGraphTest, FollowsLongChains)
+{
+    // Deeper than the call stack would take, were the walk recursive.
+    EXPECT_FALSE(compile(chainShader(20000, "if (c19999.x > 0.5) gl_FragColor = c0;"),
+                         SH_TIMING_RESTRICTIONS));
+    std::string log = getInfoLog();
+    EXPECT_NE(std::string::npos, log.find("not permitted in a conditional statement.")) << log;
+}
+
+TEST_F(DependencyGraphTest, OutputsSpanningTrees)
+{
+    ASSERT_TRUE(compile(chainShader(3, "gl_FragColor = c2 + c2;"),
+                        SH_TIMING_RESTRICTIONS | SH_DEPENDENCY_GRAPH));
+    std::string log = getInfoLog();
+
+    // The tree from the sampler visits each node once, a level deeper than
+    // the node it depends on.
+    std::string::size_type tree = log.find("--- Dependency graph spanning tree ---\n"
+                                           "u_sampler (symbol id: ");
+    ASSERT_NE(std::string::npos, tree) << log;
+    std::string::size_type treeEnd = log.find("\n\n", tree);
+    std::string samplerTree = log.substr(tree, treeEnd - tree);
+    EXPECT_NE(std::string::npos, samplerTree.find(
+        "\n  argument 0 of call to texture2D(s21;vf2;\n"
+        "    function call texture2D(s21;vf2;\n"
+        "      c0 (symbol id: ")) << samplerTree;
+    EXPECT_NE(std::string::npos, samplerTree.find("\n        c1 (symbol id: ")) << samplerTree;
+    EXPECT_NE(std::string::npos, samplerTree.find("\n          c2 (symbol id: ")) << samplerTree;
+    EXPECT_EQ(samplerTree.find("c2 (symbol"), samplerTree.rfind("c2 (symbol")) << samplerTree;
+}
+
+TEST_F(DependencyGraphTest, DISABLED_TimingRestrictionsCost)
+{
+    const int kSamplers = 8;
+    const int kStatements = 4000;
+    const int kIterations = 20;
+
+    std::ostringstream shader;
+    shader << "precision mediump float;\n";
+    for (int i = 0; i < kSamplers; ++i)
+        shader << "uniform sampler2D u_sampler" << i << ";\n";
+    shader << "varying vec2 v_uv;\n"
+              "void main() {\n"
+              "    vec4 c0 = vec4(0.0);\n";
+    for (int i = 1; i < kStatements; ++i) {
+        shader << "    vec4 c" << i << " = c" << i - 1 << " * 0.5 + texture2D(u_sampler"
+               << i % kSamplers << ", v_uv * " << i << ".0) * c" << i / 2 << ";\n";
+    }
+    shader << "    gl_FragColor = c" << kStatements - 1 << ";\n"
+              "}\n";
+
+    clock_t start = clock();
+    for (int i = 0; i < kIterations; ++i)
+        ASSERT_TRUE(compile(shader.str(), SH_OBJECT_CODE));
+    double unrestricted = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+    size_t restrictionNanoseconds = 0;
+    start = clock();
+    for (int i = 0; i < kIterations; ++i) {
+        ASSERT_TRUE(compile(shader.str(), SH_OBJECT_CODE | SH_TIMING_RESTRICTIONS));
+        void* timings = NULL;
+        ShGetInfoPointer(mCompiler, SH_PASS_TIMINGS, &timings);
+        restrictionNanoseconds += static_cast<const ShPassTimings*>(timings)->
+            passNanoseconds[SH_PASS_TIMING_RESTRICTIONS];
+    }
+    double restricted = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%d statements: %.2f ms/compile, %.2f ms/compile restricting timing, "
+           "of which %.2f ms in the dependency graph\n",
+           kStatements, unrestricted * 1000 / kIterations, restricted * 1000 / kIterations,
+           restrictionNanoseconds / 1e6 / kIterations);
+}
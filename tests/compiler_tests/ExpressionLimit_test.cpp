@@ -3,6 +3,8 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 //
+#include <stdio.h>
+#include <time.h>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -229,6 +231,62 @@ TEST_F(ExpressionLimitTest, UnusedExpressionComplexity)
         compileOptions & ~SH_LIMIT_EXPRESSION_COMPLEXITY, NULL));
 }
 
+TEST_F(ExpressionLimitTest, ExpressionComplexityInfoLog)
+{
+    ShHandle compiler = ShConstructCompiler(
+        SH_FRAGMENT_SHADER, SH_WEBGL_SPEC, SH_ESSL_OUTPUT, &resources);
+    std::string source = GenerateShaderWithUnusedLongExpression(
+        kMaxExpressionComplexity + 10);
+    const char* shaderStrings[] = { source.c_str() };
+    EXPECT_FALSE(ShCompile(compiler, shaderStrings, 1, SH_LIMIT_EXPRESSION_COMPLEXITY));
+
+    size_t bufferLen = 0;
+    ShGetInfo(compiler, SH_INFO_LOG_LENGTH, &bufferLen);
+    std::vector<char> buffer(bufferLen);
+    ShGetInfoLog(compiler, &buffer[0]);
+    std::string log(&buffer[0]);
+
+    // The error names the deepest expression, and the notes the
+    // complexity of each function.
+    EXPECT_NE(std::string::npos, log.find(
+        "Expression too complex in 'someFunction': 30 levels deep, "
+        "the limit is 16; the expression has 53 nodes")) << log;
+    EXPECT_NE(std::string::npos, log.find(
+        "NOTE: 'main': 6 nodes, 4 levels deep, largest expression of 3 nodes")) << log;
+    EXPECT_NE(std::string::npos, log.find(
+        "NOTE: 'someFunction': 57 nodes, 30 levels deep, "
+        "largest expression of 53 nodes")) << log;
+    EXPECT_NE(std::string::npos, log.find("NOTE: global scope: 3 nodes")) << log;
+    ShDestruct(compiler);
+}
+
+TEST_F(ExpressionLimitTest, DISABLED_ExpressionComplexityCost)
+{
+    const int kLength = 2000;
+    const int kIterations = 50;
+    resources.MaxExpressionComplexity = kLength * 2;
+    ShHandle compiler = ShConstructCompiler(
+        SH_FRAGMENT_SHADER, SH_WEBGL_SPEC, SH_ESSL_OUTPUT, &resources);
+    std::string source = GenerateShaderWithLongExpression(kLength);
+    const char* shaderStrings[] = { source.c_str() };
+
+    clock_t start = clock();
+    for (int i = 0; i < kIterations; ++i)
+        ASSERT_TRUE(ShCompile(compiler, shaderStrings, 1, SH_OBJECT_CODE));
+    double unlimited = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int i = 0; i < kIterations; ++i) {
+        ASSERT_TRUE(ShCompile(compiler, shaderStrings, 1,
+                              SH_OBJECT_CODE | SH_LIMIT_EXPRESSION_COMPLEXITY));
+    }
+    double limited = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%d terms: %.2f ms/compile, %.2f ms/compile limiting complexity\n",
+           kLength, unlimited * 1000 / kIterations, limited * 1000 / kIterations);
+    ShDestruct(compiler);
+}
+
 TEST_F(ExpressionLimitTest, CallStackDepth)
 {
     ShShaderSpec spec = SH_WEBGL_SPEC;
@@ -0,0 +1,118 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+#include <map>
+#include <string>
+
+#include "GLSLANG/ShaderLang.h"
+#include "gtest/gtest.h"
+
+class IncludeCallbackTest : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        ShBuiltInResources resources;
+        ShInitBuiltInResources(&resources);
+        mCompiler = ShConstructCompiler(
+            SH_FRAGMENT_SHADER, SH_GLES2_SPEC, SH_GLSL_OUTPUT, &resources);
+        ASSERT_TRUE(mCompiler != NULL);
+        mNumIncludes = 0;
+
+        mSources["prelude.h"] = "precision mediump float;\n"
+                                "#include \"color.h\"\n";
+        mSources["color.h"] = "const vec4 kColor = vec4(1.0);\n";
+        mSources["broken.h"] = "\n"
+                               "vec4 broken() { return undeclared; }\n";
+    }
+
+    virtual void TearDown()
+    {
+        ShDestruct(mCompiler);
+    }
+
+    static const char* Include(const char* name, size_t* length, void* userData)
+    {
+        IncludeCallbackTest* test = static_cast<IncludeCallbackTest*>(userData);
+        ++test->mNumIncludes;
+        std::map<std::string, std::string>::const_iterator iter =
+            test->mSources.find(name);
+        if (iter == test->mSources.end())
+            return NULL;
+
+        *length = iter->second.size();
+        return iter->second.data();
+    }
+
+    bool compile(const std::string& shader)
+    {
+        const char* source = shader.c_str();
+        return ShCompile(mCompiler, &source, 1, SH_OBJECT_CODE) != 0;
+    }
+
+    std::string getInfoLog()
+    {
+        size_t length = 0;
+        ShGetInfo(mCompiler, SH_INFO_LOG_LENGTH, &length);
+        std::string log(length, '\0');
+        ShGetInfoLog(mCompiler, &log[0]);
+        return log.c_str();
+    }
+
+    ShHandle mCompiler;
+    std::map<std::string, std::string> mSources;
+    int mNumIncludes;
+};
+
+TEST_F(IncludeCallbackTest, IncludesSources)
+{
+    const std::string shader = "#include \"prelude.h\"\n"
+                               "void main() { gl_FragColor = kColor; }\n";
+
+    ShSetIncludeCallback(mCompiler, Include, this);
+    ASSERT_TRUE(compile(shader)) << getInfoLog();
+    EXPECT_EQ(2, mNumIncludes);
+
+    // Sources are asked for again by every compile.
+    ASSERT_TRUE(compile(shader)) << getInfoLog();
+    EXPECT_EQ(4, mNumIncludes);
+}
+
+TEST_F(IncludeCallbackTest, ReportsIncludedLocations)
+{
+    ShSetIncludeCallback(mCompiler, Include, this);
+    EXPECT_FALSE(compile("#include \"broken.h\"\n"
+                         "void main() { gl_FragColor = broken(); }\n"));
+
+    // The included source is numbered after the shader string.
+    std::string log = getInfoLog();
+    EXPECT_NE(std::string::npos, log.find("1:2: 'undeclared'")) << log;
+}
+
+TEST_F(IncludeCallbackTest, ReportsMissingSources)
+{
+    ShSetIncludeCallback(mCompiler, Include, this);
+    EXPECT_FALSE(compile("#include \"missing.h\"\n"
+                         "void main() { }\n"));
+    EXPECT_EQ(1, mNumIncludes);
+
+    std::string log = getInfoLog();
+    EXPECT_NE(std::string::npos, log.find("0:1:")) << log;
+    EXPECT_NE(std::string::npos, log.find("missing.h")) << log;
+}
+
+TEST_F(IncludeCallbackTest, DisabledWithoutCallback)
+{
+    const std::string shader = "#include \"prelude.h\"\n"
+                               "void main() { gl_FragColor = kColor; }\n";
+
+    EXPECT_FALSE(compile(shader));
+
+    ShSetIncludeCallback(mCompiler, Include, this);
+    EXPECT_TRUE(compile(shader)) << getInfoLog();
+
+    ShSetIncludeCallback(mCompiler, NULL, NULL);
+    EXPECT_FALSE(compile(shader));
+    EXPECT_EQ(2, mNumIncludes);
+}
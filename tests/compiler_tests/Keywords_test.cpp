@@ -0,0 +1,121 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "compiler/Keywords.h"
+#include "gtest/gtest.h"
+
+static bool KeywordLess(const TKeyword& keyword, const std::string& name)
+{
+    return keyword.name < name;
+}
+
+// Finds name by searching the sorted table, as the lexer used to.
+static const TKeyword* SearchKeyword(const std::string& name)
+{
+    const TKeyword* end = kKeywords + kNumKeywords;
+    const TKeyword* keyword = std::lower_bound(kKeywords, end, name, KeywordLess);
+    return keyword != end && name == keyword->name ? keyword : NULL;
+}
+
+static const TKeyword* FindKeyword(const std::string& name)
+{
+    return FindKeyword(name.data(), name.size());
+}
+
+static const char kIdentifierCharacters[] =
+    "_0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+// Returns the keywords, and every identifier one edit away from them.
+static std::vector<std::string> KeywordsAndNearMisses()
+{
+    std::vector<std::string> names;
+    for (size_t i = 0; i < kNumKeywords; ++i) {
+        const std::string keyword = kKeywords[i].name;
+        names.push_back(keyword);
+        for (size_t position = 0; position <= keyword.size(); ++position) {
+            if (position < keyword.size())
+                names.push_back(std::string(keyword).erase(position, 1));
+            for (const char* c = kIdentifierCharacters; *c; ++c) {
+                names.push_back(std::string(keyword).insert(position, 1, *c));
+                if (position < keyword.size())
+                    names.push_back(std::string(keyword).replace(position, 1, 1, *c));
+            }
+        }
+    }
+    return names;
+}
+
+TEST(KeywordsTest, TableIsSorted)
+{
+    for (size_t i = 1; i < kNumKeywords; ++i)
+        EXPECT_LT(strcmp(kKeywords[i - 1].name, kKeywords[i].name), 0) << kKeywords[i].name;
+}
+
+TEST(KeywordsTest, FindsEveryKeyword)
+{
+    for (size_t i = 0; i < kNumKeywords; ++i)
+        EXPECT_EQ(&kKeywords[i], FindKeyword(kKeywords[i].name)) << kKeywords[i].name;
+}
+
+TEST(KeywordsTest, MatchesSearchOfSortedTable)
+{
+    const std::vector<std::string> names = KeywordsAndNearMisses();
+    for (size_t i = 0; i < names.size(); ++i)
+        EXPECT_EQ(SearchKeyword(names[i]), FindKeyword(names[i])) << names[i];
+
+    const char* const kIdentifiers[] = {
+        "", "a", "gl_FragColor", "gl_Position", "texture2D", "main", "u_color",
+        "samplerExternalOESx", "sampler2DRectShadow_", "averyveryverylongidentifier",
+    };
+    for (size_t i = 0; i < sizeof(kIdentifiers) / sizeof(kIdentifiers[0]); ++i)
+        EXPECT_EQ(SearchKeyword(kIdentifiers[i]), FindKeyword(kIdentifiers[i])) << kIdentifiers[i];
+}
+
+TEST(KeywordsTest, ComparesOnlyTheGivenLength)
+{
+    // Token text is not null-terminated.
+    const char kText[] = "vec4 vec44";
+    EXPECT_EQ(SearchKeyword("vec4"), FindKeyword(kText, 4));
+    EXPECT_TRUE(FindKeyword(kText + 5, 5) == NULL);
+    EXPECT_TRUE(FindKeyword(kText, 3) == NULL);
+}
+
+// Looks up identifiers, half of them keywords, by hashing them and by
+// searching the sorted table.
+TEST(KeywordsTest, DISABLED_FindKeywordCost)
+{
+    std::vector<std::string> names = KeywordsAndNearMisses();
+    names.resize(std::min(names.size(), static_cast<size_t>(10000)));
+    for (size_t i = 0; names.size() < 20000; ++i)
+        names.push_back(kKeywords[i % kNumKeywords].name);
+
+    const int kIterations = 200;
+    size_t found = 0;
+    clock_t start = clock();
+    for (int i = 0; i < kIterations; ++i) {
+        for (size_t j = 0; j < names.size(); ++j)
+            found += SearchKeyword(names[j]) != NULL;
+    }
+    double searched = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int i = 0; i < kIterations; ++i) {
+        for (size_t j = 0; j < names.size(); ++j)
+            found -= FindKeyword(names[j]) != NULL;
+    }
+    double hashed = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+    EXPECT_EQ(0u, found);
+
+    double lookups = static_cast<double>(kIterations) * names.size();
+    printf("sorted table: %.1f ns/lookup, perfect hash: %.1f ns/lookup\n",
+           searched * 1e9 / lookups, hashed * 1e9 / lookups);
+}
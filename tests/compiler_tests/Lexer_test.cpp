@@ -0,0 +1,162 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+#include <stdio.h>
+#include <time.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "GLSLANG/ShaderLang.h"
+#include "gtest/gtest.h"
+
+#define SHADER(Src) #Src
+
+class LexerTest : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        ShBuiltInResources resources;
+        ShInitBuiltInResources(&resources);
+        mFragmentCompiler = ShConstructCompiler(
+            SH_FRAGMENT_SHADER, SH_WEBGL_SPEC, SH_ESSL_OUTPUT, &resources);
+        mVertexCompiler = ShConstructCompiler(
+            SH_VERTEX_SHADER, SH_WEBGL_SPEC, SH_ESSL_OUTPUT, &resources);
+        ASSERT_TRUE(mFragmentCompiler != NULL);
+        ASSERT_TRUE(mVertexCompiler != NULL);
+    }
+
+    virtual void TearDown()
+    {
+        ShDestruct(mFragmentCompiler);
+        ShDestruct(mVertexCompiler);
+    }
+
+    bool compile(ShHandle compiler, const std::string& shader)
+    {
+        const char* source = shader.c_str();
+        return ShCompile(compiler, &source, 1, SH_OBJECT_CODE) != 0;
+    }
+
+    std::string getInfoLog(ShHandle compiler)
+    {
+        size_t bufferLen = 0;
+        ShGetInfo(compiler, SH_INFO_LOG_LENGTH, &bufferLen);
+        std::vector<char> buffer(bufferLen);
+        ShGetInfoLog(compiler, &buffer[0]);
+        return std::string(&buffer[0]);
+    }
+
+    std::string getObjectCode(ShHandle compiler)
+    {
+        size_t bufferLen = 0;
+        ShGetInfo(compiler, SH_OBJECT_CODE_LENGTH, &bufferLen);
+        std::vector<char> buffer(bufferLen);
+        ShGetObjectCode(compiler, &buffer[0]);
+        return std::string(&buffer[0]);
+    }
+
+    ShHandle mFragmentCompiler;
+    ShHandle mVertexCompiler;
+};
+
+TEST_F(LexerTest, ParsesNumericConstants)
+{
+    const std::string shader = SHADER(
+        precision mediump float;
+        void main() {
+            int i = 0x1F + 017 + 42;
+            gl_FragColor = vec4(float(i), 1.5, 2e1, .25);
+        }
+    );
+    ASSERT_TRUE(compile(mFragmentCompiler, shader)) << getInfoLog(mFragmentCompiler);
+    std::string code = getObjectCode(mFragmentCompiler);
+    // 0x1F + 017 + 42, folded.
+    EXPECT_NE(std::string::npos, code.find("88")) << code;
+    EXPECT_NE(std::string::npos, code.find("20.0")) << code;
+    EXPECT_NE(std::string::npos, code.find("0.25")) << code;
+}
+
+TEST_F(LexerTest, WarnsAboutOverflowingConstants)
+{
+    // The float constant is longer than the lexer's stack buffer.
+    const std::string longFloat = "1" + std::string(100, '0') + ".0";
+    const std::string shader =
+        "precision mediump float;\n"
+        "void main() {\n"
+        "    int i = 4294967296;\n"
+        "    gl_FragColor = vec4(float(i), " + longFloat + ", 0.0, 1.0);\n"
+        "}\n";
+    ASSERT_TRUE(compile(mFragmentCompiler, shader)) << getInfoLog(mFragmentCompiler);
+    std::string log = getInfoLog(mFragmentCompiler);
+    EXPECT_NE(std::string::npos, log.find("'4294967296' : Integer overflow")) << log;
+    EXPECT_NE(std::string::npos, log.find("'" + longFloat + "' : Float overflow")) << log;
+}
+
+// Not run by default. Reports the cost of compiling shaders whose compile
+// time is mostly lexing and parsing.
+TEST_F(LexerTest, DISABLED_CompileCost)
+{
+    const std::string vertexShader = SHADER(
+        attribute vec4 a_position;
+        attribute vec3 a_normal;
+        attribute vec2 a_texCoord;
+        uniform mat4 u_modelViewProjection;
+        uniform mat3 u_normalMatrix;
+        varying vec3 v_normal;
+        varying vec2 v_texCoord;
+        void main() {
+            v_normal = normalize(u_normalMatrix * a_normal);
+            v_texCoord = a_texCoord * 0.5 + 0.25;
+            gl_Position = u_modelViewProjection * a_position;
+        }
+    );
+
+    std::ostringstream fragmentShader;
+    fragmentShader << "precision mediump float;\n"
+                      "uniform sampler2D u_texture;\n"
+                      "varying vec3 v_normal;\n"
+                      "varying vec2 v_texCoord;\n"
+                      "void main() {\n"
+                      "    vec4 color = texture2D(u_texture, v_texCoord);\n";
+    for (int i = 0; i < 50; ++i) {
+        fragmentShader << "    color.rgb = mix(color.rgb, abs(v_normal) * " << i
+                       << ".5, 0.0" << i << ") + vec3(" << i << ", 0x" << i << ", 0"
+                       << i % 8 << ") * 1e-3;\n";
+    }
+    fragmentShader << "    gl_FragColor = color;\n"
+                      "}\n";
+
+    std::ostringstream largeShader;
+    largeShader << "precision mediump float;\n"
+                   "varying vec2 v_texCoord;\n"
+                   "void main() {\n"
+                   "    vec4 c0 = vec4(v_texCoord, 0.0, 1.0);\n";
+    for (int i = 1; i < 1900; ++i) {
+        largeShader << "    vec4 c" << i << " = c" << i - 1 << " * " << i
+                    << ".0 + vec4(" << i % 10 << ".5);\n";
+    }
+    largeShader << "    gl_FragColor = c1899;\n"
+                   "}\n";
+
+    struct Case {
+        const char* name;
+        ShHandle compiler;
+        std::string shader;
+    };
+    const Case cases[] = {
+        { "vertex shader", mVertexCompiler, vertexShader },
+        { "fragment shader", mFragmentCompiler, fragmentShader.str() },
+        { "1900-line fragment shader", mFragmentCompiler, largeShader.str() },
+    };
+
+    const int kIterations = 200;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        clock_t start = clock();
+        for (int j = 0; j < kIterations; ++j)
+            ASSERT_TRUE(compile(cases[i].compiler, cases[i].shader)) << getInfoLog(cases[i].compiler);
+        double seconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+        printf("%s: %.1f us/compile\n", cases[i].name, seconds * 1e6 / kIterations);
+    }
+}
@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+#include "GLSLANG/ShaderLang.h"
+#include "gtest/gtest.h"
+
+#define SHADER(Src) #Src
+
+class MemoryStatisticsTest : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        ShBuiltInResources resources;
+        ShInitBuiltInResources(&resources);
+        mCompiler = ShConstructCompiler(
+            SH_FRAGMENT_SHADER, SH_WEBGL_SPEC, SH_GLSL_OUTPUT, &resources);
+        ASSERT_TRUE(mCompiler != NULL);
+    }
+
+    virtual void TearDown()
+    {
+        ShDestruct(mCompiler);
+    }
+
+    ShMemoryStatistics compile(const char* shader)
+    {
+        ShCompile(mCompiler, &shader, 1, SH_OBJECT_CODE);
+        void* statistics = NULL;
+        ShGetInfoPointer(mCompiler, SH_MEMORY_STATISTICS, &statistics);
+        return *static_cast<const ShMemoryStatistics*>(statistics);
+    }
+
+    ShHandle mCompiler;
+};
+
+TEST_F(MemoryStatisticsTest, AccountsEachPhase)
+{
+    const char* shader = SHADER(
+        precision mediump float;
+        uniform vec4 u_colors[4];
+        void main() {
+            vec4 color = vec4(0.0);
+            for (int i = 0; i < 4; ++i)
+                color += u_colors[i];
+            gl_FragColor = color;
+        }
+    );
+
+    ShMemoryStatistics statistics = compile(shader);
+    EXPECT_LT(0u, statistics.numPages);
+    EXPECT_LE(statistics.allocatedBytes, statistics.peakBytes);
+    EXPECT_LT(0u, statistics.numAllocations);
+    EXPECT_LT(0u, statistics.phaseBytes[SH_PHASE_PARSE]);
+    // WebGL shaders are validated against Appendix A.
+    EXPECT_LT(0u, statistics.phaseBytes[SH_PHASE_VALIDATE_LIMITATIONS]);
+    EXPECT_LT(0u, statistics.phaseBytes[SH_PHASE_TRANSLATE]);
+
+    size_t totalBytes = 0;
+    for (int phase = 0; phase < SH_PHASE_COUNT; ++phase)
+        totalBytes += statistics.phaseBytes[phase];
+    EXPECT_EQ(statistics.allocatedBytes, totalBytes);
+
+    // The statistics are those of the latest compile only.
+    ShMemoryStatistics again = compile(shader);
+    EXPECT_EQ(statistics.numAllocations, again.numAllocations);
+    EXPECT_EQ(statistics.allocatedBytes, again.allocatedBytes);
+    EXPECT_EQ(statistics.numPages, again.numPages);
+}
+
+TEST_F(MemoryStatisticsTest, StopsAtFailedPhase)
+{
+    ShMemoryStatistics statistics = compile(SHADER(
+        void main() {
+            gl_FragColor = undeclared;
+        }
+    ));
+    EXPECT_LT(0u, statistics.phaseBytes[SH_PHASE_PARSE]);
+    EXPECT_EQ(0u, statistics.phaseBytes[SH_PHASE_VALIDATE_LIMITATIONS]);
+    EXPECT_EQ(0u, statistics.phaseBytes[SH_PHASE_TRANSLATE]);
+}
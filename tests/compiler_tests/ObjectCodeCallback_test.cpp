@@ -0,0 +1,101 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+#include <sstream>
+#include <string>
+
+#include "GLSLANG/ShaderLang.h"
+#include "gtest/gtest.h"
+
+class ObjectCodeCallbackTest : public testing::TestWithParam<ShShaderOutput> {
+protected:
+    virtual void SetUp()
+    {
+        ShBuiltInResources resources;
+        ShInitBuiltInResources(&resources);
+        mCompiler = ShConstructCompiler(
+            SH_FRAGMENT_SHADER, SH_GLES2_SPEC, GetParam(), &resources);
+        ASSERT_TRUE(mCompiler != NULL);
+        mNumChunks = 0;
+    }
+
+    virtual void TearDown()
+    {
+        ShDestruct(mCompiler);
+    }
+
+    static void Receive(const char* code, size_t length, void* userData)
+    {
+        ObjectCodeCallbackTest* test = static_cast<ObjectCodeCallbackTest*>(userData);
+        test->mStreamed.append(code, length);
+        ++test->mNumChunks;
+    }
+
+    bool compile(const std::string& shader)
+    {
+        const char* source = shader.c_str();
+        return ShCompile(mCompiler, &source, 1, SH_OBJECT_CODE) != 0;
+    }
+
+    std::string getObjectCode()
+    {
+        size_t length = 0;
+        ShGetInfo(mCompiler, SH_OBJECT_CODE_LENGTH, &length);
+        std::string code(length, '\0');
+        ShGetObjectCode(mCompiler, &code[0]);
+        return code.c_str();
+    }
+
+    // Returns a shader whose object code takes many chunks.
+    static std::string LargeShader()
+    {
+        std::ostringstream shader;
+        shader << "precision mediump float;\n"
+                  "uniform vec4 u;\n"
+                  "void main() {\n"
+                  "    vec4 v = u;\n";
+        for (int i = 0; i < 1000; ++i)
+            shader << "    v = v * " << i << ".5 + vec4(" << i << ".0);\n";
+        shader << "    gl_FragColor = v;\n"
+                  "}\n";
+        return shader.str();
+    }
+
+    ShHandle mCompiler;
+    std::string mStreamed;
+    int mNumChunks;
+};
+
+TEST_P(ObjectCodeCallbackTest, StreamsObjectCode)
+{
+    const std::string shader = LargeShader();
+    ASSERT_TRUE(compile(shader));
+    const std::string expected = getObjectCode();
+
+    ShSetObjectCodeCallback(mCompiler, Receive, this);
+    ASSERT_TRUE(compile(shader));
+    EXPECT_EQ(expected, mStreamed);
+    EXPECT_LT(1, mNumChunks);
+
+    // The streamed code is not kept.
+    size_t length = 0;
+    ShGetInfo(mCompiler, SH_OBJECT_CODE_LENGTH, &length);
+    EXPECT_EQ(1u, length);
+
+    ShSetObjectCodeCallback(mCompiler, NULL, NULL);
+    ASSERT_TRUE(compile(shader));
+    EXPECT_EQ(expected, getObjectCode());
+}
+
+TEST_P(ObjectCodeCallbackTest, SkipsFailedCompiles)
+{
+    ShSetObjectCodeCallback(mCompiler, Receive, this);
+    EXPECT_FALSE(compile("void main() { gl_FragColor = undeclared; }"));
+    EXPECT_EQ(0, mNumChunks);
+}
+
+INSTANTIATE_TEST_CASE_P(AllOutputs, ObjectCodeCallbackTest,
+                        testing::Values(SH_ESSL_OUTPUT, SH_GLSL_OUTPUT,
+                                        SH_HLSL9_OUTPUT, SH_HLSL11_OUTPUT));
@@ -0,0 +1,322 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+#include <stdio.h>
+#include <time.h>
+#include <vector>
+#include "compiler/BuiltInFunctionEmulator.h"
+#include "compiler/DetectCallDepth.h"
+#include "compiler/InfoSink.h"
+#include "compiler/PassManager.h"
+#include "compiler/SymbolTable.h"
+#include "compiler/UnfoldShortCircuitAST.h"
+#include "compiler/ValidateLimitations.h"
+#include "compiler/VariableInfo.h"
+#include "compiler/timing/RestrictVertexShaderTiming.h"
+#include "gtest/gtest.h"
+#include "third_party/compiler/ArrayBoundsClamper.h"
+
+struct Visited {
+    Visited(TIntermNode* node, Visit visit, TIntermNode* parent)
+        : node(node), visit(visit), parent(parent) { }
+    bool operator==(const Visited& other) const {
+        return node == other.node && visit == other.visit && parent == other.parent;
+    }
+
+    TIntermNode* node;
+    Visit visit;
+    TIntermNode* parent;
+};
+typedef std::vector<Visited> VisitList;
+
+// Records the nodes it visits, with their parents, and skips the subtree
+// of skipped.
+class RecordingTraverser : public TIntermTraverser {
+public:
+    RecordingTraverser(bool postVisit, TIntermNode* skipped = NULL)
+        : TIntermTraverser(true, false, postVisit), mSkipped(skipped) { }
+
+    const VisitList& getVisits() const { return mVisits; }
+
+    virtual void visitSymbol(TIntermSymbol* node) { record(PreVisit, node); }
+    virtual void visitConstantUnion(TIntermConstantUnion* node) { record(PreVisit, node); }
+    virtual bool visitBinary(Visit visit, TIntermBinary* node) { return record(visit, node); }
+    virtual bool visitUnary(Visit visit, TIntermUnary* node) { return record(visit, node); }
+    virtual bool visitSelection(Visit visit, TIntermSelection* node) { return record(visit, node); }
+    virtual bool visitAggregate(Visit visit, TIntermAggregate* node) { return record(visit, node); }
+    virtual bool visitLoop(Visit visit, TIntermLoop* node) { return record(visit, node); }
+    virtual bool visitBranch(Visit visit, TIntermBranch* node) { return record(visit, node); }
+
+private:
+    bool record(Visit visit, TIntermNode* node)
+    {
+        mVisits.push_back(Visited(node, visit, getParentNode()));
+        return node != mSkipped;
+    }
+
+    TIntermNode* mSkipped;
+    VisitList mVisits;
+};
+
+class InVisitTraverser : public TIntermTraverser {
+public:
+    InVisitTraverser() : TIntermTraverser(true, true, true) { }
+};
+
+class PassManagerTest : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        allocator.push();
+        SetGlobalPoolAllocator(&allocator);
+    }
+
+    virtual void TearDown()
+    {
+        SetGlobalPoolAllocator(NULL);
+        allocator.popAll();
+    }
+
+    TIntermSymbol* symbol(int id)
+    {
+        return new TIntermSymbol(id, "x", TType(EbtFloat, EbpHigh));
+    }
+
+    TIntermBinary* binary(TOperator op, TIntermTyped* left, TIntermTyped* right)
+    {
+        TIntermBinary* node = new TIntermBinary(op);
+        node->setLeft(left);
+        node->setRight(right);
+        node->setType(left->getType());
+        return node;
+    }
+
+    // Returns the tree of
+    //   void main() {
+    //       x0 = x1 + x2 * x3;
+    //       for (int x4 = 0; x4 < 4; ++x4)
+    //           x5 += -x6;
+    //   }
+    TIntermNode* makeTree()
+    {
+        TIntermAggregate* body = new TIntermAggregate(EOpSequence);
+        body->getSequence().push_back(
+            binary(EOpAssign, symbol(0), binary(EOpAdd, symbol(1),
+                                                binary(EOpMul, symbol(2), symbol(3)))));
+
+        ConstantUnion* zero = new ConstantUnion;
+        zero->setIConst(0);
+        TIntermAggregate* init = new TIntermAggregate(EOpDeclaration);
+        init->getSequence().push_back(binary(EOpInitialize, symbol(4),
+            new TIntermConstantUnion(zero, TType(EbtInt, EbpHigh, EvqConst))));
+        TIntermUnary* increment = new TIntermUnary(EOpPreIncrement);
+        increment->setOperand(symbol(4));
+        TIntermUnary* negate = new TIntermUnary(EOpNegative);
+        negate->setOperand(symbol(6));
+        body->getSequence().push_back(new TIntermLoop(
+            ELoopFor, init, binary(EOpLessThan, symbol(4), symbol(7)), increment,
+            binary(EOpAddAssign, symbol(5), negate)));
+
+        TIntermAggregate* main = new TIntermAggregate(EOpFunction);
+        main->setName("main(");
+        main->getSequence().push_back(new TIntermAggregate(EOpParameters));
+        main->getSequence().push_back(body);
+        TIntermAggregate* root = new TIntermAggregate(EOpSequence);
+        root->getSequence().push_back(main);
+        return root;
+    }
+
+    // Returns the body of the loop of makeTree().
+    TIntermNode* findLoopBody(TIntermNode* root)
+    {
+        TIntermAggregate* main = root->getAsAggregate()->getSequence()[0]->getAsAggregate();
+        TIntermAggregate* body = main->getSequence()[1]->getAsAggregate();
+        return body->getSequence()[1]->getAsLoopNode()->getBody();
+    }
+
+    TPoolAllocator allocator;
+};
+
+TEST_F(PassManagerTest, SharesATraversalBetweenPasses)
+{
+    TIntermNode* root = makeTree();
+    RecordingTraverser alone(true);
+    root->traverse(&alone);
+
+    RecordingTraverser first(true), second(false), third(true);
+    TPassManager passes;
+    passes.addPass(SH_PASS_VALIDATE_LIMITATIONS, &first);
+    passes.addPass(SH_PASS_UNROLL_FOR_LOOPS, &second);
+    passes.addPass(SH_PASS_COLLECT_VARIABLES, &third);
+    EXPECT_EQ(1, passes.run(root));
+
+    // Without their paths, the passes see no parents.
+    VisitList expected;
+    for (size_t i = 0; i < alone.getVisits().size(); ++i)
+        expected.push_back(Visited(alone.getVisits()[i].node, alone.getVisits()[i].visit, NULL));
+    EXPECT_TRUE(expected == first.getVisits());
+    EXPECT_TRUE(expected == third.getVisits());
+
+    VisitList preVisits;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (expected[i].visit == PreVisit)
+            preVisits.push_back(expected[i]);
+    }
+    EXPECT_TRUE(preVisits == second.getVisits());
+
+    // The passes are removed once run.
+    EXPECT_EQ(0, passes.run(root));
+}
+
+TEST_F(PassManagerTest, KeepsPathOfPassesThatUseIt)
+{
+    TIntermNode* root = makeTree();
+    RecordingTraverser alone(true);
+    root->traverse(&alone);
+
+    RecordingTraverser other(true), withPath(true);
+    TPassManager passes;
+    passes.addPass(SH_PASS_VALIDATE_LIMITATIONS, &other);
+    passes.addPass(SH_PASS_UNFOLD_SHORT_CIRCUIT, &withPath, 0, true);
+    EXPECT_EQ(1, passes.run(root));
+    EXPECT_TRUE(alone.getVisits() == withPath.getVisits());
+}
+
+TEST_F(PassManagerTest, SkipsSubtreesPerPass)
+{
+    TIntermNode* root = makeTree();
+    TIntermNode* loopBody = findLoopBody(root);
+    RecordingTraverser skippingAlone(true, loopBody), alone(true);
+    root->traverse(&skippingAlone);
+    root->traverse(&alone);
+    EXPECT_LT(skippingAlone.getVisits().size(), alone.getVisits().size());
+
+    RecordingTraverser skipping(true, loopBody), other(true);
+    TPassManager passes;
+    passes.addPass(SH_PASS_VALIDATE_LIMITATIONS, &skipping, 0, true);
+    passes.addPass(SH_PASS_COLLECT_VARIABLES, &other, 0, true);
+    EXPECT_EQ(1, passes.run(root));
+    EXPECT_TRUE(skippingAlone.getVisits() == skipping.getVisits());
+    EXPECT_TRUE(alone.getVisits() == other.getVisits());
+}
+
+TEST_F(PassManagerTest, RunsPassesAfterThoseTheyNeed)
+{
+    TIntermNode* root = makeTree();
+    RecordingTraverser map(false), collect(false), translate(false);
+    TPassManager passes;
+    passes.addPass(SH_PASS_MAP_LONG_VARIABLE_NAMES, &map);
+    // Passes that were not added are left out of the masks.
+    passes.addPass(SH_PASS_COLLECT_VARIABLES, &collect,
+                   PassBit(SH_PASS_MAP_LONG_VARIABLE_NAMES) | PassBit(SH_PASS_PARSE), true);
+    // The passes added later run in the same traversal, or a later one.
+    passes.addPass(SH_PASS_TRANSLATE, &translate, 0, true);
+    EXPECT_EQ(2, passes.run(root));
+    EXPECT_TRUE(map.getVisits() == collect.getVisits());
+    EXPECT_TRUE(map.getVisits() == translate.getVisits());
+
+    passes.addPass(SH_PASS_MAP_LONG_VARIABLE_NAMES, &map);
+    passes.addPass(SH_PASS_COLLECT_VARIABLES, &collect, PassBit(SH_PASS_PARSE));
+    EXPECT_EQ(1, passes.run(root));
+}
+
+TEST_F(PassManagerTest, GivesInVisitsATraversalOfTheirOwn)
+{
+    TIntermNode* root = makeTree();
+    RecordingTraverser before(false), after(false);
+    InVisitTraverser inVisits;
+    TPassManager passes;
+    passes.addPass(SH_PASS_VALIDATE_LIMITATIONS, &before);
+    passes.addPass(SH_PASS_INTERMEDIATE_TREE, &inVisits);
+    passes.addPass(SH_PASS_COLLECT_VARIABLES, &after);
+    EXPECT_EQ(3, passes.run(root));
+}
+
+TEST_F(PassManagerTest, ChargesSharedTraversalsToSharedTime)
+{
+    ShPassTimings timings = { 0 };
+    RecordingTraverser first(true), second(true);
+    InVisitTraverser inVisits;
+    TPassManager passes(&timings);
+    passes.addPass(SH_PASS_VALIDATE_LIMITATIONS, &first);
+    passes.addPass(SH_PASS_COLLECT_VARIABLES, &second);
+    passes.addPass(SH_PASS_INTERMEDIATE_TREE, &inVisits);
+    EXPECT_EQ(2, passes.run(makeTree()));
+    EXPECT_LT(0u, timings.sharedNanoseconds);
+    EXPECT_EQ(PassBit(SH_PASS_VALIDATE_LIMITATIONS) | PassBit(SH_PASS_COLLECT_VARIABLES),
+              timings.sharedPasses);
+    EXPECT_EQ(0u, timings.passNanoseconds[SH_PASS_VALIDATE_LIMITATIONS]);
+    EXPECT_EQ(0u, timings.passNanoseconds[SH_PASS_COLLECT_VARIABLES]);
+    EXPECT_LT(0u, timings.passNanoseconds[SH_PASS_INTERMEDIATE_TREE]);
+}
+
+// Runs the checks and markers of a WebGL compile over a deep tree, each in
+// a traversal of its own and sharing one.
+TEST_F(PassManagerTest, DISABLED_SharedTraversalCost)
+{
+    const int kStatements = 200;
+    const int kDepth = 200;
+    TIntermAggregate* body = new TIntermAggregate(EOpSequence);
+    for (int i = 0; i < kStatements; ++i) {
+        TIntermTyped* expression = symbol(1);
+        for (int depth = 0; depth < kDepth; ++depth)
+            expression = binary(depth % 2 ? EOpAdd : EOpMul, expression, symbol(depth + 2));
+        body->getSequence().push_back(binary(EOpAssign, symbol(0), expression));
+    }
+    TIntermAggregate* main = new TIntermAggregate(EOpFunction);
+    main->setName("main(");
+    main->getSequence().push_back(new TIntermAggregate(EOpParameters));
+    main->getSequence().push_back(body);
+    TIntermAggregate* root = new TIntermAggregate(EOpSequence);
+    root->getSequence().push_back(main);
+
+    TInfoSink infoSink;
+    TSymbolTable symbolTable;
+    TVariableInfoList attribs, uniforms, varyings;
+    ArrayBoundsClamper clamper;
+    BuiltInFunctionEmulator emulator(SH_FRAGMENT_SHADER);
+
+    const int kIterations = 20;
+    clock_t start = clock();
+    for (int i = 0; i < kIterations; ++i) {
+        DetectCallDepth detect(infoSink, false, 0);
+        root->traverse(&detect);
+        ValidateLimitations validate(SH_VERTEX_SHADER, symbolTable, infoSink.info);
+        root->traverse(&validate);
+        RestrictVertexShaderTiming restrictTiming(infoSink.info);
+        root->traverse(&restrictTiming);
+        emulator.MarkBuiltInFunctionsForEmulation(root);
+        clamper.MarkIndirectArrayBoundsForClamping(root);
+        UnfoldShortCircuitAST unfold;
+        root->traverse(&unfold);
+        CollectVariables collect(attribs, uniforms, varyings, NULL);
+        root->traverse(&collect);
+    }
+    double separate = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int i = 0; i < kIterations; ++i) {
+        TPassManager passes;
+        DetectCallDepth detect(infoSink, false, 0);
+        passes.addPass(SH_PASS_DETECT_CALL_DEPTH, &detect);
+        ValidateLimitations validate(SH_VERTEX_SHADER, symbolTable, infoSink.info);
+        passes.addPass(SH_PASS_VALIDATE_LIMITATIONS, &validate);
+        RestrictVertexShaderTiming restrictTiming(infoSink.info);
+        passes.addPass(SH_PASS_TIMING_RESTRICTIONS, &restrictTiming);
+        passes.run(root);
+
+        emulator.MarkBuiltInFunctionsForEmulation(&passes);
+        clamper.MarkIndirectArrayBoundsForClamping(&passes);
+        UnfoldShortCircuitAST unfold;
+        passes.addPass(SH_PASS_UNFOLD_SHORT_CIRCUIT, &unfold, 0, true);
+        CollectVariables collect(attribs, uniforms, varyings, NULL);
+        passes.addPass(SH_PASS_COLLECT_VARIABLES, &collect);
+        passes.run(root);
+    }
+    double shared = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%d nodes deep: 7 traversals: %.2f ms, 2 shared traversals: %.2f ms\n",
+           kDepth, separate * 1e3 / kIterations, shared * 1e3 / kIterations);
+}
@@ -0,0 +1,144 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+#include <string>
+#include <vector>
+#include "GLSLANG/ShaderLang.h"
+#include "gtest/gtest.h"
+
+#define SHADER(Src) #Src
+
+class PassTimingsTest : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        ShBuiltInResources resources;
+        ShInitBuiltInResources(&resources);
+        mCompiler = ShConstructCompiler(
+            SH_FRAGMENT_SHADER, SH_WEBGL_SPEC, SH_GLSL_OUTPUT, &resources);
+        ASSERT_TRUE(mCompiler != NULL);
+    }
+
+    virtual void TearDown()
+    {
+        ShDestruct(mCompiler);
+    }
+
+    ShPassTimings compile(const char* shader, int compileOptions)
+    {
+        ShCompile(mCompiler, &shader, 1, compileOptions);
+        void* timings = NULL;
+        ShGetInfoPointer(mCompiler, SH_PASS_TIMINGS, &timings);
+        return *static_cast<const ShPassTimings*>(timings);
+    }
+
+    ShHandle mCompiler;
+};
+
+TEST_F(PassTimingsTest, TimesThePassesThatRun)
+{
+    const char* shader = SHADER(
+        precision mediump float;
+        uniform vec4 u_colors[4];
+        void main() {
+            vec4 color = vec4(0.0);
+            for (int i = 0; i < 4; ++i)
+                color += u_colors[i];
+            gl_FragColor = color;
+        }
+    );
+
+    ShPassTimings timings = compile(shader, SH_OBJECT_CODE | SH_VARIABLES);
+    EXPECT_LT(0u, timings.passNanoseconds[SH_PASS_PARSE]);
+    // WebGL shaders are validated against Appendix A, in the traversal
+    // that detects the call depth.
+    EXPECT_LT(0u, timings.sharedNanoseconds);
+    EXPECT_EQ((1u << SH_PASS_DETECT_CALL_DEPTH) | (1u << SH_PASS_VALIDATE_LIMITATIONS),
+              timings.sharedPasses);
+    EXPECT_EQ(0u, timings.passNanoseconds[SH_PASS_VALIDATE_LIMITATIONS]);
+    EXPECT_LT(0u, timings.passNanoseconds[SH_PASS_COLLECT_VARIABLES]);
+    EXPECT_LT(0u, timings.passNanoseconds[SH_PASS_TRANSLATE]);
+    EXPECT_EQ(0u, timings.passNanoseconds[SH_PASS_TIMING_RESTRICTIONS]);
+    EXPECT_EQ(0u, timings.passNanoseconds[SH_PASS_INTERMEDIATE_TREE]);
+
+    size_t passNanoseconds = timings.sharedNanoseconds;
+    for (int pass = 0; pass < SH_PASS_COUNT; ++pass)
+        passNanoseconds += timings.passNanoseconds[pass];
+    EXPECT_LE(passNanoseconds, timings.totalNanoseconds);
+
+    // The timings are those of the latest compile only.
+    timings = compile(shader, SH_VARIABLES);
+    EXPECT_LT(0u, timings.passNanoseconds[SH_PASS_COLLECT_VARIABLES]);
+    EXPECT_EQ(0u, timings.passNanoseconds[SH_PASS_TRANSLATE]);
+}
+
+TEST_F(PassTimingsTest, StopsAtFailedPass)
+{
+    ShPassTimings timings = compile(SHADER(
+        void main() {
+            gl_FragColor = undeclared;
+        }
+    ), SH_OBJECT_CODE);
+    EXPECT_LT(0u, timings.passNanoseconds[SH_PASS_PARSE]);
+    EXPECT_LE(timings.passNanoseconds[SH_PASS_PARSE], timings.totalNanoseconds);
+    EXPECT_EQ(0u, timings.passNanoseconds[SH_PASS_VALIDATE_LIMITATIONS]);
+    EXPECT_EQ(0u, timings.passNanoseconds[SH_PASS_TRANSLATE]);
+}
+
+namespace {
+
+unsigned char gGpuCategoryEnabled = 0;
+std::vector<std::string> gEvents;
+
+const unsigned char* GetCategoryEnabledFlag(const char* name)
+{
+    static const unsigned char disabled = 0;
+    return std::string(name) == "gpu" ? &gGpuCategoryEnabled : &disabled;
+}
+
+void AddTraceEvent(char phase, const unsigned char* categoryGroupEnabled, const char* name,
+                   unsigned long long, int, const char**, const unsigned char*,
+                   const unsigned long long*, unsigned char)
+{
+    EXPECT_EQ(&gGpuCategoryEnabled, categoryGroupEnabled);
+    gEvents.push_back(std::string(1, phase) + " " + name);
+}
+
+}  // namespace
+
+TEST_F(PassTimingsTest, TracesPasses)
+{
+    const char* shader = SHADER(
+        precision mediump float;
+        void main() {
+            gl_FragColor = vec4(1.0);
+        }
+    );
+
+    ShSetTraceFunctionPointers(GetCategoryEnabledFlag, AddTraceEvent);
+    gEvents.clear();
+    gGpuCategoryEnabled = 0;
+    compile(shader, SH_OBJECT_CODE);
+    EXPECT_TRUE(gEvents.empty());
+
+    gGpuCategoryEnabled = 1;
+    compile(shader, SH_OBJECT_CODE);
+    ASSERT_LE(4u, gEvents.size());
+    EXPECT_EQ("B Parse", gEvents[0]);
+    EXPECT_EQ("E Parse", gEvents[1]);
+    EXPECT_EQ("B Translate", gEvents[gEvents.size() - 2]);
+    EXPECT_EQ("E Translate", gEvents.back());
+    // The events of a pass nest in those of no other.
+    for (size_t i = 0; i < gEvents.size(); i += 2) {
+        EXPECT_EQ('B', gEvents[i][0]);
+        EXPECT_EQ("E" + gEvents[i].substr(1), gEvents[i + 1]);
+    }
+
+    ShSetTraceFunctionPointers(NULL, NULL);
+    gEvents.clear();
+    compile(shader, SH_OBJECT_CODE);
+    EXPECT_TRUE(gEvents.empty());
+    gGpuCategoryEnabled = 0;
+}
@@ -0,0 +1,58 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+#include "compiler/PoolAlloc.h"
+#include "gtest/gtest.h"
+
+#ifndef GUARD_BLOCKS
+TEST(PoolAllocator, DeallocateReusesLastAllocation)
+{
+    TPoolAllocator allocator;
+    allocator.push();
+
+    void* first = allocator.allocate(24);
+    void* second = allocator.allocate(40);
+    allocator.deallocate(second, 40);
+    EXPECT_EQ(second, allocator.allocate(40));
+
+    // Older allocations stay where they are.
+    allocator.deallocate(first, 24);
+    EXPECT_NE(first, allocator.allocate(24));
+
+    allocator.pop();
+}
+
+TEST(PoolAllocator, DeallocateKeepsMemoryOfOuterPush)
+{
+    TPoolAllocator allocator;
+    allocator.push();
+    void* outer = allocator.allocate(64);
+
+    allocator.push();
+    allocator.deallocate(outer, 64);
+    EXPECT_NE(outer, allocator.allocate(64));
+    allocator.pop();
+
+    allocator.pop();
+}
+#endif  // GUARD_BLOCKS
+
+TEST(PoolAllocator, ReusesLargeBlocksAfterPop)
+{
+    TPoolAllocator allocator;
+    const size_t largeSize = 5 * allocator.getPageSize();
+
+    allocator.push();
+    void* large = allocator.allocate(largeSize);
+    size_t pages = allocator.getNumPages();
+    allocator.pop();
+    EXPECT_EQ(0u, allocator.getNumPages());
+
+    // A smaller multi-page request fits in the cached block.
+    allocator.push();
+    EXPECT_EQ(large, allocator.allocate(largeSize - allocator.getPageSize()));
+    EXPECT_EQ(pages, allocator.getNumPages());
+    allocator.pop();
+}
@@ -0,0 +1,308 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+#include <stdio.h>
+#include <time.h>
+#include <sstream>
+#include <string>
+
+#include "GLSLANG/ShaderLang.h"
+#include "gtest/gtest.h"
+
+class PreludeTest : public testing::TestWithParam<ShShaderOutput> {
+protected:
+    virtual void SetUp()
+    {
+        ShBuiltInResources resources;
+        ShInitBuiltInResources(&resources);
+        resources.OES_standard_derivatives = 1;
+        mCompiler = ShConstructCompiler(
+            SH_FRAGMENT_SHADER, SH_GLES2_SPEC, GetParam(), &resources);
+        ASSERT_TRUE(mCompiler != NULL);
+    }
+
+    virtual void TearDown()
+    {
+        ShDestruct(mCompiler);
+    }
+
+    bool compilePrelude(const std::string& prelude)
+    {
+        const char* source = prelude.c_str();
+        return ShCompilePrelude(mCompiler, &source, 1) != 0;
+    }
+
+    bool compile(const std::string& shader)
+    {
+        const char* source = shader.c_str();
+        return ShCompile(mCompiler, &source, 1, SH_OBJECT_CODE) != 0;
+    }
+
+    // Compiles the prelude and the shader as two strings of one shader.
+    bool compileConcatenated(const std::string& prelude, const std::string& shader)
+    {
+        const char* sources[] = { prelude.c_str(), shader.c_str() };
+        return ShCompile(mCompiler, sources, 2, SH_OBJECT_CODE) != 0;
+    }
+
+    std::string getObjectCode()
+    {
+        size_t length = 0;
+        ShGetInfo(mCompiler, SH_OBJECT_CODE_LENGTH, &length);
+        std::string code(length, '\0');
+        ShGetObjectCode(mCompiler, &code[0]);
+        return code.c_str();
+    }
+
+    std::string getInfoLog()
+    {
+        size_t length = 0;
+        ShGetInfo(mCompiler, SH_INFO_LOG_LENGTH, &length);
+        std::string log(length, '\0');
+        ShGetInfoLog(mCompiler, &log[0]);
+        return log.c_str();
+    }
+
+    // Verifies that compiling shader after prelude gives the same object
+    // code as compiling the two together.
+    void expectSameAsConcatenated(const std::string& prelude, const std::string& shader)
+    {
+        ASSERT_TRUE(compileConcatenated(prelude, shader)) << getInfoLog();
+        const std::string expected = getObjectCode();
+
+        ASSERT_TRUE(compilePrelude(prelude)) << getInfoLog();
+        ASSERT_TRUE(compile(shader)) << getInfoLog();
+        EXPECT_EQ(expected, getObjectCode());
+        // The prelude is not changed by the compiles.
+        ASSERT_TRUE(compile(shader)) << getInfoLog();
+        EXPECT_EQ(expected, getObjectCode());
+
+        ASSERT_NE(0, ShCompilePrelude(mCompiler, NULL, 0));
+    }
+
+    ShHandle mCompiler;
+};
+
+static const char kPrelude[] =
+    "#extension GL_OES_standard_derivatives : enable\n"
+    "precision mediump float;\n"
+    "#define SCALE 2.0\n"
+    "#define TINT(c) ((c) * u_tint)\n"
+    "struct Light { vec3 direction; vec4 color; };\n"
+    "uniform Light u_light;\n"
+    "uniform vec4 u_tint;\n"
+    "varying vec3 v_normal;\n"
+    "const float kAmbient = 0.25;\n"
+    "float diffuse(vec3 n) {\n"
+    "    return max(dot(normalize(n), u_light.direction), 0.0);\n"
+    "}\n"
+    "vec4 shade(vec3 n);\n";
+
+TEST_P(PreludeTest, MatchesConcatenation)
+{
+    expectSameAsConcatenated(kPrelude,
+        "vec4 shade(vec3 n) {\n"
+        "    return TINT(u_light.color) * (kAmbient + diffuse(n));\n"
+        "}\n"
+        "void main() {\n"
+        "    Light light = u_light;\n"
+        "    gl_FragColor = shade(v_normal) * SCALE + dFdx(light.color);\n"
+        "}\n");
+}
+
+TEST_P(PreludeTest, MatchesConcatenationWithSingleDeclarations)
+{
+    expectSameAsConcatenated("precision mediump float;\n"
+                             "uniform vec4 u_color;\n",
+                             "void main() { gl_FragColor = u_color; }\n");
+    expectSameAsConcatenated("precision mediump float;\n"
+                             "void main() { gl_FragColor = vec4(1.0); }\n",
+                             "uniform vec4 u_unused;\n");
+    expectSameAsConcatenated("#define COLOR vec4(0.5)\n",
+                             "void main() { gl_FragColor = COLOR; }\n");
+}
+
+TEST_P(PreludeTest, ShadersDefinePreludePrototypes)
+{
+    ASSERT_TRUE(compilePrelude("precision mediump float;\n"
+                               "vec4 color();\n"));
+
+    // Each compile may define the function declared by the prelude.
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_TRUE(compile("vec4 color() { return vec4(1.0); }\n"
+                            "void main() { gl_FragColor = color(); }\n")) << getInfoLog();
+    }
+    // Defining it twice is still an error.
+    EXPECT_FALSE(compile("vec4 color() { return vec4(1.0); }\n"
+                         "vec4 color() { return vec4(0.0); }\n"
+                         "void main() { gl_FragColor = color(); }\n"));
+}
+
+TEST_P(PreludeTest, ShadersShareTheGlobalScope)
+{
+    ASSERT_TRUE(compilePrelude("precision mediump float;\n"
+                               "uniform vec4 u_color;\n"
+                               "vec4 color() { return u_color; }\n"));
+
+    EXPECT_FALSE(compile("uniform vec4 u_color;\n"
+                         "void main() { gl_FragColor = u_color; }\n"));
+    EXPECT_FALSE(compile("vec4 color() { return vec4(1.0); }\n"
+                         "void main() { gl_FragColor = color(); }\n"));
+    // Local declarations may still hide the globals.
+    EXPECT_TRUE(compile("void main() {\n"
+                        "    vec4 u_color = color();\n"
+                        "    gl_FragColor = u_color;\n"
+                        "}\n")) << getInfoLog();
+}
+
+TEST_P(PreludeTest, ShadersRedefinePreludeMacros)
+{
+    ASSERT_TRUE(compilePrelude("#define VALUE 1.0\n"));
+    EXPECT_TRUE(compile("#undef VALUE\n"
+                        "#define VALUE 0.5\n"
+                        "void main() { gl_FragColor = vec4(VALUE); }\n")) << getInfoLog();
+    const std::string redefined = getObjectCode();
+
+    // The macros of the prelude are restored for the next compile.
+    EXPECT_TRUE(compile("void main() { gl_FragColor = vec4(VALUE); }\n")) << getInfoLog();
+    EXPECT_NE(redefined, getObjectCode());
+}
+
+TEST_P(PreludeTest, ReportsShaderStringNumbers)
+{
+    ASSERT_TRUE(compilePrelude("precision mediump float;\n"
+                               "\n"
+                               "\n"));
+    EXPECT_FALSE(compile("void main() {\n"
+                         "    gl_FragColor = undeclared;\n"
+                         "}\n"));
+    std::string log = getInfoLog();
+    EXPECT_NE(std::string::npos, log.find("0:2: 'undeclared'")) << log;
+}
+
+TEST_P(PreludeTest, ReportsPreludeErrors)
+{
+    ASSERT_TRUE(compilePrelude("precision mediump float;\n"
+                               "uniform vec4 u_color;\n"));
+    EXPECT_FALSE(compilePrelude("precision mediump float;\n"
+                                "uniform vec4 u_other;\n"
+                                "vec4 broken() { return undeclared; }\n"));
+    std::string log = getInfoLog();
+    EXPECT_NE(std::string::npos, log.find("0:3: 'undeclared'")) << log;
+
+    // A failed prelude replaces the previous one all the same.
+    EXPECT_FALSE(compile("precision mediump float;\n"
+                         "void main() { gl_FragColor = u_color; }\n"));
+    EXPECT_FALSE(compile("precision mediump float;\n"
+                         "void main() { gl_FragColor = u_other; }\n"));
+}
+
+TEST_P(PreludeTest, RemovesPrelude)
+{
+    const std::string shader = "void main() { gl_FragColor = u_color; }\n";
+    ASSERT_TRUE(compilePrelude("precision mediump float;\n"
+                               "uniform vec4 u_color;\n"));
+    EXPECT_TRUE(compile(shader)) << getInfoLog();
+
+    EXPECT_NE(0, ShCompilePrelude(mCompiler, NULL, 0));
+    EXPECT_FALSE(compile(shader));
+}
+
+TEST_P(PreludeTest, RemovesPreludeExtensionBehavior)
+{
+    const std::string shader = "precision mediump float;\n"
+                               "varying vec2 v_texCoord;\n"
+                               "void main() { gl_FragColor = vec4(dFdx(v_texCoord.x)); }\n";
+    EXPECT_FALSE(compile(shader));
+    EXPECT_NE(std::string::npos, getInfoLog().find("extension is disabled")) << getInfoLog();
+
+    ASSERT_TRUE(compilePrelude("#extension GL_OES_standard_derivatives : enable\n"));
+    EXPECT_TRUE(compile(shader)) << getInfoLog();
+
+    ASSERT_NE(0, ShCompilePrelude(mCompiler, NULL, 0));
+    EXPECT_FALSE(compile(shader));
+    EXPECT_NE(std::string::npos, getInfoLog().find("extension is disabled")) << getInfoLog();
+
+    // Nor do the directives of a shader outlast its compile.
+    ASSERT_TRUE(compile("#extension GL_OES_standard_derivatives : enable\n" + shader))
+        << getInfoLog();
+    EXPECT_FALSE(compile(shader));
+}
+
+TEST_P(PreludeTest, KeysCachedTranslationsOnPrelude)
+{
+    ShSetTranslationCacheSize(1 << 20);
+    const std::string shader = "void main() { gl_FragColor = COLOR; }\n";
+
+    ASSERT_TRUE(compilePrelude("#define COLOR vec4(1.0)\n"));
+    ASSERT_TRUE(compile(shader)) << getInfoLog();
+    const std::string first = getObjectCode();
+
+    ASSERT_TRUE(compilePrelude("#define COLOR vec4(0.0)\n"));
+    ASSERT_TRUE(compile(shader)) << getInfoLog();
+    EXPECT_NE(first, getObjectCode());
+
+    ShSetTranslationCacheSize(0);
+}
+
+TEST_P(PreludeTest, KeysCachedTranslationsOnPreludeBoundary)
+{
+    ShSetTranslationCacheSize(1 << 20);
+    const std::string prelude = "precision mediump float;\n"
+                                "float f() { return 1.0; }\n";
+    const std::string shader = "void main() { gl_FragColor = vec4(f()); }\n";
+
+    ASSERT_TRUE(compilePrelude(prelude));
+    EXPECT_TRUE(compile(shader)) << getInfoLog();
+
+    // The same text as the shader followed by the prelude, where f() is
+    // not declared yet when main() calls it.
+    ASSERT_NE(0, ShCompilePrelude(mCompiler, NULL, 0));
+    const char* sources[] = { shader.c_str(), prelude.c_str() };
+    EXPECT_FALSE(ShCompile(mCompiler, sources, 2, SH_OBJECT_CODE));
+    EXPECT_NE(std::string::npos, getInfoLog().find("'f' : no matching overloaded function found"))
+        << getInfoLog();
+
+    ShSetTranslationCacheSize(0);
+}
+
+// Compiles small shaders after a large prelude of declarations, once with
+// the prelude compiled ahead and once with it concatenated to each shader.
+TEST_P(PreludeTest, DISABLED_PreludeCost)
+{
+    std::ostringstream prelude;
+    prelude << "precision mediump float;\n"
+               "uniform vec4 u_color;\n";
+    for (int i = 0; i < 200; ++i) {
+        prelude << "struct S" << i << " { vec4 a; float b; };\n"
+                   "vec4 f" << i << "(S" << i << " s, vec4 c) {\n"
+                   "    return s.a * s.b + c * " << i << ".0;\n"
+                   "}\n";
+    }
+    const std::string preludeSource = prelude.str();
+    const std::string shader = "void main() {\n"
+                               "    S7 s = S7(u_color, 0.5);\n"
+                               "    gl_FragColor = f7(s, u_color);\n"
+                               "}\n";
+
+    const int kIterations = 100;
+    clock_t start = clock();
+    for (int i = 0; i < kIterations; ++i)
+        ASSERT_TRUE(compileConcatenated(preludeSource, shader));
+    double concatenated = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    ASSERT_TRUE(compilePrelude(preludeSource));
+    for (int i = 0; i < kIterations; ++i)
+        ASSERT_TRUE(compile(shader));
+    double precompiled = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("concatenated: %.2f ms/compile, precompiled prelude: %.2f ms/compile\n",
+           concatenated * 1000 / kIterations, precompiled * 1000 / kIterations);
+}
+
+INSTANTIATE_TEST_CASE_P(AllOutputs, PreludeTest,
+                        testing::Values(SH_ESSL_OUTPUT, SH_GLSL_OUTPUT,
+                                        SH_HLSL9_OUTPUT, SH_HLSL11_OUTPUT));
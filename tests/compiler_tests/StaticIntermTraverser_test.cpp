@@ -0,0 +1,300 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+#include <stdio.h>
+#include <time.h>
+#include <vector>
+#include "compiler/StaticIntermTraverser.h"
+#include "gtest/gtest.h"
+
+namespace {
+
+struct Visited {
+    Visited(TIntermNode* node, Visit visit, TIntermNode* parent)
+        : node(node), visit(visit), parent(parent) { }
+    bool operator==(const Visited& other) const {
+        return node == other.node && visit == other.visit && parent == other.parent;
+    }
+
+    TIntermNode* node;
+    Visit visit;
+    TIntermNode* parent;
+};
+typedef std::vector<Visited> VisitList;
+
+// Records the nodes it visits through the virtual traversal, and skips the
+// subtree of skipped.
+class RecordingTraverser : public TIntermTraverser {
+public:
+    RecordingTraverser(bool inVisit, bool postVisit, TIntermNode* skipped)
+        : TIntermTraverser(true, inVisit, postVisit), mSkipped(skipped) { }
+
+    const VisitList& getVisits() const { return mVisits; }
+
+    virtual void visitSymbol(TIntermSymbol* node) { record(PreVisit, node); }
+    virtual void visitConstantUnion(TIntermConstantUnion* node) { record(PreVisit, node); }
+    virtual bool visitBinary(Visit visit, TIntermBinary* node) { return record(visit, node); }
+    virtual bool visitUnary(Visit visit, TIntermUnary* node) { return record(visit, node); }
+    virtual bool visitSelection(Visit visit, TIntermSelection* node) { return record(visit, node); }
+    virtual bool visitAggregate(Visit visit, TIntermAggregate* node) { return record(visit, node); }
+    virtual bool visitLoop(Visit visit, TIntermLoop* node) { return record(visit, node); }
+    virtual bool visitBranch(Visit visit, TIntermBranch* node) { return record(visit, node); }
+
+private:
+    bool record(Visit visit, TIntermNode* node)
+    {
+        mVisits.push_back(Visited(node, visit, getParentNode()));
+        return node != mSkipped;
+    }
+
+    TIntermNode* mSkipped;
+    VisitList mVisits;
+};
+
+// The same, through the static traversal.
+class StaticRecordingTraverser : public TStaticIntermTraverser<StaticRecordingTraverser> {
+public:
+    StaticRecordingTraverser(bool inVisit, bool postVisit, TIntermNode* skipped)
+        : TStaticIntermTraverser<StaticRecordingTraverser>(true, inVisit, postVisit),
+          mSkipped(skipped) { }
+
+    const VisitList& getVisits() const { return mVisits; }
+
+    void visitSymbol(TIntermSymbol* node) { record(PreVisit, node); }
+    void visitConstantUnion(TIntermConstantUnion* node) { record(PreVisit, node); }
+    bool visitBinary(Visit visit, TIntermBinary* node) { return record(visit, node); }
+    bool visitUnary(Visit visit, TIntermUnary* node) { return record(visit, node); }
+    bool visitSelection(Visit visit, TIntermSelection* node) { return record(visit, node); }
+    bool visitAggregate(Visit visit, TIntermAggregate* node) { return record(visit, node); }
+    bool visitLoop(Visit visit, TIntermLoop* node) { return record(visit, node); }
+    bool visitBranch(Visit visit, TIntermBranch* node) { return record(visit, node); }
+
+private:
+    bool record(Visit visit, TIntermNode* node)
+    {
+        mVisits.push_back(Visited(node, visit, getParentNode()));
+        return node != mSkipped;
+    }
+
+    TIntermNode* mSkipped;
+    VisitList mVisits;
+};
+
+// Counts the nodes of a tree, and the bytes of the node objects.
+class NodeCounter : public TIntermTraverser {
+public:
+    NodeCounter() : numNodes(0), numBytes(0) { }
+
+    virtual void visitSymbol(TIntermSymbol* node) { count(sizeof(*node)); }
+    virtual void visitConstantUnion(TIntermConstantUnion* node) { count(sizeof(*node)); }
+    virtual bool visitBinary(Visit, TIntermBinary* node) { return count(sizeof(*node)); }
+    virtual bool visitUnary(Visit, TIntermUnary* node) { return count(sizeof(*node)); }
+    virtual bool visitSelection(Visit, TIntermSelection* node) { return count(sizeof(*node)); }
+    virtual bool visitAggregate(Visit, TIntermAggregate* node) { return count(sizeof(*node)); }
+    virtual bool visitLoop(Visit, TIntermLoop* node) { return count(sizeof(*node)); }
+    virtual bool visitBranch(Visit, TIntermBranch* node) { return count(sizeof(*node)); }
+
+    size_t numNodes;
+    size_t numBytes;
+
+private:
+    bool count(size_t bytes)
+    {
+        ++numNodes;
+        numBytes += bytes;
+        return true;
+    }
+};
+
+class StaticNodeCounter : public TStaticIntermTraverser<StaticNodeCounter> {
+public:
+    StaticNodeCounter() : numNodes(0) { }
+
+    void visitSymbol(TIntermSymbol*) { ++numNodes; }
+    void visitConstantUnion(TIntermConstantUnion*) { ++numNodes; }
+    bool visitBinary(Visit, TIntermBinary*) { ++numNodes; return true; }
+    bool visitUnary(Visit, TIntermUnary*) { ++numNodes; return true; }
+    bool visitSelection(Visit, TIntermSelection*) { ++numNodes; return true; }
+    bool visitAggregate(Visit, TIntermAggregate*) { ++numNodes; return true; }
+    bool visitLoop(Visit, TIntermLoop*) { ++numNodes; return true; }
+    bool visitBranch(Visit, TIntermBranch*) { ++numNodes; return true; }
+
+    void incrementDepth(TIntermNode*) { }
+    void decrementDepth() { }
+
+    size_t numNodes;
+};
+
+}  // namespace
+
+class StaticIntermTraverserTest : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        allocator.push();
+        SetGlobalPoolAllocator(&allocator);
+    }
+
+    virtual void TearDown()
+    {
+        SetGlobalPoolAllocator(NULL);
+        allocator.popAll();
+    }
+
+    TIntermSymbol* symbol(int id)
+    {
+        return new TIntermSymbol(id, "x", TType(EbtFloat, EbpHigh));
+    }
+
+    TIntermBinary* binary(TOperator op, TIntermTyped* left, TIntermTyped* right)
+    {
+        TIntermBinary* node = new TIntermBinary(op);
+        node->setLeft(left);
+        node->setRight(right);
+        node->setType(left->getType());
+        return node;
+    }
+
+    // Returns the tree of
+    //   float f() {
+    //       for (int x0 = 0; x0 < x1; ++x0)
+    //           if (x2 > x3) x4 += -x5; else return x6;
+    //       return x7 * x8;
+    //   }
+    TIntermNode* makeTree()
+    {
+        ConstantUnion* zero = new ConstantUnion;
+        zero->setIConst(0);
+        TIntermAggregate* init = new TIntermAggregate(EOpDeclaration);
+        init->getSequence().push_back(binary(EOpInitialize, symbol(0),
+            new TIntermConstantUnion(zero, TType(EbtInt, EbpHigh, EvqConst))));
+        TIntermUnary* increment = new TIntermUnary(EOpPreIncrement);
+        increment->setOperand(symbol(0));
+        TIntermUnary* negate = new TIntermUnary(EOpNegative);
+        negate->setOperand(symbol(5));
+        TIntermSelection* selection = new TIntermSelection(
+            binary(EOpGreaterThan, symbol(2), symbol(3)),
+            binary(EOpAddAssign, symbol(4), negate),
+            new TIntermBranch(EOpReturn, symbol(6)));
+
+        TIntermAggregate* body = new TIntermAggregate(EOpSequence);
+        body->getSequence().push_back(new TIntermLoop(
+            ELoopFor, init, binary(EOpLessThan, symbol(0), symbol(1)), increment, selection));
+        body->getSequence().push_back(
+            new TIntermBranch(EOpReturn, binary(EOpMul, symbol(7), symbol(8))));
+
+        TIntermAggregate* function = new TIntermAggregate(EOpFunction);
+        function->setName("f(");
+        function->getSequence().push_back(new TIntermAggregate(EOpParameters));
+        function->getSequence().push_back(body);
+        TIntermAggregate* root = new TIntermAggregate(EOpSequence);
+        root->getSequence().push_back(function);
+        return root;
+    }
+
+    TPoolAllocator allocator;
+};
+
+TEST_F(StaticIntermTraverserTest, VisitsLikeTIntermTraverser)
+{
+    TIntermNode* root = makeTree();
+    TIntermNode* loop = root->getAsAggregate()->getSequence()[0]->getAsAggregate()->
+        getSequence()[1]->getAsAggregate()->getSequence()[0];
+    TIntermNode* skips[] = { NULL, loop, root };
+    for (int skip = 0; skip < 3; ++skip) {
+        for (int inVisit = 0; inVisit < 2; ++inVisit) {
+            for (int postVisit = 0; postVisit < 2; ++postVisit) {
+                RecordingTraverser expected(inVisit != 0, postVisit != 0, skips[skip]);
+                root->traverse(&expected);
+                StaticRecordingTraverser actual(inVisit != 0, postVisit != 0, skips[skip]);
+                actual.traverse(root);
+
+                EXPECT_TRUE(expected.getVisits() == actual.getVisits())
+                    << "skip " << skip << ", in-visits " << inVisit
+                    << ", post-visits " << postVisit;
+                EXPECT_EQ(expected.getMaxDepth(), actual.getMaxDepth());
+            }
+        }
+    }
+}
+
+TEST_F(StaticIntermTraverserTest, KnowsNodeKinds)
+{
+    TIntermSymbol* x = symbol(0);
+    EXPECT_EQ(EIntermSymbol, x->getKind());
+    EXPECT_EQ(x, x->getAsSymbolNode());
+    EXPECT_EQ(x, x->getAsTyped());
+    EXPECT_TRUE(x->getAsBinaryNode() == NULL);
+
+    TIntermBinary* add = binary(EOpAdd, x, symbol(1));
+    EXPECT_EQ(EIntermBinary, add->getKind());
+    EXPECT_EQ(add, add->getAsBinaryNode());
+    EXPECT_EQ(add, add->getAsTyped());
+    EXPECT_TRUE(add->getAsAggregate() == NULL);
+
+    TIntermBranch* branch = new TIntermBranch(EOpReturn, add);
+    EXPECT_EQ(EIntermBranch, branch->getKind());
+    EXPECT_TRUE(branch->getAsTyped() == NULL);
+
+    TIntermLoop* loop = new TIntermLoop(ELoopWhile, NULL, add, NULL, branch);
+    EXPECT_EQ(EIntermLoop, loop->getKind());
+    EXPECT_EQ(loop, loop->getAsLoopNode());
+    EXPECT_TRUE(loop->getAsTyped() == NULL);
+}
+
+TEST_F(StaticIntermTraverserTest, KeepsLines)
+{
+    TIntermSymbol* x = symbol(0);
+    TSourceLoc line = { 3, 100000, 4, 100002 };
+    x->setLine(line);
+    EXPECT_EQ(3, x->getLine().first_file);
+    EXPECT_EQ(100000, x->getLine().first_line);
+    EXPECT_EQ(4, x->getLine().last_file);
+    EXPECT_EQ(100002, x->getLine().last_line);
+
+    // Source string numbers are kept in full.
+    TSourceLoc farLine = { 70000, 1, 70001, 2 };
+    x->setLine(farLine);
+    EXPECT_EQ(70000, x->getLine().first_file);
+    EXPECT_EQ(70001, x->getLine().last_file);
+}
+
+TEST_F(StaticIntermTraverserTest, DISABLED_TraversalThroughput)
+{
+    const int kStatements = 200;
+    const int kDepth = 200;
+    const int kIterations = 50;
+    TIntermAggregate* root = new TIntermAggregate(EOpSequence);
+    for (int i = 0; i < kStatements; ++i) {
+        TIntermTyped* expression = symbol(1);
+        for (int depth = 0; depth < kDepth; ++depth)
+            expression = binary(depth % 2 ? EOpAdd : EOpMul, expression, symbol(depth + 2));
+        root->getSequence().push_back(binary(EOpAssign, symbol(0), expression));
+    }
+
+    NodeCounter counter;
+    root->traverse(&counter);
+
+    clock_t start = clock();
+    for (int i = 0; i < kIterations; ++i) {
+        NodeCounter virtualCounter;
+        root->traverse(&virtualCounter);
+    }
+    double virtualSeconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (int i = 0; i < kIterations; ++i) {
+        StaticNodeCounter staticCounter;
+        staticCounter.traverse(root);
+        ASSERT_EQ(counter.numNodes, staticCounter.numNodes);
+    }
+    double staticSeconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+    double numNodes = static_cast<double>(counter.numNodes) * kIterations;
+    printf("%u nodes, %.1f bytes/node: virtual %.1f nodes/us, static %.1f nodes/us\n",
+           static_cast<unsigned int>(counter.numNodes),
+           static_cast<double>(counter.numBytes) / counter.numNodes,
+           numNodes / virtualSeconds / 1e6, numNodes / staticSeconds / 1e6);
+}
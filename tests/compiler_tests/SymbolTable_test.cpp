@@ -0,0 +1,407 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+#include <ctype.h>
+#include <stdio.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include "compiler/BuiltInSymbolTable.h"
+#include "gtest/gtest.h"
+
+#define SHADER(Src) #Src
+
+class SymbolTableTest : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        allocator.push();
+        SetGlobalPoolAllocator(&allocator);
+
+        ShBuiltInResources resources;
+        ShInitBuiltInResources(&resources);
+        builtIns = TBuiltInSymbolTable::GetInstance(
+            SH_FRAGMENT_SHADER, SH_GLES2_SPEC, resources);
+    }
+
+    virtual void TearDown()
+    {
+        builtIns->Release();
+        SetGlobalPoolAllocator(NULL);
+        allocator.popAll();
+    }
+
+    TVariable* insertFloat(TSymbolTable* table, const char* name)
+    {
+        TVariable* variable = new TVariable(NewPoolTString(name),
+                                            TType(EbtFloat, EbpHigh));
+        return table->insert(*variable) ? variable : NULL;
+    }
+
+    TPoolAllocator allocator;
+    TBuiltInSymbolTable* builtIns;
+};
+
+TEST_F(SymbolTableTest, FindsSharedBuiltIns)
+{
+    TSymbolTable table;
+    table.pushSharedBuiltInLevel(builtIns->getSymbolTable());
+    table.push();
+
+    bool builtIn = false;
+    TSymbol* symbol = table.find("gl_FragColor", &builtIn);
+    ASSERT_TRUE(symbol != NULL);
+    EXPECT_TRUE(builtIn);
+    EXPECT_EQ(symbol, table.findBuiltIn("gl_FragColor"));
+    EXPECT_TRUE(table.find("sin(f1;") != NULL);
+    EXPECT_TRUE(table.find("sin(f2;f2;") == NULL);
+
+    TSymbolTable other;
+    other.pushSharedBuiltInLevel(builtIns->getSymbolTable());
+    EXPECT_EQ(symbol, other.find("gl_FragColor"));
+
+    table.pop();
+}
+
+TEST_F(SymbolTableTest, InnerScopesShadowOuterScopes)
+{
+    TSymbolTable table;
+    table.pushSharedBuiltInLevel(builtIns->getSymbolTable());
+    table.push();
+
+    TVariable* global = insertFloat(&table, "x");
+    ASSERT_TRUE(global != NULL);
+    EXPECT_TRUE(insertFloat(&table, "x") == NULL);
+
+    table.push();
+    TVariable* local = insertFloat(&table, "x");
+    ASSERT_TRUE(local != NULL);
+    bool builtIn = true;
+    bool sameScope = false;
+    EXPECT_EQ(local, table.find("x", &builtIn, &sameScope));
+    EXPECT_FALSE(builtIn);
+    EXPECT_TRUE(sameScope);
+
+    table.pop();
+    EXPECT_EQ(global, table.find("x", &builtIn, &sameScope));
+    EXPECT_TRUE(sameScope);
+
+    // A user-defined symbol may hide a built-in one.
+    TVariable* sin = insertFloat(&table, "sin");
+    ASSERT_TRUE(sin != NULL);
+    EXPECT_EQ(sin, table.find("sin"));
+
+    table.pop();
+    EXPECT_TRUE(table.atBuiltInLevel());
+}
+
+TEST_F(SymbolTableTest, ForgetsUserNamesWhenBackAtBuiltInLevel)
+{
+    TSymbolTable table;
+    table.pushSharedBuiltInLevel(builtIns->getSymbolTable());
+
+    table.push();
+    ASSERT_TRUE(insertFloat(&table, "userName") != NULL);
+    EXPECT_TRUE(table.find("userName") != NULL);
+    table.pop();
+
+    table.push();
+    bool builtIn = false;
+    bool sameScope = true;
+    EXPECT_TRUE(table.find("userName", &builtIn, &sameScope) == NULL);
+    EXPECT_TRUE(builtIn);
+    EXPECT_FALSE(sameScope);
+    EXPECT_TRUE(table.find("gl_FragCoord") != NULL);
+    table.pop();
+}
+
+TEST_F(SymbolTableTest, StructureTypesShareTheirProperties)
+{
+    // struct Inner { vec3 a; float b[2]; };
+    TFieldList* innerFields = NewPoolTFieldList();
+    innerFields->push_back(new TField(new TType(EbtFloat, EbpHigh, EvqTemporary, 3), NewPoolTString("a")));
+    TType* b = new TType(EbtFloat, EbpHigh);
+    b->setArraySize(2);
+    innerFields->push_back(new TField(b, NewPoolTString("b")));
+    TStructure* inner = new TStructure(NewPoolTString("Inner"), innerFields);
+
+    // struct Outer { Inner i; mat3 m; };
+    TFieldList* outerFields = NewPoolTFieldList();
+    outerFields->push_back(new TField(new TType(inner), NewPoolTString("i")));
+    outerFields->push_back(new TField(new TType(EbtFloat, EbpHigh, EvqTemporary, 3, true), NewPoolTString("m")));
+    TStructure* outer = new TStructure(NewPoolTString("Outer"), outerFields);
+
+    EXPECT_EQ("struct-Inner-vf3;-f1[2];", inner->mangledName());
+    EXPECT_EQ("struct-Outer-struct-Inner-vf3;-f1[2];1;-mf3;", outer->mangledName());
+    EXPECT_EQ(5u, inner->objectSize());
+    EXPECT_EQ(14u, outer->objectSize());
+    EXPECT_EQ(3, inner->registerCount());
+    EXPECT_EQ(6, outer->registerCount());
+    EXPECT_EQ(1, inner->deepestNesting());
+    EXPECT_EQ(2, outer->deepestNesting());
+    EXPECT_TRUE(outer->containsArrays());
+
+    TType outerArray(outer);
+    outerArray.setArraySize(4);
+    EXPECT_EQ(56u, outerArray.getObjectSize());
+    EXPECT_EQ(6, outerArray.elementRegisterCount());
+    EXPECT_EQ(24, outerArray.totalRegisterCount());
+
+    TString mangledName;
+    outerArray.appendMangledName(mangledName);
+    EXPECT_EQ(outer->mangledName() + "1[4];", mangledName);
+}
+
+TEST_F(SymbolTableTest, CallsFindFunctionsBySignature)
+{
+    TSymbolTable table;
+    table.pushSharedBuiltInLevel(builtIns->getSymbolTable());
+    table.push();
+
+    TFunction call(NewPoolTString("texture2D"), TType(EbtVoid, EbpUndefined));
+    TParameter sampler = { NULL, new TType(EbtSampler2D, EbpLow, EvqUniform) };
+    call.addParameter(sampler);
+    TParameter coordinate = { NULL, new TType(EbtFloat, EbpMedium, EvqTemporary, 2) };
+    call.addParameter(coordinate);
+
+    bool builtIn = false;
+    TSymbol* symbol = table.findFunction(call, &builtIn);
+    ASSERT_TRUE(symbol != NULL);
+    EXPECT_TRUE(symbol->isFunction());
+    EXPECT_TRUE(builtIn);
+    EXPECT_EQ(symbol, table.find("texture2D(s21;vf2;"));
+    EXPECT_EQ("texture2D(s21;vf2;", call.getMangledName());
+
+    // No texture2D takes a vec3 coordinate.
+    TFunction projected(NewPoolTString("texture2D"), TType(EbtVoid, EbpUndefined));
+    projected.addParameter(sampler);
+    TParameter projectedCoordinate = { NULL, new TType(EbtFloat, EbpMedium, EvqTemporary, 3) };
+    projected.addParameter(projectedCoordinate);
+    EXPECT_TRUE(table.findFunction(projected) == NULL);
+
+    table.pop();
+}
+
+TEST_F(SymbolTableTest, InternsEqualTypesOnce)
+{
+    TTypeTable types;
+    const TCanonicalType* uniform = types.intern(TType(EbtFloat, EbpHigh, EvqUniform, 3));
+    // Types that differ only in qualifier and precision are equal.
+    EXPECT_EQ(uniform, types.intern(TType(EbtFloat, EbpLow, EvqTemporary, 3)));
+    EXPECT_EQ(uniform, types.find(TType(EbtFloat, EbpMedium, EvqConst, 3)));
+    EXPECT_EQ(EvqTemporary, uniform->type.getQualifier());
+    EXPECT_EQ(EbpUndefined, uniform->type.getPrecision());
+    EXPECT_EQ("vf3;", uniform->mangledName);
+
+    TType matrixArray(EbtFloat, EbpHigh, EvqUniform, 3, true);
+    matrixArray.setArraySize(2);
+    EXPECT_TRUE(types.find(matrixArray) == NULL);
+    const TCanonicalType* canonical = types.intern(matrixArray);
+    EXPECT_NE(uniform, canonical);
+    EXPECT_EQ("mf3[2];", canonical->mangledName);
+    EXPECT_EQ(18u, canonical->objectSize);
+    EXPECT_EQ(3, canonical->elementRegisterCount);
+    EXPECT_EQ(6, canonical->totalRegisterCount);
+
+    // A child table finds the types of its parent, and forgets its own.
+    TTypeTable child;
+    child.setParent(&types);
+    EXPECT_EQ(canonical, child.find(matrixArray));
+    const TCanonicalType* scalar = child.intern(TType(EbtInt, EbpHigh));
+    EXPECT_TRUE(types.find(TType(EbtInt, EbpHigh)) == NULL);
+    EXPECT_EQ(scalar, child.find(TType(EbtInt, EbpLow)));
+    child.clear();
+    EXPECT_TRUE(child.find(TType(EbtInt, EbpHigh)) == NULL);
+    EXPECT_EQ(canonical, child.find(matrixArray));
+}
+
+TEST_F(SymbolTableTest, InternsSignaturesByParameterTypes)
+{
+    TTypeTable types;
+    TFunction none(NewPoolTString("f"), TType(EbtVoid, EbpUndefined));
+    EXPECT_EQ(TTypeTable::emptySignature(), types.intern(none));
+
+    TFunction vector(NewPoolTString("f"), TType(EbtVoid, EbpUndefined));
+    TParameter in = { NULL, new TType(EbtFloat, EbpHigh, EvqIn, 2) };
+    vector.addParameter(in);
+    TParameter out = { NULL, new TType(EbtInt, EbpHigh, EvqOut) };
+    vector.addParameter(out);
+    EXPECT_TRUE(types.find(vector) == NULL);
+    const TSignature* signature = types.intern(vector);
+    ASSERT_TRUE(signature != NULL);
+    EXPECT_EQ(types.find(TType(EbtInt, EbpLow)), signature->last);
+    EXPECT_EQ(types.find(TType(EbtFloat, EbpLow, EvqTemporary, 2)), signature->prefix->last);
+    EXPECT_EQ(TTypeTable::emptySignature(), signature->prefix->prefix);
+
+    // The call of another function with arguments of the same types has
+    // the same signature.
+    TFunction call(NewPoolTString("g"), TType(EbtVoid, EbpUndefined));
+    TParameter first = { NULL, new TType(EbtFloat, EbpLow, EvqTemporary, 2) };
+    call.addParameter(first);
+    TParameter second = { NULL, new TType(EbtInt, EbpMedium, EvqConst) };
+    call.addParameter(second);
+    EXPECT_EQ(signature, types.find(call));
+
+    // Signatures of a child table have ids of their own.
+    TTypeTable child;
+    child.setParent(&types);
+    EXPECT_EQ(signature, child.find(call));
+    TParameter third = { NULL, new TType(EbtBool, EbpUndefined) };
+    call.addParameter(third);
+    const TSignature* longer = child.intern(call);
+    EXPECT_EQ(signature, longer->prefix);
+    EXPECT_NE(signature->id, longer->id);
+    EXPECT_NE(signature->prefix->id, longer->id);
+}
+
+// Not run by default. Reports the cost of looking up each identifier of
+// a typical shader, declaring the user-defined ones as they first appear.
+TEST_F(SymbolTableTest, DISABLED_LookupCostPerIdentifier)
+{
+    static const char* shader = SHADER(
+        precision mediump float;
+        uniform sampler2D u_diffuseMap;
+        uniform sampler2D u_normalMap;
+        uniform samplerCube u_environmentMap;
+        uniform vec3 u_lightPositions[4];
+        uniform vec3 u_lightColors[4];
+        uniform vec3 u_cameraPosition;
+        uniform float u_shininess;
+        uniform float u_reflectivity;
+        varying vec3 v_position;
+        varying vec3 v_normal;
+        varying vec3 v_tangent;
+        varying vec2 v_texCoord;
+        vec3 perturbNormal(vec3 normal, vec3 tangent, vec2 texCoord) {
+            vec3 bitangent = cross(normal, tangent);
+            vec3 mapped = texture2D(u_normalMap, texCoord).xyz * 2.0 - 1.0;
+            return normalize(mapped.x * tangent + mapped.y * bitangent + mapped.z * normal);
+        }
+        float attenuation(float distance) {
+            return 1.0 / (1.0 + 0.09 * distance + 0.032 * distance * distance);
+        }
+        vec3 shade(vec3 normal, vec3 viewDirection, vec3 albedo) {
+            vec3 color = vec3(0.0);
+            for (int i = 0; i < 4; ++i) {
+                vec3 toLight = u_lightPositions[i] - v_position;
+                float distance = length(toLight);
+                vec3 lightDirection = toLight / distance;
+                vec3 halfVector = normalize(lightDirection + viewDirection);
+                float diffuse = max(dot(normal, lightDirection), 0.0);
+                float specular = pow(max(dot(normal, halfVector), 0.0), u_shininess);
+                color += (albedo * diffuse + vec3(specular)) * u_lightColors[i] * attenuation(distance);
+            }
+            return color;
+        }
+        void main() {
+            vec3 normal = perturbNormal(normalize(v_normal), normalize(v_tangent), v_texCoord);
+            vec3 viewDirection = normalize(u_cameraPosition - v_position);
+            vec4 albedo = texture2D(u_diffuseMap, v_texCoord);
+            vec3 reflected = reflect(-viewDirection, normal);
+            vec3 environment = textureCube(u_environmentMap, reflected).rgb;
+            vec3 color = mix(shade(normal, viewDirection, albedo.rgb), environment, u_reflectivity);
+            gl_FragColor = vec4(clamp(color, 0.0, 1.0), albedo.a);
+        }
+    );
+
+    std::vector<TString> identifiers;
+    for (const char* p = shader; *p;) {
+        if (isalpha(*p) || *p == '_') {
+            const char* begin = p;
+            while (isalnum(*p) || *p == '_')
+                ++p;
+            identifiers.push_back(TString(begin, p));
+        } else {
+            ++p;
+        }
+    }
+
+    TSymbolTable table;
+    table.pushSharedBuiltInLevel(builtIns->getSymbolTable());
+    table.push();
+    table.push();
+    for (size_t i = 0; i < identifiers.size(); ++i) {
+        if (table.find(identifiers[i]) == NULL)
+            insertFloat(&table, identifiers[i].c_str());
+    }
+
+    const int kIterations = 10000;
+    size_t found = 0;
+    clock_t start = clock();
+    for (int i = 0; i < kIterations; ++i) {
+        for (size_t j = 0; j < identifiers.size(); ++j) {
+            if (table.find(identifiers[j]) != NULL)
+                ++found;
+        }
+    }
+    clock_t end = clock();
+    EXPECT_EQ(kIterations * identifiers.size(), found);
+    size_t lookups = kIterations * identifiers.size();
+
+    printf("%u identifiers, %.1f ns per lookup\n",
+           static_cast<unsigned int>(identifiers.size()),
+           1e9 * (end - start) / CLOCKS_PER_SEC / lookups);
+
+    table.pop();
+    table.pop();
+}
+
+// Not run by default. Reports the cost of resolving a call: building the
+// signature of the call from the types of its arguments, as the parser
+// does, and looking it up.
+TEST_F(SymbolTableTest, DISABLED_CallResolutionCost)
+{
+    TSymbolTable table;
+    table.pushSharedBuiltInLevel(builtIns->getSymbolTable());
+    table.push();
+
+    TFieldList* fields = NewPoolTFieldList();
+    fields->push_back(new TField(new TType(EbtFloat, EbpHigh, EvqTemporary, 3), NewPoolTString("position")));
+    fields->push_back(new TField(new TType(EbtFloat, EbpHigh, EvqTemporary, 3), NewPoolTString("color")));
+    TType light(new TStructure(NewPoolTString("Light"), fields));
+
+    TFunction* shade = new TFunction(NewPoolTString("shade"), TType(EbtFloat, EbpHigh, EvqTemporary, 3));
+    TParameter lightParameter = { NULL, new TType(light) };
+    shade->addParameter(lightParameter);
+    TParameter normalParameter = { NULL, new TType(EbtFloat, EbpHigh, EvqTemporary, 3) };
+    shade->addParameter(normalParameter);
+    ASSERT_TRUE(table.insert(*shade));
+
+    struct Call {
+        const char* name;
+        TType arguments[3];
+        int argumentCount;
+    };
+    const Call calls[] = {
+        { "texture2D", { TType(EbtSampler2D, EbpLow), TType(EbtFloat, EbpHigh, EvqTemporary, 2) }, 2 },
+        { "dot", { TType(EbtFloat, EbpHigh, EvqTemporary, 3), TType(EbtFloat, EbpHigh, EvqTemporary, 3) }, 2 },
+        { "mix", { TType(EbtFloat, EbpHigh, EvqTemporary, 3), TType(EbtFloat, EbpHigh, EvqTemporary, 3),
+                   TType(EbtFloat, EbpHigh) }, 3 },
+        { "clamp", { TType(EbtFloat, EbpHigh, EvqTemporary, 4), TType(EbtFloat, EbpHigh),
+                     TType(EbtFloat, EbpHigh) }, 3 },
+        { "shade", { light, TType(EbtFloat, EbpHigh, EvqTemporary, 3) }, 2 },
+    };
+    const int kCalls = sizeof(calls) / sizeof(calls[0]);
+
+    const int kIterations = 100000;
+    size_t found = 0;
+    clock_t start = clock();
+    for (int i = 0; i < kIterations; ++i) {
+        for (int j = 0; j < kCalls; ++j) {
+            TFunction call(NewPoolTString(calls[j].name), TType(EbtVoid, EbpUndefined));
+            for (int k = 0; k < calls[j].argumentCount; ++k) {
+                TParameter parameter = { NULL, new TType(calls[j].arguments[k]) };
+                call.addParameter(parameter);
+            }
+            if (table.findFunction(call) != NULL)
+                ++found;
+        }
+    }
+    clock_t end = clock();
+    EXPECT_EQ(static_cast<size_t>(kIterations * kCalls), found);
+
+    printf("%.1f ns per call\n", 1e9 * (end - start) / CLOCKS_PER_SEC / (kIterations * kCalls));
+    table.pop();
+}
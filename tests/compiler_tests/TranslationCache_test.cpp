@@ -0,0 +1,379 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "GLSLANG/ShaderLang.h"
+#include "gtest/gtest.h"
+
+#define SHADER(Src) #Src
+
+namespace {
+
+const char* kVertexShader = SHADER(
+    attribute vec4 a_position;
+    uniform mat4 u_modelViewProjectionMatrix;
+    varying vec4 v_color;
+    void main() {
+        v_color = a_position * 0.5 + 0.5;
+        gl_Position = u_modelViewProjectionMatrix * a_position;
+    }
+);
+
+const char* kOtherVertexShader = SHADER(
+    attribute vec4 a_position;
+    void main() {
+        gl_Position = a_position;
+    }
+);
+
+const char* kInvalidVertexShader = SHADER(
+    void main() {
+        gl_Position = undeclared;
+    }
+);
+
+const int kCompileOptions = SH_OBJECT_CODE | SH_VARIABLES;
+
+size_t GetInfo(ShHandle compiler, ShShaderInfo pname)
+{
+    size_t value = 0;
+    ShGetInfo(compiler, pname, &value);
+    return value;
+}
+
+std::string GetObjectCode(ShHandle compiler)
+{
+    std::vector<char> buffer(GetInfo(compiler, SH_OBJECT_CODE_LENGTH) + 1);
+    ShGetObjectCode(compiler, &buffer[0]);
+    return std::string(&buffer[0]);
+}
+
+std::string GetInfoLog(ShHandle compiler)
+{
+    std::vector<char> buffer(GetInfo(compiler, SH_INFO_LOG_LENGTH) + 1);
+    ShGetInfoLog(compiler, &buffer[0]);
+    return std::string(&buffer[0]);
+}
+
+std::string GetActiveUniform(ShHandle compiler, int index)
+{
+    std::vector<char> name(GetInfo(compiler, SH_ACTIVE_UNIFORM_MAX_LENGTH) + 1);
+    size_t length = 0;
+    int size = 0;
+    ShDataType type = SH_NONE;
+    ShPrecisionType precision = SH_PRECISION_UNDEFINED;
+    int staticUse = 0;
+    ShGetVariableInfo(compiler, SH_ACTIVE_UNIFORMS, index, &length, &size,
+                      &type, &precision, &staticUse, &name[0], NULL);
+    return std::string(&name[0]);
+}
+
+}  // namespace
+
+class TranslationCacheTest : public testing::Test {
+protected:
+    virtual void SetUp()
+    {
+        ShInitBuiltInResources(&mResources);
+        mCompiler = ShConstructCompiler(
+            SH_VERTEX_SHADER, SH_GLES2_SPEC, SH_GLSL_OUTPUT, &mResources);
+        ASSERT_TRUE(mCompiler != NULL);
+        ShSetTranslationCacheSize(1 << 20);
+    }
+
+    virtual void TearDown()
+    {
+        // Leave the cache disabled for the other tests.
+        ShSetTranslationCacheSize(0);
+        ShDestruct(mCompiler);
+    }
+
+    size_t hits() { return GetInfo(mCompiler, SH_TRANSLATION_CACHE_HITS); }
+    size_t misses() { return GetInfo(mCompiler, SH_TRANSLATION_CACHE_MISSES); }
+    size_t evictions() { return GetInfo(mCompiler, SH_TRANSLATION_CACHE_EVICTIONS); }
+
+    bool compile(const char* shader, int compileOptions = kCompileOptions)
+    {
+        return ShCompile(mCompiler, &shader, 1, compileOptions) != 0;
+    }
+
+    ShBuiltInResources mResources;
+    ShHandle mCompiler;
+};
+
+// A second compile of the same shader is a hit, and leaves the compiler in
+// the same state as the first one.
+TEST_F(TranslationCacheTest, HitMatchesCompile)
+{
+    size_t hitsBefore = hits();
+    size_t missesBefore = misses();
+
+    ASSERT_TRUE(compile(kVertexShader));
+    EXPECT_EQ(missesBefore + 1, misses());
+    std::string objectCode = GetObjectCode(mCompiler);
+    std::string infoLog = GetInfoLog(mCompiler);
+    ASSERT_EQ(1u, GetInfo(mCompiler, SH_ACTIVE_ATTRIBUTES));
+    ASSERT_EQ(1u, GetInfo(mCompiler, SH_ACTIVE_UNIFORMS));
+    ASSERT_EQ(1u, GetInfo(mCompiler, SH_VARYINGS));
+    EXPECT_LT(0u, GetInfo(mCompiler, SH_TRANSLATION_CACHE_SIZE));
+
+    ASSERT_TRUE(compile(kOtherVertexShader));
+    ASSERT_TRUE(compile(kVertexShader));
+    EXPECT_EQ(hitsBefore + 1, hits());
+    EXPECT_EQ(objectCode, GetObjectCode(mCompiler));
+    EXPECT_EQ(infoLog, GetInfoLog(mCompiler));
+    EXPECT_EQ(1u, GetInfo(mCompiler, SH_ACTIVE_ATTRIBUTES));
+    EXPECT_EQ(1u, GetInfo(mCompiler, SH_VARYINGS));
+    ASSERT_EQ(1u, GetInfo(mCompiler, SH_ACTIVE_UNIFORMS));
+    EXPECT_EQ("u_modelViewProjectionMatrix", GetActiveUniform(mCompiler, 0));
+}
+
+// Compiles that fail are cached along with their info log.
+TEST_F(TranslationCacheTest, HitPreservesFailure)
+{
+    EXPECT_FALSE(compile(kInvalidVertexShader));
+    std::string infoLog = GetInfoLog(mCompiler);
+    EXPECT_NE(std::string::npos, infoLog.find("undeclared"));
+
+    size_t hitsBefore = hits();
+    EXPECT_FALSE(compile(kInvalidVertexShader));
+    EXPECT_EQ(hitsBefore + 1, hits());
+    EXPECT_EQ(infoLog, GetInfoLog(mCompiler));
+}
+
+// Anything the translation depends on besides the source is part of the key.
+TEST_F(TranslationCacheTest, MissesOnDifferentInputs)
+{
+    ASSERT_TRUE(compile(kVertexShader));
+
+    size_t hitsBefore = hits();
+    ASSERT_TRUE(compile(kVertexShader, SH_OBJECT_CODE));
+    EXPECT_EQ(hitsBefore, hits());
+
+    ShBuiltInResources resources = mResources;
+    resources.MaxVertexAttribs++;
+    ShHandle compiler = ShConstructCompiler(
+        SH_VERTEX_SHADER, SH_GLES2_SPEC, SH_GLSL_OUTPUT, &resources);
+    EXPECT_NE(0, ShCompile(compiler, &kVertexShader, 1, kCompileOptions));
+    EXPECT_EQ(hitsBefore, hits());
+    ShDestruct(compiler);
+
+    compiler = ShConstructCompiler(
+        SH_VERTEX_SHADER, SH_GLES2_SPEC, SH_ESSL_OUTPUT, &mResources);
+    EXPECT_NE(0, ShCompile(compiler, &kVertexShader, 1, kCompileOptions));
+    EXPECT_EQ(hitsBefore, hits());
+    ShDestruct(compiler);
+}
+
+// The least recently used translations are evicted to stay in budget.
+TEST_F(TranslationCacheTest, EvictsLeastRecentlyUsed)
+{
+    ASSERT_TRUE(compile(kVertexShader));
+    size_t entrySize = GetInfo(mCompiler, SH_TRANSLATION_CACHE_SIZE);
+
+    // Make room for kVertexShader and kOtherVertexShader, which is smaller.
+    ShSetTranslationCacheSize(0);
+    ShSetTranslationCacheSize(entrySize * 2);
+    ASSERT_TRUE(compile(kVertexShader));
+    ASSERT_TRUE(compile(kOtherVertexShader));
+    ASSERT_TRUE(compile(kVertexShader));
+
+    size_t evictionsBefore = evictions();
+    size_t hitsBefore = hits();
+    EXPECT_FALSE(compile(kInvalidVertexShader));
+    EXPECT_LT(evictionsBefore, evictions());
+    EXPECT_GE(entrySize * 2, GetInfo(mCompiler, SH_TRANSLATION_CACHE_SIZE));
+
+    // kOtherVertexShader was the least recently used.
+    ASSERT_TRUE(compile(kVertexShader));
+    EXPECT_EQ(hitsBefore + 1, hits());
+    ASSERT_TRUE(compile(kOtherVertexShader));
+    EXPECT_EQ(hitsBefore + 1, hits());
+}
+
+// A size of 0 empties the cache and stops it from caching.
+TEST_F(TranslationCacheTest, DisabledBySizeZero)
+{
+    ASSERT_TRUE(compile(kVertexShader));
+    ShSetTranslationCacheSize(0);
+    EXPECT_EQ(0u, GetInfo(mCompiler, SH_TRANSLATION_CACHE_SIZE));
+
+    size_t hitsBefore = hits();
+    size_t missesBefore = misses();
+    ASSERT_TRUE(compile(kVertexShader));
+    EXPECT_EQ(hitsBefore, hits());
+    EXPECT_EQ(missesBefore, misses());
+    EXPECT_EQ(0u, GetInfo(mCompiler, SH_TRANSLATION_CACHE_SIZE));
+}
+
+namespace {
+
+const char* kStorePath = "translation_cache_test.store";
+const char* kStoreIndexPath = "translation_cache_test.store.index";
+
+std::vector<char> ReadFile(const char* path)
+{
+    std::vector<char> contents;
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return contents;
+    char buffer[4096];
+    size_t read = 0;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        contents.insert(contents.end(), buffer, buffer + read);
+    fclose(file);
+    return contents;
+}
+
+void WriteFile(const char* path, const std::vector<char>& contents)
+{
+    FILE* file = fopen(path, "wb");
+    ASSERT_TRUE(file != NULL);
+    if (!contents.empty())
+        fwrite(&contents[0], 1, contents.size(), file);
+    fclose(file);
+}
+
+}  // namespace
+
+// Runs with the in-memory cache disabled, so that every hit comes from the
+// persistent store.
+class PersistentTranslationCacheTest : public TranslationCacheTest {
+protected:
+    virtual void SetUp()
+    {
+        TranslationCacheTest::SetUp();
+        ShSetTranslationCacheSize(0);
+        remove(kStorePath);
+        remove(kStoreIndexPath);
+        ASSERT_EQ(1, ShSetTranslationCacheFile(kStorePath));
+    }
+
+    virtual void TearDown()
+    {
+        ShSetTranslationCacheFile(NULL);
+        remove(kStorePath);
+        remove(kStoreIndexPath);
+        TranslationCacheTest::TearDown();
+    }
+
+    // Closes the store, as at the end of a process, and opens it again.
+    void reopen()
+    {
+        ASSERT_EQ(1, ShSetTranslationCacheFile(NULL));
+        ASSERT_EQ(1, ShSetTranslationCacheFile(kStorePath));
+    }
+
+    size_t persistentHits()
+    {
+        return GetInfo(mCompiler, SH_TRANSLATION_CACHE_PERSISTENT_HITS);
+    }
+};
+
+// Translations are found again once the store is reopened, indexed or not.
+TEST_F(PersistentTranslationCacheTest, HitMatchesCompile)
+{
+    ASSERT_TRUE(compile(kVertexShader));
+    std::string objectCode = GetObjectCode(mCompiler);
+    EXPECT_FALSE(compile(kInvalidVertexShader));
+    std::string infoLog = GetInfoLog(mCompiler);
+
+    reopen();
+    size_t hitsBefore = persistentHits();
+    ASSERT_TRUE(compile(kVertexShader));
+    EXPECT_EQ(hitsBefore + 1, persistentHits());
+    EXPECT_EQ(objectCode, GetObjectCode(mCompiler));
+    EXPECT_EQ(1u, GetInfo(mCompiler, SH_ACTIVE_ATTRIBUTES));
+    EXPECT_EQ(1u, GetInfo(mCompiler, SH_VARYINGS));
+    ASSERT_EQ(1u, GetInfo(mCompiler, SH_ACTIVE_UNIFORMS));
+    EXPECT_EQ("u_modelViewProjectionMatrix", GetActiveUniform(mCompiler, 0));
+    EXPECT_FALSE(compile(kInvalidVertexShader));
+    EXPECT_EQ(hitsBefore + 2, persistentHits());
+    EXPECT_EQ(infoLog, GetInfoLog(mCompiler));
+
+    // Without an index, as when the process exits without closing the
+    // store, the records are found by scanning the data file.
+    ASSERT_EQ(1, ShSetTranslationCacheFile(NULL));
+    remove(kStoreIndexPath);
+    ASSERT_EQ(1, ShSetTranslationCacheFile(kStorePath));
+    ASSERT_TRUE(compile(kVertexShader));
+    EXPECT_EQ(hitsBefore + 3, persistentHits());
+    EXPECT_EQ(objectCode, GetObjectCode(mCompiler));
+}
+
+// Translations that depend on the process are not persisted.
+TEST_F(PersistentTranslationCacheTest, SkipsMappedLongNames)
+{
+    ASSERT_TRUE(compile(kVertexShader, kCompileOptions | SH_MAP_LONG_VARIABLE_NAMES));
+    reopen();
+    size_t hitsBefore = persistentHits();
+    ASSERT_TRUE(compile(kVertexShader, kCompileOptions | SH_MAP_LONG_VARIABLE_NAMES));
+    EXPECT_EQ(hitsBefore, persistentHits());
+}
+
+// A store written by another version of the translator is started over.
+TEST_F(PersistentTranslationCacheTest, DiscardsOtherVersions)
+{
+    ASSERT_TRUE(compile(kVertexShader));
+    ASSERT_EQ(1, ShSetTranslationCacheFile(NULL));
+
+    // The version follows the magic number and the format version.
+    std::vector<char> data = ReadFile(kStorePath);
+    ASSERT_LT(12u, data.size());
+    data[8]++;
+    WriteFile(kStorePath, data);
+
+    ASSERT_EQ(1, ShSetTranslationCacheFile(kStorePath));
+    size_t hitsBefore = persistentHits();
+    ASSERT_TRUE(compile(kVertexShader));
+    EXPECT_EQ(hitsBefore, persistentHits());
+    std::vector<char> newData = ReadFile(kStorePath);
+    ASSERT_LT(12u, newData.size());
+    EXPECT_NE(data[8], newData[8]);
+}
+
+// Truncated or corrupted files only cause misses, and the store keeps
+// working past them.
+TEST_F(PersistentTranslationCacheTest, SurvivesDamagedFiles)
+{
+    ASSERT_TRUE(compile(kVertexShader));
+    std::string objectCode = GetObjectCode(mCompiler);
+    ASSERT_TRUE(compile(kOtherVertexShader));
+    ASSERT_EQ(1, ShSetTranslationCacheFile(NULL));
+    std::vector<char> data = ReadFile(kStorePath);
+    std::vector<char> index = ReadFile(kStoreIndexPath);
+    ASSERT_FALSE(index.empty());
+
+    // Flip a byte in every record, and cut the index short.
+    std::vector<char> corrupted = data;
+    for (size_t i = 32; i < corrupted.size(); i += 64)
+        corrupted[i] ^= 0x5A;
+    WriteFile(kStorePath, corrupted);
+    WriteFile(kStoreIndexPath, std::vector<char>(index.begin(), index.begin() + index.size() / 2));
+
+    ASSERT_EQ(1, ShSetTranslationCacheFile(kStorePath));
+    size_t hitsBefore = persistentHits();
+    ASSERT_TRUE(compile(kVertexShader));
+    EXPECT_EQ(hitsBefore, persistentHits());
+    EXPECT_EQ(objectCode, GetObjectCode(mCompiler));
+    reopen();
+    ASSERT_TRUE(compile(kVertexShader));
+    EXPECT_EQ(hitsBefore + 1, persistentHits());
+
+    // Truncate the data file in the middle of a record, behind the back of
+    // an intact index.
+    ASSERT_EQ(1, ShSetTranslationCacheFile(NULL));
+    WriteFile(kStorePath, std::vector<char>(data.begin(), data.end() - 16));
+    WriteFile(kStoreIndexPath, index);
+    ASSERT_EQ(1, ShSetTranslationCacheFile(kStorePath));
+    hitsBefore = persistentHits();
+    ASSERT_TRUE(compile(kVertexShader));
+    EXPECT_EQ(hitsBefore + 1, persistentHits());
+    EXPECT_EQ(objectCode, GetObjectCode(mCompiler));
+    ASSERT_TRUE(compile(kOtherVertexShader));
+    EXPECT_EQ(hitsBefore + 1, persistentHits());
+}
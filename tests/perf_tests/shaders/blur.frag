@@ -0,0 +1,18 @@
+precision mediump float;
+
+uniform sampler2D u_image;
+uniform vec2 u_texelSize;
+uniform float u_weights[5];
+
+varying vec2 v_texCoord;
+
+void main()
+{
+    vec4 sum = texture2D(u_image, v_texCoord) * u_weights[0];
+    for (int i = 1; i < 5; ++i) {
+        vec2 offset = u_texelSize * float(i);
+        sum += texture2D(u_image, v_texCoord + offset) * u_weights[i];
+        sum += texture2D(u_image, v_texCoord - offset) * u_weights[i];
+    }
+    gl_FragColor = sum;
+}
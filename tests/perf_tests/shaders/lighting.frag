@@ -0,0 +1,34 @@
+precision mediump float;
+
+struct Light {
+    vec3 position;
+    vec3 color;
+    float attenuation;
+};
+
+uniform Light u_lights[4];
+uniform sampler2D u_diffuse;
+uniform float u_shininess;
+
+varying vec3 v_normal;
+varying vec3 v_eyePosition;
+varying vec2 v_texCoord;
+
+void main()
+{
+    vec3 normal = normalize(v_normal);
+    vec3 view = normalize(-v_eyePosition);
+    vec3 albedo = texture2D(u_diffuse, v_texCoord).rgb;
+    vec3 color = vec3(0.05) * albedo;
+    for (int i = 0; i < 4; ++i) {
+        vec3 toLight = u_lights[i].position - v_eyePosition;
+        float distance = length(toLight);
+        vec3 direction = toLight / distance;
+        float falloff = 1.0 / (1.0 + u_lights[i].attenuation * distance * distance);
+        float diffuse = max(dot(normal, direction), 0.0);
+        vec3 halfway = normalize(direction + view);
+        float specular = diffuse > 0.0 ? pow(max(dot(normal, halfway), 0.0), u_shininess) : 0.0;
+        color += (albedo * diffuse + vec3(specular)) * u_lights[i].color * falloff;
+    }
+    gl_FragColor = vec4(color, 1.0);
+}
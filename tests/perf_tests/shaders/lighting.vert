@@ -0,0 +1,19 @@
+attribute vec3 a_position;
+attribute vec3 a_normal;
+attribute vec2 a_texCoord;
+
+uniform mat4 u_modelViewProjection;
+uniform mat4 u_modelView;
+uniform mat3 u_normalMatrix;
+
+varying vec3 v_normal;
+varying vec3 v_eyePosition;
+varying vec2 v_texCoord;
+
+void main()
+{
+    v_normal = normalize(u_normalMatrix * a_normal);
+    v_eyePosition = (u_modelView * vec4(a_position, 1.0)).xyz;
+    v_texCoord = a_texCoord;
+    gl_Position = u_modelViewProjection * vec4(a_position, 1.0);
+}
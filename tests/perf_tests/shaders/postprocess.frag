@@ -0,0 +1,32 @@
+#extension GL_OES_standard_derivatives : enable
+precision mediump float;
+
+uniform sampler2D u_scene;
+uniform sampler2D u_bloom;
+uniform float u_exposure;
+uniform vec2 u_resolution;
+
+varying vec2 v_texCoord;
+
+vec3 tonemap(vec3 color)
+{
+    color *= u_exposure;
+    return color / (color + vec3(1.0));
+}
+
+float luminance(vec3 color)
+{
+    return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+void main()
+{
+    vec3 scene = texture2D(u_scene, v_texCoord).rgb;
+    vec3 bloom = texture2D(u_bloom, v_texCoord).rgb;
+    vec3 color = tonemap(scene + bloom);
+    float edge = fwidth(luminance(color)) * 4.0;
+    vec2 centered = v_texCoord - vec2(0.5);
+    float vignette = smoothstep(0.8, 0.2, length(centered * u_resolution / u_resolution.y));
+    color = mix(color, vec3(0.0), clamp(edge, 0.0, 1.0));
+    gl_FragColor = vec4(pow(color * vignette, vec3(1.0 / 2.2)), 1.0);
+}
@@ -0,0 +1,31 @@
+attribute vec3 a_position;
+attribute vec3 a_normal;
+attribute vec4 a_boneIndices;
+attribute vec4 a_boneWeights;
+
+uniform mat4 u_viewProjection;
+uniform vec4 u_bones[3 * 32];
+
+varying vec3 v_normal;
+
+mat4 boneMatrix(float index)
+{
+    int i = int(index) * 3;
+    vec4 row0 = u_bones[i];
+    vec4 row1 = u_bones[i + 1];
+    vec4 row2 = u_bones[i + 2];
+    return mat4(row0.x, row1.x, row2.x, 0.0,
+                row0.y, row1.y, row2.y, 0.0,
+                row0.z, row1.z, row2.z, 0.0,
+                row0.w, row1.w, row2.w, 1.0);
+}
+
+void main()
+{
+    mat4 skin = boneMatrix(a_boneIndices.x) * a_boneWeights.x +
+                boneMatrix(a_boneIndices.y) * a_boneWeights.y +
+                boneMatrix(a_boneIndices.z) * a_boneWeights.z +
+                boneMatrix(a_boneIndices.w) * a_boneWeights.w;
+    v_normal = normalize((skin * vec4(a_normal, 0.0)).xyz);
+    gl_Position = u_viewProjection * skin * vec4(a_position, 1.0);
+}
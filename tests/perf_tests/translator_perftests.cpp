@@ -0,0 +1,269 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+//
+// Compiles a directory of shaders for every output and a few common sets of
+// options, and reports the throughput, latency and memory of each run as
+// one JSON object per line:
+//
+//   {"output": "glsl", "options": "webgl", "shaders": 12, "failures": 0,
+//    "shaders_per_second": 2345.6, "p50_us": 301.2, "p99_us": 1502.7,
+//    "peak_pool_bytes": 262144}
+//
+// Usage: translator_perftests [-n=iterations] directory
+// The shaders are the files of the directory ending in .frag or .vert.
+//
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include "GLSLANG/ShaderLang.h"
+
+namespace {
+
+struct Shader {
+    std::string name;
+    ShShaderType type;
+    std::string source;
+};
+
+struct OptionSet {
+    const char* name;
+    ShShaderSpec spec;
+    int compileOptions;
+};
+
+struct Output {
+    const char* name;
+    ShShaderOutput output;
+};
+
+const OptionSet kOptionSets[] = {
+    { "gles2", SH_GLES2_SPEC, SH_OBJECT_CODE | SH_VARIABLES },
+    { "webgl", SH_WEBGL_SPEC, SH_OBJECT_CODE | SH_VARIABLES | SH_VALIDATE_LOOP_INDEXING |
+                              SH_CLAMP_INDIRECT_ARRAY_BOUNDS },
+    { "webgl_timing", SH_WEBGL_SPEC, SH_OBJECT_CODE | SH_VARIABLES | SH_VALIDATE_LOOP_INDEXING |
+                                     SH_CLAMP_INDIRECT_ARRAY_BOUNDS | SH_TIMING_RESTRICTIONS },
+};
+
+const Output kOutputs[] = {
+    { "essl", SH_ESSL_OUTPUT },
+    { "glsl", SH_GLSL_OUTPUT },
+    { "hlsl9", SH_HLSL9_OUTPUT },
+    { "hlsl11", SH_HLSL11_OUTPUT },
+};
+
+double GetTimeSeconds()
+{
+#if defined(_WIN32)
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return static_cast<double>(counter.QuadPart) / frequency.QuadPart;
+#else
+#if defined(_POSIX_TIMERS) && _POSIX_TIMERS > 0 && defined(_POSIX_MONOTONIC_CLOCK)
+    struct timespec now;
+    if (clock_gettime(CLOCK_MONOTONIC, &now) == 0)
+        return now.tv_sec + now.tv_nsec * 1e-9;
+#endif
+    struct timeval time;
+    gettimeofday(&time, NULL);
+    return time.tv_sec + time.tv_usec * 1e-6;
+#endif
+}
+
+bool EndsWith(const std::string& name, const char* suffix)
+{
+    size_t length = strlen(suffix);
+    return name.size() > length && name.compare(name.size() - length, length, suffix) == 0;
+}
+
+// Returns the names of the files in directory, sorted.
+std::vector<std::string> ListDirectory(const std::string& directory)
+{
+    std::vector<std::string> names;
+#if defined(_WIN32)
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA((directory + "\\*").c_str(), &data);
+    if (find != INVALID_HANDLE_VALUE) {
+        do {
+            if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+                names.push_back(data.cFileName);
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
+    }
+#else
+    DIR* dir = opendir(directory.c_str());
+    if (dir) {
+        while (struct dirent* entry = readdir(dir)) {
+            if (entry->d_name[0] != '.')
+                names.push_back(entry->d_name);
+        }
+        closedir(dir);
+    }
+#endif
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+bool ReadFile(const std::string& path, std::string* contents)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+
+    char buffer[4096];
+    size_t count = 0;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        contents->append(buffer, count);
+    fclose(file);
+    return true;
+}
+
+std::vector<Shader> LoadShaders(const std::string& directory)
+{
+    std::vector<Shader> shaders;
+    std::vector<std::string> names = ListDirectory(directory);
+    for (size_t i = 0; i < names.size(); ++i) {
+        Shader shader;
+        if (EndsWith(names[i], ".frag"))
+            shader.type = SH_FRAGMENT_SHADER;
+        else if (EndsWith(names[i], ".vert"))
+            shader.type = SH_VERTEX_SHADER;
+        else
+            continue;
+
+        shader.name = names[i];
+        if (!ReadFile(directory + "/" + names[i], &shader.source)) {
+            fprintf(stderr, "Error: unable to read %s\n", names[i].c_str());
+            continue;
+        }
+        shaders.push_back(shader);
+    }
+    return shaders;
+}
+
+// Returns the value at fraction of the sorted values.
+double Percentile(const std::vector<double>& sorted, double fraction)
+{
+    if (sorted.empty())
+        return 0.0;
+    size_t index = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+// Compiles each shader iterations times with a compiler of its type, and
+// prints the results of the run.
+void Run(const std::vector<Shader>& shaders, const Output& output, const OptionSet& options,
+         const ShBuiltInResources& resources, int iterations)
+{
+    ShHandle compilers[2] = {
+        ShConstructCompiler(SH_FRAGMENT_SHADER, options.spec, output.output, &resources),
+        ShConstructCompiler(SH_VERTEX_SHADER, options.spec, output.output, &resources),
+    };
+
+    std::vector<double> latencies;
+    latencies.reserve(shaders.size() * iterations);
+    size_t failures = 0;
+    size_t peakPoolBytes = 0;
+    double totalSeconds = 0.0;
+    for (size_t i = 0; i < shaders.size(); ++i) {
+        ShHandle compiler = compilers[shaders[i].type == SH_FRAGMENT_SHADER ? 0 : 1];
+        const char* source = shaders[i].source.c_str();
+        for (int iteration = 0; iteration < iterations; ++iteration) {
+            double start = GetTimeSeconds();
+            int compiled = ShCompile(compiler, &source, 1, options.compileOptions);
+            double seconds = GetTimeSeconds() - start;
+            latencies.push_back(seconds);
+            totalSeconds += seconds;
+
+            if (iteration == 0) {
+                failures += compiled ? 0 : 1;
+                void* statistics = NULL;
+                ShGetInfoPointer(compiler, SH_MEMORY_STATISTICS, &statistics);
+                if (statistics) {
+                    peakPoolBytes = std::max(peakPoolBytes,
+                        static_cast<const ShMemoryStatistics*>(statistics)->peakBytes);
+                }
+            }
+        }
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    printf("{\"output\": \"%s\", \"options\": \"%s\", \"shaders\": %u, \"failures\": %u, "
+           "\"shaders_per_second\": %.1f, \"p50_us\": %.1f, \"p99_us\": %.1f, "
+           "\"peak_pool_bytes\": %u}\n",
+           output.name, options.name,
+           static_cast<unsigned int>(shaders.size()), static_cast<unsigned int>(failures),
+           totalSeconds > 0.0 ? latencies.size() / totalSeconds : 0.0,
+           Percentile(latencies, 0.50) * 1e6, Percentile(latencies, 0.99) * 1e6,
+           static_cast<unsigned int>(peakPoolBytes));
+    fflush(stdout);
+
+    ShDestruct(compilers[0]);
+    ShDestruct(compilers[1]);
+}
+
+void Usage()
+{
+    fprintf(stderr, "Usage: translator_perftests [-n=iterations] directory\n"
+                    "Where: directory : holds the shaders, in files ending in .frag or .vert\n"
+                    "       -n=n      : compile each shader n times (10 by default)\n");
+}
+
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    int iterations = 10;
+    const char* directory = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "-n=", 3) == 0 && atoi(&argv[i][3]) > 0) {
+            iterations = atoi(&argv[i][3]);
+        } else if (argv[i][0] != '-' && directory == NULL) {
+            directory = argv[i];
+        } else {
+            Usage();
+            return 1;
+        }
+    }
+    if (directory == NULL) {
+        Usage();
+        return 1;
+    }
+
+    std::vector<Shader> shaders = LoadShaders(directory);
+    if (shaders.empty()) {
+        fprintf(stderr, "Error: no shaders in %s\n", directory);
+        return 1;
+    }
+
+    ShInitialize();
+    ShBuiltInResources resources;
+    ShInitBuiltInResources(&resources);
+    resources.OES_standard_derivatives = 1;
+
+    for (size_t output = 0; output < sizeof(kOutputs) / sizeof(kOutputs[0]); ++output) {
+        for (size_t options = 0; options < sizeof(kOptionSets) / sizeof(kOptionSets[0]); ++options)
+            Run(shaders, kOutputs[output], kOptionSets[options], resources, iterations);
+    }
+
+    ShFinalize();
+    return 0;
+}
@@ -28,6 +28,12 @@ class MockDirectiveHandler : public pp::DirectiveHandler
 
     MOCK_METHOD2(handleVersion,
         void(const pp::SourceLocation& loc, int version));
+
+    MOCK_METHOD4(handleInclude,
+        bool(const pp::SourceLocation& loc,
+             const std::string& name,
+             const char** source,
+             size_t* length));
 };
 
 #endif  // PREPROCESSOR_TESTS_MOCK_DIRECTIVE_HANDLER_H_
@@ -4,6 +4,10 @@
 // found in the LICENSE file.
 //
 
+#include <stdio.h>
+#include <time.h>
+#include <sstream>
+
 #include "PreprocessorTest.h"
 #include "Token.h"
 
@@ -891,3 +895,374 @@ TEST_F(DefineTest, Predefined_FILE2)
     EXPECT_EQ(pp::Token::CONST_INT, token.type);
     EXPECT_EQ("21", token.text);
 }
+
+TEST_F(DefineTest, ManyMacros)
+{
+    std::ostringstream input, expected;
+    for (int i = 0; i < 100; ++i)
+        input << "#define M" << i << " " << i << "\n";
+    for (int i = 0; i < 100; i += 2)
+        input << "#undef M" << i << "\n";
+    for (int i = 0; i < 100; ++i)
+        input << "M" << i << "\n";
+
+    for (int i = 0; i < 150; ++i)
+        expected << "\n";
+    for (int i = 0; i < 100; ++i)
+    {
+        if (i % 2 == 0)
+            expected << "M";
+        expected << i << "\n";
+    }
+
+    preprocess(input.str().c_str(), expected.str().c_str());
+}
+
+TEST_F(DefineTest, SharedPredefinedMacros)
+{
+    pp::PredefinedMacroSet predefined;
+    predefined.define("GL_OES_foo", 1);
+
+    const char* input = "#define foo GL_OES_foo\n"
+                        "foo GL_ES\n";
+    pp::Preprocessor preprocessor1(&mDiagnostics, &mDirectiveHandler,
+                                   &predefined);
+    ASSERT_TRUE(preprocessor1.init(1, &input, NULL));
+    pp::Token token;
+    preprocessor1.lex(&token);
+    EXPECT_EQ("1", token.text);
+    preprocessor1.lex(&token);
+    EXPECT_EQ("1", token.text);
+
+    // The macros defined by one preprocessor are not seen by the others,
+    // and the shared ones cannot be undefined.
+    input = "foo\n"
+            "#undef GL_OES_foo\n"
+            "GL_OES_foo\n";
+    pp::Preprocessor preprocessor2(&mDiagnostics, &mDirectiveHandler,
+                                   &predefined);
+    ASSERT_TRUE(preprocessor2.init(1, &input, NULL));
+    EXPECT_CALL(mDiagnostics,
+                print(pp::Diagnostics::MACRO_PREDEFINED_UNDEFINED,
+                      pp::SourceLocation(0, 2),
+                      "GL_OES_foo"));
+    preprocessor2.lex(&token);
+    EXPECT_EQ("foo", token.text);
+    preprocessor2.lex(&token);
+    EXPECT_EQ("1", token.text);
+}
+
+// Returns a shader of about ten thousand tokens, which uses a few macros
+// if macroHeavy is true, and none otherwise.
+static std::string BenchmarkShader(bool macroHeavy)
+{
+    std::ostringstream shader;
+    shader << "#define SATURATE(x) clamp(x, 0.0, 1.0)\n"
+              "#define SCALE 0.5\n"
+              "precision mediump float;\n"
+              "uniform vec3 u_color;\n";
+    for (int i = 0; i < 200; ++i)
+    {
+        shader << "vec3 shade" << i << "(vec3 normal, vec3 direction) {\n";
+        if (macroHeavy)
+            shader << "    float d = SATURATE(dot(normal, direction)) * SCALE;\n";
+        else
+            shader << "    float d = clamp(dot(normal, direction), 0.0, 1.0) * 0.5;\n";
+        shader << "    return u_color * d + vec3(0.25);\n"
+                  "}\n";
+    }
+    return shader.str();
+}
+
+// Preprocesses shaders with and without macros, with the macros of twenty
+// extensions either defined for each shader or shared.
+TEST_F(DefineTest, DISABLED_LookupCost)
+{
+    const int kNumExtensions = 20;
+    pp::PredefinedMacroSet predefined;
+    std::vector<std::string> extensions;
+    for (int i = 0; i < kNumExtensions; ++i)
+    {
+        std::ostringstream name;
+        name << "GL_EXT_extension_" << i;
+        extensions.push_back(name.str());
+        predefined.define(extensions.back().c_str(), 1);
+    }
+
+    const int kIterations = 200;
+    for (int heavy = 0; heavy < 2; ++heavy)
+    {
+        std::string shader = BenchmarkShader(heavy != 0);
+        for (int shared = 0; shared < 2; ++shared)
+        {
+            size_t numTokens = 0;
+            clock_t start = clock();
+            for (int i = 0; i < kIterations; ++i)
+            {
+                pp::Preprocessor preprocessor(&mDiagnostics, &mDirectiveHandler,
+                                              shared ? &predefined : NULL);
+                const char* input = shader.c_str();
+                ASSERT_TRUE(preprocessor.init(1, &input, NULL));
+                for (int e = 0; !shared && e < kNumExtensions; ++e)
+                    preprocessor.predefineMacro(extensions[e].c_str(), 1);
+
+                pp::Token token;
+                do
+                {
+                    preprocessor.lex(&token);
+                    ++numTokens;
+                } while (token.type != pp::Token::LAST);
+            }
+            double seconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+            printf("%s shader, %s macros: %.2f million tokens/s\n",
+                   heavy ? "Macro-heavy" : "Macro-free",
+                   shared ? "shared" : "per-shader",
+                   numTokens / seconds / 1e6);
+        }
+    }
+}
+
+TEST_F(DefineTest, RepeatedInvocation)
+{
+    const char* input = "#define foo(x) bar(x) + x\n"
+                        "#define bar(y) (y)\n"
+                        "foo(1) foo(1)\n"
+                        "foo(1) foo(2)\n";
+    const char* expected = "\n"
+                           "\n"
+                           "(1) + 1 (1) + 1\n"
+                           "(1) + 1 (2) + 2\n";
+
+    preprocess(input, expected);
+}
+
+TEST_F(DefineTest, RepeatedInvocationRedefined)
+{
+    const char* input = "#define foo(x) bar x\n"
+                        "#define bar 1\n"
+                        "foo(a) foo(a)\n"
+                        "#undef bar\n"
+                        "foo(a) foo(a)\n"
+                        "#define bar 2\n"
+                        "foo(a) foo(a)\n";
+    const char* expected = "\n"
+                           "\n"
+                           "1 a 1 a\n"
+                           "\n"
+                           "bar a bar a\n"
+                           "\n"
+                           "2 a 2 a\n";
+
+    preprocess(input, expected);
+}
+
+TEST_F(DefineTest, RepeatedInvocationOfLine)
+{
+    const char* input = "#define foo(x) x __LINE__\n"
+                        "foo(__LINE__) foo(__LINE__)\n"
+                        "foo(__LINE__) foo(__LINE__)\n";
+    const char* expected = "\n"
+                           "2 2 2 2\n"
+                           "3 3 3 3\n";
+
+    preprocess(input, expected);
+}
+
+TEST_F(DefineTest, RepeatedInvocationFollowedByArgs)
+{
+    // The expansion of bar invokes foo with the tokens after it.
+    const char* input = "#define foo(x) [x]\n"
+                        "#define bar foo\n"
+                        "bar(1) bar(2) bar + bar(3)\n";
+    const char* expected = "\n"
+                           "\n"
+                           "[1] [2] foo + [3]\n";
+
+    preprocess(input, expected);
+}
+
+TEST_F(DefineTest, RepeatedInvocationWithErrors)
+{
+    const char* input = "#define foo(x) bar(x, x)\n"
+                        "#define bar(x) x\n"
+                        "foo(1) foo(1)\n";
+    const char* expected = "\n"
+                           "\n"
+                           "\n";
+
+    EXPECT_CALL(mDiagnostics,
+                print(pp::Diagnostics::MACRO_TOO_MANY_ARGS,
+                      pp::SourceLocation(0, 3),
+                      "bar"))
+        .Times(2);
+
+    preprocess(input, expected);
+}
+
+TEST_F(DefineTest, RepeatedSelfReference)
+{
+    const char* input = "#define foo bar\n"
+                        "#define bar foo baz(foo)\n"
+                        "#define baz(x) x\n"
+                        "foo foo\n"
+                        "bar bar\n";
+    const char* expected = "\n"
+                           "\n"
+                           "\n"
+                           "foo foo foo foo\n"
+                           "bar bar bar bar\n";
+
+    preprocess(input, expected);
+}
+
+// Lexes input with a preprocessor of its own, and saves its macros.
+static void SaveMacros(const char* input, pp::MacroSnapshot* snapshot)
+{
+    MockDiagnostics diagnostics;
+    MockDirectiveHandler directiveHandler;
+    pp::Preprocessor preprocessor(&diagnostics, &directiveHandler);
+    std::string source(input);
+    const char* string = source.c_str();
+    ASSERT_TRUE(preprocessor.init(1, &string, NULL));
+
+    pp::Token token;
+    do
+    {
+        preprocessor.lex(&token);
+    } while (token.type != pp::Token::LAST);
+    preprocessor.saveMacros(snapshot);
+}
+
+TEST_F(DefineTest, SnapshotDefinesMacros)
+{
+    pp::MacroSnapshot snapshot;
+    SaveMacros("#define foo 1 + bar\n"
+               "#define bar(x, y) (x * y)\n"
+               "#define baz\n"
+               "#undef baz\n",
+               &snapshot);
+    // The predefined macros are not saved.
+    EXPECT_EQ(2u, snapshot.size());
+
+    const char* input = "foo\n"
+                        "bar(2, 3)\n"
+                        "foo(4, 5)\n"
+                        "baz\n"
+                        "__LINE__\n";
+    const char* expected = "1 + bar\n"
+                           "(2 * 3)\n"
+                           "1 + (4 * 5)\n"
+                           "baz\n"
+                           "5\n";
+
+    mPreprocessor.defineMacros(snapshot);
+    preprocess(input, expected);
+}
+
+TEST_F(DefineTest, SnapshotMacrosCanBeRedefined)
+{
+    pp::MacroSnapshot snapshot;
+    SaveMacros("#define foo 1\n"
+               "#define bar 2\n",
+               &snapshot);
+
+    const char* input = "#undef foo\n"
+                        "#define foo 3\n"
+                        "#define bar 2\n"
+                        "foo bar\n";
+    const char* expected = "\n"
+                           "\n"
+                           "\n"
+                           "3 2\n";
+
+    mPreprocessor.defineMacros(snapshot);
+    preprocess(input, expected);
+
+    // The snapshot itself is not changed.
+    pp::Preprocessor preprocessor(&mDiagnostics, &mDirectiveHandler);
+    preprocessor.defineMacros(snapshot);
+    const char* string = "foo bar";
+    ASSERT_TRUE(preprocessor.init(1, &string, NULL));
+    pp::Token token;
+    preprocessor.lex(&token);
+    EXPECT_EQ("1", token.text);
+}
+
+TEST_F(DefineTest, SnapshotMacroRedefinedDifferently)
+{
+    pp::MacroSnapshot snapshot;
+    SaveMacros("#define foo 1\n", &snapshot);
+
+    const char* input = "#define foo 2\n"
+                        "foo\n";
+    const char* expected = "\n"
+                           "1\n";
+
+    EXPECT_CALL(mDiagnostics,
+                print(pp::Diagnostics::MACRO_REDEFINED,
+                      pp::SourceLocation(0, 1),
+                      "foo"));
+
+    mPreprocessor.defineMacros(snapshot);
+    preprocess(input, expected);
+}
+
+// Invokes the same function-like macros many times with the same
+// arguments, as generated shaders do.
+TEST_F(DefineTest, DISABLED_RepeatedInvocationCost)
+{
+    std::ostringstream shader;
+    shader << "#define SATURATE(x) clamp(x, 0.0, 1.0)\n"
+              "#define LUMA(c) dot(c, vec3(0.299, 0.587, 0.114))\n"
+              "#define SHADE(n, l) SATURATE(dot(n, l)) * LUMA(u_color)\n";
+    for (int i = 0; i < 2000; ++i)
+        shader << "d += SHADE(v_normal, u_light) + SATURATE(d);\n";
+    const std::string input = shader.str();
+
+    const int kIterations = 20;
+    size_t numTokens = 0;
+    clock_t start = clock();
+    for (int i = 0; i < kIterations; ++i)
+    {
+        pp::Preprocessor preprocessor(&mDiagnostics, &mDirectiveHandler);
+        const char* string = input.c_str();
+        ASSERT_TRUE(preprocessor.init(1, &string, NULL));
+
+        pp::Token token;
+        do
+        {
+            preprocessor.lex(&token);
+            ++numTokens;
+        } while (token.type != pp::Token::LAST);
+    }
+    double seconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+    printf("%.2f million tokens/s\n", numTokens / seconds / 1e6);
+}
+
+// Invokes a function-like macro many times, each time with different
+// arguments, so that no expansion is reused.
+TEST_F(DefineTest, DISABLED_DistinctInvocationCost)
+{
+    std::ostringstream shader;
+    shader << "#define F(a, b) ((a) * (b) + (a))\n";
+    for (int i = 0; i < 20000; ++i)
+        shader << "F(a_" << i << ", b_" << i << ")\n";
+    const std::string input = shader.str();
+
+    const int kIterations = 20;
+    clock_t start = clock();
+    for (int i = 0; i < kIterations; ++i)
+    {
+        pp::Preprocessor preprocessor(&mDiagnostics, &mDirectiveHandler);
+        const char* string = input.c_str();
+        ASSERT_TRUE(preprocessor.init(1, &string, NULL));
+
+        pp::Token token;
+        do
+        {
+            preprocessor.lex(&token);
+        } while (token.type != pp::Token::LAST);
+    }
+    double seconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+    printf("%.2f ms per 20000 invocations\n", seconds * 1e3 / kIterations);
+}
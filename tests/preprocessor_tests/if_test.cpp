@@ -4,6 +4,10 @@
 // found in the LICENSE file.
 //
 
+#include <stdio.h>
+#include <time.h>
+#include <sstream>
+
 #include "PreprocessorTest.h"
 #include "Token.h"
 
@@ -833,3 +837,120 @@ TEST_F(IfTest, UnterminatedIfdef)
     mPreprocessor.lex(&token);
 }
 
+
+TEST_F(IfTest, SkippedGroupWithComments)
+{
+    const char* str = "pass_1\n"
+                      "#if 0\n"
+                      "/* #endif */\n"
+                      "// #endif\n"
+                      "fail /*\n"
+                      "#endif\n"
+                      "*/\n"
+                      "/* c */ #else\n"
+                      "pass_2\n"
+                      "#endif\n"
+                      "pass_3\n";
+    const char* expected = "pass_1\n"
+                           "\n"
+                           "\n"
+                           "\n"
+                           "\n"
+                           "\n"
+                           "\n"
+                           "\n"
+                           "pass_2\n"
+                           "\n"
+                           "pass_3\n";
+
+    preprocess(str, expected);
+}
+
+TEST_F(IfTest, SkippedGroupWithLineContinuations)
+{
+    const char* str = "pass_1\n"
+                      "#if 0\n"
+                      "fail \\\n"
+                      "#endif\n"
+                      "fail\n"
+                      "#endif\n"
+                      "pass_2\n";
+    const char* expected = "pass_1\n"
+                           "\n"
+                           "\n"
+                           "\n"
+                           "\n"
+                           "\n"
+                           "pass_2\n";
+
+    preprocess(str, expected);
+}
+
+TEST_F(IfTest, SkippedGroupWithCarriageReturns)
+{
+    const char* str = "pass_1\r\n"
+                      "#if 0\r\n"
+                      "fail\r\n"
+                      "fail\r"
+                      "#endif\r"
+                      "pass_2\n";
+    const char* expected = "pass_1\n"
+                           "\n"
+                           "\n"
+                           "\n"
+                           "\n"
+                           "pass_2\n";
+
+    preprocess(str, expected);
+}
+
+TEST_F(IfTest, SkippedGroupAcrossStrings)
+{
+    const char* const str[] = {"#if 0\nfail\n", "fail\n#e", "ndif\n", "foo"};
+    ASSERT_TRUE(mPreprocessor.init(4, str, 0));
+
+    pp::Token token;
+    mPreprocessor.lex(&token);
+    EXPECT_EQ(pp::Token::IDENTIFIER, token.type);
+    EXPECT_EQ("foo", token.text);
+    EXPECT_EQ(3, token.location.file);
+    EXPECT_EQ(1, token.location.line);
+}
+
+// Preprocesses a shader with many feature blocks, most of them disabled,
+// as the permutations of an uber-shader are.
+TEST_F(IfTest, DISABLED_SkippedGroupThroughput)
+{
+    std::string str;
+    for (int i = 0; i < 500; ++i)
+    {
+        std::ostringstream block;
+        block << "#ifdef FEATURE_" << i << "\n"
+              << "// Feature " << i << ".\n"
+              << "uniform vec4 u_feature" << i << ";\n"
+              << "vec4 feature" << i << "(vec4 color) {\n"
+              << "    /* Scale and bias. */\n"
+              << "    return color * u_feature" << i << " + vec4(0.5);\n"
+              << "}\n"
+              << "#endif\n";
+        str += block.str();
+    }
+    str += "#define FEATURE_0\n";
+
+    const int kIterations = 200;
+    clock_t start = clock();
+    for (int i = 0; i < kIterations; ++i)
+    {
+        pp::Preprocessor preprocessor(&mDiagnostics, &mDirectiveHandler);
+        const char* input = str.c_str();
+        ASSERT_TRUE(preprocessor.init(1, &input, 0));
+
+        pp::Token token;
+        do
+        {
+            preprocessor.lex(&token);
+        } while (token.type != pp::Token::LAST);
+    }
+    double seconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+    printf("%.1f MB/s\n", kIterations * str.size() / seconds / (1024 * 1024));
+}
@@ -0,0 +1,347 @@
+//
+// Copyright (c) 2013 The ANGLE Project Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+//
+
+#include <cstring>
+#include <ctime>
+#include <sstream>
+
+#include "PreprocessorTest.h"
+#include "IncludeCache.h"
+#include "Token.h"
+
+using testing::_;
+
+class IncludeTest : public PreprocessorTest
+{
+  protected:
+    virtual void SetUp()
+    {
+        mPreprocessor.setIncludeCache(&mIncludeCache);
+    }
+
+    // Makes the directive handler provide source for #include "name".
+    void expectInclude(const char* name, const char* source, int times = 1)
+    {
+        EXPECT_CALL(mDirectiveHandler, handleInclude(_, std::string(name), _, _))
+            .Times(times)
+            .WillRepeatedly(testing::DoAll(
+                testing::SetArgPointee<2>(source),
+                testing::SetArgPointee<3>(std::strlen(source)),
+                testing::Return(true)));
+    }
+
+    // Preprocesses the input string and verifies that it has the expected
+    // tokens, which are separated by a space. Line numbers are not
+    // compared, as included tokens are in other files.
+    void expectTokens(const char* input, const char* expected)
+    {
+        ASSERT_TRUE(mPreprocessor.init(1, &input, NULL));
+
+        std::string actual;
+        pp::Token token;
+        mPreprocessor.lex(&token);
+        while (token.type != pp::Token::LAST)
+        {
+            if (!actual.empty())
+                actual += ' ';
+            actual += token.text.str();
+            mPreprocessor.lex(&token);
+        }
+        EXPECT_EQ(expected, actual);
+    }
+
+    pp::IncludeCache mIncludeCache;
+};
+
+TEST_F(IncludeTest, Quoted)
+{
+    const char* input = "#include \"foo.h\"\n"
+                        "bar\n";
+    const char* expected = "foo bar";
+
+    expectInclude("foo.h", "foo");
+    expectTokens(input, expected);
+}
+
+TEST_F(IncludeTest, AngleBrackets)
+{
+    const char* input = "#include <foo.h>\n"
+                        "bar\n";
+    const char* expected = "foo bar";
+
+    expectInclude("foo.h", "foo\n");
+    expectTokens(input, expected);
+}
+
+TEST_F(IncludeTest, NameWithSpaces)
+{
+    const char* input = "#include \"my foo.h\"\n";
+
+    expectInclude("my foo.h", "foo\n");
+    expectTokens(input, "foo");
+}
+
+TEST_F(IncludeTest, AtEndOfInput)
+{
+    const char* input = "#include \"foo.h\"";
+
+    expectInclude("foo.h", "foo");
+    expectTokens(input, "foo");
+}
+
+TEST_F(IncludeTest, IncludedLocation)
+{
+    const char* const input[] = {"foo\n", "#include \"a.h\"\n#include \"b.h\"\nbaz"};
+    ASSERT_TRUE(mPreprocessor.init(2, input, NULL));
+    expectInclude("a.h", "\nbar");
+    expectInclude("b.h", "qux");
+
+    pp::Token token;
+    mPreprocessor.lex(&token);
+    EXPECT_EQ("foo", token.text);
+    EXPECT_EQ(pp::SourceLocation(0, 1), token.location);
+
+    // Included sources are numbered after the input strings.
+    mPreprocessor.lex(&token);
+    EXPECT_EQ("bar", token.text);
+    EXPECT_EQ(pp::SourceLocation(2, 2), token.location);
+
+    mPreprocessor.lex(&token);
+    EXPECT_EQ("qux", token.text);
+    EXPECT_EQ(pp::SourceLocation(3, 1), token.location);
+
+    // The includer continues where it was.
+    mPreprocessor.lex(&token);
+    EXPECT_EQ("baz", token.text);
+    EXPECT_EQ(pp::SourceLocation(1, 3), token.location);
+}
+
+TEST_F(IncludeTest, Nested)
+{
+    const char* input = "#include \"a.h\"\n"
+                        "baz\n";
+    const char* expected = "foo bar baz";
+
+    expectInclude("a.h", "#include \"b.h\"\nbar\n");
+    expectInclude("b.h", "foo\n");
+    expectTokens(input, expected);
+}
+
+TEST_F(IncludeTest, SameSourceTwice)
+{
+    const char* input = "#include \"foo.h\"\n"
+                        "#include \"foo.h\"\n";
+    const char* const kSource = "foo\n";
+
+    expectInclude("foo.h", kSource, 2);
+    ASSERT_TRUE(mPreprocessor.init(1, &input, NULL));
+
+    pp::Token token;
+    mPreprocessor.lex(&token);
+    EXPECT_EQ("foo", token.text);
+    EXPECT_EQ(pp::SourceLocation(1, 1), token.location);
+
+    mPreprocessor.lex(&token);
+    EXPECT_EQ("foo", token.text);
+    EXPECT_EQ(pp::SourceLocation(2, 1), token.location);
+    EXPECT_EQ(1u, mIncludeCache.size());
+}
+
+TEST_F(IncludeTest, CacheSharedByPreprocessors)
+{
+    const char* input = "#include \"foo.h\"\n";
+    expectInclude("foo.h", "foo bar\n", 2);
+
+    expectTokens(input, "foo bar");
+
+    // Another preprocessor finds the tokens in the cache.
+    MockDiagnostics diagnostics;
+    pp::Preprocessor preprocessor(&diagnostics, &mDirectiveHandler);
+    preprocessor.setIncludeCache(&mIncludeCache);
+    ASSERT_TRUE(preprocessor.init(1, &input, NULL));
+
+    pp::Token token;
+    preprocessor.lex(&token);
+    EXPECT_EQ("foo", token.text);
+    preprocessor.lex(&token);
+    EXPECT_EQ("bar", token.text);
+    preprocessor.lex(&token);
+    EXPECT_EQ(pp::Token::LAST, token.type);
+    EXPECT_EQ(1u, mIncludeCache.size());
+}
+
+TEST_F(IncludeTest, MacroDefinedInInclude)
+{
+    const char* input = "#include \"foo.h\"\n"
+                        "FOO\n";
+    const char* expected = "bar";
+
+    expectInclude("foo.h", "#define FOO bar\n");
+    expectTokens(input, expected);
+}
+
+TEST_F(IncludeTest, ConditionalEvaluatedPerInclusion)
+{
+    const char* input = "#include \"foo.h\"\n"
+                        "#define FOO\n"
+                        "#include \"foo.h\"\n";
+    const char* expected = "without with";
+
+    expectInclude("foo.h", "#ifdef FOO\nwith\n#else\nwithout\n#endif\n", 2);
+    expectTokens(input, expected);
+}
+
+TEST_F(IncludeTest, LineInInclude)
+{
+    const char* input = "#include \"foo.h\"\n"
+                        "bar";
+    ASSERT_TRUE(mPreprocessor.init(1, &input, NULL));
+    expectInclude("foo.h", "#line 10 5\nfoo\n");
+
+    pp::Token token;
+    mPreprocessor.lex(&token);
+    EXPECT_EQ("foo", token.text);
+    EXPECT_EQ(pp::SourceLocation(5, 10), token.location);
+
+    // #line does not carry over to the includer.
+    mPreprocessor.lex(&token);
+    EXPECT_EQ("bar", token.text);
+    EXPECT_EQ(pp::SourceLocation(0, 2), token.location);
+}
+
+TEST_F(IncludeTest, DiagnosticInInclude)
+{
+    const char* input = "foo\n"
+                        "#include \"foo.h\"\n";
+
+    expectInclude("foo.h", "\nbar /* baz", 2);
+    EXPECT_CALL(mDiagnostics, print(pp::Diagnostics::EOF_IN_COMMENT,
+                                    pp::SourceLocation(1, 2), _));
+    expectTokens(input, "foo bar");
+
+    // The diagnostics of a cached source are reported again, in the file
+    // of the new inclusion.
+    MockDiagnostics diagnostics;
+    pp::Preprocessor preprocessor(&diagnostics, &mDirectiveHandler);
+    preprocessor.setIncludeCache(&mIncludeCache);
+    const char* const inputs[] = {"\n", input};
+    ASSERT_TRUE(preprocessor.init(2, inputs, NULL));
+    EXPECT_CALL(diagnostics, print(pp::Diagnostics::EOF_IN_COMMENT,
+                                   pp::SourceLocation(2, 2), _));
+
+    pp::Token token;
+    do
+    {
+        preprocessor.lex(&token);
+    } while (token.type != pp::Token::LAST);
+}
+
+TEST_F(IncludeTest, NotFound)
+{
+    const char* input = "#include \"foo.h\"\n"
+                        "bar\n";
+    const char* expected = "bar";
+
+    EXPECT_CALL(mDirectiveHandler, handleInclude(_, std::string("foo.h"), _, _))
+        .WillOnce(testing::Return(false));
+    EXPECT_CALL(mDiagnostics, print(pp::Diagnostics::INCLUDE_NOT_FOUND,
+                                    pp::SourceLocation(0, 1), "foo.h"));
+    expectTokens(input, expected);
+}
+
+TEST_F(IncludeTest, InvalidName)
+{
+    const char* input = "#include foo.h\n"
+                        "#include \"foo.h\n"
+                        "#include <foo.h> bar\n"
+                        "#include \"\"\n";
+
+    EXPECT_CALL(mDirectiveHandler, handleInclude(_, _, _, _)).Times(0);
+    EXPECT_CALL(mDiagnostics, print(pp::Diagnostics::INVALID_INCLUDE_DIRECTIVE, _, _))
+        .Times(4);
+    expectTokens(input, "");
+}
+
+TEST_F(IncludeTest, TooDeep)
+{
+    const char* input = "#include \"foo.h\"\n";
+
+    EXPECT_CALL(mDirectiveHandler, handleInclude(_, std::string("foo.h"), _, _))
+        .WillRepeatedly(testing::DoAll(
+            testing::SetArgPointee<2>("#include \"foo.h\"\n"),
+            testing::SetArgPointee<3>(std::strlen("#include \"foo.h\"\n")),
+            testing::Return(true)));
+    EXPECT_CALL(mDiagnostics, print(pp::Diagnostics::INCLUDE_TOO_DEEP, _, "foo.h"));
+    expectTokens(input, "");
+}
+
+TEST_F(IncludeTest, SkippedInExcludedGroup)
+{
+    const char* input = "#if 0\n"
+                        "#include \"foo.h\"\n"
+                        "#endif\n";
+
+    EXPECT_CALL(mDirectiveHandler, handleInclude(_, _, _, _)).Times(0);
+    expectTokens(input, "");
+}
+
+TEST(IncludeDisabledTest, InvalidDirective)
+{
+    MockDiagnostics diagnostics;
+    MockDirectiveHandler directiveHandler;
+    pp::Preprocessor preprocessor(&diagnostics, &directiveHandler);
+    const char* input = "#include \"foo.h\"\n";
+    ASSERT_TRUE(preprocessor.init(1, &input, NULL));
+
+    EXPECT_CALL(directiveHandler, handleInclude(_, _, _, _)).Times(0);
+    EXPECT_CALL(diagnostics, print(pp::Diagnostics::DIRECTIVE_INVALID_NAME,
+                                   pp::SourceLocation(0, 1), "include"));
+
+    pp::Token token;
+    preprocessor.lex(&token);
+    EXPECT_EQ(pp::Token::LAST, token.type);
+}
+
+// Compares including a prelude shared by many shaders with pasting it into
+// each of them.
+TEST_F(IncludeTest, DISABLED_PreludeCost)
+{
+    std::ostringstream prelude;
+    for (int i = 0; i < 500; ++i)
+    {
+        prelude << "// Helper " << i << ".\n"
+                   "float helper" << i << "(float x) { return x * " << i << ".0 + 0.5; }\n";
+    }
+    const std::string preludeText = prelude.str();
+    const std::string body = "void main() { gl_FragColor = vec4(helper1(0.5)); }\n";
+    const std::string pasted = preludeText + body;
+    const std::string included = "#include \"prelude.h\"\n" + body;
+    const int kIterations = 200;
+    expectInclude("prelude.h", preludeText.c_str(), kIterations);
+
+    for (int include = 0; include < 2; ++include)
+    {
+        size_t numTokens = 0;
+        clock_t start = clock();
+        for (int i = 0; i < kIterations; ++i)
+        {
+            pp::Preprocessor preprocessor(&mDiagnostics, &mDirectiveHandler);
+            preprocessor.setIncludeCache(&mIncludeCache);
+            const char* input = include ? included.c_str() : pasted.c_str();
+            ASSERT_TRUE(preprocessor.init(1, &input, NULL));
+
+            pp::Token token;
+            do
+            {
+                preprocessor.lex(&token);
+                ++numTokens;
+            } while (token.type != pp::Token::LAST);
+        }
+        double seconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+        printf("%s prelude: %.2f million tokens/s\n",
+               include ? "Included" : "Pasted", numTokens / seconds / 1e6);
+    }
+}
@@ -4,8 +4,12 @@
 // found in the LICENSE file.
 //
 
-#include "gtest/gtest.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sstream>
 
+#include "PreprocessorTest.h"
 #include "Token.h"
 
 TEST(TokenTest, DefaultConstructor)
@@ -88,3 +92,108 @@ TEST(TokenTest, Write)
     EXPECT_TRUE(out2.good());
     EXPECT_EQ(" foo", out2.str());
 }
+
+TEST(TokenTextTest, Intern)
+{
+    pp::TokenTextTable table;
+    const char str[] = "foobar";
+    pp::TokenText foo = table.intern(str, 3);
+    EXPECT_EQ("foo", foo);
+    EXPECT_NE(str, foo.data());
+    // Interned text is null-terminated.
+    EXPECT_EQ('\0', foo.data()[3]);
+
+    EXPECT_EQ(foo.data(), table.intern("foo", 3).data());
+    EXPECT_NE(foo.data(), table.intern(str, 6).data());
+}
+
+class TokenTextPreprocessorTest : public PreprocessorTest
+{
+};
+
+TEST_F(TokenTextPreprocessorTest, RefersToInput)
+{
+    const char* str = "foo bar";
+    ASSERT_TRUE(mPreprocessor.init(1, &str, 0));
+
+    pp::Token token;
+    mPreprocessor.lex(&token);
+    EXPECT_EQ("foo", token.text);
+    EXPECT_EQ(str, token.text.data());
+
+    mPreprocessor.lex(&token);
+    EXPECT_EQ("bar", token.text);
+    EXPECT_EQ(str + 4, token.text.data());
+}
+
+TEST_F(TokenTextPreprocessorTest, SplitAcrossStrings)
+{
+    const char* const str[] = {"f", "o", "o"};
+    ASSERT_TRUE(mPreprocessor.init(3, str, 0));
+
+    pp::Token token;
+    mPreprocessor.lex(&token);
+    EXPECT_EQ(pp::Token::IDENTIFIER, token.type);
+    EXPECT_EQ("foo", token.text);
+}
+
+TEST_F(TokenTextPreprocessorTest, MacroText)
+{
+    const char* str = "#define FOO(x) x + __LINE__\n"
+                      "FOO(bar)\n";
+    ASSERT_TRUE(mPreprocessor.init(1, &str, 0));
+
+    pp::Token token;
+    mPreprocessor.lex(&token);
+    EXPECT_EQ("bar", token.text);
+    EXPECT_EQ(strstr(str, "bar"), token.text.data());
+    mPreprocessor.lex(&token);
+    EXPECT_EQ("+", token.text);
+    mPreprocessor.lex(&token);
+    EXPECT_EQ("2", token.text);
+}
+
+// Preprocesses a shader made of typical lighting code with a few macros.
+TEST_F(TokenTextPreprocessorTest, DISABLED_TokensPerSecond)
+{
+    std::string str = "#define SATURATE(x) clamp(x, 0.0, 1.0)\n"
+                      "#define NUM_LIGHTS 4\n"
+                      "precision mediump float;\n"
+                      "uniform vec3 u_lightPositions[NUM_LIGHTS];\n"
+                      "uniform vec3 u_lightColors[NUM_LIGHTS];\n"
+                      "varying vec3 v_position;\n"
+                      "varying vec3 v_normal;\n";
+    for (int i = 0; i < 200; ++i)
+    {
+        std::ostringstream function;
+        function << "vec3 light" << i << "(vec3 normal) {\n"
+                 << "    vec3 color = vec3(0.0);\n"
+                 << "    for (int i = 0; i < NUM_LIGHTS; ++i) {\n"
+                 << "        vec3 direction = normalize(u_lightPositions[i] - v_position);\n"
+                 << "        float diffuse = SATURATE(dot(normal, direction));\n"
+                 << "        color += u_lightColors[i] * diffuse; // Lambert.\n"
+                 << "    }\n"
+                 << "    return color;\n"
+                 << "}\n";
+        str += function.str();
+    }
+
+    const int kIterations = 100;
+    size_t numTokens = 0;
+    clock_t start = clock();
+    for (int i = 0; i < kIterations; ++i)
+    {
+        pp::Preprocessor preprocessor(&mDiagnostics, &mDirectiveHandler);
+        const char* input = str.c_str();
+        ASSERT_TRUE(preprocessor.init(1, &input, 0));
+
+        pp::Token token;
+        do
+        {
+            preprocessor.lex(&token);
+            ++numTokens;
+        } while (token.type != pp::Token::LAST);
+    }
+    double seconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+    printf("%.2f million tokens/s\n", numTokens / seconds / 1e6);
+}